@@ -291,7 +291,8 @@ usage_general (void)
 	              "  status\n\n"
 	              "  hostname [<hostname>]\n\n"
 	              "  permissions\n\n"
-	              "  logging [level <log level>] [domains <log domains>]\n\n"));
+	              "  logging [level <log level>] [domains <log domains>]\n\n"
+	              "  logging dump\n\n"));
 }
 
 static void
@@ -358,14 +359,15 @@ usage_general_reload (void)
 static void
 usage_general_logging (void)
 {
-	g_printerr (_("Usage: nmcli general logging { ARGUMENTS | help }\n"
+	g_printerr (_("Usage: nmcli general logging { ARGUMENTS | dump | help }\n"
 	              "\n"
 	              "ARGUMENTS := [level <log level>] [domains <log domains>]\n"
 	              "\n"
 	              "Get or change NetworkManager logging level and domains.\n"
 	              "Without any argument current logging level and domains are shown. In order to\n"
 	              "change logging state, provide level and/or domain. Please refer to the man page\n"
-	              "for the list of possible logging domains.\n\n"));
+	              "for the list of possible logging domains.\n\n"
+	              "With \"dump\", the recent messages from the flight recorder are printed.\n\n"));
 }
 
 static void
@@ -748,6 +750,31 @@ _set_logging_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 	quit ();
 }
 
+static void
+_dump_logging_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+	NmCli *nmc = user_data;
+	gs_unref_variant GVariant *res = NULL;
+	gs_free_error GError *error = NULL;
+	gs_free const char **lines = NULL;
+	gsize i;
+
+	res = nm_client_dbus_call_finish (NM_CLIENT (object), result, &error);
+	if (!res) {
+		g_dbus_error_strip_remote_error (error);
+		g_string_printf (nmc->return_text, _("Error: failed to dump logging: %s"),
+		                 nmc_error_get_simple_message (error));
+		nmc->return_value = NMC_RESULT_ERROR_UNKNOWN;
+		quit ();
+		return;
+	}
+
+	g_variant_get (res, "(^a&s)", &lines);
+	for (i = 0; lines[i]; i++)
+		g_print ("%s\n", lines[i]);
+	quit ();
+}
+
 static void
 do_general_logging (const NMCCommand *cmd, NmCli *nmc, int argc, const char *const*argv)
 {
@@ -757,6 +784,20 @@ do_general_logging (const NMCCommand *cmd, NmCli *nmc, int argc, const char *con
 			return;
 
 		show_general_logging (nmc);
+	} else if (   argc == 1
+	           && !nmc->complete
+	           && matches (*argv, "dump")) {
+		nmc->should_wait++;
+		nm_client_dbus_call (nmc->client,
+		                     NM_DBUS_PATH,
+		                     NM_DBUS_INTERFACE,
+		                     "DumpLogging",
+		                     NULL,
+		                     G_VARIANT_TYPE ("(as)"),
+		                     -1,
+		                     NULL,
+		                     _dump_logging_cb,
+		                     nmc);
 	} else {
 		/* arguments provided -> set logging level and domains */
 		const char *level = NULL;
@@ -764,7 +805,7 @@ do_general_logging (const NMCCommand *cmd, NmCli *nmc, int argc, const char *con
 
 		do {
 			if (argc == 1 && nmc->complete)
-				nmc_complete_strings (*argv, "level", "domains");
+				nmc_complete_strings (*argv, "level", "domains", "dump");
 
 			if (matches (*argv, "level")) {
 				argc--;
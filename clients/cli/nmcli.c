@@ -243,6 +243,7 @@ usage (void)
 	              "  -o, --overview                           overview mode\n"
 	              "  -p, --pretty                             pretty output\n"
 	              "  -s, --show-secrets                       allow displaying passwords\n"
+	              "      --stream                             print large listings while they are generated\n"
 	              "  -t, --terse                              terse output\n"
 	              "  -v, --version                            show program version\n"
 	              "  -w, --wait <seconds>                     set timeout waiting for finishing operations\n"
@@ -743,7 +744,7 @@ process_command_line (NmCli *nmc, int argc, char **argv_orig)
 
 		if (argc == 1 && nmc->complete) {
 			nmc_complete_strings (argv[0], "--terse", "--pretty", "--mode", "--overview",
-			                               "--colors", "--escape",
+			                               "--colors", "--escape", "--stream",
 			                               "--fields", "--nocheck", "--get-values",
 			                               "--wait", "--version", "--help");
 		}
@@ -835,6 +836,8 @@ process_command_line (NmCli *nmc, int argc, char **argv_orig)
 			 * before the "-g <field>" option (-g may be still more practical and easy to remember than -t -f).
 			*/
 			nmc->mode_specified = TRUE;
+		} else if (matches_arg (nmc, &argc, &argv, "-stream", NULL)) {
+			nmc->nmc_config_mutable.stream_output = TRUE;
 		} else if (matches_arg (nmc, &argc, &argv, "-nocheck", NULL)) {
 			/* ignore for backward compatibility */
 		} else if (matches_arg (nmc, &argc, &argv, "-wait", &value)) {
@@ -98,6 +98,7 @@ typedef struct _NmcConfig {
 	bool in_editor;                                   /* Whether running the editor - nmcli con edit' */
 	bool show_secrets;                                /* Whether to display secrets (both input and output): option '--show-secrets' */
 	bool overview;                                    /* Overview mode (hide default values) */
+	bool stream_output;                               /* Print rows while rendering them, with the column widths of the first rows: option '--stream' */
 	const char *palette[_NM_META_COLOR_NUM];          /* Color palette */
 } NmcConfig;
 
@@ -939,6 +939,9 @@ typedef struct {
 	bool text_to_free:1;
 } PrintDataCell;
 
+/* the number of rows that get rendered at once, when streaming the output. */
+#define PRINT_STREAM_CHUNK_SIZE 256
+
 static void
 _print_data_header_cell_clear (gpointer cell_p)
 {
@@ -978,22 +981,13 @@ _print_data_cell_clear (gpointer cell_p)
 	_print_data_cell_clear_text (cell);
 }
 
-static void
-_print_fill (const NmcConfig *nmc_config,
-             gpointer const *targets,
-             gpointer targets_data,
-             const PrintDataCol *cols,
-             guint cols_len,
-             GArray **out_header_row,
-             GArray **out_cells)
+static GArray *
+_print_fill_header (const NmcConfig *nmc_config,
+                    const PrintDataCol *cols,
+                    guint cols_len)
 {
-	GArray *cells;
 	GArray *header_row;
-	guint i_row, i_col;
-	guint targets_len;
-	NMMetaAccessorGetType text_get_type;
-	NMMetaAccessorGetFlags text_get_flags;
-
+	guint i_col;
 
 	header_row = g_array_sized_new (FALSE, TRUE, sizeof (PrintDataHeaderCell), cols_len);
 	g_array_set_clear_func (header_row, _print_data_header_cell_clear);
@@ -1035,11 +1029,38 @@ _print_fill (const NmcConfig *nmc_config,
 		}
 	}
 
-	targets_len = NM_PTRARRAY_LEN (targets);
+	return header_row;
+}
 
-	cells = g_array_sized_new (FALSE, TRUE, sizeof (PrintDataCell), targets_len * header_row->len);
-	g_array_set_clear_func (cells, _print_data_cell_clear);
-	g_array_set_size (cells, targets_len * header_row->len);
+/* _print_fill_cells:
+ * @nmc_config: the configuration
+ * @header_row: the header row, as returned by _print_fill_header()
+ * @targets: the targets to render
+ * @targets_len: the number of @targets
+ * @targets_data: the data passed to the accessors
+ * @row_offset: the row index of the first target
+ * @update_to_print: whether cells may opt-in for their column to be
+ *   printed. When streaming, the columns that get printed are fixed after
+ *   the first chunk and later chunks must not change them.
+ * @cells: the array of cells. One row for each target gets appended.
+ */
+static void
+_print_fill_cells (const NmcConfig *nmc_config,
+                   GArray *header_row,
+                   gpointer const *targets,
+                   guint targets_len,
+                   gpointer targets_data,
+                   guint row_offset,
+                   gboolean update_to_print,
+                   GArray *cells)
+{
+	guint i_row, i_col;
+	guint cells_offset;
+	NMMetaAccessorGetType text_get_type;
+	NMMetaAccessorGetFlags text_get_flags;
+
+	cells_offset = cells->len;
+	g_array_set_size (cells, cells_offset + targets_len * header_row->len);
 
 	text_get_type = nmc_print_output_to_accessor_get_type (nmc_config->print_output);
 	text_get_flags = NM_META_ACCESSOR_GET_FLAGS_ACCEPT_STRV;
@@ -1048,7 +1069,7 @@ _print_fill (const NmcConfig *nmc_config,
 
 	for (i_row = 0; i_row < targets_len; i_row++) {
 		gpointer target = targets[i_row];
-		PrintDataCell *cells_line = &g_array_index (cells, PrintDataCell, i_row * header_row->len);
+		PrintDataCell *cells_line = &g_array_index (cells, PrintDataCell, cells_offset + i_row * header_row->len);
 
 		for (i_col = 0; i_col < header_row->len; i_col++) {
 			char *to_free = NULL;
@@ -1062,7 +1083,7 @@ _print_fill (const NmcConfig *nmc_config,
 			header_cell = &g_array_index (header_row, PrintDataHeaderCell, i_col);
 			info = header_cell->col->selection_item->info;
 
-			cell->row_idx = i_row;
+			cell->row_idx = row_offset + i_row;
 			cell->header_cell = header_cell;
 
 			value = nm_meta_abstract_info_get (info,
@@ -1078,9 +1099,11 @@ _print_fill (const NmcConfig *nmc_config,
 
 			nm_assert (!to_free || value == to_free);
 
-			if (   (   is_default
-			        && nmc_config->overview)
-			    || NM_FLAGS_HAS (text_out_flags, NM_META_ACCESSOR_GET_OUT_FLAGS_HIDE)) {
+			if (!update_to_print) {
+				/* the set of printed columns is already fixed. */
+			} else if (   (   is_default
+			               && nmc_config->overview)
+			           || NM_FLAGS_HAS (text_out_flags, NM_META_ACCESSOR_GET_OUT_FLAGS_HIDE)) {
 				/* don't mark the entry for display. This is to shorten the output in case
 				 * the property is the default value. But we only do that, if the user
 				 * opts in to this behavior (-overview), or of the property marks itself
@@ -1133,13 +1156,23 @@ _print_fill (const NmcConfig *nmc_config,
 			}
 		}
 	}
+}
+
+static void
+_print_fill_width (GArray *header_row,
+                   const GArray *cells)
+{
+	guint i_row, i_col;
+	guint row_len;
+
+	row_len = cells->len / header_row->len;
 
 	for (i_col = 0; i_col < header_row->len; i_col++) {
 		PrintDataHeaderCell *header_cell = &g_array_index (header_row, PrintDataHeaderCell, i_col);
 
 		header_cell->width = nmc_string_screen_width (header_cell->title, NULL);
 
-		for (i_row = 0; i_row < targets_len; i_row++) {
+		for (i_row = 0; i_row < row_len; i_row++) {
 			const PrintDataCell *cells_line = &g_array_index (cells, PrintDataCell, i_row * header_row->len);
 			const PrintDataCell *cell = &cells_line[i_col];
 			const char *const*i_strv;
@@ -1163,9 +1196,18 @@ _print_fill (const NmcConfig *nmc_config,
 
 		header_cell->width += 1;
 	}
+}
+
+static gboolean
+_print_all_columns_to_print (const GArray *header_row)
+{
+	guint i_col;
 
-	*out_header_row = header_row;
-	*out_cells = cells;
+	for (i_col = 0; i_col < header_row->len; i_col++) {
+		if (!g_array_index (header_row, PrintDataHeaderCell, i_col).to_print)
+			return FALSE;
+	}
+	return TRUE;
 }
 
 static gboolean
@@ -1205,16 +1247,14 @@ _print_skip_column (const NmcConfig *nmc_config,
 }
 
 static void
-_print_do (const NmcConfig *nmc_config,
-           const char *header_name_no_l10n,
-           guint col_len,
-           guint row_len,
-           const PrintDataHeaderCell *header_row,
-           const PrintDataCell *cells)
+_print_do_header (const NmcConfig *nmc_config,
+                  const char *header_name_no_l10n,
+                  guint col_len,
+                  const PrintDataHeaderCell *header_row)
 {
 	int width1, width2;
 	int table_width = 0;
-	guint i_row, i_col;
+	guint i_col;
 	nm_auto_free_gstring GString *str = NULL;
 
 	g_assert (col_len);
@@ -1243,13 +1283,11 @@ _print_do (const NmcConfig *nmc_config,
 		g_print ("%s\n", line);
 	}
 
-	str = !nmc_config->multiline_output
-	      ? g_string_sized_new (100)
-	      : NULL;
-
 	/* print the header for the tabular form */
 	if (   NM_IN_SET (nmc_config->print_output, NMC_PRINT_NORMAL, NMC_PRINT_PRETTY)
 	    && !nmc_config->multiline_output) {
+		str = g_string_sized_new (100);
+
 		for (i_col = 0; i_col < col_len; i_col++) {
 			const PrintDataHeaderCell *header_cell = &header_row[i_col];
 			const char *title;
@@ -1278,6 +1316,22 @@ _print_do (const NmcConfig *nmc_config,
 			g_print ("%s\n", (line = g_strnfill (table_width, '-')));
 		}
 	}
+}
+
+static void
+_print_do_rows (const NmcConfig *nmc_config,
+                guint col_len,
+                guint row_len,
+                const PrintDataHeaderCell *header_row,
+                const PrintDataCell *cells)
+{
+	int width1, width2;
+	guint i_row, i_col;
+	nm_auto_free_gstring GString *str = NULL;
+
+	str = !nmc_config->multiline_output
+	      ? g_string_sized_new (100)
+	      : NULL;
 
 	for (i_row = 0; i_row < row_len; i_row++) {
 		const PrintDataCell *current_line = &cells[i_row * col_len];
@@ -1345,7 +1399,6 @@ _print_do (const NmcConfig *nmc_config,
 						width2 = nmc_string_screen_width (text, NULL);  /* Width of the string (in screen columns) */
 						g_string_append_printf (str, "%-*s", (int) (header_cell->width + width1 - width2), text);
 						g_string_append_c (str, ' ');  /* Column separator */
-						table_width += header_cell->width + width1 - width2 + 1;
 					}
 				}
 			}
@@ -1382,6 +1435,9 @@ nmc_print (const NmcConfig *nmc_config,
 	guint cols_len;
 	gs_unref_array GArray *header_row = NULL;
 	gs_unref_array GArray *cells = NULL;
+	guint targets_len;
+	guint n_rows;
+	guint i_row;
 
 	if (!_output_selection_parse (fields,
 	                              fields_str,
@@ -1391,20 +1447,78 @@ nmc_print (const NmcConfig *nmc_config,
 	                              error))
 		return FALSE;
 
-	_print_fill (nmc_config,
-	             targets,
-	             targets_data,
-	             cols_data,
-	             cols_len,
-	             &header_row,
-	             &cells);
-
-	_print_do (nmc_config,
-	           header_name_no_l10n,
-	           header_row->len,
-	           cells->len / header_row->len,
-	           &g_array_index (header_row, PrintDataHeaderCell, 0),
-	           &g_array_index (cells, PrintDataCell, 0));
+	header_row = _print_fill_header (nmc_config, cols_data, cols_len);
+
+	targets_len = NM_PTRARRAY_LEN (targets);
+
+	/* Rendering all cells before printing anything takes a lot of memory
+	 * for large listings. Instead, render and print them in chunks.
+	 *
+	 * For terse and multiline output, this gives the same result as long as
+	 * every column is already printed after the first chunk. With --stream,
+	 * the printed columns and the column widths for tabular output are
+	 * determined by the first chunk alone. */
+	n_rows = NM_MIN (targets_len, PRINT_STREAM_CHUNK_SIZE);
+
+	cells = g_array_sized_new (FALSE, TRUE, sizeof (PrintDataCell), n_rows * header_row->len);
+	g_array_set_clear_func (cells, _print_data_cell_clear);
+
+	_print_fill_cells (nmc_config,
+	                   header_row,
+	                   targets,
+	                   n_rows,
+	                   targets_data,
+	                   0,
+	                   TRUE,
+	                   cells);
+
+	if (   n_rows < targets_len
+	    && !nmc_config->stream_output
+	    && !(   (   nmc_config->multiline_output
+	             || nmc_config->print_output == NMC_PRINT_TERSE)
+	         && _print_all_columns_to_print (header_row))) {
+		/* we cannot stream. Render the remaining rows too. */
+		_print_fill_cells (nmc_config,
+		                   header_row,
+		                   &targets[n_rows],
+		                   targets_len - n_rows,
+		                   targets_data,
+		                   n_rows,
+		                   TRUE,
+		                   cells);
+		n_rows = targets_len;
+	}
+
+	_print_fill_width (header_row, cells);
+
+	_print_do_header (nmc_config,
+	                  header_name_no_l10n,
+	                  header_row->len,
+	                  &g_array_index (header_row, PrintDataHeaderCell, 0));
+
+	i_row = 0;
+	while (TRUE) {
+		_print_do_rows (nmc_config,
+		                header_row->len,
+		                n_rows,
+		                &g_array_index (header_row, PrintDataHeaderCell, 0),
+		                &g_array_index (cells, PrintDataCell, 0));
+
+		i_row += n_rows;
+		if (i_row >= targets_len)
+			break;
+
+		n_rows = NM_MIN (targets_len - i_row, PRINT_STREAM_CHUNK_SIZE);
+		g_array_set_size (cells, 0);
+		_print_fill_cells (nmc_config,
+		                   header_row,
+		                   &targets[i_row],
+		                   n_rows,
+		                   targets_data,
+		                   i_row,
+		                   FALSE,
+		                   cells);
+	}
 
 	return TRUE;
 }
@@ -926,6 +926,7 @@ fi
 %dir %{_sysconfdir}/%{name}/dispatcher.d/pre-down.d
 %dir %{_sysconfdir}/%{name}/dispatcher.d/pre-up.d
 %dir %{_sysconfdir}/%{name}/dispatcher.d/no-wait.d
+%dir %{_sysconfdir}/%{name}/dispatcher.d/parallel.d
 %dir %{_sysconfdir}/%{name}/dnsmasq.d
 %dir %{_sysconfdir}/%{name}/dnsmasq-shared.d
 %dir %{_sysconfdir}/%{name}/system-connections
@@ -951,6 +952,7 @@ fi
 %dir %{nmlibdir}/dispatcher.d/pre-down.d
 %dir %{nmlibdir}/dispatcher.d/pre-up.d
 %dir %{nmlibdir}/dispatcher.d/no-wait.d
+%dir %{nmlibdir}/dispatcher.d/parallel.d
 %dir %{nmlibdir}/VPN
 %dir %{nmlibdir}/system-connections
 %{_mandir}/man1/*
@@ -23,11 +23,56 @@
 
 typedef struct Request Request;
 
+typedef struct {
+	dev_t st_dev;
+	ino_t st_ino;
+	struct timespec st_mtim;
+	bool exists:1;
+} DirState;
+
+typedef struct {
+	/* the invocation of an "ActionBatch" call. */
+	GDBusMethodInvocation *context;
+
+	/* the "a(sus)" results, one for each request of the batch. */
+	GVariant **results;
+	guint n_requests;
+	guint n_pending;
+} Batch;
+
+typedef struct {
+	char *path;
+	bool wait;
+	bool parallel;
+} ScriptEntry;
+
+typedef struct {
+	/* the ScriptEntry list, sorted by basename. */
+	GArray *entries;
+
+	/* the state of the NMLIBDIR and NMCONFDIR directories
+	 * at the time of the scan. */
+	DirState dirs[2];
+
+	/* whether the directories were modified shortly before the
+	 * scan. In that case, their mtime might not have changed for
+	 * a later modification and the cache cannot be trusted. */
+	bool unstable:1;
+} ScriptCache;
+
+typedef enum {
+	SCRIPT_CACHE_TYPE_DEFAULT,
+	SCRIPT_CACHE_TYPE_PRE_UP,
+	SCRIPT_CACHE_TYPE_PRE_DOWN,
+	_SCRIPT_CACHE_TYPE_NUM,
+} ScriptCacheType;
+
 static struct {
 	GDBusConnection *dbus_connection;
 	GMainLoop *loop;
 	gboolean debug;
 	gboolean persist;
+	char *test_dir;
 	guint quit_id;
 	guint request_id_counter;
 	gboolean ever_acquired_name;
@@ -36,6 +81,12 @@ static struct {
 	Request *current_request;
 	GQueue *requests_waiting;
 	int num_requests_pending;
+
+	/* NMLIBDIR and NMCONFDIR, or the "lib" and "etc" directories
+	 * below --test-dir. */
+	char *script_bases[2];
+
+	ScriptCache *script_caches[_SCRIPT_CACHE_TYPE_NUM];
 } gl;
 
 typedef struct {
@@ -46,6 +97,7 @@ typedef struct {
 	DispatchResult result;
 	char *error;
 	gboolean wait;
+	gboolean parallel;
 	gboolean dispatched;
 	guint watch_id;
 	guint timeout_id;
@@ -54,7 +106,11 @@ typedef struct {
 struct Request {
 	guint request_id;
 
+	/* either @context or @batch is set. */
 	GDBusMethodInvocation *context;
+	Batch *batch;
+	guint batch_idx;
+
 	char *action;
 	char *iface;
 	char **envp;
@@ -64,6 +120,7 @@ struct Request {
 	guint idx;
 	int num_scripts_done;
 	int num_scripts_nowait;
+	int num_scripts_parallel;
 };
 
 /*****************************************************************************/
@@ -166,6 +223,7 @@ request_free (Request *request)
 {
 	g_assert_cmpuint (request->num_scripts_done, ==, request->scripts->len);
 	g_assert_cmpuint (request->num_scripts_nowait, ==, 0);
+	g_assert_cmpuint (request->num_scripts_parallel, ==, 0);
 
 	g_free (request->action);
 	g_free (request->iface);
@@ -175,6 +233,38 @@ request_free (Request *request)
 	g_slice_free (Request, request);
 }
 
+static void
+request_return (Request *request, GVariant *results)
+{
+	Batch *batch = request->batch;
+	GVariantBuilder builder;
+	guint i;
+
+	if (!batch) {
+		g_dbus_method_invocation_return_value (request->context,
+		                                       g_variant_new ("(@a(sus))", results));
+		return;
+	}
+
+	nm_assert (request->batch_idx < batch->n_requests);
+	nm_assert (!batch->results[request->batch_idx]);
+	nm_assert (batch->n_pending > 0);
+
+	batch->results[request->batch_idx] = g_variant_ref_sink (results);
+	if (--batch->n_pending > 0)
+		return;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa(sus)"));
+	for (i = 0; i < batch->n_requests; i++) {
+		g_variant_builder_add_value (&builder, batch->results[i]);
+		g_variant_unref (batch->results[i]);
+	}
+	g_dbus_method_invocation_return_value (batch->context,
+	                                       g_variant_new ("(aa(sus))", &builder));
+	g_free (batch->results);
+	nm_g_slice_free (batch);
+}
+
 static gboolean
 quit_timeout_cb (gpointer user_data)
 {
@@ -245,7 +335,6 @@ static void
 complete_request (Request *request)
 {
 	GVariantBuilder results;
-	GVariant *ret;
 	guint i;
 
 	nm_assert (request);
@@ -264,8 +353,7 @@ complete_request (Request *request)
 		                       script->error ?: "");
 	}
 
-	ret = g_variant_new ("(a(sus))", &results);
-	g_dbus_method_invocation_return_value (request->context, ret);
+	request_return (request, g_variant_builder_end (&results));
 
 	_LOG_R_T (request, "completed (%u scripts)", request->scripts->len);
 
@@ -360,6 +448,8 @@ script_watch_cb (GPid pid, int status, gpointer user_data)
 	script->request->num_scripts_done++;
 	if (!script->wait)
 		script->request->num_scripts_nowait--;
+	else if (script->parallel)
+		script->request->num_scripts_parallel--;
 
 	if (WIFEXITED (status)) {
 		err = WEXITSTATUS (status);
@@ -402,6 +492,8 @@ script_timeout_cb (gpointer user_data)
 	script->request->num_scripts_done++;
 	if (!script->wait)
 		script->request->num_scripts_nowait--;
+	else if (script->parallel)
+		script->request->num_scripts_parallel--;
 
 	_LOG_S_W (script, "complete: timeout (kill script)");
 
@@ -429,8 +521,10 @@ check_permissions (struct stat *s, const char **out_error_msg)
 	g_return_val_if_fail (out_error_msg != NULL, FALSE);
 	g_return_val_if_fail (*out_error_msg == NULL, FALSE);
 
-	/* Only accept files owned by root */
-	if (s->st_uid != 0) {
+	/* Only accept files owned by root (or by the user running the
+	 * tests, with --test-dir). */
+	if (   s->st_uid != 0
+	    && !(gl.test_dir && s->st_uid == geteuid ())) {
 		*out_error_msg = "not owned by root.";
 		return FALSE;
 	}
@@ -500,7 +594,8 @@ script_dispatch (ScriptInfo *script)
 	argv[2] = request->action;
 	argv[3] = NULL;
 
-	_LOG_S_T (script, "run script%s", script->wait ? "" : " (no-wait)");
+	_LOG_S_T (script, "run script%s",
+	          !script->wait ? " (no-wait)" : (script->parallel ? " (parallel)" : ""));
 
 	if (!g_spawn_async ("/", argv, request->envp, G_SPAWN_DO_NOT_REAP_CHILD, NULL, NULL, &script->pid, &error)) {
 		_LOG_S_W (script, "complete: failed to execute script: %s", error->message);
@@ -514,30 +609,47 @@ script_dispatch (ScriptInfo *script)
 	script->timeout_id = g_timeout_add_seconds (SCRIPT_TIMEOUT, script_timeout_cb, script);
 	if (!script->wait)
 		request->num_scripts_nowait++;
+	else if (script->parallel)
+		request->num_scripts_parallel++;
 	return TRUE;
 }
 
 static gboolean
 dispatch_one_script (Request *request)
 {
-	if (request->num_scripts_nowait > 0)
+	if (   request->num_scripts_nowait > 0
+	    || request->num_scripts_parallel > 0)
 		return TRUE;
 
 	while (request->idx < request->scripts->len) {
 		ScriptInfo *script;
 
 		script = g_ptr_array_index (request->scripts, request->idx++);
-		if (script_dispatch (script))
-			return TRUE;
+		if (!script_dispatch (script))
+			continue;
+
+		if (script->parallel) {
+			/* also start the following "parallel" scripts. The next
+			 * ordered script runs after all of them completed. */
+			while (request->idx < request->scripts->len) {
+				ScriptInfo *next = g_ptr_array_index (request->scripts, request->idx);
+
+				if (!next->parallel)
+					break;
+				request->idx++;
+				script_dispatch (next);
+			}
+		}
+		return TRUE;
 	}
 	return FALSE;
 }
 
 static int
-_compare_basenames (gconstpointer a, gconstpointer b)
+_compare_entries (gconstpointer a, gconstpointer b)
 {
-	const char *basename_a = strrchr (a, '/');
-	const char *basename_b = strrchr (b, '/');
+	const char *basename_a = strrchr (((const ScriptEntry *) a)->path, '/');
+	const char *basename_b = strrchr (((const ScriptEntry *) b)->path, '/');
 	int ret;
 
 	nm_assert (basename_a);
@@ -552,18 +664,61 @@ _compare_basenames (gconstpointer a, gconstpointer b)
 }
 
 static void
-_find_scripts (Request *request, GHashTable *scripts, const char *base, const char *subdir)
+_script_entry_clear (gpointer data)
+{
+	ScriptEntry *entry = data;
+
+	g_free (entry->path);
+}
+
+static void
+_script_cache_free (ScriptCache *cache)
+{
+	g_array_unref (cache->entries);
+	nm_g_slice_free (cache);
+}
+
+static void
+_dir_state_get (DirState *state, const char *dirname)
+{
+	struct stat st;
+
+	if (stat (dirname, &st) != 0) {
+		*state = (DirState) { .exists = FALSE };
+		return;
+	}
+
+	*state = (DirState) {
+		.st_dev  = st.st_dev,
+		.st_ino  = st.st_ino,
+		.st_mtim = st.st_mtim,
+		.exists  = TRUE,
+	};
+}
+
+static gboolean
+_dir_state_equal (const DirState *a, const DirState *b)
+{
+	if (a->exists != b->exists)
+		return FALSE;
+	if (!a->exists)
+		return TRUE;
+	return    a->st_dev == b->st_dev
+	       && a->st_ino == b->st_ino
+	       && a->st_mtim.tv_sec == b->st_mtim.tv_sec
+	       && a->st_mtim.tv_nsec == b->st_mtim.tv_nsec;
+}
+
+static void
+_find_scripts (GHashTable *scripts, const char *dirname)
 {
 	const char *filename;
-	gs_free char *dirname = NULL;
 	GError *error = NULL;
 	GDir *dir;
 
-	dirname = g_build_filename (base, "dispatcher.d", subdir, NULL);
-
 	if (!(dir = g_dir_open (dirname, 0, &error))) {
 		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
-			_LOG_R_W (request, "find-scripts: Failed to open dispatcher directory '%s': %s",
+			_LOG_X_W ("find-scripts: Failed to open dispatcher directory '%s': %s",
 			          dirname, error->message);
 		}
 		g_error_free (error);
@@ -582,91 +737,179 @@ _find_scripts (Request *request, GHashTable *scripts, const char *base, const ch
 	g_dir_close (dir);
 }
 
-static GSList *
-find_scripts (Request *request)
+static void
+script_get_flags (const char *path,
+                  const char *link_target,
+                  bool *out_wait,
+                  bool *out_parallel)
+{
+	gs_free char *link = NULL;
+	gs_free char *dir = NULL;
+	nm_auto_free char *real = NULL;
+
+	*out_wait = TRUE;
+	*out_parallel = FALSE;
+
+	if (!link_target)
+		return;
+
+	if (!g_path_is_absolute (link_target)) {
+		dir = g_path_get_dirname (path);
+		link = g_build_path ("/", dir, link_target, NULL);
+		nm_clear_g_free (&dir);
+	} else
+		link = g_strdup (link_target);
+
+	dir = g_path_get_dirname (link);
+	real = realpath (dir, NULL);
+	if (NM_STR_HAS_SUFFIX (real, "/no-wait.d"))
+		*out_wait = FALSE;
+	else if (NM_STR_HAS_SUFFIX (real, "/parallel.d"))
+		*out_parallel = TRUE;
+}
+
+static gboolean
+script_check (const char *path)
+{
+	const char *err_msg = NULL;
+	struct stat st;
+	int err;
+
+	err = stat (path, &st);
+	if (err) {
+		_LOG_X_W ("find-scripts: Failed to stat '%s': %d", path, err);
+		return FALSE;
+	}
+
+	if (   !S_ISREG (st.st_mode)
+	    || st.st_size == 0) {
+		/* silently skip. */
+		return FALSE;
+	}
+
+	if (!check_permissions (&st, &err_msg)) {
+		_LOG_X_W ("find-scripts: Cannot execute '%s': %s", path, err_msg);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Returns the scripts for @action. The directory listing and the resolved
+ * links are cached, as long as the modification times of the dispatcher
+ * directories don't change. The files themselves can change without
+ * touching the directory, so callers must check each script with
+ * script_check() before running it. */
+static const GArray *
+find_scripts (const char *action)
 {
 	gs_unref_hashtable GHashTable *scripts = NULL;
 	GSList *script_list = NULL;
-	GHashTableIter iter;
+	GSList *iter;
+	GHashTableIter h_iter;
+	DirState dirs[G_N_ELEMENTS (gl.script_bases)];
+	ScriptCacheType cache_type;
+	ScriptCache *cache;
 	const char *subdir;
 	char *path;
 	char *filename;
+	gint64 now_sec;
+	gboolean unstable = FALSE;
+	guint i;
+
+	G_STATIC_ASSERT_EXPR (G_N_ELEMENTS (dirs) == G_N_ELEMENTS (cache->dirs));
 
-	if (NM_IN_STRSET (request->action, NMD_ACTION_PRE_UP,
-	                                   NMD_ACTION_VPN_PRE_UP))
+	if (NM_IN_STRSET (action, NMD_ACTION_PRE_UP,
+	                          NMD_ACTION_VPN_PRE_UP)) {
 		subdir = "pre-up.d";
-	else if (NM_IN_STRSET (request->action, NMD_ACTION_PRE_DOWN,
-	                                        NMD_ACTION_VPN_PRE_DOWN))
+		cache_type = SCRIPT_CACHE_TYPE_PRE_UP;
+	} else if (NM_IN_STRSET (action, NMD_ACTION_PRE_DOWN,
+	                                 NMD_ACTION_VPN_PRE_DOWN)) {
 		subdir = "pre-down.d";
-	else
+		cache_type = SCRIPT_CACHE_TYPE_PRE_DOWN;
+	} else {
 		subdir = NULL;
+		cache_type = SCRIPT_CACHE_TYPE_DEFAULT;
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (gl.script_bases); i++) {
+		gs_free char *dirname = NULL;
+
+		dirname = g_build_filename (gl.script_bases[i], "dispatcher.d", subdir, NULL);
+		_dir_state_get (&dirs[i], dirname);
+	}
+
+	cache = gl.script_caches[cache_type];
+	if (   cache
+	    && !cache->unstable) {
+		for (i = 0; i < G_N_ELEMENTS (dirs); i++) {
+			if (!_dir_state_equal (&dirs[i], &cache->dirs[i]))
+				break;
+		}
+		if (i == G_N_ELEMENTS (dirs)) {
+			_LOG_X_T ("find-scripts: use cached scripts");
+			return cache->entries;
+		}
+	}
 
 	scripts = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, g_free);
 
-	_find_scripts (request, scripts, NMLIBDIR, subdir);
-	_find_scripts (request, scripts, NMCONFDIR, subdir);
+	now_sec = g_get_real_time () / G_USEC_PER_SEC;
+	for (i = 0; i < G_N_ELEMENTS (gl.script_bases); i++) {
+		gs_free char *dirname = NULL;
 
-	g_hash_table_iter_init (&iter, scripts);
-	while (g_hash_table_iter_next (&iter, (gpointer *) &filename, (gpointer *) &path)) {
+		dirname = g_build_filename (gl.script_bases[i], "dispatcher.d", subdir, NULL);
+		_find_scripts (scripts, dirname);
+
+		/* filesystems with a coarse timestamp granularity might not
+		 * change the mtime for a modification that follows shortly. */
+		if (   dirs[i].exists
+		    && dirs[i].st_mtim.tv_sec >= now_sec - 1)
+			unstable = TRUE;
+	}
+
+	g_hash_table_iter_init (&h_iter, scripts);
+	while (g_hash_table_iter_next (&h_iter, (gpointer *) &filename, (gpointer *) &path)) {
 		gs_free char *link_target = NULL;
-		const char *err_msg = NULL;
-		struct stat st;
-		int err;
+		ScriptEntry *entry;
 
 		link_target = g_file_read_link (path, NULL);
 		if (nm_streq0 (link_target, "/dev/null"))
 			continue;
 
-		err = stat (path, &st);
-		if (err)
-			_LOG_R_W (request, "find-scripts: Failed to stat '%s': %d", path, err);
-		else if (   !S_ISREG (st.st_mode)
-		         || st.st_size == 0) {
-			/* silently skip. */
-		} else if (!check_permissions (&st, &err_msg))
-			_LOG_R_W (request, "find-scripts: Cannot execute '%s': %s", path, err_msg);
-		else {
-			/* success */
-			script_list = g_slist_prepend (script_list, g_strdup (path));
-			continue;
-		}
+		entry = g_slice_new (ScriptEntry);
+		entry->path = g_strdup (path);
+		script_get_flags (path, link_target, &entry->wait, &entry->parallel);
+		script_list = g_slist_prepend (script_list, entry);
 	}
 
-	return g_slist_sort (script_list, _compare_basenames);
-}
-
-static gboolean
-script_must_wait (const char *path)
-{
-	gs_free char *link = NULL;
-
-	link = g_file_read_link (path, NULL);
-	if (link) {
-		gs_free char *dir = NULL;
-		nm_auto_free char *real = NULL;
-
-		if (!g_path_is_absolute (link)) {
-			char *tmp;
+	script_list = g_slist_sort (script_list, _compare_entries);
 
-			dir = g_path_get_dirname (path);
-			tmp = g_build_path ("/", dir, link, NULL);
-			g_free (link);
-			g_free (dir);
-			link = tmp;
-		}
+	if (!cache) {
+		cache = g_slice_new0 (ScriptCache);
+		gl.script_caches[cache_type] = cache;
+	} else
+		g_array_unref (cache->entries);
 
-		dir = g_path_get_dirname (link);
-		real = realpath (dir, NULL);
-		if (NM_STR_HAS_SUFFIX (real, "/no-wait.d"))
-			return FALSE;
+	cache->entries = g_array_sized_new (FALSE, FALSE, sizeof (ScriptEntry), g_slist_length (script_list));
+	g_array_set_clear_func (cache->entries, _script_entry_clear);
+	for (iter = script_list; iter; iter = iter->next) {
+		g_array_append_vals (cache->entries, iter->data, 1);
+		nm_g_slice_free ((ScriptEntry *) iter->data);
 	}
+	g_slist_free (script_list);
 
-	return TRUE;
+	memcpy (cache->dirs, dirs, sizeof (dirs));
+	cache->unstable = unstable;
+
+	return cache->entries;
 }
 
 static void
-_method_call_action (GDBusMethodInvocation *invocation,
-                     GVariant *parameters)
+_action_request_start (GVariant *parameters,
+                       GDBusMethodInvocation *invocation,
+                       Batch *batch,
+                       guint batch_idx)
 {
 	const char *action;
 	gs_unref_variant GVariant *connection = NULL;
@@ -683,8 +926,7 @@ _method_call_action (GDBusMethodInvocation *invocation,
 	gs_unref_variant GVariant *vpn_ip4_config = NULL;
 	gs_unref_variant GVariant *vpn_ip6_config = NULL;
 	gboolean debug;
-	GSList *sorted_scripts = NULL;
-	GSList *iter;
+	const GArray *entries;
 	Request *request;
 	char **p;
 	guint i, num_nowait = 0;
@@ -727,6 +969,8 @@ _method_call_action (GDBusMethodInvocation *invocation,
 	request->request_id = ++gl.request_id_counter;
 	request->debug = debug || gl.debug;
 	request->context = invocation;
+	request->batch = batch;
+	request->batch_idx = batch_idx;
 	request->action = g_strdup (action);
 
 	request->envp = nm_dispatcher_utils_construct_envp (action,
@@ -748,17 +992,21 @@ _method_call_action (GDBusMethodInvocation *invocation,
 
 	request->scripts = g_ptr_array_new_full (5, script_info_free);
 
-	sorted_scripts = find_scripts (request);
-	for (iter = sorted_scripts; iter; iter = g_slist_next (iter)) {
+	entries = find_scripts (request->action);
+	for (i = 0; i < entries->len; i++) {
+		const ScriptEntry *entry = &g_array_index (entries, ScriptEntry, i);
 		ScriptInfo *s;
 
+		if (!script_check (entry->path))
+			continue;
+
 		s = g_slice_new0 (ScriptInfo);
 		s->request = request;
-		s->script = iter->data;
-		s->wait = script_must_wait (s->script);
+		s->script = g_strdup (entry->path);
+		s->wait = entry->wait;
+		s->parallel = entry->parallel;
 		g_ptr_array_add (request->scripts, s);
 	}
-	g_slist_free (sorted_scripts);
 
 	_LOG_R_D (request, "new request (%u scripts)", request->scripts->len);
 	if (   _LOG_R_T_enabled (request)
@@ -776,7 +1024,7 @@ _method_call_action (GDBusMethodInvocation *invocation,
 			_LOG_R_D (request, "completed: no scripts");
 
 		results = g_variant_new_array (G_VARIANT_TYPE ("(sus)"), NULL, 0);
-		g_dbus_method_invocation_return_value (invocation, g_variant_new ("(@a(sus))", results));
+		request_return (request, results);
 		request->num_scripts_done = request->scripts->len;
 		request_free (request);
 		return;
@@ -829,6 +1077,83 @@ _method_call_action (GDBusMethodInvocation *invocation,
 	}
 }
 
+static void
+_method_call_action (GDBusMethodInvocation *invocation,
+                     GVariant *parameters)
+{
+	_action_request_start (parameters, invocation, NULL, 0);
+}
+
+static void
+_method_call_action_batch (GDBusMethodInvocation *invocation,
+                           GVariant *parameters)
+{
+	gs_unref_variant GVariant *events = NULL;
+	Batch *batch;
+	guint i;
+
+	events = g_variant_get_child_value (parameters, 0);
+
+	batch = g_slice_new (Batch);
+	*batch = (Batch) {
+		.context    = invocation,
+		.n_requests = g_variant_n_children (events),
+	};
+
+	if (batch->n_requests == 0) {
+		g_dbus_method_invocation_return_value (invocation,
+		                                       g_variant_new_parsed ("(@aa(sus) [],)"));
+		nm_g_slice_free (batch);
+		return;
+	}
+
+	batch->results = g_new0 (GVariant *, batch->n_requests);
+	batch->n_pending = batch->n_requests;
+
+	/* the requests are handled in order, exactly as if they arrived as
+	 * separate "Action" calls. The batch returns after the last request
+	 * completed. */
+	for (i = 0; i < batch->n_requests; i++) {
+		gs_unref_variant GVariant *event = NULL;
+
+		event = g_variant_get_child_value (events, i);
+		_action_request_start (event, NULL, batch, i);
+	}
+}
+
+static void
+_method_call_get_actions (GDBusMethodInvocation *invocation)
+{
+	static const char *const actions[] = {
+		NMD_ACTION_HOSTNAME,
+		NMD_ACTION_PRE_UP,
+		NMD_ACTION_UP,
+		NMD_ACTION_PRE_DOWN,
+		NMD_ACTION_DOWN,
+		NMD_ACTION_VPN_PRE_UP,
+		NMD_ACTION_VPN_UP,
+		NMD_ACTION_VPN_PRE_DOWN,
+		NMD_ACTION_VPN_DOWN,
+		NMD_ACTION_DHCP4_CHANGE,
+		NMD_ACTION_DHCP6_CHANGE,
+		NMD_ACTION_CONNECTIVITY_CHANGE,
+	};
+	GVariantBuilder builder;
+	guint i;
+
+	/* NetworkManager caches the result until the directories change. So this
+	 * must not depend on the permissions of the scripts, which can change
+	 * without touching the directories. */
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("as"));
+	for (i = 0; i < G_N_ELEMENTS (actions); i++) {
+		if (find_scripts (actions[i])->len > 0)
+			g_variant_builder_add (&builder, "s", actions[i]);
+	}
+
+	g_dbus_method_invocation_return_value (invocation,
+	                                       g_variant_new ("(as)", &builder));
+}
+
 static void
 on_name_acquired (GDBusConnection *connection,
                   const char      *name,
@@ -873,6 +1198,14 @@ _method_call (GDBusConnection *connection,
 			_method_call_action (invocation, parameters);
 			return;
 		}
+		if (nm_streq (method_name, "ActionBatch")) {
+			_method_call_action_batch (invocation, parameters);
+			return;
+		}
+		if (nm_streq (method_name, "GetActions")) {
+			_method_call_get_actions (invocation);
+			return;
+		}
 	}
 	g_dbus_method_invocation_return_error (invocation,
 	                                       G_DBUS_ERROR,
@@ -907,6 +1240,21 @@ static GDBusInterfaceInfo *const interface_info = NM_DEFINE_GDBUS_INTERFACE_INFO
 				NM_DEFINE_GDBUS_ARG_INFO ("results", "a(sus)"),
 			),
 		),
+		NM_DEFINE_GDBUS_METHOD_INFO (
+			"ActionBatch",
+			.in_args = NM_DEFINE_GDBUS_ARG_INFOS (
+				NM_DEFINE_GDBUS_ARG_INFO ("events", "a(" NMD_ACTION_ARGS_SIGNATURE ")"),
+			),
+			.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+				NM_DEFINE_GDBUS_ARG_INFO ("results", "aa(sus)"),
+			),
+		),
+		NM_DEFINE_GDBUS_METHOD_INFO (
+			"GetActions",
+			.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+				NM_DEFINE_GDBUS_ARG_INFO ("actions", "as"),
+			),
+		),
 	),
 );
 
@@ -985,6 +1333,7 @@ parse_command_line (int *p_argc,
 	GOptionEntry entries[] = {
 		{ "debug", 0, 0, G_OPTION_ARG_NONE, &gl.debug, "Output to console rather than syslog", NULL },
 		{ "persist", 0, 0, G_OPTION_ARG_NONE, &gl.persist, "Don't quit after a short timeout", NULL },
+		{ "test-dir", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_FILENAME, &gl.test_dir, "Run scripts from DIR/lib and DIR/etc and use the session bus (for testing)", "DIR" },
 		{ NULL }
 	};
 	gboolean success;
@@ -1008,6 +1357,7 @@ main (int argc, char **argv)
 	guint signal_id_int = 0;
 	guint dbus_regist_id = 0;
 	guint dbus_own_name_id = 0;
+	guint i;
 
 	if (!parse_command_line (&argc, &argv, &error)) {
 		_LOG_X_W ("Error parsing command line arguments: %s", error->message);
@@ -1029,9 +1379,17 @@ main (int argc, char **argv)
 	} else
 		logging_setup ();
 
+	if (gl.test_dir) {
+		gl.script_bases[0] = g_build_filename (gl.test_dir, "lib", NULL);
+		gl.script_bases[1] = g_build_filename (gl.test_dir, "etc", NULL);
+	} else {
+		gl.script_bases[0] = g_strdup (NMLIBDIR);
+		gl.script_bases[1] = g_strdup (NMCONFDIR);
+	}
+
 	gl.loop = g_main_loop_new (NULL, FALSE);
 
-	gl.dbus_connection = g_bus_get_sync (G_BUS_TYPE_SYSTEM, NULL, &error);
+	gl.dbus_connection = g_bus_get_sync (gl.test_dir ? G_BUS_TYPE_SESSION : G_BUS_TYPE_SYSTEM, NULL, &error);
 	if (!gl.dbus_connection) {
 		_LOG_X_W ("Could not get the system bus (%s).  Make sure the message bus daemon is running!",
 		          error->message);
@@ -1090,6 +1448,12 @@ done:
 
 	nm_clear_pointer (&gl.requests_waiting, g_queue_free);
 
+	for (i = 0; i < G_N_ELEMENTS (gl.script_caches); i++)
+		nm_clear_pointer (&gl.script_caches[i], _script_cache_free);
+	for (i = 0; i < G_N_ELEMENTS (gl.script_bases); i++)
+		nm_clear_g_free (&gl.script_bases[i]);
+	nm_clear_g_free (&gl.test_dir);
+
 	nm_clear_g_source (&signal_id_term);
 	nm_clear_g_source (&signal_id_int);
 	nm_clear_g_source (&gl.quit_id);
@@ -0,0 +1,555 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <glib-unix.h>
+
+#include "nm-libnm-core-aux/nm-dispatcher-api.h"
+
+#include "nm-utils/nm-test-utils.h"
+
+#define DISPATCHER_PATH NM_BUILD_BUILDDIR"/dispatcher/nm-dispatcher"
+
+/*****************************************************************************/
+
+/* Runs nm-dispatcher with --test-dir on a private session bus. The
+ * scripts are taken from the "lib" and "etc" directories below
+ * TestFixture.dir, and they leave marker files in TestFixture.state_dir. */
+typedef struct {
+	GTestDBus *test_bus;
+	GDBusConnection *bus;
+
+	char *dir;
+	char *state_dir;
+
+	/* the files and directories below @dir, in the order they were created. */
+	GPtrArray *paths;
+
+	GPid pid;
+	int log_fd;
+	GSource *log_source;
+
+	/* the (debug) output of nm-dispatcher. */
+	GString *log;
+} TestFixture;
+
+static char *
+_fixture_path (TestFixture *f, const char *path)
+{
+	return g_build_filename (f->dir, path, NULL);
+}
+
+static void
+_fixture_mkdir (TestFixture *f, const char *path)
+{
+	char *full = _fixture_path (f, path);
+
+	g_assert_cmpint (mkdir (full, 0755), ==, 0);
+	g_ptr_array_add (f->paths, full);
+}
+
+static void
+_fixture_add_script (TestFixture *f, const char *path, const char *body)
+{
+	char *full = _fixture_path (f, path);
+	gs_free char *contents = NULL;
+
+	contents = g_strdup_printf ("#!/bin/sh\n"
+	                            "\n"
+	                            "STATE='%s'\n"
+	                            "\n"
+	                            "%s",
+	                            f->state_dir,
+	                            body);
+	nmtst_file_set_contents (full, contents);
+	g_assert_cmpint (chmod (full, 0755), ==, 0);
+	g_ptr_array_add (f->paths, full);
+}
+
+static void
+_fixture_add_link (TestFixture *f, const char *path, const char *target)
+{
+	char *full = _fixture_path (f, path);
+
+	g_assert_cmpint (symlink (target, full), ==, 0);
+	g_ptr_array_add (f->paths, full);
+}
+
+/* nm-dispatcher doesn't trust its cache for directories that were modified
+ * within the last second. Pretend that they were modified long ago. */
+static void
+_fixture_age_dir (TestFixture *f, const char *path)
+{
+	gs_free char *full = _fixture_path (f, path);
+	struct timeval tv[2] = {
+		{ .tv_sec = (g_get_real_time () / G_USEC_PER_SEC) - 60 },
+		{ .tv_sec = (g_get_real_time () / G_USEC_PER_SEC) - 60 },
+	};
+
+	g_assert_cmpint (utimes (full, tv), ==, 0);
+}
+
+static void
+_fixture_clear_state (TestFixture *f)
+{
+	const char *name;
+	GDir *dir;
+
+	dir = g_dir_open (f->state_dir, 0, NULL);
+	g_assert (dir);
+	while ((name = g_dir_read_name (dir))) {
+		gs_free char *full = g_build_filename (f->state_dir, name, NULL);
+
+		g_assert_cmpint (unlink (full), ==, 0);
+	}
+	g_dir_close (dir);
+}
+
+static gboolean
+_fixture_has_state (TestFixture *f, const char *name)
+{
+	gs_free char *full = g_build_filename (f->state_dir, name, NULL);
+
+	return g_file_test (full, G_FILE_TEST_EXISTS);
+}
+
+/* reads the available output of nm-dispatcher. Returns FALSE on EOF. */
+static gboolean
+_fixture_read_log (TestFixture *f)
+{
+	char buf[4096];
+	gssize n;
+
+	for (;;) {
+		n = read (f->log_fd, buf, sizeof (buf));
+		if (n > 0) {
+			g_string_append_len (f->log, buf, n);
+			continue;
+		}
+		if (n < 0 && errno == EINTR)
+			continue;
+		return n < 0 && errno == EAGAIN;
+	}
+}
+
+static gboolean
+_fixture_read_log_cb (int fd, GIOCondition condition, gpointer user_data)
+{
+	return _fixture_read_log (user_data) ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+/* nm-dispatcher logs before it replies, so after a reply, the output
+ * is complete. */
+static guint
+_fixture_log_count (TestFixture *f, const char *needle)
+{
+	const char *s;
+	guint n = 0;
+
+	_fixture_read_log (f);
+	for (s = f->log->str; (s = strstr (s, needle)); s++)
+		n++;
+	return n;
+}
+
+static void
+_name_appeared_cb (GDBusConnection *connection,
+                   const char *name,
+                   const char *name_owner,
+                   gpointer user_data)
+{
+	*((gboolean *) user_data) = TRUE;
+}
+
+static TestFixture *
+_fixture_new (void)
+{
+	gs_free_error GError *error = NULL;
+	gs_free char *dbus_daemon = NULL;
+	TestFixture *f;
+
+	if (!g_file_test (DISPATCHER_PATH, G_FILE_TEST_IS_EXECUTABLE)) {
+		g_test_skip ("nm-dispatcher was not built");
+		return NULL;
+	}
+
+	dbus_daemon = g_find_program_in_path ("dbus-daemon");
+	if (!dbus_daemon) {
+		g_test_skip ("dbus-daemon is not available");
+		return NULL;
+	}
+
+	f = g_slice_new0 (TestFixture);
+	f->paths = g_ptr_array_new_with_free_func (g_free);
+	f->log = g_string_new (NULL);
+	f->log_fd = -1;
+
+	f->dir = g_dir_make_tmp ("test-dispatcher-XXXXXX", &error);
+	nmtst_assert_success (f->dir, error);
+
+	_fixture_mkdir (f, "state");
+	f->state_dir = _fixture_path (f, "state");
+	_fixture_mkdir (f, "lib");
+	_fixture_mkdir (f, "lib/dispatcher.d");
+	_fixture_mkdir (f, "etc");
+	_fixture_mkdir (f, "etc/dispatcher.d");
+	_fixture_mkdir (f, "etc/dispatcher.d/parallel.d");
+
+	f->test_bus = g_test_dbus_new (G_TEST_DBUS_NONE);
+	g_test_dbus_up (f->test_bus);
+
+	f->bus = g_bus_get_sync (G_BUS_TYPE_SESSION, NULL, &error);
+	nmtst_assert_success (f->bus, error);
+
+	return f;
+}
+
+static void
+_fixture_start (TestFixture *f)
+{
+	gs_free_error GError *error = NULL;
+	gboolean appeared = FALSE;
+	gboolean success;
+	const char *argv[] = {
+		DISPATCHER_PATH,
+		"--debug",
+		"--persist",
+		"--test-dir",
+		f->dir,
+		NULL,
+	};
+	gs_strfreev char **envp = NULL;
+	guint watch_id;
+
+	/* the test checks the debug messages, whatever the caller set. */
+	envp = g_environ_setenv (g_get_environ (), "G_MESSAGES_DEBUG", "all", TRUE);
+
+	success = g_spawn_async_with_pipes (NULL,
+	                                    (char **) argv,
+	                                    envp,
+	                                    G_SPAWN_DO_NOT_REAP_CHILD,
+	                                    NULL,
+	                                    NULL,
+	                                    &f->pid,
+	                                    NULL,
+	                                    &f->log_fd,
+	                                    NULL,
+	                                    &error);
+	nmtst_assert_success (success, error);
+
+	g_assert (g_unix_set_fd_nonblocking (f->log_fd, TRUE, NULL));
+	f->log_source = nm_g_unix_fd_source_new (f->log_fd,
+	                                         G_IO_IN | G_IO_HUP,
+	                                         G_PRIORITY_DEFAULT,
+	                                         _fixture_read_log_cb,
+	                                         f,
+	                                         NULL);
+	g_source_attach (f->log_source, NULL);
+
+	watch_id = g_bus_watch_name_on_connection (f->bus,
+	                                           NM_DISPATCHER_DBUS_SERVICE,
+	                                           G_BUS_NAME_WATCHER_FLAGS_NONE,
+	                                           _name_appeared_cb,
+	                                           NULL,
+	                                           &appeared,
+	                                           NULL);
+	nmtst_main_context_iterate_until_assert (NULL, 5000, appeared);
+	g_bus_unwatch_name (watch_id);
+}
+
+static void
+_fixture_free (TestFixture *f)
+{
+	guint i;
+
+	if (f->pid) {
+		int status;
+
+		g_assert_cmpint (kill (f->pid, SIGTERM), ==, 0);
+		g_assert_cmpint (waitpid (f->pid, &status, 0), ==, f->pid);
+		g_spawn_close_pid (f->pid);
+	}
+	nm_clear_g_source_inst (&f->log_source);
+	if (f->log_fd >= 0)
+		nm_close (f->log_fd);
+
+	g_clear_object (&f->bus);
+	g_test_dbus_down (f->test_bus);
+	g_clear_object (&f->test_bus);
+
+	_fixture_clear_state (f);
+	for (i = f->paths->len; i > 0; i--)
+		g_assert_cmpint (remove (f->paths->pdata[i - 1]), ==, 0);
+	g_assert_cmpint (rmdir (f->dir), ==, 0);
+
+	g_ptr_array_unref (f->paths);
+	g_string_free (f->log, TRUE);
+	g_free (f->state_dir);
+	g_free (f->dir);
+	nm_g_slice_free (f);
+}
+
+NM_AUTO_DEFINE_FCN0 (TestFixture *, _nm_auto_free_fixture, _fixture_free);
+#define nm_auto_free_fixture nm_auto (_nm_auto_free_fixture)
+
+/*****************************************************************************/
+
+typedef struct {
+	GVariant *result;
+	GError *error;
+	bool done:1;
+} CallData;
+
+static void
+_call_cb (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+	CallData *data = user_data;
+
+	data->result = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source), result, &data->error);
+	data->done = TRUE;
+}
+
+/* the main context must keep running to collect the output of
+ * nm-dispatcher, so don't block on the reply. */
+static GVariant *
+_call (TestFixture *f,
+       const char *method_name,
+       GVariant *parameters,
+       const char *reply_type)
+{
+	CallData data = { };
+
+	g_dbus_connection_call (f->bus,
+	                        NM_DISPATCHER_DBUS_SERVICE,
+	                        NM_DISPATCHER_DBUS_PATH,
+	                        NM_DISPATCHER_DBUS_INTERFACE,
+	                        method_name,
+	                        parameters,
+	                        G_VARIANT_TYPE (reply_type),
+	                        G_DBUS_CALL_FLAGS_NONE,
+	                        30000,
+	                        NULL,
+	                        _call_cb,
+	                        &data);
+	nmtst_main_context_iterate_until_assert (NULL, 30000, data.done);
+	nmtst_assert_success (data.result, data.error);
+	return data.result;
+}
+
+/* the arguments of an "Action" call that needs no device. */
+static GVariant *
+_action_args (const char *action)
+{
+	return g_variant_new_parsed ("(%s,"
+	                             " @a{sa{sv}} {},"
+	                             " @a{sv} {}, @a{sv} {}, @a{sv} {}, @a{sv} {},"
+	                             " @a{sv} {}, @a{sv} {}, @a{sv} {},"
+	                             " '', '',"
+	                             " @a{sv} {}, @a{sv} {}, @a{sv} {},"
+	                             " false)",
+	                             action);
+}
+
+/* asserts that @results ("a(sus)") are the successful runs of @scripts,
+ * in this order. */
+static void
+_assert_results (TestFixture *f, GVariant *results, const char *const *scripts)
+{
+	gsize n = NM_PTRARRAY_LEN (scripts);
+	gsize i;
+
+	g_assert (g_variant_is_of_type (results, G_VARIANT_TYPE ("a(sus)")));
+	g_assert_cmpint (g_variant_n_children (results), ==, n);
+
+	for (i = 0; i < n; i++) {
+		gs_free char *expected = _fixture_path (f, scripts[i]);
+		const char *path;
+		const char *error;
+		guint32 result;
+
+		g_variant_get_child (results, i, "(&su&s)", &path, &result, &error);
+		g_assert_cmpstr (path, ==, expected);
+		g_assert_cmpstr (error, ==, "");
+		g_assert_cmpint (result, ==, DISPATCH_RESULT_SUCCESS);
+	}
+}
+
+static void
+_assert_action (TestFixture *f, const char *action, const char *const *scripts)
+{
+	gs_unref_variant GVariant *ret = NULL;
+	gs_unref_variant GVariant *results = NULL;
+
+	_fixture_clear_state (f);
+	ret = _call (f, "Action", _action_args (action), "(a(sus))");
+	results = g_variant_get_child_value (ret, 0);
+	_assert_results (f, results, scripts);
+}
+
+/*****************************************************************************/
+
+#define PARALLEL_SCRIPT(name, other) \
+	"[ -e \"$STATE/first\" ] || exit 1\n" \
+	"touch \"$STATE/" name ".started\"\n" \
+	"i=0\n" \
+	"while [ ! -e \"$STATE/" other ".started\" ]; do\n" \
+	"    i=$((i + 1))\n" \
+	"    [ $i -lt 100 ] || exit 1\n" \
+	"    sleep 0.05\n" \
+	"done\n" \
+	"touch \"$STATE/" name ".done\"\n"
+
+static void
+test_scripts (void)
+{
+	nm_auto_free_fixture TestFixture *f = NULL;
+	const char *const scripts[] = {
+		"lib/dispatcher.d/10-first",
+		"etc/dispatcher.d/20-a",
+		"etc/dispatcher.d/21-b",
+		"etc/dispatcher.d/30-last",
+		NULL,
+	};
+	const char *const scripts_new[] = {
+		"lib/dispatcher.d/10-first",
+		"etc/dispatcher.d/20-a",
+		"etc/dispatcher.d/21-b",
+		"etc/dispatcher.d/30-last",
+		"etc/dispatcher.d/40-new",
+		NULL,
+	};
+
+	f = _fixture_new ();
+	if (!f)
+		return;
+
+	/* the parallel.d scripts only complete if they run at the same time,
+	 * and after the ordered script before them. The next ordered script
+	 * only runs after both completed. */
+	_fixture_add_script (f, "lib/dispatcher.d/10-first",
+	                     "touch \"$STATE/first\"\n");
+	_fixture_add_script (f, "etc/dispatcher.d/parallel.d/20-a",
+	                     PARALLEL_SCRIPT ("a", "b"));
+	_fixture_add_script (f, "etc/dispatcher.d/parallel.d/21-b",
+	                     PARALLEL_SCRIPT ("b", "a"));
+	_fixture_add_link (f, "etc/dispatcher.d/20-a", "parallel.d/20-a");
+	_fixture_add_link (f, "etc/dispatcher.d/21-b", "parallel.d/21-b");
+	_fixture_add_script (f, "etc/dispatcher.d/30-last",
+	                     "[ -e \"$STATE/a.done\" ] && [ -e \"$STATE/b.done\" ] || exit 1\n"
+	                     "touch \"$STATE/last\"\n");
+	_fixture_age_dir (f, "lib/dispatcher.d");
+	_fixture_age_dir (f, "etc/dispatcher.d");
+
+	_fixture_start (f);
+
+	_assert_action (f, NMD_ACTION_HOSTNAME, scripts);
+	g_assert (_fixture_has_state (f, "last"));
+	g_assert_cmpint (_fixture_log_count (f, "find-scripts: use cached scripts"), ==, 0);
+
+	/* the unchanged directories are not read again. */
+	_assert_action (f, NMD_ACTION_HOSTNAME, scripts);
+	g_assert (_fixture_has_state (f, "last"));
+	g_assert_cmpint (_fixture_log_count (f, "find-scripts: use cached scripts"), ==, 1);
+
+	/* a new script changes the directory and invalidates the cache. */
+	_fixture_add_script (f, "etc/dispatcher.d/40-new",
+	                     "[ -e \"$STATE/last\" ] || exit 1\n");
+	_assert_action (f, NMD_ACTION_HOSTNAME, scripts_new);
+	g_assert_cmpint (_fixture_log_count (f, "find-scripts: use cached scripts"), ==, 1);
+}
+
+static void
+test_action_batch (void)
+{
+	nm_auto_free_fixture TestFixture *f = NULL;
+	gs_unref_variant GVariant *ret = NULL;
+	gs_unref_variant GVariant *results = NULL;
+	gs_free char *actions_file = NULL;
+	gs_free char *actions = NULL;
+	GVariantBuilder builder;
+	const char *const events[] = {
+		NMD_ACTION_HOSTNAME,
+		NMD_ACTION_UP,
+		NMD_ACTION_CONNECTIVITY_CHANGE,
+		NMD_ACTION_HOSTNAME,
+	};
+	const char *const scripts[] = {
+		"etc/dispatcher.d/10-record",
+		NULL,
+	};
+	const char *const no_scripts[] = {
+		NULL,
+	};
+	guint i;
+
+	f = _fixture_new ();
+	if (!f)
+		return;
+
+	_fixture_add_script (f, "etc/dispatcher.d/10-record",
+	                     "echo \"$2\" >> \"$STATE/actions\"\n");
+
+	_fixture_start (f);
+
+	/* an empty batch returns right away. */
+	ret = _call (f,
+	             "ActionBatch",
+	             g_variant_new_parsed ("(@a(" NMD_ACTION_ARGS_SIGNATURE ") [],)"),
+	             "(aa(sus))");
+	results = g_variant_get_child_value (ret, 0);
+	g_assert_cmpint (g_variant_n_children (results), ==, 0);
+	g_clear_pointer (&results, g_variant_unref);
+	g_clear_pointer (&ret, g_variant_unref);
+
+	/* each event gets its own results, in the order of the events. The
+	 * "up" event lacks the device and is rejected without running any
+	 * script, but still has its (empty) slot. */
+	_fixture_clear_state (f);
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(" NMD_ACTION_ARGS_SIGNATURE ")"));
+	for (i = 0; i < G_N_ELEMENTS (events); i++)
+		g_variant_builder_add_value (&builder, _action_args (events[i]));
+	ret = _call (f,
+	             "ActionBatch",
+	             g_variant_new ("(a(" NMD_ACTION_ARGS_SIGNATURE "))", &builder),
+	             "(aa(sus))");
+	results = g_variant_get_child_value (ret, 0);
+	g_assert_cmpint (g_variant_n_children (results), ==, G_N_ELEMENTS (events));
+	for (i = 0; i < G_N_ELEMENTS (events); i++) {
+		gs_unref_variant GVariant *event_results = NULL;
+
+		event_results = g_variant_get_child_value (results, i);
+		_assert_results (f,
+		                 event_results,
+		                 nm_streq (events[i], NMD_ACTION_UP) ? no_scripts : scripts);
+	}
+
+	/* the scripts ran in the order of the events. */
+	actions_file = g_build_filename (f->state_dir, "actions", NULL);
+	g_assert (g_file_get_contents (actions_file, &actions, NULL, NULL));
+	g_assert_cmpstr (actions, ==, NMD_ACTION_HOSTNAME "\n"
+	                              NMD_ACTION_CONNECTIVITY_CHANGE "\n"
+	                              NMD_ACTION_HOSTNAME "\n");
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	nmtst_init (&argc, &argv, TRUE);
+
+	g_test_add_func ("/dispatcher/scripts", test_scripts);
+	g_test_add_func ("/dispatcher/action-batch", test_action_batch);
+
+	return g_test_run ();
+}
@@ -52,6 +52,15 @@ typedef struct {
 
 	/* D-Bus path of the connection, if any */
 	char *path;
+
+	/* incremented whenever a setting is added or removed. */
+	guint64 settings_generation;
+
+	/* the state of the settings at the time of the last successful
+	 * _nm_connection_verify(). See _verify_cache_lookup(). */
+	guint64 verify_cache_settings_generation;
+	guint64 verify_cache_setting_generations;
+	bool verify_cache_valid:1;
 } NMConnectionPrivate;
 
 G_DEFINE_INTERFACE (NMConnection, nm_connection, G_TYPE_OBJECT)
@@ -88,6 +97,7 @@ setting_changed_cb (NMSetting *setting,
 static void
 _setting_release (NMConnection *connection, NMSetting *setting)
 {
+	NM_CONNECTION_GET_PRIVATE (connection)->settings_generation++;
 	g_signal_handlers_disconnect_by_func (setting, setting_changed_cb, connection);
 }
 
@@ -115,6 +125,7 @@ _nm_connection_add_setting (NMConnection *connection, NMSetting *setting)
 		_setting_release (connection, s_old);
 
 	g_hash_table_insert (priv->settings, _gtype_to_hash_key (setting_type), setting);
+	priv->settings_generation++;
 
 	g_signal_connect (setting, "notify", (GCallback) setting_changed_cb, connection);
 }
@@ -151,7 +162,7 @@ _nm_connection_remove_setting (NMConnection *connection, GType setting_type)
 	priv = NM_CONNECTION_GET_PRIVATE (connection);
 	setting = g_hash_table_lookup (priv->settings, _gtype_to_hash_key (setting_type));
 	if (setting) {
-		g_signal_handlers_disconnect_by_func (setting, setting_changed_cb, connection);
+		_setting_release (connection, setting);
 		g_hash_table_remove (priv->settings, _gtype_to_hash_key (setting_type));
 		g_signal_emit (connection, signals[CHANGED], 0);
 		return TRUE;
@@ -1386,6 +1397,11 @@ _normalize_invalid_slave_port_settings (NMConnection *self)
  * MAC address.  The returned #GError contains information about which
  * setting and which property failed validation, and how it failed validation.
  *
+ * A successful result is remembered until a setting is added or removed, or
+ * a setting emits a property change notification. Modifying objects owned by
+ * a setting in place (for example, an #NMIPRoute returned by
+ * nm_setting_ip_config_get_route()) is not detected.
+ *
  * Returns: %TRUE if the connection is valid, %FALSE if it is not
  **/
 gboolean
@@ -1402,8 +1418,41 @@ nm_connection_verify (NMConnection *connection, GError **error)
 	return result == NM_SETTING_VERIFY_SUCCESS || result == NM_SETTING_VERIFY_NORMALIZABLE;
 }
 
-NMSettingVerifyResult
-_nm_connection_verify (NMConnection *connection, GError **error)
+static guint64
+_verify_cache_get_setting_generations (NMConnectionPrivate *priv)
+{
+	GHashTableIter iter;
+	NMSetting *setting;
+	guint64 generations = 0;
+
+	/* the generation of each setting only ever increases. As long as the
+	 * set of settings is unchanged (which we track via settings_generation),
+	 * the sum only stays the same if none of the settings changed. */
+	g_hash_table_iter_init (&iter, priv->settings);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &setting))
+		generations += _nm_setting_get_generation (setting);
+	return generations;
+}
+
+static gboolean
+_verify_cache_lookup (NMConnectionPrivate *priv, guint64 *out_setting_generations)
+{
+	guint64 setting_generations;
+
+	/* The verify() implementation of a setting commonly looks at other settings
+	 * of the connection (for example, the connection.type or whether this is
+	 * a slave). The result is thus only valid for the connection as a whole,
+	 * and we only remember whether the last verification succeeded for the
+	 * exact same settings. */
+	setting_generations = _verify_cache_get_setting_generations (priv);
+	*out_setting_generations = setting_generations;
+	return    priv->verify_cache_valid
+	       && priv->verify_cache_settings_generation == priv->settings_generation
+	       && priv->verify_cache_setting_generations == setting_generations;
+}
+
+static NMSettingVerifyResult
+_connection_verify (NMConnection *connection, GError **error)
 {
 	NMSettingIPConfig *s_ip4, *s_ip6;
 	NMSettingProxy *s_proxy;
@@ -1412,9 +1461,6 @@ _nm_connection_verify (NMConnection *connection, GError **error)
 	NMSettingVerifyResult normalizable_error_type = NM_SETTING_VERIFY_SUCCESS;
 	guint i;
 
-	g_return_val_if_fail (NM_IS_CONNECTION (connection), NM_SETTING_VERIFY_ERROR);
-	g_return_val_if_fail (!error || !*error, NM_SETTING_VERIFY_ERROR);
-
 	settings = nm_connection_get_settings (connection, NULL);
 	if (   !settings
 	    || !NM_IS_SETTING_CONNECTION (settings[0])) {
@@ -1553,6 +1599,35 @@ _nm_connection_verify (NMConnection *connection, GError **error)
 	return NM_SETTING_VERIFY_SUCCESS;
 }
 
+NMSettingVerifyResult
+_nm_connection_verify (NMConnection *connection, GError **error)
+{
+	NMConnectionPrivate *priv;
+	NMSettingVerifyResult result;
+	guint64 setting_generations;
+
+	g_return_val_if_fail (NM_IS_CONNECTION (connection), NM_SETTING_VERIFY_ERROR);
+	g_return_val_if_fail (!error || !*error, NM_SETTING_VERIFY_ERROR);
+
+	priv = NM_CONNECTION_GET_PRIVATE (connection);
+
+	if (_verify_cache_lookup (priv, &setting_generations))
+		return NM_SETTING_VERIFY_SUCCESS;
+
+	result = _connection_verify (connection, error);
+
+	/* Only a success is cached. Failures need to produce the error
+	 * anew and are anyway followed by modifications (or are fatal). */
+	if (result == NM_SETTING_VERIFY_SUCCESS) {
+		priv->verify_cache_settings_generation = priv->settings_generation;
+		priv->verify_cache_setting_generations = setting_generations;
+		priv->verify_cache_valid = TRUE;
+	} else
+		priv->verify_cache_valid = FALSE;
+
+	return result;
+}
+
 /**
  * nm_connection_verify_secrets:
  * @connection: the #NMConnection to verify in
@@ -724,6 +724,8 @@ typedef gboolean  (*NMSettInfoPropMissingFromDBusFcn)   (NMSetting     *setting,
 typedef GVariant *(*NMSettInfoPropGPropToDBusFcn)       (const GValue *from);
 typedef void      (*NMSettInfoPropGPropFromDBusFcn)     (GVariant *from,
                                                          GValue *to);
+typedef gboolean  (*NMSettInfoPropGPropEqualFcn)        (const GValue *a,
+                                                         const GValue *b);
 
 const NMSettInfoSetting *nmtst_sett_info_settings (void);
 
@@ -738,6 +740,12 @@ typedef struct {
 	 * on the GValue value of the GObject property. */
 	NMSettInfoPropGPropToDBusFcn       gprop_to_dbus_fcn;
 	NMSettInfoPropGPropFromDBusFcn     gprop_from_dbus_fcn;
+
+	/* Optional. Compares two (non-default) GValues of the GObject property
+	 * natively, without converting them to GVariant first. It must agree with
+	 * comparing the D-Bus representation of the values. If unset,
+	 * compare_property() falls back to comparing the variants. */
+	NMSettInfoPropGPropEqualFcn        gprop_equal_fcn;
 } NMSettInfoPropertType;
 
 struct _NMSettInfoProperty {
@@ -3177,13 +3177,15 @@ _parse_info_find (NMSetting *setting,
 static void
 read_one_setting_value (KeyfileReaderInfo *info,
                         NMSetting *setting,
-                        const NMSettInfoProperty *property_info)
+                        const NMMetaSettingInfo *setting_info,
+                        const NMSettInfoProperty *property_info,
+                        const ParseInfoProperty *pip,
+                        gboolean has_key)
 {
 	GKeyFile *keyfile = info->keyfile;
 	gs_free_error GError *err = NULL;
-	const NMMetaSettingInfo *setting_info;
-	const ParseInfoProperty *pip;
 	gs_free char *tmp_str = NULL;
+	const char *group;
 	const char *key;
 	GType type;
 	guint64 u64;
@@ -3192,12 +3194,24 @@ read_one_setting_value (KeyfileReaderInfo *info,
 	nm_assert (!info->error);
 	nm_assert (   !property_info->param_spec
 	           || nm_streq (property_info->param_spec->name, property_info->name));
+	nm_assert (setting_info);
 
 	key = property_info->name;
 
-	_parse_info_find (setting, key, &setting_info, NULL, &pip);
+#if NM_MORE_ASSERTS > 5
+	{
+		const ParseInfoProperty *pip2;
 
-	nm_assert (setting_info);
+		_parse_info_find (setting, key, NULL, NULL, &pip2);
+		nm_assert (pip == pip2);
+		nm_assert (has_key == g_key_file_has_key (keyfile, info->group, key, NULL));
+	}
+#endif
+
+	/* The group name as it is in the keyfile. This might be an alias of
+	 * setting_info->setting_name. By using it directly, the getters don't
+	 * need to fail and retry with the alias for each key. */
+	group = info->group;
 
 	if (!pip) {
 		if (nm_streq (key, NM_SETTING_NAME))
@@ -3224,17 +3238,8 @@ read_one_setting_value (KeyfileReaderInfo *info,
 	 * encoded by the setting property, this won't be true.
 	 */
 	if (   (!pip || !pip->parser_no_check_key)
-	    && !nm_keyfile_plugin_kf_has_key (keyfile, setting_info->setting_name, key, &err)) {
-		/* Key doesn't exist or an error occurred, thus nothing to do. */
-		if (err) {
-			if (!handle_warn (info,
-			                  key,
-			                  key,
-			                  NM_KEYFILE_WARN_SEVERITY_WARN,
-			                  _("error loading setting value: %s"),
-			                  err->message))
-				return;
-		}
+	    && !has_key) {
+		/* Key doesn't exist, thus nothing to do. */
 		return;
 	}
 
@@ -3249,11 +3254,11 @@ read_one_setting_value (KeyfileReaderInfo *info,
 	if (type == G_TYPE_STRING) {
 		gs_free char *str_val = NULL;
 
-		str_val = nm_keyfile_plugin_kf_get_string (keyfile, setting_info->setting_name, key, &err);
+		str_val = nm_keyfile_plugin_kf_get_string (keyfile, group, key, &err);
 		if (!err)
 			nm_g_object_set_property_string_take (G_OBJECT (setting), key, g_steal_pointer (&str_val), &err);
 	} else if (type == G_TYPE_UINT) {
-		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, setting_info->setting_name, key, &err);
+		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, group, key, &err);
 		if (!err) {
 			u64 = _nm_utils_ascii_str_to_uint64 (tmp_str, 0, 0, G_MAXUINT, G_MAXUINT64);
 			if (   u64 == G_MAXUINT64
@@ -3264,7 +3269,7 @@ read_one_setting_value (KeyfileReaderInfo *info,
 				nm_g_object_set_property_uint (G_OBJECT (setting), key, u64, &err);
 		}
 	} else if (type == G_TYPE_INT) {
-		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, setting_info->setting_name, key, &err);
+		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, group, key, &err);
 		if (!err) {
 			i64 = _nm_utils_ascii_str_to_int64 (tmp_str, 0, G_MININT, G_MAXINT, G_MININT64);
 			if (   i64 == G_MININT64
@@ -3277,11 +3282,11 @@ read_one_setting_value (KeyfileReaderInfo *info,
 	} else if (type == G_TYPE_BOOLEAN) {
 		gboolean bool_val;
 
-		bool_val = nm_keyfile_plugin_kf_get_boolean (keyfile, setting_info->setting_name, key, &err);
+		bool_val = nm_keyfile_plugin_kf_get_boolean (keyfile, group, key, &err);
 		if (!err)
 			nm_g_object_set_property_boolean (G_OBJECT (setting), key, bool_val, &err);
 	} else if (type == G_TYPE_CHAR) {
-		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, setting_info->setting_name, key, &err);
+		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, group, key, &err);
 		if (!err) {
 			/* As documented by glib, G_TYPE_CHAR is really a (signed!) gint8. */
 			i64 = _nm_utils_ascii_str_to_int64 (tmp_str, 0, G_MININT8, G_MAXINT8, G_MININT64);
@@ -3293,7 +3298,7 @@ read_one_setting_value (KeyfileReaderInfo *info,
 				nm_g_object_set_property_char (G_OBJECT (setting), key, i64, &err);
 		}
 	} else if (type == G_TYPE_UINT64) {
-		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, setting_info->setting_name, key, &err);
+		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, group, key, &err);
 		if (!err) {
 			u64 = _nm_utils_ascii_str_to_uint64 (tmp_str, 0, 0, G_MAXUINT64, G_MAXUINT64);
 			if (   u64 == G_MAXUINT64
@@ -3304,7 +3309,7 @@ read_one_setting_value (KeyfileReaderInfo *info,
 				nm_g_object_set_property_uint64 (G_OBJECT (setting), key, u64, &err);
 		}
 	} else if (type == G_TYPE_INT64) {
-		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, setting_info->setting_name, key, &err);
+		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, group, key, &err);
 		if (!err) {
 			i64 = _nm_utils_ascii_str_to_int64 (tmp_str, 0, G_MININT64, G_MAXINT64, G_MAXINT64);
 			if (   i64 == G_MAXINT64
@@ -3322,7 +3327,7 @@ read_one_setting_value (KeyfileReaderInfo *info,
 		int i;
 		gboolean already_warned = FALSE;
 
-		tmp = nm_keyfile_plugin_kf_get_integer_list_uint (keyfile, setting_info->setting_name, key, &length, NULL);
+		tmp = nm_keyfile_plugin_kf_get_integer_list_uint (keyfile, group, key, &length, NULL);
 
 		array = g_byte_array_sized_new (length);
 		for (i = 0; i < length; i++) {
@@ -3349,14 +3354,14 @@ read_one_setting_value (KeyfileReaderInfo *info,
 		gs_strfreev char **sa = NULL;
 		gsize length;
 
-		sa = nm_keyfile_plugin_kf_get_string_list (keyfile, setting_info->setting_name, key, &length, NULL);
+		sa = nm_keyfile_plugin_kf_get_string_list (keyfile, group, key, &length, NULL);
 		g_object_set (setting, key, sa, NULL);
 	} else if (type == G_TYPE_HASH_TABLE) {
 		read_hash_of_string (keyfile, setting, key);
 	} else if (type == G_TYPE_ARRAY) {
 		read_array_of_uint (keyfile, setting, key);
 	} else if (G_TYPE_IS_FLAGS (type)) {
-		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, setting_info->setting_name, key, &err);
+		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, group, key, &err);
 		if (!err) {
 			u64 = _nm_utils_ascii_str_to_uint64 (tmp_str, 0, 0, G_MAXUINT, G_MAXUINT64);
 			if (   u64 == G_MAXUINT64
@@ -3367,7 +3372,7 @@ read_one_setting_value (KeyfileReaderInfo *info,
 				nm_g_object_set_property_flags (G_OBJECT (setting), key, type, u64, &err);
 		}
 	} else if (G_TYPE_IS_ENUM (type)) {
-		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, setting_info->setting_name, key, &err);
+		tmp_str = nm_keyfile_plugin_kf_get_value (keyfile, group, key, &err);
 		if (!err) {
 			i64 = _nm_utils_ascii_str_to_int64 (tmp_str, 0, G_MININT, G_MAXINT, G_MAXINT64);
 			if (   i64 == G_MAXINT64
@@ -3398,7 +3403,13 @@ static void
 _read_setting (KeyfileReaderInfo *info)
 {
 	const NMSettInfoSetting *sett_info;
+	const NMMetaSettingInfo *setting_info;
+	const ParseInfoSetting *pis;
 	gs_unref_object NMSetting *setting = NULL;
+	gs_strfreev char **keys_all = NULL;
+	gsize n_keys_all;
+	gsize key_idx;
+	gsize pip_idx;
 	const char *alias;
 	GType type;
 	guint i;
@@ -3522,10 +3533,55 @@ _read_setting (KeyfileReaderInfo *info)
 		}
 	}
 
+	/* Both sett_info->property_infos and the parse-info properties are sorted by
+	 * name. Also sort the keys of the group, then match all three lists in a single
+	 * pass. That avoids a binary search and a GKeyFile lookup for each property. */
+	setting_info = sett_info->setting_class->setting_info;
+	nm_assert (setting_info);
+	nm_assert (setting_info->meta_type < G_N_ELEMENTS (parse_infos));
+	pis = parse_infos[setting_info->meta_type];
+	pip_idx = 0;
+
+	keys_all = g_key_file_get_keys (info->keyfile, info->group, &n_keys_all, NULL);
+	if (!keys_all)
+		n_keys_all = 0;
+	nm_utils_strv_sort (keys_all, n_keys_all);
+	key_idx = 0;
+
 	for (i = 0; i < sett_info->property_infos_len; i++) {
+		const NMSettInfoProperty *property_info = &sett_info->property_infos[i];
+		const ParseInfoProperty *pip = NULL;
+		gboolean has_key = FALSE;
+
+		if (pis && pis->properties) {
+			for (; pis->properties[pip_idx]; pip_idx++) {
+				int c;
+
+				c = strcmp (pis->properties[pip_idx]->property_name, property_info->name);
+				if (c < 0)
+					continue;
+				if (c == 0)
+					pip = pis->properties[pip_idx++];
+				break;
+			}
+		}
+
+		for (; key_idx < n_keys_all; key_idx++) {
+			int c;
+
+			c = strcmp (keys_all[key_idx], property_info->name);
+			if (c < 0)
+				continue;
+			has_key = (c == 0);
+			break;
+		}
+
 		read_one_setting_value (info,
 		                        setting,
-		                        &sett_info->property_infos[i]);
+		                        setting_info,
+		                        property_info,
+		                        pip,
+		                        has_key);
 		if (info->error)
 			goto out;
 	}
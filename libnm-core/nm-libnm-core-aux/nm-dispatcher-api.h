@@ -10,6 +10,10 @@
 #define NM_DISPATCHER_DBUS_INTERFACE "org.freedesktop.nm_dispatcher"
 #define NM_DISPATCHER_DBUS_PATH      "/org/freedesktop/nm_dispatcher"
 
+/* the signature of the arguments of one "Action" call. "ActionBatch"
+ * takes an array of these. */
+#define NMD_ACTION_ARGS_SIGNATURE "sa{sa{sv}}a{sv}a{sv}a{sv}a{sv}a{sv}a{sv}a{sv}ssa{sv}a{sv}a{sv}b"
+
 #define NMD_CONNECTION_PROPS_PATH         "path"
 #define NMD_CONNECTION_PROPS_FILENAME     "filename"
 #define NMD_CONNECTION_PROPS_EXTERNAL     "external"
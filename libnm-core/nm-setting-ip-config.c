@@ -11,6 +11,7 @@
 #include <arpa/inet.h>
 #include <linux/fib_rules.h>
 
+#include "nm-glib-aux/nm-ref-string.h"
 #include "nm-glib-aux/nm-str-buf.h"
 #include "nm-setting-ip4-config.h"
 #include "nm-setting-ip6-config.h"
@@ -3637,7 +3638,7 @@ NM_GOBJECT_PROPERTIES_DEFINE (NMSettingIPConfig,
 
 typedef struct {
 	GPtrArray *dns;         /* array of IP address strings */
-	GPtrArray *dns_search;  /* array of domain name strings */
+	GPtrArray *dns_search;  /* array of interned NMRefString domain names */
 	GPtrArray *dns_options; /* array of DNS options */
 	GPtrArray *addresses;   /* array of NMIPAddress */
 	GPtrArray *routes;      /* array of NMIPRoute */
@@ -3861,7 +3862,7 @@ nm_setting_ip_config_get_dns_search (NMSettingIPConfig *setting, int idx)
 	priv = NM_SETTING_IP_CONFIG_GET_PRIVATE (setting);
 	g_return_val_if_fail (idx >= 0 && idx < priv->dns_search->len, NULL);
 
-	return priv->dns_search->pdata[idx];
+	return nm_ref_string_get_str (priv->dns_search->pdata[idx]);
 }
 
 /**
@@ -3879,6 +3880,7 @@ nm_setting_ip_config_add_dns_search (NMSettingIPConfig *setting,
                                      const char *dns_search)
 {
 	NMSettingIPConfigPrivate *priv;
+	nm_auto_ref_string NMRefString *rstr = NULL;
 	guint i;
 
 	g_return_val_if_fail (NM_IS_SETTING_IP_CONFIG (setting), FALSE);
@@ -3886,12 +3888,14 @@ nm_setting_ip_config_add_dns_search (NMSettingIPConfig *setting,
 	g_return_val_if_fail (dns_search[0] != '\0', FALSE);
 
 	priv = NM_SETTING_IP_CONFIG_GET_PRIVATE (setting);
+
+	rstr = nm_ref_string_new (dns_search);
 	for (i = 0; i < priv->dns_search->len; i++) {
-		if (!strcmp (dns_search, priv->dns_search->pdata[i]))
+		if (priv->dns_search->pdata[i] == rstr)
 			return FALSE;
 	}
 
-	g_ptr_array_add (priv->dns_search, g_strdup (dns_search));
+	g_ptr_array_add (priv->dns_search, g_steal_pointer (&rstr));
 	_notify (setting, PROP_DNS_SEARCH);
 	return TRUE;
 }
@@ -3939,7 +3943,7 @@ nm_setting_ip_config_remove_dns_search_by_value (NMSettingIPConfig *setting,
 
 	priv = NM_SETTING_IP_CONFIG_GET_PRIVATE (setting);
 	for (i = 0; i < priv->dns_search->len; i++) {
-		if (!strcmp (dns_search, priv->dns_search->pdata[i])) {
+		if (nm_ref_string_equals_str (priv->dns_search->pdata[i], dns_search)) {
 			g_ptr_array_remove_index (priv->dns_search, i);
 			_notify (setting, PROP_DNS_SEARCH);
 			return TRUE;
@@ -5362,6 +5366,31 @@ _nm_sett_info_property_override_create_array_ip_config (void)
 
 /*****************************************************************************/
 
+static char **
+_dns_search_to_strv (const GPtrArray *dns_search)
+{
+	char **strv;
+	guint i;
+
+	strv = g_new (char *, dns_search->len + 1);
+	for (i = 0; i < dns_search->len; i++)
+		strv[i] = g_strdup (nm_ref_string_get_str (dns_search->pdata[i]));
+	strv[i] = NULL;
+	return strv;
+}
+
+static void
+_dns_search_set_strv (GPtrArray *dns_search, const char *const*strv)
+{
+	gsize i;
+
+	g_ptr_array_set_size (dns_search, 0);
+	for (i = 0; strv && strv[i]; i++)
+		g_ptr_array_add (dns_search, nm_ref_string_new (strv[i]));
+}
+
+/*****************************************************************************/
+
 static void
 get_property (GObject *object, guint prop_id,
               GValue *value, GParamSpec *pspec)
@@ -5377,7 +5406,7 @@ get_property (GObject *object, guint prop_id,
 		g_value_take_boxed (value, _nm_utils_ptrarray_to_strv (priv->dns));
 		break;
 	case PROP_DNS_SEARCH:
-		g_value_take_boxed (value, _nm_utils_ptrarray_to_strv (priv->dns_search));
+		g_value_take_boxed (value, _dns_search_to_strv (priv->dns_search));
 		break;
 	case PROP_DNS_OPTIONS:
 		g_value_take_boxed (value, priv->dns_options ? _nm_utils_ptrarray_to_strv (priv->dns_options) : NULL);
@@ -5460,8 +5489,7 @@ set_property (GObject *object, guint prop_id,
 		priv->dns = _nm_utils_strv_to_ptrarray (g_value_get_boxed (value));
 		break;
 	case PROP_DNS_SEARCH:
-		g_ptr_array_unref (priv->dns_search);
-		priv->dns_search = _nm_utils_strv_to_ptrarray (g_value_get_boxed (value));
+		_dns_search_set_strv (priv->dns_search, g_value_get_boxed (value));
 		break;
 	case PROP_DNS_OPTIONS:
 		strv = g_value_get_boxed (value);
@@ -5554,7 +5582,7 @@ nm_setting_ip_config_init (NMSettingIPConfig *setting)
 	NMSettingIPConfigPrivate *priv = NM_SETTING_IP_CONFIG_GET_PRIVATE (setting);
 
 	priv->dns                = g_ptr_array_new_with_free_func (g_free);
-	priv->dns_search         = g_ptr_array_new_with_free_func (g_free);
+	priv->dns_search         = g_ptr_array_new_with_free_func ((GDestroyNotify) _nm_ref_string_unref_non_null);
 	priv->addresses          = g_ptr_array_new_with_free_func ((GDestroyNotify) nm_ip_address_unref);
 	priv->routes             = g_ptr_array_new_with_free_func ((GDestroyNotify) nm_ip_route_unref);
 	priv->route_metric       = -1;
@@ -46,6 +46,9 @@ NM_GOBJECT_PROPERTIES_DEFINE (NMSetting,
 
 typedef struct {
 	GenData *gendata;
+
+	/* incremented whenever the setting emits a property change notification. */
+	guint64 generation;
 } NMSettingPrivate;
 
 G_DEFINE_ABSTRACT_TYPE (NMSetting, nm_setting, G_TYPE_OBJECT)
@@ -205,6 +208,70 @@ _gprop_to_dbus_fcn_flags (const GValue *val)
 	return g_variant_new_uint32 (g_value_get_flags (val));
 }
 
+/*****************************************************************************/
+
+static gboolean
+_gprop_equal_fcn_plain (const GValue *a, const GValue *b)
+{
+	nm_assert (G_VALUE_TYPE (a) == G_VALUE_TYPE (b));
+
+	switch (G_TYPE_FUNDAMENTAL (G_VALUE_TYPE (a))) {
+	case G_TYPE_BOOLEAN:
+		return (!g_value_get_boolean (a)) == (!g_value_get_boolean (b));
+	case G_TYPE_UCHAR:
+		return g_value_get_uchar (a) == g_value_get_uchar (b);
+	case G_TYPE_INT:
+		return g_value_get_int (a) == g_value_get_int (b);
+	case G_TYPE_UINT:
+		return g_value_get_uint (a) == g_value_get_uint (b);
+	case G_TYPE_INT64:
+		return g_value_get_int64 (a) == g_value_get_int64 (b);
+	case G_TYPE_UINT64:
+		return g_value_get_uint64 (a) == g_value_get_uint64 (b);
+	case G_TYPE_DOUBLE:
+		return g_value_get_double (a) == g_value_get_double (b);
+	case G_TYPE_ENUM:
+		return g_value_get_enum (a) == g_value_get_enum (b);
+	case G_TYPE_FLAGS:
+		return g_value_get_flags (a) == g_value_get_flags (b);
+	}
+	nm_assert_not_reached ();
+	return FALSE;
+}
+
+static gboolean
+_gprop_equal_fcn_string (const GValue *a, const GValue *b)
+{
+	/* on D-Bus, a NULL string is serialized as "". */
+	return nm_streq (g_value_get_string (a) ?: "",
+	                 g_value_get_string (b) ?: "");
+}
+
+static gboolean
+_gprop_equal_fcn_strv (const GValue *a, const GValue *b)
+{
+	const char *const*strv_a = g_value_get_boxed (a);
+	const char *const*strv_b = g_value_get_boxed (b);
+
+	/* on D-Bus, a NULL strv is serialized as empty array. */
+	return _nm_utils_strv_cmp_n (strv_a, strv_a ? -1 : 0,
+	                             strv_b, strv_b ? -1 : 0) == 0;
+}
+
+static gboolean
+_gprop_equal_fcn_bytes (const GValue *a, const GValue *b)
+{
+	GBytes *bytes_a = g_value_get_boxed (a);
+	GBytes *bytes_b = g_value_get_boxed (b);
+
+	if (!bytes_a || !bytes_b) {
+		/* on D-Bus, %NULL is serialized as empty array. */
+		return    (bytes_a ? g_bytes_get_size (bytes_a) : 0u) == 0
+		       && (bytes_b ? g_bytes_get_size (bytes_b) : 0u) == 0;
+	}
+	return g_bytes_equal (bytes_a, bytes_b);
+}
+
 gboolean
 _nm_properties_override_assert (const NMSettInfoProperty *prop_info)
 {
@@ -402,33 +469,43 @@ _nm_setting_class_commit_full (NMSettingClass *setting_class,
 		nm_assert (p->param_spec);
 
 		vtype = p->param_spec->value_type;
-		if (vtype == G_TYPE_BOOLEAN)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_BOOLEAN);
-		else if (vtype == G_TYPE_UCHAR)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_BYTE);
-		else if (vtype == G_TYPE_INT)
+		if (vtype == G_TYPE_BOOLEAN) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_BOOLEAN,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
+		} else if (vtype == G_TYPE_UCHAR) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_BYTE,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
+		} else if (vtype == G_TYPE_INT)
 			p->property_type = &nm_sett_info_propert_type_plain_i;
 		else if (vtype == G_TYPE_UINT)
 			p->property_type = &nm_sett_info_propert_type_plain_u;
-		else if (vtype == G_TYPE_INT64)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_INT64);
-		else if (vtype == G_TYPE_UINT64)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_UINT64);
-		else if (vtype == G_TYPE_STRING)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_STRING);
-		else if (vtype == G_TYPE_DOUBLE)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_DOUBLE);
-		else if (vtype == G_TYPE_STRV)
-			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_STRING_ARRAY);
-		else if (vtype == G_TYPE_BYTES) {
+		else if (vtype == G_TYPE_INT64) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_INT64,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
+		} else if (vtype == G_TYPE_UINT64) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_UINT64,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
+		} else if (vtype == G_TYPE_STRING) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_STRING,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_string);
+		} else if (vtype == G_TYPE_DOUBLE) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_DOUBLE,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
+		} else if (vtype == G_TYPE_STRV) {
+			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_STRING_ARRAY,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_strv);
+		} else if (vtype == G_TYPE_BYTES) {
 			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_BYTESTRING,
-			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_bytes);
+			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_bytes,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_bytes);
 		} else if (g_type_is_a (vtype, G_TYPE_ENUM)) {
 			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_INT32,
-			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_enum);
+			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_enum,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
 		} else if (g_type_is_a (vtype, G_TYPE_FLAGS)) {
 			p->property_type = NM_SETT_INFO_PROPERT_TYPE (.dbus_type = G_VARIANT_TYPE_UINT32,
-			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_flags);
+			                                              .gprop_to_dbus_fcn = _gprop_to_dbus_fcn_flags,
+			                                              .gprop_equal_fcn = _gprop_equal_fcn_plain);
 		} else
 			nm_assert_not_reached ();
 
@@ -531,6 +608,24 @@ _nm_setting_emit_property_changed (NMSetting *setting)
 	_notify (setting, PROP_NAME);
 }
 
+/**
+ * _nm_setting_get_generation:
+ * @setting: the #NMSetting
+ *
+ * Returns: a counter that is incremented each time @setting emits
+ *   a "notify" signal, including the artificial notifications from
+ *   _nm_setting_emit_property_changed(). The value only ever increases,
+ *   so it can be used to detect whether the setting was modified since
+ *   a previous call.
+ */
+guint64
+_nm_setting_get_generation (NMSetting *setting)
+{
+	nm_assert (NM_IS_SETTING (setting));
+
+	return NM_SETTING_GET_PRIVATE (setting)->generation;
+}
+
 /*****************************************************************************/
 
 gboolean
@@ -1329,6 +1424,8 @@ compare_property (const NMSettInfoSetting *sett_info,
 {
 	const NMSettInfoProperty *property_info = &sett_info->property_infos[property_idx];
 	const GParamSpec *param_spec = property_info->param_spec;
+	gs_unref_variant GVariant *variant1 = NULL;
+	gs_unref_variant GVariant *variant2 = NULL;
 
 	if (!param_spec)
 		return NM_TERNARY_DEFAULT;
@@ -1359,16 +1456,39 @@ compare_property (const NMSettInfoSetting *sett_info,
 	                                                    flags))
 		return NM_TERNARY_DEFAULT;
 
-	if (set_b) {
-		gs_unref_variant GVariant *value1  = NULL;
-		gs_unref_variant GVariant *value2  = NULL;
-
-		value1 = property_to_dbus (sett_info, property_idx, con_a, set_a, NM_CONNECTION_SERIALIZE_ALL, NULL, TRUE, TRUE);
-		value2 = property_to_dbus (sett_info, property_idx, con_b, set_b, NM_CONNECTION_SERIALIZE_ALL, NULL, TRUE, TRUE);
-		if (nm_property_compare (value1, value2) != 0)
-			return NM_TERNARY_FALSE;
+	if (!set_b)
+		return NM_TERNARY_TRUE;
+
+	if (   property_info->property_type->gprop_equal_fcn
+	    && !property_info->property_type->to_dbus_fcn) {
+		nm_auto_unset_gvalue GValue value1 = { 0, };
+		nm_auto_unset_gvalue GValue value2 = { 0, };
+		gboolean is_default1;
+		gboolean is_default2;
+
+		/* Compare the GObject property values natively. That gives the same result as
+		 * comparing the variants below (where a default value is serialized as %NULL),
+		 * but avoids creating them. */
+		g_value_init (&value1, param_spec->value_type);
+		g_value_init (&value2, param_spec->value_type);
+		g_object_get_property (G_OBJECT (set_a), param_spec->name, &value1);
+		g_object_get_property (G_OBJECT (set_b), param_spec->name, &value2);
+
+		is_default1 = g_param_value_defaults ((GParamSpec *) param_spec, &value1);
+		is_default2 = g_param_value_defaults ((GParamSpec *) param_spec, &value2);
+		if (is_default1 || is_default2)
+			return (is_default1 && is_default2) ? NM_TERNARY_TRUE : NM_TERNARY_FALSE;
+
+		return   property_info->property_type->gprop_equal_fcn (&value1, &value2)
+		       ? NM_TERNARY_TRUE
+		       : NM_TERNARY_FALSE;
 	}
 
+	variant1 = property_to_dbus (sett_info, property_idx, con_a, set_a, NM_CONNECTION_SERIALIZE_ALL, NULL, TRUE, TRUE);
+	variant2 = property_to_dbus (sett_info, property_idx, con_b, set_b, NM_CONNECTION_SERIALIZE_ALL, NULL, TRUE, TRUE);
+	if (nm_property_compare (variant1, variant2) != 0)
+		return NM_TERNARY_FALSE;
+
 	return NM_TERNARY_TRUE;
 }
 
@@ -2358,11 +2478,13 @@ const NMSettInfoPropertType nm_sett_info_propert_type_deprecated_ignore_u = {
 };
 
 const NMSettInfoPropertType nm_sett_info_propert_type_plain_i = {
-	.dbus_type   = G_VARIANT_TYPE_INT32,
+	.dbus_type       = G_VARIANT_TYPE_INT32,
+	.gprop_equal_fcn = _gprop_equal_fcn_plain,
 };
 
 const NMSettInfoPropertType nm_sett_info_propert_type_plain_u = {
-	.dbus_type   = G_VARIANT_TYPE_UINT32,
+	.dbus_type       = G_VARIANT_TYPE_UINT32,
+	.gprop_equal_fcn = _gprop_equal_fcn_plain,
 };
 
 /*****************************************************************************/
@@ -2820,6 +2942,15 @@ get_property (GObject *object, guint prop_id,
 
 /*****************************************************************************/
 
+static void
+notify (GObject *object, GParamSpec *pspec)
+{
+	NM_SETTING_GET_PRIVATE (object)->generation++;
+
+	if (G_OBJECT_CLASS (nm_setting_parent_class)->notify)
+		G_OBJECT_CLASS (nm_setting_parent_class)->notify (object, pspec);
+}
+
 static void
 nm_setting_init (NMSetting *setting)
 {
@@ -2848,6 +2979,7 @@ nm_setting_class_init (NMSettingClass *setting_class)
 	g_type_class_add_private (setting_class, sizeof (NMSettingPrivate));
 
 	object_class->get_property = get_property;
+	object_class->notify       = notify;
 	object_class->finalize     = finalize;
 
 	setting_class->update_one_secret         = update_one_secret;
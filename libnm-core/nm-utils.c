@@ -833,10 +833,20 @@ _nm_utils_strdict_from_dbus (GVariant *dbus_value,
 	g_value_take_boxed (prop_value, hash);
 }
 
+static gboolean
+_nm_utils_strdict_equal (const GValue *a, const GValue *b)
+{
+	return nm_utils_hash_table_equal (g_value_get_boxed (a),
+	                                  g_value_get_boxed (b),
+	                                  TRUE,
+	                                  g_str_equal);
+}
+
 const NMSettInfoPropertType nm_sett_info_propert_type_strdict = {
 	.dbus_type           = NM_G_VARIANT_TYPE ("a{ss}"),
 	.gprop_to_dbus_fcn   = _nm_utils_strdict_to_dbus,
 	.gprop_from_dbus_fcn = _nm_utils_strdict_from_dbus,
+	.gprop_equal_fcn     = _nm_utils_strdict_equal,
 };
 
 GHashTable *
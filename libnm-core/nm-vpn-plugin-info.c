@@ -908,6 +908,29 @@ nm_vpn_plugin_info_supports_multiple (NMVpnPluginInfo *self)
 	return _nm_utils_ascii_str_to_bool (s, FALSE);
 }
 
+/**
+ * nm_vpn_plugin_info_supports_instances:
+ * @self: plugin info instance
+ *
+ * A service that supports instances handles many connections in one
+ * process. Each connection is handled by a separate instance of the
+ * plugin, created via the AddInstance() D-Bus method.
+ *
+ * Returns: %TRUE if the service supports instances, otherwise %FALSE
+ *
+ * Since: 1.28
+ */
+gboolean
+nm_vpn_plugin_info_supports_instances (NMVpnPluginInfo *self)
+{
+	const char *s;
+
+	g_return_val_if_fail (NM_IS_VPN_PLUGIN_INFO (self), FALSE);
+
+	s = nm_vpn_plugin_info_lookup_property (self, NM_VPN_PLUGIN_INFO_KF_GROUP_CONNECTION, "supports-instances");
+	return _nm_utils_ascii_str_to_bool (s, FALSE);
+}
+
 /**
  * nm_vpn_plugin_info_get_aliases:
  * @self: plugin info instance
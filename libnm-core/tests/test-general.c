@@ -4924,6 +4924,64 @@ test_connection_normalize_uuid (void)
 
 /*****************************************************************************/
 
+static void
+test_connection_verify_cache (void)
+{
+	gs_unref_object NMConnection *con = NULL;
+	NMSettingConnection *s_con;
+	NMSetting *s_ethtool;
+	NMSetting *s_ip4;
+	guint64 generation;
+
+	con = nmtst_create_minimal_connection ("test1", NULL, NM_SETTING_WIRED_SETTING_NAME, &s_con);
+	nmtst_connection_normalize (con);
+
+	nmtst_assert_connection_verifies_without_normalization (con);
+	nmtst_assert_connection_verifies_without_normalization (con);
+
+	/* a GObject property change invalidates the cached result. */
+	generation = _nm_setting_get_generation (NM_SETTING (s_con));
+	g_object_set (s_con,
+	              NM_SETTING_CONNECTION_ID, NULL,
+	              NULL);
+	g_assert_cmpint (_nm_setting_get_generation (NM_SETTING (s_con)), >, generation);
+	nmtst_assert_connection_unnormalizable (con, NM_CONNECTION_ERROR, NM_CONNECTION_ERROR_MISSING_PROPERTY);
+	g_object_set (s_con,
+	              NM_SETTING_CONNECTION_ID, "test1",
+	              NULL);
+	nmtst_assert_connection_verifies_without_normalization (con);
+
+	/* as does a change of a property that is not a GObject property. */
+	s_ethtool = nm_setting_ethtool_new ();
+	nm_connection_add_setting (con, s_ethtool);
+	nmtst_assert_connection_verifies_without_normalization (con);
+
+	generation = _nm_setting_get_generation (s_ethtool);
+	nm_setting_option_set_boolean (s_ethtool, "not-an-ethtool-option", TRUE);
+	g_assert_cmpint (_nm_setting_get_generation (s_ethtool), >, generation);
+	nmtst_assert_connection_unnormalizable (con, NM_CONNECTION_ERROR, NM_CONNECTION_ERROR_INVALID_PROPERTY);
+	nm_setting_option_clear_by_name (s_ethtool, NULL);
+	nmtst_assert_connection_verifies_without_normalization (con);
+
+	/* and adding or removing settings. */
+	s_ip4 = nm_connection_get_setting (con, NM_TYPE_SETTING_IP4_CONFIG);
+	g_assert (s_ip4);
+	g_object_ref (s_ip4);
+	nm_connection_remove_setting (con, NM_TYPE_SETTING_IP4_CONFIG);
+	nmtst_assert_connection_verifies_and_normalizable (con);
+	nm_connection_add_setting (con, s_ip4);
+	nmtst_assert_connection_verifies_without_normalization (con);
+
+	/* a normalizable connection is not cached as valid. */
+	g_object_set (s_con,
+	              NM_SETTING_CONNECTION_UUID, NULL,
+	              NULL);
+	nmtst_assert_connection_verifies_and_normalizable (con);
+	nmtst_assert_connection_verifies_and_normalizable (con);
+}
+
+/*****************************************************************************/
+
 /*
  * Test normalization of interface-name
  */
@@ -9226,6 +9284,7 @@ int main (int argc, char **argv)
 	g_test_add_func ("/core/general/test_connection_new_from_dbus", test_connection_new_from_dbus);
 	g_test_add_func ("/core/general/test_connection_normalize_virtual_iface_name", test_connection_normalize_virtual_iface_name);
 	g_test_add_func ("/core/general/test_connection_normalize_uuid", test_connection_normalize_uuid);
+	g_test_add_func ("/core/general/test_connection_verify_cache", test_connection_verify_cache);
 	g_test_add_func ("/core/general/test_connection_normalize_type", test_connection_normalize_type);
 	g_test_add_func ("/core/general/test_connection_normalize_slave_type_1", test_connection_normalize_slave_type_1);
 	g_test_add_func ("/core/general/test_connection_normalize_slave_type_2", test_connection_normalize_slave_type_2);
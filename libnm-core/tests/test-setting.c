@@ -3911,6 +3911,7 @@ test_setting_metadata (void)
 
 			g_assert (!sip->property_type->to_dbus_fcn || !sip->property_type->gprop_to_dbus_fcn);
 			g_assert (!sip->property_type->from_dbus_fcn || !sip->property_type->gprop_from_dbus_fcn);
+			g_assert (!sip->property_type->gprop_equal_fcn || sip->param_spec);
 
 			if (!g_hash_table_insert (h_properties, (char *) sip->name, sip->param_spec))
 				g_assert_not_reached ();
@@ -4023,7 +4024,8 @@ test_setting_metadata (void)
 				    || pt->from_dbus_fcn != pt_2->from_dbus_fcn
 				    || pt->missing_from_dbus_fcn != pt_2->missing_from_dbus_fcn
 				    || pt->gprop_to_dbus_fcn != pt_2->gprop_to_dbus_fcn
-				    || pt->gprop_from_dbus_fcn != pt_2->gprop_from_dbus_fcn)
+				    || pt->gprop_from_dbus_fcn != pt_2->gprop_from_dbus_fcn
+				    || pt->gprop_equal_fcn != pt_2->gprop_equal_fcn)
 					continue;
 
 				if (   (pt   == &nm_sett_info_propert_type_plain_i && pt_2 == &nm_sett_info_propert_type_deprecated_ignore_i)
@@ -4052,6 +4054,96 @@ test_setting_metadata (void)
 
 /*****************************************************************************/
 
+static NMConnection *
+_create_connection_many_routes (guint n_routes)
+{
+	NMConnection *con;
+	NMSettingIPConfig *s_ip4;
+	NMSettingBond *s_bond;
+	NMIPAddress *addr;
+	guint i;
+
+	con = nmtst_create_minimal_connection ("many-routes",
+	                                       "a8c3ec49-b7b5-4a2d-a8cc-2f1a3a2c4e6b",
+	                                       NM_SETTING_BOND_SETTING_NAME,
+	                                       NULL);
+
+	s_bond = NM_SETTING_BOND (nm_connection_get_setting (con, NM_TYPE_SETTING_BOND));
+	nm_setting_bond_add_option (s_bond, NM_SETTING_BOND_OPTION_MODE, "802.3ad");
+	nm_setting_bond_add_option (s_bond, NM_SETTING_BOND_OPTION_MIIMON, "100");
+	nm_setting_bond_add_option (s_bond, NM_SETTING_BOND_OPTION_XMIT_HASH_POLICY, "layer3+4");
+
+	s_ip4 = NM_SETTING_IP_CONFIG (nm_setting_ip4_config_new ());
+	g_object_set (s_ip4,
+	              NM_SETTING_IP_CONFIG_METHOD, NM_SETTING_IP4_CONFIG_METHOD_MANUAL,
+	              NULL);
+	addr = nm_ip_address_new (AF_INET, "192.168.1.5", 24, NULL);
+	nm_setting_ip_config_add_address (s_ip4, addr);
+	nm_ip_address_unref (addr);
+	nm_setting_ip_config_add_dns_search (s_ip4, "example.com");
+
+	for (i = 0; i < n_routes; i++) {
+		NMIPRoute *route;
+		char dest[NM_UTILS_INET_ADDRSTRLEN];
+
+		route = nm_ip_route_new (AF_INET,
+		                         nm_sprintf_buf (dest, "10.%u.%u.0", (i >> 8) & 0xFFu, i & 0xFFu),
+		                         24,
+		                         "192.168.1.1",
+		                         100 + (i % 10),
+		                         NULL);
+		g_assert (route);
+		nm_setting_ip_config_add_route (s_ip4, route);
+		nm_ip_route_unref (route);
+	}
+
+	nm_connection_add_setting (con, NM_SETTING (s_ip4));
+
+	nmtst_connection_normalize (con);
+	return con;
+}
+
+static void
+test_compare_many_routes (void)
+{
+	const guint N_ROUTES = nmtst_test_quick () ? 500 : 10000;
+	gs_unref_object NMConnection *con1 = NULL;
+	gs_unref_object NMConnection *con2 = NULL;
+	gs_unref_hashtable GHashTable *diffs = NULL;
+	NMSettingIPConfig *s_ip4;
+	NMIPRoute *route;
+
+	con1 = _create_connection_many_routes (N_ROUTES);
+	con2 = nm_simple_connection_new_clone (con1);
+
+	g_assert (nm_connection_compare (con1, con2, NM_SETTING_COMPARE_FLAG_EXACT));
+	g_assert (nm_connection_diff (con1, con2, NM_SETTING_COMPARE_FLAG_EXACT, &diffs));
+	g_assert (!diffs);
+
+	/* a "" string differs from the default %NULL, also with native comparison. */
+	s_ip4 = nm_connection_get_setting_ip4_config (con2);
+	g_object_set (s_ip4, NM_SETTING_IP_CONFIG_DHCP_HOSTNAME, "", NULL);
+	g_assert (!nm_connection_compare (con1, con2, NM_SETTING_COMPARE_FLAG_EXACT));
+	g_object_set (s_ip4, NM_SETTING_IP_CONFIG_DHCP_HOSTNAME, NULL, NULL);
+	g_assert (nm_connection_compare (con1, con2, NM_SETTING_COMPARE_FLAG_EXACT));
+
+	/* change the metric of the last route. */
+	route = nm_ip_route_dup (nm_setting_ip_config_get_route (s_ip4, N_ROUTES - 1));
+	nm_ip_route_set_metric (route, 5);
+	nm_setting_ip_config_remove_route (s_ip4, N_ROUTES - 1);
+	nm_setting_ip_config_add_route (s_ip4, route);
+	nm_ip_route_unref (route);
+
+	g_assert (!nm_connection_compare (con1, con2, NM_SETTING_COMPARE_FLAG_EXACT));
+	g_assert (!nm_connection_diff (con1, con2, NM_SETTING_COMPARE_FLAG_EXACT, &diffs));
+	g_assert (diffs);
+	g_assert_cmpint (g_hash_table_size (diffs), ==, 1);
+	g_assert (g_hash_table_lookup (g_hash_table_lookup (diffs, NM_SETTING_IP4_CONFIG_SETTING_NAME),
+	                               NM_SETTING_IP_CONFIG_ROUTES));
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -4150,5 +4242,7 @@ main (int argc, char **argv)
 
 	g_test_add_func ("/libnm/test_setting_metadata", test_setting_metadata);
 
+	g_test_add_func ("/libnm/settings/compare/many-routes", test_compare_many_routes);
+
 	return g_test_run ();
 }
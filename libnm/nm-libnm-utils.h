@@ -12,6 +12,7 @@
 #include "nm-types.h"
 #include "nm-object.h"
 #include "nm-client.h"
+#include "nm-vpn-service-plugin.h"
 
 /*****************************************************************************/
 
@@ -1032,4 +1033,8 @@ _nm_device_notify_update_prop_hw_address (NMClient *client,
 
 /*****************************************************************************/
 
+gboolean nmtst_vpn_service_plugin_has_quit_timer (NMVpnServicePlugin *plugin);
+
+/*****************************************************************************/
+
 #endif /* __NM_LIBNM_UTILS_H__ */
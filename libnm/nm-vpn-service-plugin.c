@@ -17,6 +17,7 @@
 #include "nm-utils.h"
 #include "nm-connection.h"
 #include "nm-dbus-helpers.h"
+#include "nm-libnm-utils.h"
 #include "nm-core-internal.h"
 #include "nm-simple-connection.h"
 
@@ -37,7 +38,16 @@ typedef struct {
 	GDBusConnection *connection;
 	NMDBusVpnPlugin *dbus_vpn_service_plugin;
 	char *dbus_service_name;
+	char *dbus_object_path;
 	gboolean dbus_watch_peer;
+	gboolean multi_instance;
+
+	/* for the main plugin, the instances by object path. */
+	GHashTable *instances;
+
+	/* for an instance, the main plugin that created it. */
+	NMVpnServicePlugin *main_plugin;
+	guint instance_remove_id;
 
 	/* Temporary stuff */
 	guint connect_timer;
@@ -65,6 +75,7 @@ enum {
 	FAILURE,
 	QUIT,
 	SECRETS_REQUIRED,
+	INSTANCE_ADDED,
 
 	LAST_SIGNAL
 };
@@ -74,6 +85,8 @@ static guint signals[LAST_SIGNAL] = { 0 };
 NM_GOBJECT_PROPERTIES_DEFINE_BASE (
 	PROP_DBUS_SERVICE_NAME,
 	PROP_DBUS_WATCH_PEER,
+	PROP_DBUS_OBJECT_PATH,
+	PROP_MULTI_INSTANCE,
 	PROP_STATE,
 );
 
@@ -253,6 +266,9 @@ nm_vpn_service_plugin_shutdown (NMVpnServicePlugin *plugin)
 	nm_clear_g_source (&priv->fail_stop_id);
 	nm_clear_g_source (&priv->quit_timer);
 	nm_clear_g_source (&priv->connect_timer);
+	nm_clear_g_source (&priv->instance_remove_id);
+
+	nm_clear_pointer (&priv->instances, g_hash_table_destroy);
 
 	state = nm_vpn_service_plugin_get_state (plugin);
 	if (state == NM_VPN_SERVICE_STATE_STARTED ||
@@ -965,6 +981,97 @@ impl_vpn_service_plugin_set_failure (NMVpnServicePlugin *plugin,
 	g_dbus_method_invocation_return_value (context, NULL);
 }
 
+static void
+_instance_destroy (gpointer data)
+{
+	NMVpnServicePlugin *instance = data;
+
+	NM_VPN_SERVICE_PLUGIN_GET_PRIVATE (instance)->main_plugin = NULL;
+	nm_vpn_service_plugin_shutdown (instance);
+	g_object_unref (instance);
+}
+
+static gboolean
+_instance_remove_cb (gpointer data)
+{
+	NMVpnServicePlugin *instance = data;
+	NMVpnServicePluginPrivate *priv = NM_VPN_SERVICE_PLUGIN_GET_PRIVATE (instance);
+	NMVpnServicePlugin *main_plugin = priv->main_plugin;
+	NMVpnServicePluginPrivate *main_priv;
+
+	priv->instance_remove_id = 0;
+
+	if (!main_plugin)
+		return G_SOURCE_REMOVE;
+
+	main_priv = NM_VPN_SERVICE_PLUGIN_GET_PRIVATE (main_plugin);
+
+	/* this drops the last reference of the main plugin to @instance. */
+	g_hash_table_remove (main_priv->instances, priv->dbus_object_path);
+
+	if (g_hash_table_size (main_priv->instances) == 0)
+		schedule_quit_timer (main_plugin);
+
+	return G_SOURCE_REMOVE;
+}
+
+gboolean
+nmtst_vpn_service_plugin_has_quit_timer (NMVpnServicePlugin *plugin)
+{
+	g_return_val_if_fail (NM_IS_VPN_SERVICE_PLUGIN (plugin), FALSE);
+
+	return NM_VPN_SERVICE_PLUGIN_GET_PRIVATE (plugin)->quit_timer != 0;
+}
+
+static void
+impl_vpn_service_plugin_add_instance (NMVpnServicePlugin *plugin,
+                                      GDBusMethodInvocation *context,
+                                      const char *path,
+                                      gpointer user_data)
+{
+	NMVpnServicePluginPrivate *priv = NM_VPN_SERVICE_PLUGIN_GET_PRIVATE (plugin);
+	NMVpnServicePlugin *instance;
+	GError *error = NULL;
+
+	if (   !priv->multi_instance
+	    || priv->dbus_object_path) {
+		g_dbus_method_invocation_return_error (context,
+		                                       NM_VPN_PLUGIN_ERROR,
+		                                       NM_VPN_PLUGIN_ERROR_BAD_ARGUMENTS,
+		                                       "Plugin does not support instances");
+		return;
+	}
+
+	if (   nm_streq (path, NM_VPN_DBUS_PLUGIN_PATH)
+	    || g_hash_table_contains (priv->instances, path)) {
+		g_dbus_method_invocation_return_error (context,
+		                                       NM_VPN_PLUGIN_ERROR,
+		                                       NM_VPN_PLUGIN_ERROR_BAD_ARGUMENTS,
+		                                       "Instance %s already exists",
+		                                       path);
+		return;
+	}
+
+	instance = g_initable_new (G_OBJECT_TYPE (plugin), NULL, &error,
+	                           NM_VPN_SERVICE_PLUGIN_DBUS_SERVICE_NAME, priv->dbus_service_name,
+	                           NM_VPN_SERVICE_PLUGIN_DBUS_WATCH_PEER, priv->dbus_watch_peer,
+	                           NM_VPN_SERVICE_PLUGIN_DBUS_OBJECT_PATH, path,
+	                           NULL);
+	if (!instance) {
+		g_dbus_method_invocation_take_error (context, error);
+		return;
+	}
+
+	NM_VPN_SERVICE_PLUGIN_GET_PRIVATE (instance)->main_plugin = plugin;
+	g_hash_table_insert (priv->instances, g_strdup (path), instance);
+
+	nm_clear_g_source (&priv->quit_timer);
+
+	g_signal_emit (plugin, signals[INSTANCE_ADDED], 0, instance);
+
+	g_dbus_method_invocation_return_value (context, NULL);
+}
+
 /*****************************************************************************/
 
 static void
@@ -1013,6 +1120,41 @@ nm_vpn_service_plugin_init (NMVpnServicePlugin *plugin)
 	                   NULL);
 }
 
+static gboolean
+_export (NMVpnServicePlugin *plugin,
+         GDBusConnection *connection,
+         const char *path,
+         GError **error)
+{
+	NMVpnServicePluginPrivate *priv = NM_VPN_SERVICE_PLUGIN_GET_PRIVATE (plugin);
+
+	priv->dbus_vpn_service_plugin = nmdbus_vpn_plugin_skeleton_new ();
+
+	_nm_dbus_bind_properties (plugin, priv->dbus_vpn_service_plugin);
+	_nm_dbus_bind_methods (plugin, priv->dbus_vpn_service_plugin,
+	                       "Connect", impl_vpn_service_plugin_connect,
+	                       "ConnectInteractive", impl_vpn_service_plugin_connect_interactive,
+	                       "NeedSecrets", impl_vpn_service_plugin_need_secrets,
+	                       "NewSecrets", impl_vpn_service_plugin_new_secrets,
+	                       "Disconnect", impl_vpn_service_plugin_disconnect,
+	                       "SetConfig", impl_vpn_service_plugin_set_config,
+	                       "SetIp4Config", impl_vpn_service_plugin_set_ip4_config,
+	                       "SetIp6Config", impl_vpn_service_plugin_set_ip6_config,
+	                       "SetFailure", impl_vpn_service_plugin_set_failure,
+	                       "AddInstance", impl_vpn_service_plugin_add_instance,
+	                       NULL);
+
+	if (!g_dbus_interface_skeleton_export (G_DBUS_INTERFACE_SKELETON (priv->dbus_vpn_service_plugin),
+	                                       connection,
+	                                       path,
+	                                       error))
+		return FALSE;
+
+	nm_vpn_service_plugin_set_connection (plugin, connection);
+	nm_vpn_service_plugin_set_state (plugin, NM_VPN_SERVICE_STATE_INIT);
+	return TRUE;
+}
+
 static gboolean
 init_sync (GInitable *initable, GCancellable *cancellable, GError **error)
 {
@@ -1028,10 +1170,18 @@ init_sync (GInitable *initable, GCancellable *cancellable, GError **error)
 		return FALSE;
 	}
 
-	connection = g_bus_get_sync (G_BUS_TYPE_SYSTEM, NULL, error);
+	connection = g_bus_get_sync (_nm_dbus_bus_type (), NULL, error);
 	if (!connection)
 		return FALSE;
 
+	if (priv->dbus_object_path) {
+		/* an instance, that shares the bus name of the main plugin. */
+		return _export (plugin, connection, priv->dbus_object_path, error);
+	}
+
+	if (priv->multi_instance)
+		priv->instances = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, _instance_destroy);
+
 	proxy = g_dbus_proxy_new_sync (connection,
 	                               G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES |
 	                               G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
@@ -1043,30 +1193,9 @@ init_sync (GInitable *initable, GCancellable *cancellable, GError **error)
 	if (!proxy)
 		return FALSE;
 
-	priv->dbus_vpn_service_plugin = nmdbus_vpn_plugin_skeleton_new ();
-
-	_nm_dbus_bind_properties (plugin, priv->dbus_vpn_service_plugin);
-	_nm_dbus_bind_methods (plugin, priv->dbus_vpn_service_plugin,
-	                       "Connect", impl_vpn_service_plugin_connect,
-	                       "ConnectInteractive", impl_vpn_service_plugin_connect_interactive,
-	                       "NeedSecrets", impl_vpn_service_plugin_need_secrets,
-	                       "NewSecrets", impl_vpn_service_plugin_new_secrets,
-	                       "Disconnect", impl_vpn_service_plugin_disconnect,
-	                       "SetConfig", impl_vpn_service_plugin_set_config,
-	                       "SetIp4Config", impl_vpn_service_plugin_set_ip4_config,
-	                       "SetIp6Config", impl_vpn_service_plugin_set_ip6_config,
-	                       "SetFailure", impl_vpn_service_plugin_set_failure,
-	                       NULL);
-
-	if (!g_dbus_interface_skeleton_export (G_DBUS_INTERFACE_SKELETON (priv->dbus_vpn_service_plugin),
-	                                       connection,
-	                                       NM_VPN_DBUS_PLUGIN_PATH,
-	                                       error))
+	if (!_export (plugin, connection, NM_VPN_DBUS_PLUGIN_PATH, error))
 		return FALSE;
 
-	nm_vpn_service_plugin_set_connection (plugin, connection);
-	nm_vpn_service_plugin_set_state (plugin, NM_VPN_SERVICE_STATE_INIT);
-
 	ret = g_dbus_proxy_call_sync (proxy,
 	                              "RequestName",
 	                              g_variant_new ("(su)", priv->dbus_service_name, 0),
@@ -1097,6 +1226,14 @@ set_property (GObject *object, guint prop_id,
 		/* construct-only */
 		priv->dbus_watch_peer = g_value_get_boolean (value);
 		break;
+	case PROP_DBUS_OBJECT_PATH:
+		/* construct-only */
+		priv->dbus_object_path = g_value_dup_string (value);
+		break;
+	case PROP_MULTI_INSTANCE:
+		/* construct-only */
+		priv->multi_instance = g_value_get_boolean (value);
+		break;
 	case PROP_STATE:
 		nm_vpn_service_plugin_set_state (NM_VPN_SERVICE_PLUGIN (object),
 		                                 (NMVpnServiceState) g_value_get_enum (value));
@@ -1120,6 +1257,12 @@ get_property (GObject *object, guint prop_id,
 	case PROP_DBUS_WATCH_PEER:
 		g_value_set_boolean (value, priv->dbus_watch_peer);
 		break;
+	case PROP_DBUS_OBJECT_PATH:
+		g_value_set_string (value, priv->dbus_object_path);
+		break;
+	case PROP_MULTI_INSTANCE:
+		g_value_set_boolean (value, priv->multi_instance);
+		break;
 	case PROP_STATE:
 		g_value_set_enum (value, nm_vpn_service_plugin_get_state (NM_VPN_SERVICE_PLUGIN (object)));
 		break;
@@ -1144,6 +1287,7 @@ finalize (GObject *object)
 
 	nm_vpn_service_plugin_set_connection (plugin, NULL);
 	g_free (priv->dbus_service_name);
+	g_free (priv->dbus_object_path);
 
 	nm_clear_pointer (&priv->banner, g_variant_unref);
 	nm_clear_pointer (&priv->tundev, g_variant_unref);
@@ -1164,7 +1308,13 @@ state_changed (NMVpnServicePlugin *plugin, NMVpnServiceState state)
 		nm_clear_g_source (&priv->fail_stop_id);
 		break;
 	case NM_VPN_SERVICE_STATE_STOPPED:
-		if (priv->dbus_watch_peer)
+		if (priv->dbus_object_path) {
+			/* an instance only handles one connection. The main plugin
+			 * drops it and decides when to quit. */
+			if (   priv->main_plugin
+			    && !priv->instance_remove_id)
+				priv->instance_remove_id = g_idle_add (_instance_remove_cb, plugin);
+		} else if (priv->dbus_watch_peer)
 			nm_vpn_service_plugin_emit_quit (plugin);
 		else
 			schedule_quit_timer (plugin);
@@ -1222,6 +1372,41 @@ nm_vpn_service_plugin_class_init (NMVpnServicePluginClass *plugin_class)
 	                          G_PARAM_CONSTRUCT_ONLY |
 	                          G_PARAM_STATIC_STRINGS);
 
+	/**
+	 * NMVpnServicePlugin:object-path:
+	 *
+	 * The D-Bus object path of this plugin. This is only set for
+	 * the instances of a multi-instance plugin, which get created
+	 * by the plugin on request of NetworkManager.
+	 *
+	 * Since: 1.28
+	 */
+	obj_properties[PROP_DBUS_OBJECT_PATH] =
+	    g_param_spec_string (NM_VPN_SERVICE_PLUGIN_DBUS_OBJECT_PATH, "", "",
+	                         NULL,
+	                         G_PARAM_READWRITE |
+	                         G_PARAM_CONSTRUCT_ONLY |
+	                         G_PARAM_STATIC_STRINGS);
+
+	/**
+	 * NMVpnServicePlugin:multi-instance:
+	 *
+	 * Whether the plugin handles many connections in one process. For
+	 * each connection, a new instance of the plugin's type gets created,
+	 * with the same #NMVpnServicePlugin:service-name and
+	 * #NMVpnServicePlugin:watch-peer. The plugin should also set
+	 * "supports-instances=true" in the "VPN Connection" section of its
+	 * plugin info file, so that NetworkManager makes use of it.
+	 *
+	 * Since: 1.28
+	 */
+	obj_properties[PROP_MULTI_INSTANCE] =
+	    g_param_spec_boolean (NM_VPN_SERVICE_PLUGIN_MULTI_INSTANCE, "", "",
+	                          FALSE,
+	                          G_PARAM_READWRITE |
+	                          G_PARAM_CONSTRUCT_ONLY |
+	                          G_PARAM_STATIC_STRINGS);
+
 	/**
 	 * NMVpnServicePlugin:state:
 	 *
@@ -1316,6 +1501,25 @@ nm_vpn_service_plugin_class_init (NMVpnServicePluginClass *plugin_class)
 	                  G_TYPE_NONE, 0,
 	                  G_TYPE_NONE);
 
+	/**
+	 * NMVpnServicePlugin::instance-added:
+	 * @plugin: the main plugin
+	 * @instance: the new #NMVpnServicePlugin instance
+	 *
+	 * Emitted by a multi-instance plugin after it created a new
+	 * instance, before the instance handles any request.
+	 *
+	 * Since: 1.28
+	 */
+	signals[INSTANCE_ADDED] =
+	    g_signal_new ("instance-added",
+	                  G_OBJECT_CLASS_TYPE (object_class),
+	                  G_SIGNAL_RUN_FIRST,
+	                  0, NULL, NULL,
+	                  NULL,
+	                  G_TYPE_NONE, 1,
+	                  NM_TYPE_VPN_SERVICE_PLUGIN);
+
 	setup_unix_signal_handler ();
 }
 
@@ -26,6 +26,8 @@ G_BEGIN_DECLS
 
 #define NM_VPN_SERVICE_PLUGIN_DBUS_SERVICE_NAME "service-name"
 #define NM_VPN_SERVICE_PLUGIN_DBUS_WATCH_PEER   "watch-peer"
+#define NM_VPN_SERVICE_PLUGIN_DBUS_OBJECT_PATH  "object-path"
+#define NM_VPN_SERVICE_PLUGIN_MULTI_INSTANCE    "multi-instance"
 #define NM_VPN_SERVICE_PLUGIN_STATE             "state"
 
 /**
@@ -11,6 +11,8 @@
 
 #include <sys/mman.h>
 
+#include "nm-glib-aux/nm-dbus-aux.h"
+
 #include "NetworkManager.h"
 #include "nm-access-point.h"
 #include "nm-checkpoint.h"
@@ -3110,15 +3112,250 @@ test_nm_auth_permissions (void)
 
 /*****************************************************************************/
 
+static void
+test_nm_vpn_plugin_info_supports_instances (void)
+{
+	static const char *const values[] = { NULL, "false", "true", };
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (values); i++) {
+		gs_unref_keyfile GKeyFile *keyfile = g_key_file_new ();
+		gs_unref_object NMVpnPluginInfo *info = NULL;
+		gs_free_error GError *error = NULL;
+
+		g_key_file_set_string (keyfile, NM_VPN_PLUGIN_INFO_KF_GROUP_CONNECTION, "name", "test");
+		g_key_file_set_string (keyfile, NM_VPN_PLUGIN_INFO_KF_GROUP_CONNECTION, "service", "org.freedesktop.NetworkManager.test");
+		if (values[i])
+			g_key_file_set_string (keyfile, NM_VPN_PLUGIN_INFO_KF_GROUP_CONNECTION, "supports-instances", values[i]);
+
+		info = nm_vpn_plugin_info_new_with_data (NULL, keyfile, &error);
+		nmtst_assert_success (info, error);
+		g_assert_cmpint (nm_vpn_plugin_info_supports_instances (info), ==, nm_streq0 (values[i], "true"));
+	}
+}
+
+/*****************************************************************************/
+
+#define TEST_VPN_SERVICE_NAME "org.freedesktop.NetworkManager.test-vpn-instances"
+
+typedef NMVpnServicePlugin      TestVpnPlugin;
+typedef NMVpnServicePluginClass TestVpnPluginClass;
+
+GType test_vpn_plugin_get_type (void);
+
+G_DEFINE_TYPE (TestVpnPlugin, test_vpn_plugin, NM_TYPE_VPN_SERVICE_PLUGIN)
+
+static gboolean
+test_vpn_plugin_connect (NMVpnServicePlugin *plugin,
+                         NMConnection *connection,
+                         GError **error)
+{
+	g_set_error_literal (error, NM_VPN_PLUGIN_ERROR, NM_VPN_PLUGIN_ERROR_FAILED, "not implemented");
+	return FALSE;
+}
+
+static gboolean
+test_vpn_plugin_disconnect (NMVpnServicePlugin *plugin,
+                            GError **error)
+{
+	return TRUE;
+}
+
+static void
+test_vpn_plugin_init (TestVpnPlugin *plugin)
+{
+}
+
+static void
+test_vpn_plugin_class_init (TestVpnPluginClass *klass)
+{
+	klass->connect = test_vpn_plugin_connect;
+	klass->disconnect = test_vpn_plugin_disconnect;
+}
+
+typedef struct {
+	GVariant *result;
+	GError *error;
+	bool done:1;
+} VpnCallData;
+
+static void
+_vpn_call_cb (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+	VpnCallData *data = user_data;
+
+	data->result = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source), result, &data->error);
+	data->done = TRUE;
+}
+
+/* the plugin handles the call on the main context, so we cannot block
+ * on the reply. */
+static GVariant *
+_vpn_call (GDBusConnection *bus,
+           const char *path,
+           const char *interface_name,
+           const char *method_name,
+           GVariant *parameters,
+           GError **error)
+{
+	VpnCallData data = { };
+
+	g_dbus_connection_call (bus,
+	                        TEST_VPN_SERVICE_NAME,
+	                        path,
+	                        interface_name,
+	                        method_name,
+	                        parameters,
+	                        NULL,
+	                        G_DBUS_CALL_FLAGS_NONE,
+	                        -1,
+	                        NULL,
+	                        _vpn_call_cb,
+	                        &data);
+	nmtst_main_context_iterate_until_assert (NULL, 5000, data.done);
+
+	if (data.error)
+		g_propagate_error (error, data.error);
+	return data.result;
+}
+
+static gboolean
+_vpn_is_exported (GDBusConnection *bus, const char *path)
+{
+	gs_unref_variant GVariant *ret = NULL;
+	gs_free_error GError *error = NULL;
+
+	ret = _vpn_call (bus,
+	                 path,
+	                 DBUS_INTERFACE_PROPERTIES,
+	                 "Get",
+	                 g_variant_new ("(ss)", NM_VPN_DBUS_PLUGIN_INTERFACE, "State"),
+	                 &error);
+	g_assert (!ret == !!error);
+	return !!ret;
+}
+
+static void
+_vpn_instance_added_cb (NMVpnServicePlugin *plugin,
+                        NMVpnServicePlugin *instance,
+                        gpointer user_data)
+{
+	GPtrArray *instances = user_data;
+
+	g_assert (G_OBJECT_TYPE (instance) == G_OBJECT_TYPE (plugin));
+	g_ptr_array_add (instances, instance);
+}
+
+static void
+test_nm_vpn_service_plugin_instances (void)
+{
+	static const char *const paths[] = {
+		NM_VPN_DBUS_PLUGIN_PATH "/1",
+		NM_VPN_DBUS_PLUGIN_PATH "/2",
+	};
+	gs_unref_object GDBusConnection *bus = NULL;
+	gs_unref_object NMVpnServicePlugin *plugin = NULL;
+	gs_unref_ptrarray GPtrArray *instances = g_ptr_array_new ();
+	NMVpnServicePlugin *weak[G_N_ELEMENTS (paths)];
+	gs_free char *address = NULL;
+	gs_free_error GError *error = NULL;
+	GVariant *ret;
+	guint i;
+
+	address = g_dbus_address_get_for_bus_sync (G_BUS_TYPE_SESSION, NULL, NULL);
+	if (address) {
+		bus = g_dbus_connection_new_for_address_sync (address,
+		                                              G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT
+		                                              | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+		                                              NULL,
+		                                              NULL,
+		                                              NULL);
+	}
+	if (!bus) {
+		g_test_skip ("no D-Bus session bus");
+		return;
+	}
+
+	plugin = g_initable_new (test_vpn_plugin_get_type (), NULL, &error,
+	                         NM_VPN_SERVICE_PLUGIN_DBUS_SERVICE_NAME, TEST_VPN_SERVICE_NAME,
+	                         NM_VPN_SERVICE_PLUGIN_MULTI_INSTANCE, TRUE,
+	                         NULL);
+	nmtst_assert_success (plugin, error);
+	g_signal_connect (plugin, "instance-added", G_CALLBACK (_vpn_instance_added_cb), instances);
+	g_assert (!nmtst_vpn_service_plugin_has_quit_timer (plugin));
+
+	for (i = 0; i < G_N_ELEMENTS (paths); i++) {
+		ret = _vpn_call (bus,
+		                 NM_VPN_DBUS_PLUGIN_PATH,
+		                 NM_VPN_DBUS_PLUGIN_INTERFACE,
+		                 "AddInstance",
+		                 g_variant_new ("(o)", paths[i]),
+		                 &error);
+		nmtst_assert_success (ret, error);
+		g_variant_unref (ret);
+
+		g_assert_cmpint (instances->len, ==, i + 1);
+		weak[i] = instances->pdata[i];
+		g_object_add_weak_pointer (G_OBJECT (weak[i]), (gpointer *) &weak[i]);
+	}
+
+	/* each instance is exported at its own path, under the common name. */
+	g_assert (weak[0] != weak[1]);
+	for (i = 0; i < G_N_ELEMENTS (paths); i++) {
+		gs_free char *path = NULL;
+
+		g_object_get (weak[i], NM_VPN_SERVICE_PLUGIN_DBUS_OBJECT_PATH, &path, NULL);
+		g_assert_cmpstr (path, ==, paths[i]);
+		g_assert (_vpn_is_exported (bus, paths[i]));
+	}
+	g_assert_cmpstr (paths[0], !=, paths[1]);
+	g_assert (_vpn_is_exported (bus, NM_VPN_DBUS_PLUGIN_PATH));
+
+	/* the same path cannot be added twice. */
+	ret = _vpn_call (bus,
+	                 NM_VPN_DBUS_PLUGIN_PATH,
+	                 NM_VPN_DBUS_PLUGIN_INTERFACE,
+	                 "AddInstance",
+	                 g_variant_new ("(o)", paths[0]),
+	                 &error);
+	g_assert (!ret);
+	g_assert (error);
+	g_clear_error (&error);
+	g_assert_cmpint (instances->len, ==, G_N_ELEMENTS (paths));
+
+	/* a stopped instance is dropped and unexported, but the main plugin
+	 * keeps running while other instances remain. */
+	nm_vpn_service_plugin_set_state (weak[0], NM_VPN_SERVICE_STATE_STOPPED);
+	nmtst_main_context_iterate_until_assert (NULL, 5000, !weak[0]);
+	g_assert (!_vpn_is_exported (bus, paths[0]));
+	g_assert (_vpn_is_exported (bus, paths[1]));
+	g_assert (!nmtst_vpn_service_plugin_has_quit_timer (plugin));
+
+	/* the quit timer is only armed once the last instance is gone. */
+	nm_vpn_service_plugin_set_state (weak[1], NM_VPN_SERVICE_STATE_STOPPED);
+	nmtst_main_context_iterate_until_assert (NULL, 5000, !weak[1]);
+	g_assert (!_vpn_is_exported (bus, paths[1]));
+	g_assert (_vpn_is_exported (bus, NM_VPN_DBUS_PLUGIN_PATH));
+	g_assert (nmtst_vpn_service_plugin_has_quit_timer (plugin));
+
+	nm_vpn_service_plugin_shutdown (plugin);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int main (int argc, char **argv)
 {
+	g_setenv ("LIBNM_USE_SESSION_BUS", "1", TRUE);
+
 	nmtst_init (&argc, &argv, TRUE);
 
 	g_test_add_func ("/libnm/general/fixup_product_string", test_fixup_product_string);
 	g_test_add_func ("/libnm/general/fixup_vendor_string", test_fixup_vendor_string);
 	g_test_add_func ("/libnm/general/nm_vpn_service_plugin_read_vpn_details", test_nm_vpn_service_plugin_read_vpn_details);
+	g_test_add_func ("/libnm/general/nm_vpn_plugin_info_supports_instances", test_nm_vpn_plugin_info_supports_instances);
+	g_test_add_func ("/libnm/general/nm_vpn_service_plugin_instances", test_nm_vpn_service_plugin_instances);
 	g_test_add_func ("/libnm/general/test_types", test_types);
 	g_test_add_func ("/libnm/general/test_nml_dbus_meta", test_nml_dbus_meta);
 	g_test_add_func ("/libnm/general/test_dbus_meta_types", test_dbus_meta_types);
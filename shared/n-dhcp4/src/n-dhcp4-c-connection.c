@@ -159,7 +159,22 @@ int n_dhcp4_c_connection_listen(NDhcp4CConnection *connection) {
                 connection->fd_udp = c_close(connection->fd_udp);
         }
 
-        r = n_dhcp4_c_socket_packet_new(&fd_packet, connection->client_config->ifindex);
+        /*
+         * On ethernet, replies carry our hardware address in 'chaddr', so let
+         * the kernel drop replies to other clients on the same segment. This
+         * avoids waking up every client for every broadcast reply, in case a
+         * large number of clients share the same broadcast domain.
+         */
+        if (connection->client_config->transport == N_DHCP4_TRANSPORT_ETHERNET)
+                r = n_dhcp4_c_socket_packet_new(&fd_packet,
+                                                connection->client_config->ifindex,
+                                                connection->client_config->mac,
+                                                connection->client_config->n_mac);
+        else
+                r = n_dhcp4_c_socket_packet_new(&fd_packet,
+                                                connection->client_config->ifindex,
+                                                NULL,
+                                                0);
         if (r)
                 return r;
 
@@ -271,6 +286,26 @@ static int n_dhcp4_c_connection_verify_incoming(NDhcp4CConnection *connection,
                 if (header->xid != request_xid)
                         return N_DHCP4_E_UNEXPECTED;
 
+                /*
+                 * An ACK in reply to a DISCOVER is only valid if we asked for
+                 * rapid commit, and the server confirms it (RFC 4039). Drop
+                 * anything else here, as an accepted ACK ends the transaction
+                 * and we would no longer accept any OFFER.
+                 */
+                if (type == N_DHCP4_MESSAGE_ACK &&
+                    connection->request->userdata.type == N_DHCP4_C_MESSAGE_DISCOVER) {
+                        if (!connection->probe_config->rapid_commit)
+                                return N_DHCP4_E_UNEXPECTED;
+
+                        r = n_dhcp4_incoming_query(message, N_DHCP4_OPTION_RAPID_COMMIT, NULL, NULL);
+                        if (r) {
+                                if (r == N_DHCP4_E_UNSET)
+                                        return N_DHCP4_E_UNEXPECTED;
+                                else
+                                        return r;
+                        }
+                }
+
                 break;
         case N_DHCP4_MESSAGE_FORCERENEW:
                 /*
@@ -116,6 +116,7 @@ int n_dhcp4_client_probe_config_dup(NDhcp4ClientProbeConfig *config,
 
         dup->inform_only = config->inform_only;
         dup->init_reboot = config->init_reboot;
+        dup->rapid_commit = config->rapid_commit;
         dup->requested_ip = config->requested_ip;
         dup->ms_start_delay = config->ms_start_delay;
 
@@ -190,6 +191,24 @@ _c_public_ void n_dhcp4_client_probe_config_set_init_reboot(NDhcp4ClientProbeCon
         config->init_reboot = init_reboot;
 }
 
+/**
+ * n_dhcp4_client_probe_config_set_rapid_commit() - set rapid-commit property
+ * @config:                     configuration to operate on
+ * @rapid_commit:               value to set
+ *
+ * This sets the rapid-commit property of the given configuration object.
+ *
+ * The default is false. If set to true, the client includes the Rapid Commit
+ * option (RFC 4039) in its DISCOVER messages. A server supporting the option
+ * may then reply directly with an ACK, rather than an OFFER. Such an ACK is
+ * granted right away, saving one roundtrip. Servers that do not support the
+ * option simply ignore it, and the client proceeds with the regular
+ * OFFER/REQUEST exchange.
+ */
+_c_public_ void n_dhcp4_client_probe_config_set_rapid_commit(NDhcp4ClientProbeConfig *config, bool rapid_commit) {
+        config->rapid_commit = rapid_commit;
+}
+
 /**
  * n_dhcp4_client_probe_config_set_requested_ip() - set requested-ip property
  * @config:                     configuration to operate on
@@ -705,6 +724,12 @@ static int n_dhcp4_client_probe_transition_deferred(NDhcp4ClientProbe *probe, ui
                                 return r;
                 }
 
+                if (probe->config->rapid_commit) {
+                        r = n_dhcp4_outgoing_append(request, N_DHCP4_OPTION_RAPID_COMMIT, NULL, 0);
+                        if (r)
+                                return r;
+                }
+
                 r = n_dhcp4_client_probe_outgoing_append_options(probe, request);
                 if (r)
                         return r;
@@ -949,6 +974,22 @@ static int n_dhcp4_client_probe_transition_ack(NDhcp4ClientProbe *probe, NDhcp4I
                 probe->ns_nak_restart_delay = 0;
                 break;
 
+        case N_DHCP4_CLIENT_PROBE_STATE_SELECTING:
+                /*
+                 * An ACK in reply to a DISCOVER is only valid if we asked for
+                 * rapid commit, and the server confirms it (RFC 4039).
+                 */
+                if (!probe->config->rapid_commit)
+                        break;
+
+                r = n_dhcp4_incoming_query(message, N_DHCP4_OPTION_RAPID_COMMIT, NULL, NULL);
+                if (r) {
+                        if (r == N_DHCP4_E_UNSET)
+                                break;
+                        return r;
+                }
+
+                /* fall-through */
         case N_DHCP4_CLIENT_PROBE_STATE_REQUESTING:
         case N_DHCP4_CLIENT_PROBE_STATE_REBOOTING:
 
@@ -973,7 +1014,6 @@ static int n_dhcp4_client_probe_transition_ack(NDhcp4ClientProbe *probe, NDhcp4I
                 break;
 
         case N_DHCP4_CLIENT_PROBE_STATE_INIT:
-        case N_DHCP4_CLIENT_PROBE_STATE_SELECTING:
         case N_DHCP4_CLIENT_PROBE_STATE_INIT_REBOOT:
         case N_DHCP4_CLIENT_PROBE_STATE_BOUND:
         case N_DHCP4_CLIENT_PROBE_STATE_GRANTED:
@@ -73,6 +73,7 @@ enum {
         N_DHCP4_OPTION_REBINDING_T2_TIME                = 59,
         N_DHCP4_OPTION_VENDOR_CLASS_IDENTIFIER          = 60,
         N_DHCP4_OPTION_CLIENT_IDENTIFIER                = 61,
+        N_DHCP4_OPTION_RAPID_COMMIT                     = 80,
         N_DHCP4_OPTION_FQDN                             = 81,
         N_DHCP4_OPTION_NEW_POSIX_TIMEZONE               = 100,
         N_DHCP4_OPTION_NEW_TZDB_TIMEZONE                = 101,
@@ -262,6 +263,7 @@ struct NDhcp4ClientProbeOption {
 struct NDhcp4ClientProbeConfig {
         bool inform_only;
         bool init_reboot;
+        bool rapid_commit;
         struct in_addr requested_ip;
         unsigned short int entropy[3];
         uint64_t ms_start_delay;        /* max ms to wait before starting probe */
@@ -538,7 +540,7 @@ void n_dhcp4_incoming_get_yiaddr(NDhcp4Incoming *message, struct in_addr *yiaddr
 
 /* sockets */
 
-int n_dhcp4_c_socket_packet_new(int *sockfdp, int ifindex);
+int n_dhcp4_c_socket_packet_new(int *sockfdp, int ifindex, const uint8_t *chaddr, size_t n_chaddr);
 int n_dhcp4_c_socket_udp_new(int *sockfdp,
                              int ifindex,
                              const struct in_addr *client_addr,
@@ -24,6 +24,8 @@
  * n_dhcp4_c_socket_packet_new() - create a new DHCP4 client packet socket
  * @sockfdp:            return argument for the new socket
  * @ifindex:            interface index to bind to
+ * @chaddr:             client hardware address to filter on, or NULL
+ * @n_chaddr:           length of @chaddr
  *
  * Create a new AF_PACKET/SOCK_DGRAM socket usable to listen to and send DHCP client
  * packets before an IP address has been configured.
@@ -31,10 +33,24 @@
  * Only unfragmented DHCP packets from a server to a client destined for the given
  * ifindex is returned.
  *
+ * If @chaddr is an ethernet address (@n_chaddr is ETH_ALEN), the socket filter
+ * additionally drops all replies whose 'chaddr' field does not match it. Many
+ * clients sharing one broadcast domain (e.g., macvlan or ipvlan links on the
+ * same parent) thereby only get woken up for replies destined to themselves,
+ * rather than for every broadcast reply on the segment. Other hardware address
+ * lengths are not filtered in the kernel.
+ *
  * Return: 0 on success, or a negative error code on failure.
  */
-int n_dhcp4_c_socket_packet_new(int *sockfdp, int ifindex) {
+int n_dhcp4_c_socket_packet_new(int *sockfdp, int ifindex, const uint8_t *chaddr, size_t n_chaddr) {
         _c_cleanup_(c_closep) int sockfd = -1;
+        bool filter_chaddr = chaddr && n_chaddr == ETH_ALEN;
+        uint32_t chaddr_hi = filter_chaddr ? ((uint32_t)chaddr[0] << 24 |
+                                              (uint32_t)chaddr[1] << 16 |
+                                              (uint32_t)chaddr[2] << 8 |
+                                              (uint32_t)chaddr[3]) : 0;
+        uint32_t chaddr_lo = filter_chaddr ? ((uint32_t)chaddr[4] << 8 |
+                                              (uint32_t)chaddr[5]) : 0;
         struct sock_filter filter[] = {
                 /*
                  * IP
@@ -92,6 +108,28 @@ int n_dhcp4_c_socket_packet_new(int *sockfdp, int ifindex) {
                 BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, N_DHCP4_MESSAGE_MAGIC, 1, 0),                               /* cookie == DHCP magic cookie ? */
                 BPF_STMT(BPF_RET + BPF_K, 0),                                                                   /* ignore */
 
+                /*
+                 * Client hardware address
+                 *
+                 * Check
+                 *  - 'hlen' and 'chaddr' match our ethernet address
+                 *
+                 * The whole block is skipped if no address was given.
+                 */
+                BPF_STMT(BPF_JMP + BPF_JA, filter_chaddr ? 0 : 9),                                              /* skip chaddr checks ? */
+
+                BPF_STMT(BPF_LD + BPF_B + BPF_IND, offsetof(NDhcp4Header, hlen)),                               /* A <- DHCP hlen */
+                BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, ETH_ALEN, 1, 0),                                            /* hlen == ETH_ALEN ? */
+                BPF_STMT(BPF_RET + BPF_K, 0),                                                                   /* ignore */
+
+                BPF_STMT(BPF_LD + BPF_W + BPF_IND, offsetof(NDhcp4Header, chaddr)),                             /* A <- chaddr[0..3] */
+                BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, chaddr_hi, 1, 0),                                           /* chaddr[0..3] matches ? */
+                BPF_STMT(BPF_RET + BPF_K, 0),                                                                   /* ignore */
+
+                BPF_STMT(BPF_LD + BPF_H + BPF_IND, offsetof(NDhcp4Header, chaddr) + 4),                         /* A <- chaddr[4..5] */
+                BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, chaddr_lo, 1, 0),                                           /* chaddr[4..5] matches ? */
+                BPF_STMT(BPF_RET + BPF_K, 0),                                                                   /* ignore */
+
                 BPF_STMT(BPF_RET + BPF_K, 65535),                                                               /* return all */
         };
         struct sock_fprog fprog = {
@@ -77,6 +77,7 @@ static void test_api_functions(void) {
                 (void *)n_dhcp4_client_probe_config_freev,
                 (void *)n_dhcp4_client_probe_config_set_inform_only,
                 (void *)n_dhcp4_client_probe_config_set_init_reboot,
+                (void *)n_dhcp4_client_probe_config_set_rapid_commit,
                 (void *)n_dhcp4_client_probe_config_set_requested_ip,
                 (void *)n_dhcp4_client_probe_config_set_start_delay,
                 (void *)n_dhcp4_client_probe_config_request_option,
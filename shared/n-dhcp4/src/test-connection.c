@@ -78,6 +78,24 @@ static void test_c_connection_connect(int netns,
         netns_set(oldns);
 }
 
+static void test_client_dispatch(int netns, NDhcp4Client *client) {
+        struct pollfd pfd = { .events = POLLIN };
+        int r, oldns;
+
+        n_dhcp4_client_get_fd(client, &pfd.fd);
+        r = poll(&pfd, 1, -1);
+        c_assert(r == 1);
+        c_assert(pfd.revents == POLLIN);
+
+        netns_get(&oldns);
+        netns_set(netns);
+
+        r = n_dhcp4_client_dispatch(client);
+        c_assert(!r || r == N_DHCP4_E_PREEMPTED);
+
+        netns_set(oldns);
+}
+
 static void test_server_receive(NDhcp4SConnection *connection, uint8_t expected_type, NDhcp4Incoming **messagep) {
         _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *message = NULL;
         uint8_t received_type;
@@ -381,10 +399,149 @@ static void test_connection(void) {
         link_del_ip4(&link_server, &addr_server, 8);
 }
 
+static void test_rapid_commit(bool rapid_commit) {
+        const struct in_addr addr_server = (struct in_addr){ htonl(10 << 24 | 1) };
+        const struct in_addr addr_client = (struct in_addr){ htonl(10 << 24 | 2) };
+        _c_cleanup_(netns_closep) int ns_server = -1, ns_client = -1;
+        _c_cleanup_(link_deinit) Link link_server = LINK_NULL(link_server);
+        _c_cleanup_(link_deinit) Link link_client = LINK_NULL(link_client);
+        _c_cleanup_(n_dhcp4_client_config_freep) NDhcp4ClientConfig *client_config = NULL;
+        _c_cleanup_(n_dhcp4_client_probe_config_freep) NDhcp4ClientProbeConfig *probe_config = NULL;
+        _c_cleanup_(n_dhcp4_client_unrefp) NDhcp4Client *client = NULL;
+        _c_cleanup_(n_dhcp4_client_probe_freep) NDhcp4ClientProbe *probe = NULL;
+        _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *request_in = NULL;
+        NDhcp4SConnection connection_server = N_DHCP4_S_CONNECTION_NULL(connection_server);
+        NDhcp4SConnectionIp connection_server_ip = N_DHCP4_S_CONNECTION_IP_NULL(connection_server_ip);
+        NDhcp4ClientEvent *event;
+        int r;
+
+        /* setup */
+
+        netns_new(&ns_server);
+        netns_new(&ns_client);
+
+        link_new_veth(&link_server, &link_client, ns_server, ns_client);
+        link_add_ip4(&link_server, &addr_server, 8);
+
+        test_s_connection_init(ns_server, &connection_server, link_server.ifindex);
+        n_dhcp4_s_connection_ip_init(&connection_server_ip, addr_server);
+        n_dhcp4_s_connection_ip_link(&connection_server_ip, &connection_server);
+
+        r = n_dhcp4_client_config_new(&client_config);
+        c_assert(!r);
+
+        n_dhcp4_client_config_set_ifindex(client_config, link_client.ifindex);
+        n_dhcp4_client_config_set_transport(client_config, N_DHCP4_TRANSPORT_ETHERNET);
+        n_dhcp4_client_config_set_request_broadcast(client_config, false);
+        n_dhcp4_client_config_set_mac(client_config, link_client.mac.ether_addr_octet, ETH_ALEN);
+        n_dhcp4_client_config_set_broadcast_mac(client_config,
+                                                (const uint8_t[]){
+                                                        0xff, 0xff, 0xff,
+                                                        0xff, 0xff, 0xff,
+                                                },
+                                                ETH_ALEN);
+        r = n_dhcp4_client_config_set_client_id(client_config,
+                                                (void *)"client-id",
+                                                strlen("client-id"));
+        c_assert(!r);
+
+        r = n_dhcp4_client_new(&client, client_config);
+        c_assert(!r);
+
+        r = n_dhcp4_client_probe_config_new(&probe_config);
+        c_assert(!r);
+
+        n_dhcp4_client_probe_config_set_start_delay(probe_config, 1);
+        n_dhcp4_client_probe_config_set_rapid_commit(probe_config, rapid_commit);
+
+        r = n_dhcp4_client_probe(client, &probe, probe_config);
+        c_assert(!r);
+
+        /* the DISCOVER carries option 80 only if rapid commit was requested */
+
+        test_client_dispatch(ns_client, client);
+        test_server_receive(&connection_server, N_DHCP4_MESSAGE_DISCOVER, &request_in);
+
+        r = n_dhcp4_incoming_query(request_in, N_DHCP4_OPTION_RAPID_COMMIT, NULL, NULL);
+        c_assert(rapid_commit ? !r : r == N_DHCP4_E_UNSET);
+
+        /* an ACK without option 80 is ignored in SELECTING */
+        {
+                _c_cleanup_(n_dhcp4_outgoing_freep) NDhcp4Outgoing *reply = NULL;
+
+                r = n_dhcp4_s_connection_ack_new(&connection_server, &reply, request_in, &addr_server, &addr_client, 60);
+                c_assert(!r);
+
+                r = n_dhcp4_s_connection_send_reply(&connection_server, &addr_server, reply);
+                c_assert(!r);
+
+                test_client_dispatch(ns_client, client);
+
+                r = n_dhcp4_client_pop_event(client, &event);
+                c_assert(!r);
+                c_assert(!event);
+        }
+
+        /* an ACK with option 80 grants the lease, if rapid commit was requested */
+        {
+                _c_cleanup_(n_dhcp4_outgoing_freep) NDhcp4Outgoing *reply = NULL;
+
+                r = n_dhcp4_s_connection_ack_new(&connection_server, &reply, request_in, &addr_server, &addr_client, 60);
+                c_assert(!r);
+
+                r = n_dhcp4_outgoing_append(reply, N_DHCP4_OPTION_RAPID_COMMIT, NULL, 0);
+                c_assert(!r);
+
+                r = n_dhcp4_s_connection_send_reply(&connection_server, &addr_server, reply);
+                c_assert(!r);
+
+                test_client_dispatch(ns_client, client);
+
+                r = n_dhcp4_client_pop_event(client, &event);
+                c_assert(!r);
+                if (rapid_commit) {
+                        c_assert(event);
+                        c_assert(event->event == N_DHCP4_CLIENT_EVENT_GRANTED);
+                        c_assert(event->granted.probe == probe);
+                } else {
+                        c_assert(!event);
+                }
+        }
+
+        /* an ignored ACK does not end the transaction, OFFERs are still accepted */
+        if (!rapid_commit) {
+                _c_cleanup_(n_dhcp4_outgoing_freep) NDhcp4Outgoing *reply = NULL;
+
+                r = n_dhcp4_s_connection_offer_new(&connection_server, &reply, request_in, &addr_server, &addr_client, 60);
+                c_assert(!r);
+
+                r = n_dhcp4_s_connection_send_reply(&connection_server, &addr_server, reply);
+                c_assert(!r);
+
+                test_client_dispatch(ns_client, client);
+
+                r = n_dhcp4_client_pop_event(client, &event);
+                c_assert(!r);
+                c_assert(event);
+                c_assert(event->event == N_DHCP4_CLIENT_EVENT_OFFER);
+                c_assert(event->offer.probe == probe);
+        }
+
+        /* teardown */
+
+        probe = n_dhcp4_client_probe_free(probe);
+        n_dhcp4_s_connection_ip_unlink(&connection_server_ip);
+        n_dhcp4_s_connection_ip_deinit(&connection_server_ip);
+        n_dhcp4_s_connection_deinit(&connection_server);
+        link_del_ip4(&link_server, &addr_server, 8);
+}
+
 int main(int argc, char **argv) {
         test_setup();
 
         test_connection();
+        test_rapid_commit(false);
+        test_rapid_commit(true);
 
         return 0;
 }
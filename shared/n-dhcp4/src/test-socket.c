@@ -31,7 +31,19 @@ static void test_client_packet_socket_new(Link *link, int *skp) {
         netns_get(&oldns);
         netns_set(link->netns);
 
-        r = n_dhcp4_c_socket_packet_new(skp, link->ifindex);
+        r = n_dhcp4_c_socket_packet_new(skp, link->ifindex, NULL, 0);
+        c_assert(r >= 0);
+
+        netns_set(oldns);
+}
+
+static void test_client_packet_socket_new_chaddr(Link *link, int *skp, const uint8_t *chaddr) {
+        int r, oldns;
+
+        netns_get(&oldns);
+        netns_set(link->netns);
+
+        r = n_dhcp4_c_socket_packet_new(skp, link->ifindex, chaddr, ETH_ALEN);
         c_assert(r >= 0);
 
         netns_set(oldns);
@@ -208,6 +220,81 @@ static void test_server_client_packet(Link *link_server, Link *link_client) {
         link_del_ip4(link_server, &addr_server, 8);
 }
 
+static void test_server_client_packet_chaddr(Link *link_server, Link *link_client) {
+        struct in_addr addr_client = (struct in_addr){ htonl(10 << 24 | 2) };
+        struct in_addr addr_server = (struct in_addr){ htonl(10 << 24 | 1) };
+        int sk_clients[64];
+        _c_cleanup_(c_closep) int sk_server = -1;
+        uint8_t buf[UINT16_MAX];
+        size_t i;
+        int r;
+
+        /* setup */
+
+        link_add_ip4(link_server, &addr_server, 8);
+
+        /*
+         * Open many client packet sockets on the same link, each filtering on
+         * a different client hardware address, and broadcast one reply per
+         * address. Every socket must see exactly its own reply.
+         */
+
+        for (i = 0; i < C_ARRAY_SIZE(sk_clients); ++i)
+                test_client_packet_socket_new_chaddr(link_client,
+                                                     &sk_clients[i],
+                                                     (const uint8_t[]){ 0x02, 0x00, 0x00, 0x00, 0x00, i });
+
+        test_server_packet_socket_new(link_server, &sk_server);
+
+        for (i = 0; i < C_ARRAY_SIZE(sk_clients); ++i) {
+                _c_cleanup_(n_dhcp4_outgoing_freep) NDhcp4Outgoing *outgoing = NULL;
+                NDhcp4Header *header;
+
+                r = n_dhcp4_outgoing_new(&outgoing, 0, 0);
+                c_assert(!r);
+                header = n_dhcp4_outgoing_get_header(outgoing);
+                header->op = N_DHCP4_OP_BOOTREPLY;
+                header->hlen = ETH_ALEN;
+                memcpy(header->chaddr, (const uint8_t[]){ 0x02, 0x00, 0x00, 0x00, 0x00, i }, ETH_ALEN);
+
+                r = n_dhcp4_s_socket_packet_send(sk_server,
+                                                 link_server->ifindex,
+                                                 &addr_server,
+                                                 (const unsigned char[]){
+                                                        0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+                                                 },
+                                                 ETH_ALEN,
+                                                 &addr_client,
+                                                 outgoing);
+                c_assert(!r);
+        }
+
+        /* the last reply was queued after all others, wait for it */
+        test_poll(sk_clients[C_ARRAY_SIZE(sk_clients) - 1]);
+
+        for (i = 0; i < C_ARRAY_SIZE(sk_clients); ++i) {
+                _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *incoming1 = NULL, *incoming2 = NULL;
+
+                test_poll(sk_clients[i]);
+
+                r = n_dhcp4_c_socket_packet_recv(sk_clients[i], buf, sizeof(buf), &incoming1);
+                c_assert(!r);
+                c_assert(incoming1);
+                c_assert(n_dhcp4_incoming_get_header(incoming1)->chaddr[5] == i);
+
+                r = n_dhcp4_c_socket_packet_recv(sk_clients[i], buf, sizeof(buf), &incoming2);
+                c_assert(r == N_DHCP4_E_AGAIN);
+                c_assert(!incoming2);
+        }
+
+        /* teardown */
+
+        for (i = 0; i < C_ARRAY_SIZE(sk_clients); ++i)
+                c_close(sk_clients[i]);
+
+        link_del_ip4(link_server, &addr_server, 8);
+}
+
 static void test_server_client_udp(Link *link_server, Link *link_client) {
         _c_cleanup_(n_dhcp4_outgoing_freep) NDhcp4Outgoing *outgoing = NULL;
         _c_cleanup_(n_dhcp4_incoming_freep) NDhcp4Incoming *incoming = NULL;
@@ -265,6 +352,7 @@ static void test_sockets(void) {
         test_client_server_packet(&link_server, &link_client);
         test_client_server_udp(&link_server, &link_client);
         test_server_client_packet(&link_server, &link_client);
+        test_server_client_packet_chaddr(&link_server, &link_client);
         test_server_client_udp(&link_server, &link_client);
 }
 
@@ -69,7 +69,7 @@ struct _NMBluez5DunContext {
 #define _NMLOG_PREFIX_NAME "bluez"
 #define _NMLOG(level, context, ...) \
     G_STMT_START { \
-        if (nm_logging_enabled ((level), (_NMLOG_DOMAIN))) { \
+        if (nm_log_enabled ((level), (_NMLOG_DOMAIN))) { \
             const NMBluez5DunContext *const _context = (context); \
             \
             _nm_log ((level), (_NMLOG_DOMAIN), 0, NULL, NULL, \
@@ -23,7 +23,7 @@ _nm_device_log_self_to_device (t *self) \
 		const NMLogLevel _level = (level); \
 		const NMLogDomain _domain = (domain); \
 		\
-		if (nm_logging_enabled (_level, _domain)) { \
+		if (nm_log_enabled (_level, _domain)) { \
 			typeof (*self) *const _self = (self); \
 			const char *const _ifname = _nm_device_get_iface (_nm_device_log_self_to_device (_self)); \
 			\
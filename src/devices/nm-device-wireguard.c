@@ -105,6 +105,12 @@ typedef struct {
 
 	/* dirty flag used during _peers_update_all(). */
 	bool dirty_update_all:1;
+
+	/* the peer was added or changed, and is not yet configured in the kernel. */
+	bool dirty_platform:1;
+
+	/* the resolved endpoint changed, and is not yet configured in the kernel. */
+	bool dirty_endpoint:1;
 } PeerData;
 
 NM_GOBJECT_PROPERTIES_DEFINE (NMDeviceWireGuard,
@@ -139,6 +145,10 @@ typedef struct {
 	bool auto_default_route_refresh:1;
 	bool auto_default_route_priority_initialized:1;
 
+	/* whether the peers in the kernel might not match our view, so that the
+	 * next reapply must replace all peers instead of only updating the changed ones. */
+	bool peers_need_full_sync:1;
+
 } NMDeviceWireGuardPrivate;
 
 struct _NMDeviceWireGuard {
@@ -760,8 +770,10 @@ _peers_resolve_cb (GObject *source_object,
 		 * anyway. Either the IP address is still good (and we would wrongly
 		 * reject it), or it isn't -- in which case it does not hurt much. */
 	} else {
-		if (nm_sock_addr_union_cmp (&peer_data->ep_resolv.sockaddr, &sockaddr) != 0)
+		if (nm_sock_addr_union_cmp (&peer_data->ep_resolv.sockaddr, &sockaddr) != 0) {
 			changed = TRUE;
+			peer_data->dirty_endpoint = TRUE;
+		}
 		peer_data->ep_resolv.sockaddr = sockaddr;
 	}
 
@@ -950,13 +962,13 @@ _peers_remove_all (NMDeviceWireGuardPrivate *priv)
 static void
 _peers_update_all (NMDeviceWireGuard *self,
                    NMSettingWireGuard *s_wg,
-                   gboolean *out_peers_removed)
+                   GPtrArray **out_removed_public_keys)
 {
 	NMDeviceWireGuardPrivate *priv = NM_DEVICE_WIREGUARD_GET_PRIVATE (self);
+	gs_unref_ptrarray GPtrArray *removed_public_keys = NULL;
 	PeerData *peer_data_safe;
 	PeerData *peer_data;
 	guint i, n;
-	gboolean peers_removed = FALSE;
 
 	c_list_for_each_entry (peer_data, &priv->lst_peers_head, lst_peers)
 		peer_data->dirty_update_all = TRUE;
@@ -971,23 +983,30 @@ _peers_update_all (NMDeviceWireGuard *self,
 			peer_data = _peers_add (self, peer);
 			added = TRUE;
 		}
-		_peers_update (self, peer_data, peer, added);
+		if (   _peers_update (self, peer_data, peer, added)
+		    || added)
+			peer_data->dirty_platform = TRUE;
 		peer_data->dirty_update_all = FALSE;
 	}
 
 	c_list_for_each_entry_safe (peer_data, peer_data_safe, &priv->lst_peers_head, lst_peers) {
 		if (peer_data->dirty_update_all) {
+			if (!removed_public_keys)
+				removed_public_keys = g_ptr_array_new_with_free_func (g_free);
+			g_ptr_array_add (removed_public_keys,
+			                 g_strdup (nm_wireguard_peer_get_public_key (peer_data->peer)));
 			_peers_remove (priv, peer_data);
-			peers_removed = TRUE;
 		}
 	}
 
-	NM_SET_OUT (out_peers_removed, peers_removed);
+	NM_SET_OUT (out_removed_public_keys, g_steal_pointer (&removed_public_keys));
 }
 
 static void
 _peers_get_platform_list (NMDeviceWireGuardPrivate *priv,
                           LinkConfigMode config_mode,
+                          gboolean incremental,
+                          const GPtrArray *removed_public_keys,
                           NMPWireGuardPeer **out_peers,
                           NMPlatformWireGuardChangePeerFlags **out_peer_flags,
                           guint *out_len,
@@ -1000,6 +1019,7 @@ _peers_get_platform_list (NMDeviceWireGuardPrivate *priv,
 	guint i_good;
 	guint n_aip;
 	guint i_aip;
+	guint n_removed;
 	guint len;
 	guint i;
 
@@ -1012,11 +1032,13 @@ _peers_get_platform_list (NMDeviceWireGuardPrivate *priv,
 
 	nm_assert (len == c_list_length (&priv->lst_peers_head));
 
-	if (len == 0)
+	n_removed = removed_public_keys ? removed_public_keys->len : 0u;
+
+	if (len + n_removed == 0)
 		return;
 
-	plpeers = g_new0 (NMPWireGuardPeer, len);
-	plpeer_flags = g_new0 (NMPlatformWireGuardChangePeerFlags, len);
+	plpeers = g_new0 (NMPWireGuardPeer, len + n_removed);
+	plpeer_flags = g_new0 (NMPlatformWireGuardChangePeerFlags, len + n_removed);
 
 	i_good = 0;
 	c_list_for_each_entry (peer_data, &priv->lst_peers_head, lst_peers) {
@@ -1024,6 +1046,16 @@ _peers_get_platform_list (NMDeviceWireGuardPrivate *priv,
 		NMPWireGuardPeer *plp = &plpeers[i_good];
 		NMSettingSecretFlags psk_secret_flags;
 
+		if (incremental) {
+			/* only configure the peers that changed since the last time. */
+			if (config_mode == LINK_CONFIG_MODE_ENDPOINTS) {
+				if (!peer_data->dirty_endpoint)
+					continue;
+			} else if (   !peer_data->dirty_platform
+			           && !peer_data->dirty_endpoint)
+				continue;
+		}
+
 		if (!nm_utils_base64secret_decode (nm_wireguard_peer_get_public_key (peer_data->peer),
 		                                   sizeof (plp->public_key),
 		                                   plp->public_key))
@@ -1031,6 +1063,12 @@ _peers_get_platform_list (NMDeviceWireGuardPrivate *priv,
 
 		*plf = NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_NONE;
 
+		if (config_mode == LINK_CONFIG_MODE_ENDPOINTS) {
+			/* we only update the endpoint. Don't re-create a peer that was removed
+			 * in the meantime. */
+			*plf |= NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_UPDATE_ONLY;
+		}
+
 		plp->persistent_keepalive_interval = nm_wireguard_peer_get_persistent_keepalive (peer_data->peer);
 		if (NM_IN_SET (config_mode, LINK_CONFIG_MODE_FULL,
 		                            LINK_CONFIG_MODE_REAPPLY))
@@ -1042,6 +1080,10 @@ _peers_get_platform_list (NMDeviceWireGuardPrivate *priv,
 		plp->endpoint = peer_data->ep_resolv.sockaddr;
 		if (plp->endpoint.sa.sa_family == AF_UNSPEC) {
 			/* we don't actually ever clear endpoints, if we don't have better information. */
+			if (config_mode == LINK_CONFIG_MODE_ENDPOINTS) {
+				/* there is nothing to update for this peer. */
+				goto skip;
+			}
 		} else
 			*plf |= NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_ENDPOINT;
 
@@ -1107,6 +1149,18 @@ skip:
 		memset (plp, 0, sizeof (*plp));
 	}
 
+	for (i = 0; i < n_removed; i++) {
+		NMPWireGuardPeer *plp = &plpeers[i_good];
+
+		if (!nm_utils_base64secret_decode (removed_public_keys->pdata[i],
+		                                   sizeof (plp->public_key),
+		                                   plp->public_key))
+			continue;
+
+		plpeer_flags[i_good] = NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REMOVE_ME;
+		i_good++;
+	}
+
 	if (i_good == 0)
 		return;
 
@@ -1358,9 +1412,11 @@ link_config (NMDeviceWireGuard *self,
 	NMPlatformLnkWireGuard wg_lnk;
 	gs_free NMPWireGuardPeer *plpeers = NULL;
 	gs_free NMPlatformWireGuardChangePeerFlags *plpeer_flags = NULL;
+	gs_unref_ptrarray GPtrArray *removed_public_keys = NULL;
 	guint plpeers_len = 0;
 	const char *setting_name;
-	gboolean peers_removed;
+	gboolean incremental;
+	PeerData *peer_data;
 	NMPlatformWireGuardChangeFlags wg_change_flags;
 	int ifindex;
 	int r;
@@ -1407,7 +1463,15 @@ link_config (NMDeviceWireGuard *self,
 		return NM_ACT_STAGE_RETURN_FAILURE;
 	}
 
-	_peers_update_all (self, s_wg, &peers_removed);
+	_peers_update_all (self, s_wg, &removed_public_keys);
+
+	/* On reapply, we only send the peers that were added, changed or removed,
+	 * instead of replacing all peers. With many peers and allowed-ips, that
+	 * saves rewriting the entire device. Only if we are unsure about the
+	 * state in the kernel, fall back to replacing all peers. */
+	incremental =    NM_IN_SET (config_mode, LINK_CONFIG_MODE_ENDPOINTS)
+	              || (   NM_IN_SET (config_mode, LINK_CONFIG_MODE_REAPPLY)
+	                  && !priv->peers_need_full_sync);
 
 	wg_lnk = (NMPlatformLnkWireGuard) { };
 
@@ -1415,7 +1479,7 @@ link_config (NMDeviceWireGuard *self,
 
 	if (   NM_IN_SET (config_mode, LINK_CONFIG_MODE_FULL)
 	    || (   NM_IN_SET (config_mode, LINK_CONFIG_MODE_REAPPLY)
-	        && peers_removed))
+	        && !incremental))
 		wg_change_flags |= NM_PLATFORM_WIREGUARD_CHANGE_FLAG_REPLACE_PEERS;
 
 	if (NM_IN_SET (config_mode, LINK_CONFIG_MODE_FULL,
@@ -1443,6 +1507,11 @@ link_config (NMDeviceWireGuard *self,
 
 	_peers_get_platform_list (priv,
 	                          config_mode,
+	                          incremental,
+	                            (   incremental
+	                             && config_mode == LINK_CONFIG_MODE_REAPPLY)
+	                          ? removed_public_keys
+	                          : NULL,
 	                          &plpeers,
 	                          &plpeer_flags,
 	                          &plpeers_len,
@@ -1459,10 +1528,27 @@ link_config (NMDeviceWireGuard *self,
 	nm_explicit_bzero (plpeers, sizeof (plpeers[0]) * plpeers_len);
 
 	if (r < 0) {
+		/* we don't know which parts of the configuration made it to the kernel. */
+		priv->peers_need_full_sync = TRUE;
 		NM_SET_OUT (out_failure_reason, NM_DEVICE_STATE_REASON_CONFIG_FAILED);
 		return NM_ACT_STAGE_RETURN_FAILURE;
 	}
 
+	c_list_for_each_entry (peer_data, &priv->lst_peers_head, lst_peers) {
+		peer_data->dirty_endpoint = FALSE;
+		if (NM_IN_SET (config_mode, LINK_CONFIG_MODE_FULL,
+		                            LINK_CONFIG_MODE_REAPPLY))
+			peer_data->dirty_platform = FALSE;
+	}
+
+	if (NM_IN_SET (config_mode, LINK_CONFIG_MODE_FULL,
+	                            LINK_CONFIG_MODE_REAPPLY))
+		priv->peers_need_full_sync = FALSE;
+	else if (config_mode == LINK_CONFIG_MODE_ASSUME) {
+		/* we don't know what was configured externally. */
+		priv->peers_need_full_sync = TRUE;
+	}
+
 	return NM_ACT_STAGE_RETURN_SUCCESS;
 }
 
@@ -618,6 +618,10 @@ typedef struct _NMDevicePrivate {
 		 * p_cur_interval. */
 		gint64 p_cur_basetime_ns;
 
+		/* once we check at the max interval, the checks are delayed by this
+		 * offset. It spreads the checks of all devices over the interval. */
+		guint p_offset_msec;
+
 		NMConnectivityState state;
 	} concheck_x[2];
 
@@ -3045,6 +3049,8 @@ concheck_is_possible (NMDevice *self)
 	return TRUE;
 }
 
+#define CONCHECK_P_PROBE_INTERVAL 1
+
 static gboolean
 concheck_periodic_schedule_do (NMDevice *self, int addr_family, gint64 now_ns)
 {
@@ -3073,6 +3079,11 @@ concheck_periodic_schedule_do (NMDevice *self, int addr_family, gint64 now_ns)
 	 * correct. */
 
 	expiry = priv->concheck_x[IS_IPv4].p_cur_basetime_ns + (priv->concheck_x[IS_IPv4].p_cur_interval * NM_UTILS_NSEC_PER_SEC);
+	if (   priv->concheck_x[IS_IPv4].p_cur_interval == priv->concheck_x[IS_IPv4].p_max_interval
+	    && priv->concheck_x[IS_IPv4].p_max_interval > CONCHECK_P_PROBE_INTERVAL) {
+		/* we are not probing. Don't check at the same time as the other devices. */
+		expiry += priv->concheck_x[IS_IPv4].p_offset_msec * NM_UTILS_NSEC_PER_MSEC;
+	}
 	tdiff = expiry - now_ns;
 
 	_LOGT (LOGD_CONCHECK, "connectivity: [IPv%c] periodic-check: %sscheduled in %lld milliseconds (%u seconds interval)",
@@ -3094,8 +3105,6 @@ out:
 	return FALSE;
 }
 
-#define CONCHECK_P_PROBE_INTERVAL 1
-
 static void
 concheck_periodic_schedule_set (NMDevice *self, int addr_family, ConcheckScheduleMode mode)
 {
@@ -3255,9 +3264,13 @@ concheck_update_interval (NMDevice *self, int addr_family, gboolean check_now)
 	new_interval = NM_MIN (new_interval, 7 *24 * 3600);
 
 	if (new_interval != priv->concheck_x[IS_IPv4].p_max_interval) {
-		_LOGT (LOGD_CONCHECK, "connectivity: [IPv%c] periodic-check: set interval to %u seconds",
-		       nm_utils_addr_family_to_char (addr_family), new_interval);
 		priv->concheck_x[IS_IPv4].p_max_interval = new_interval;
+		priv->concheck_x[IS_IPv4].p_offset_msec = nm_connectivity_get_periodic_offset_msec (concheck_get_mgr (self),
+		                                                                                   new_interval);
+		_LOGT (LOGD_CONCHECK, "connectivity: [IPv%c] periodic-check: set interval to %u seconds (offset %u milliseconds)",
+		       nm_utils_addr_family_to_char (addr_family),
+		       new_interval,
+		       priv->concheck_x[IS_IPv4].p_offset_msec);
 	}
 
 	if (!new_interval) {
@@ -3463,10 +3476,11 @@ concheck_cb (NMConnectivity *connectivity,
 
 	seq = handle->seq;
 
-	_LOGT (LOGD_CONCHECK, "connectivity: [Ipv%c] complete check (seq:%llu, state:%s)",
+	_LOGT (LOGD_CONCHECK, "connectivity: [Ipv%c] complete check (seq:%llu, state:%s, latency:%lld msec)",
 	       nm_utils_addr_family_to_char (handle->addr_family),
 	       (long long unsigned) handle->seq,
-	       nm_connectivity_state_to_string (state));
+	       nm_connectivity_state_to_string (state),
+	       (long long) nm_connectivity_check_get_latency_msec (c_handle));
 
 	/* find out, if there are any periodic checks pending (either whether they
 	 * were scheduled before or after @handle. */
@@ -7173,6 +7187,18 @@ act_stage2_config (NMDevice *self, NMDeviceStateReason *out_failure_reason)
 	return NM_ACT_STAGE_RETURN_SUCCESS;
 }
 
+static guint
+_get_lldp_min_update_interval_ms (NMDevice *self)
+{
+	gs_free char *value = NULL;
+
+	value = nm_config_data_get_device_config (NM_CONFIG_GET_DATA,
+	                                          NM_CONFIG_KEYFILE_KEY_DEVICE_LLDP_MIN_UPDATE_INTERVAL,
+	                                          self,
+	                                          NULL);
+	return _nm_utils_ascii_str_to_int64 (value, 10, 0, G_MAXINT32, NM_LLDP_LISTENER_MIN_UPDATE_INTERVAL_MSEC_DEFAULT);
+}
+
 static void
 lldp_init (NMDevice *self, gboolean restart)
 {
@@ -7194,6 +7220,8 @@ lldp_init (NMDevice *self, gboolean restart)
 		}
 
 		if (!nm_lldp_listener_is_running (priv->lldp_listener)) {
+			nm_lldp_listener_set_min_update_interval (priv->lldp_listener,
+			                                          _get_lldp_min_update_interval_ms (self));
 			if (nm_lldp_listener_start (priv->lldp_listener, nm_device_get_ifindex (self), &error))
 				_LOGD (LOGD_DEVICE, "LLDP listener %p started", priv->lldp_listener);
 			else {
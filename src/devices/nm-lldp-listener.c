@@ -17,7 +17,6 @@
 #include "systemd/nm-sd.h"
 
 #define MAX_NEIGHBORS            128
-#define MIN_UPDATE_INTERVAL_NSEC (2 * NM_UTILS_NSEC_PER_SEC)
 
 #define LLDP_MAC_NEAREST_BRIDGE          (&((struct ether_addr) { .ether_addr_octet = { 0x01, 0x80, 0xc2, 0x00, 0x00, 0x0e } }))
 #define LLDP_MAC_NEAREST_NON_TPMR_BRIDGE (&((struct ether_addr) { .ether_addr_octet = { 0x01, 0x80, 0xc2, 0x00, 0x00, 0x03 } }))
@@ -34,9 +33,13 @@ typedef struct {
 	GHashTable   *lldp_neighbors;
 	GVariant     *variant;
 
+	/* a hash over the content of all neighbors in @variant. */
+	guint         variant_hash;
+
 	/* the timestamp in nsec until which we delay updates. */
 	gint64        ratelimit_next_nsec;
 	guint         ratelimit_id;
+	guint         min_update_interval_msec;
 
 	int           ifindex;
 } NMLldpListenerPrivate;
@@ -61,6 +64,7 @@ typedef struct {
 	sd_lldp_neighbor *neighbor_sd;
 	char *chassis_id;
 	char *port_id;
+	guint raw_hash;
 	guint8 chassis_id_type;
 	guint8 port_id_type;
 } LldpNeighbor;
@@ -73,7 +77,7 @@ typedef struct {
     G_STMT_START { \
         const NMLogLevel _level = (level); \
         \
-        if (nm_logging_enabled (_level, _NMLOG_DOMAIN)) { \
+        if (nm_log_enabled (_level, _NMLOG_DOMAIN)) { \
             char _sbuf[64]; \
             int _ifindex = (self) ? NM_LLDP_LISTENER_GET_PRIVATE (self)->ifindex : 0; \
             \
@@ -253,6 +257,9 @@ lldp_neighbor_equal (LldpNeighbor *a, LldpNeighbor *b)
 	if (a->neighbor_sd == b->neighbor_sd)
 		return TRUE;
 
+	if (a->raw_hash != b->raw_hash)
+		return FALSE;
+
 	lldp_neighbor_get_raw (a, &raw_data_a, &raw_len_a);
 	lldp_neighbor_get_raw (b, &raw_data_b, &raw_len_b);
 	return    raw_len_a == raw_len_b
@@ -405,6 +412,8 @@ lldp_neighbor_new (sd_lldp_neighbor *neighbor_sd)
 	gsize port_id_len;
 	gs_free char *s_chassis_id = NULL;
 	gs_free char *s_port_id = NULL;
+	const guint8 *raw_data;
+	gsize raw_len;
 
 	if (!lldp_neighbor_id_get (neighbor_sd,
 	                           &chassis_id_type,
@@ -466,6 +475,13 @@ lldp_neighbor_new (sd_lldp_neighbor *neighbor_sd)
 		.port_id_type    = port_id_type,
 		.port_id         = g_steal_pointer (&s_port_id),
 	};
+
+	/* Chatty peers resend their LLDPDU frequently, mostly with identical content.
+	 * Remember a hash of the content, so that such refreshes can be discarded
+	 * cheaply. */
+	lldp_neighbor_get_raw (neigh, &raw_data, &raw_len);
+	neigh->raw_hash = nm_hash_mem (1434712217u, raw_data, raw_len);
+
 	return neigh;
 }
 
@@ -767,6 +783,32 @@ data_changed_notify (NMLldpListener *self, NMLldpListenerPrivate *priv)
 	_notify (self, PROP_NEIGHBORS);
 }
 
+static void
+data_changed_publish (NMLldpListener *self, NMLldpListenerPrivate *priv)
+{
+	gs_unref_variant GVariant *variant_old = NULL;
+	guint variant_hash_old;
+
+	/* The neighbors might have changed back and forth while we were rate limited.
+	 * Only emit a change notification, if the neighbors really differ from what
+	 * we published last. */
+	variant_old = g_steal_pointer (&priv->variant);
+	variant_hash_old = priv->variant_hash;
+	if (!variant_old) {
+		_notify (self, PROP_NEIGHBORS);
+		return;
+	}
+
+	nm_lldp_listener_get_neighbors (self);
+	if (   priv->variant_hash == variant_hash_old
+	    && g_variant_equal (priv->variant, variant_old)) {
+		_LOGT ("neighbors unchanged, skip publishing");
+		return;
+	}
+
+	_notify (self, PROP_NEIGHBORS);
+}
+
 static gboolean
 data_changed_timeout (gpointer user_data)
 {
@@ -778,8 +820,9 @@ data_changed_timeout (gpointer user_data)
 	priv = NM_LLDP_LISTENER_GET_PRIVATE (self);
 
 	priv->ratelimit_id = 0;
-	priv->ratelimit_next_nsec = nm_utils_get_monotonic_timestamp_nsec() + MIN_UPDATE_INTERVAL_NSEC;
-	data_changed_notify (self, priv);
+	priv->ratelimit_next_nsec =   nm_utils_get_monotonic_timestamp_nsec ()
+	                            + ((gint64) priv->min_update_interval_msec) * NM_UTILS_NSEC_PER_MSEC;
+	data_changed_publish (self, priv);
 	return G_SOURCE_REMOVE;
 }
 
@@ -975,6 +1018,23 @@ nm_lldp_listener_stop (NMLldpListener *self)
 		data_changed_notify (self, priv);
 }
 
+/**
+ * nm_lldp_listener_set_min_update_interval:
+ * @self: the #NMLldpListener
+ * @interval_msec: the minimum time in milliseconds between two notifications
+ *   about changed neighbors.
+ *
+ * Changes to the neighbors are collected and published at most once per
+ * @interval_msec. The new interval takes effect with the next notification.
+ */
+void
+nm_lldp_listener_set_min_update_interval (NMLldpListener *self, guint interval_msec)
+{
+	g_return_if_fail (NM_IS_LLDP_LISTENER (self));
+
+	NM_LLDP_LISTENER_GET_PRIVATE (self)->min_update_interval_msec = interval_msec;
+}
+
 gboolean
 nm_lldp_listener_is_running (NMLldpListener *self)
 {
@@ -998,16 +1058,21 @@ nm_lldp_listener_get_neighbors (NMLldpListener *self)
 	if (G_UNLIKELY (!priv->variant)) {
 		gs_free LldpNeighbor **neighbors = NULL;
 		GVariantBuilder array_builder;
+		NMHashState h;
 		guint i, n;
 
+		nm_hash_init (&h, 1903470131u);
 		g_variant_builder_init (&array_builder, G_VARIANT_TYPE ("aa{sv}"));
 		neighbors = (LldpNeighbor **) nm_utils_hash_keys_to_array (priv->lldp_neighbors,
 		                                                           lldp_neighbor_id_cmp_p,
 		                                                           NULL,
 		                                                           &n);
-		for (i = 0; i < n; i++)
+		for (i = 0; i < n; i++) {
+			nm_hash_update_val (&h, neighbors[i]->raw_hash);
 			g_variant_builder_add_value (&array_builder, lldp_neighbor_to_variant (neighbors[i]));
+		}
 		priv->variant = g_variant_ref_sink (g_variant_builder_end (&array_builder));
+		priv->variant_hash = nm_hash_complete (&h);
 	}
 	return priv->variant;
 }
@@ -1031,6 +1096,10 @@ get_property (GObject *object, guint prop_id,
 static void
 nm_lldp_listener_init (NMLldpListener *self)
 {
+	NMLldpListenerPrivate *priv = NM_LLDP_LISTENER_GET_PRIVATE (self);
+
+	priv->min_update_interval_msec = NM_LLDP_LISTENER_MIN_UPDATE_INTERVAL_MSEC_DEFAULT;
+
 	_LOGT ("lldp listener created");
 }
 
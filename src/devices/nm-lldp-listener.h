@@ -15,12 +15,16 @@
 
 #define NM_LLDP_LISTENER_NEIGHBORS "neighbors"
 
+/* the default minimum interval between two notifications about changed neighbors. */
+#define NM_LLDP_LISTENER_MIN_UPDATE_INTERVAL_MSEC_DEFAULT 2000
+
 typedef struct _NMLldpListenerClass NMLldpListenerClass;
 
 GType nm_lldp_listener_get_type (void);
 NMLldpListener *nm_lldp_listener_new (void);
 gboolean nm_lldp_listener_start (NMLldpListener *self, int ifindex, GError **error);
 void nm_lldp_listener_stop (NMLldpListener *self);
+void nm_lldp_listener_set_min_update_interval (NMLldpListener *self, guint interval_msec);
 gboolean nm_lldp_listener_is_running (NMLldpListener *self);
 
 GVariant *nm_lldp_listener_get_neighbors (NMLldpListener *self);
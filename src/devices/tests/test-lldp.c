@@ -522,6 +522,108 @@ test_recv (TestRecvFixture *fixture, gconstpointer user_data)
 	nm_clear_pointer (&loop, g_main_loop_unref);
 }
 
+/* like _test_recv_data0_frame0, but with system name "SYZ". */
+TEST_RECV_FRAME_DEFINE (_test_recv_ratelimit_frame1,
+	NULL,
+	/* Ethernet header */
+	0x01, 0x80, 0xc2, 0x00, 0x00, 0x03,     /* Destination MAC */
+	0x01, 0x02, 0x03, 0x04, 0x05, 0x06,     /* Source MAC */
+	0x88, 0xcc,                             /* Ethertype */
+	/* LLDP mandatory TLVs */
+	0x02, 0x07, 0x04, 0x00, 0x01, 0x02,     /* Chassis: MAC, 00:01:02:03:04:05 */
+	0x03, 0x04, 0x05,
+	0x04, 0x04, 0x05, 0x31, 0x2f, 0x33,     /* Port: interface name, "1/3" */
+	0x06, 0x02, 0x00, 0x78,                 /* TTL: 120 seconds */
+	/* LLDP optional TLVs */
+	0x08, 0x04, 0x50, 0x6f, 0x72, 0x74,     /* Port Description: "Port" */
+	0x0a, 0x03, 0x53, 0x59, 0x5a,           /* System Name: "SYZ" */
+	0x0c, 0x04, 0x66, 0x6f, 0x6f, 0x00,     /* System Description: "foo" (NULL-terminated) */
+	0x00, 0x00                              /* End Of LLDPDU */
+);
+
+typedef struct {
+	GMainLoop *loop;
+	guint num_called;
+	gint64 last_called_usec;
+} TestRecvRatelimitInfo;
+
+static void
+_test_recv_ratelimit_changed (NMLldpListener *lldp_listener, GParamSpec *pspec,
+                              gpointer user_data)
+{
+	TestRecvRatelimitInfo *info = user_data;
+
+	info->num_called++;
+	info->last_called_usec = g_get_monotonic_time ();
+	g_main_loop_quit (info->loop);
+}
+
+static void
+_test_recv_write (TestRecvFixture *fixture, const TestRecvFrame *f)
+{
+	g_assert (write (fixture->fd, f->frame, f->frame_len) == f->frame_len);
+}
+
+static void
+test_recv_ratelimit (TestRecvFixture *fixture, gconstpointer user_data)
+{
+	const guint INTERVAL_MSEC = 300;
+	gs_unref_object NMLldpListener *listener = NULL;
+	TestRecvRatelimitInfo info = { };
+	gs_free_error GError *error = NULL;
+	gint64 prev_called_usec;
+	gulong notify_id;
+	guint sd_id;
+
+	if (fixture->ifindex == 0) {
+		g_test_skip ("Tun device not available");
+		return;
+	}
+
+	listener = nm_lldp_listener_new ();
+	nm_lldp_listener_set_min_update_interval (listener, INTERVAL_MSEC);
+	g_assert (nm_lldp_listener_start (listener, fixture->ifindex, &error));
+	g_assert_no_error (error);
+
+	info.loop = g_main_loop_new (NULL, FALSE);
+	notify_id = g_signal_connect (listener, "notify::" NM_LLDP_LISTENER_NEIGHBORS,
+	                              (GCallback) _test_recv_ratelimit_changed, &info);
+	sd_id = nm_sd_event_attach_default ();
+
+	/* the first neighbor is published right away. */
+	_test_recv_write (fixture, &_test_recv_data0_frame0);
+	g_assert (nmtst_main_loop_run (info.loop, 1000));
+	g_assert_cmpint (info.num_called, ==, 1);
+
+	/* the neighbor changes and changes back within the interval. The
+	 * published neighbors are the same, so there is no notification. */
+	_test_recv_write (fixture, &_test_recv_ratelimit_frame1);
+	_test_recv_write (fixture, &_test_recv_data0_frame0);
+	g_assert (!nmtst_main_loop_run (info.loop, INTERVAL_MSEC * 2));
+	g_assert_cmpint (info.num_called, ==, 1);
+
+	/* refreshing the neighbor with the same content doesn't notify either. */
+	_test_recv_write (fixture, &_test_recv_data0_frame0);
+	g_assert (!nmtst_main_loop_run (info.loop, INTERVAL_MSEC * 2));
+	g_assert_cmpint (info.num_called, ==, 1);
+
+	/* a real change after the interval is published right away... */
+	_test_recv_write (fixture, &_test_recv_ratelimit_frame1);
+	g_assert (nmtst_main_loop_run (info.loop, 1000));
+	g_assert_cmpint (info.num_called, ==, 2);
+	prev_called_usec = info.last_called_usec;
+
+	/* ... but the next one is delayed until the interval passed. */
+	_test_recv_write (fixture, &_test_recv_data0_frame0);
+	g_assert (nmtst_main_loop_run (info.loop, INTERVAL_MSEC * 4));
+	g_assert_cmpint (info.num_called, ==, 3);
+	g_assert_cmpint (info.last_called_usec - prev_called_usec, >=, (gint64) INTERVAL_MSEC * 1000 * 3 / 4);
+
+	nm_clear_g_signal_handler (listener, &notify_id);
+	nm_clear_g_source (&sd_id);
+	nm_clear_pointer (&info.loop, g_main_loop_unref);
+}
+
 static void
 _test_recv_fixture_teardown (TestRecvFixture *fixture, gconstpointer user_data)
 {
@@ -604,6 +706,7 @@ _nmtstp_setup_tests (void)
 	_TEST_ADD_RECV ("/lldp/recv/0_twice", &_test_recv_data0_twice);
 	_TEST_ADD_RECV ("/lldp/recv/1",       &_test_recv_data1);
 	_TEST_ADD_RECV ("/lldp/recv/2_ttl1",  &_test_recv_data2_ttl1);
+	g_test_add ("/lldp/recv/ratelimit", TestRecvFixture, NULL, _test_recv_fixture_setup, test_recv_ratelimit, _test_recv_fixture_teardown);
 
 	g_test_add_data_func ("/lldp/parse-frames/0", &_test_recv_data0_frame0, test_parse_frames);
 	g_test_add_data_func ("/lldp/parse-frames/1", &_test_recv_data1_frame0, test_parse_frames);
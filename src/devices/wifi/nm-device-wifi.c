@@ -827,6 +827,63 @@ ap_add_remove (NMDeviceWifi *self,
 		nm_device_recheck_available_connections (NM_DEVICE (self));
 }
 
+static guint
+_get_max_aps_per_ssid (NMDeviceWifi *self)
+{
+	gs_free char *value = NULL;
+
+	value = nm_config_data_get_device_config (NM_CONFIG_GET_DATA,
+	                                          NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_MAX_APS_PER_SSID,
+	                                          NM_DEVICE (self),
+	                                          NULL);
+	return _nm_utils_ascii_str_to_int64 (value, 10, 0, G_MAXUINT32, 0);
+}
+
+/* Checks whether the new @ap can be exported, without exceeding the
+ * configured number of APs for its SSID. To make room, the weakest AP
+ * with that SSID may get removed. */
+static gboolean
+ap_limit_per_ssid (NMDeviceWifi *self, NMWifiAP *ap)
+{
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+	NMWifiAP *weakest = NULL;
+	NMWifiAP *iter;
+	GBytes *ssid;
+	guint max_aps;
+	guint n = 0;
+
+	ssid = nm_wifi_ap_get_ssid (ap);
+	if (!ssid || _nm_utils_is_empty_ssid (ssid))
+		return TRUE;
+
+	max_aps = _get_max_aps_per_ssid (self);
+	if (max_aps == 0)
+		return TRUE;
+
+	c_list_for_each_entry (iter, &priv->aps_lst_head, aps_lst) {
+		if (!nm_gbytes_equal0 (ssid, nm_wifi_ap_get_ssid (iter)))
+			continue;
+		n++;
+		if (iter == priv->current_ap)
+			continue;
+		if (   !weakest
+		    || nm_wifi_ap_get_strength (iter) < nm_wifi_ap_get_strength (weakest))
+			weakest = iter;
+	}
+
+	if (n < max_aps)
+		return TRUE;
+
+	if (   !weakest
+	    || nm_wifi_ap_get_strength (weakest) >= nm_wifi_ap_get_strength (ap)) {
+		_ap_dump (self, LOGL_TRACE, ap, "ignored", 0);
+		return FALSE;
+	}
+
+	ap_add_remove (self, FALSE, weakest, FALSE);
+	return TRUE;
+}
+
 static void
 remove_all_aps (NMDeviceWifi *self)
 {
@@ -1961,7 +2018,11 @@ supplicant_iface_bss_changed_cb (NMSupplicantInterface *iface,
 			}
 		}
 
-		ap_add_remove (self, TRUE, ap, TRUE);
+		/* The limit does not apply to the BSS the supplicant is associated
+		 * with. It becomes the current AP below. */
+		if (   nm_supplicant_interface_get_current_bss (iface) == bss_info->bss_path
+		    || ap_limit_per_ssid (self, ap))
+			ap_add_remove (self, TRUE, ap, TRUE);
 	}
 
 	/* Update the current AP if the supplicant notified a current BSS change
@@ -61,7 +61,7 @@ G_DEFINE_TYPE (NMIwdManager, nm_iwd_manager, G_TYPE_OBJECT)
 
 #define _NMLOG(level, ...) \
 	G_STMT_START { \
-		if (nm_logging_enabled (level, _NMLOG_DOMAIN)) { \
+		if (nm_log_enabled (level, _NMLOG_DOMAIN)) { \
 			char __prefix[32]; \
 			\
 			if (self) \
@@ -116,7 +116,7 @@ G_DEFINE_TYPE (NMModemBroadband, nm_modem_broadband, NM_TYPE_MODEM)
     G_STMT_START { \
         const NMLogLevel _level = (level); \
         \
-        if (nm_logging_enabled (_level, (_NMLOG_DOMAIN))) { \
+        if (nm_log_enabled (_level, (_NMLOG_DOMAIN))) { \
             NMModemBroadband *const __self = (self); \
             char __prefix_name[128]; \
             const char *__uid; \
@@ -66,7 +66,7 @@ G_DEFINE_TYPE (NMModemOfono, nm_modem_ofono, NM_TYPE_MODEM)
     G_STMT_START { \
         const NMLogLevel _level = (level); \
         \
-        if (nm_logging_enabled (_level, (_NMLOG_DOMAIN))) { \
+        if (nm_log_enabled (_level, (_NMLOG_DOMAIN))) { \
             NMModemOfono *const __self = (self); \
             char __prefix_name[128]; \
             const char *__uid; \
@@ -37,7 +37,7 @@ _nm_dhcp_client_get_domain (NMDhcpClient *self)
          * Same for the _NMLOG_ENABLED() macro. Probably it would be more
          * expensive to determine the correct value then what we could
          * safe. */ \
-        if (nm_logging_enabled (_level, _NMLOG_DOMAIN)) { \
+        if (nm_log_enabled (_level, _NMLOG_DOMAIN)) { \
             NMDhcpClient *_self = (NMDhcpClient *) (self); \
             const char *__ifname = _self ? nm_dhcp_client_get_iface (_self) : NULL; \
             const NMLogDomain _domain = _nm_dhcp_client_get_domain (_self); \
@@ -62,7 +62,7 @@ _nm_dhcp_client_get_domain (NMDhcpClient *self)
          * Same for the _NMLOG_ENABLED() macro. Probably it would be more
          * expensive to determine the correct value then what we could
          * safe. */ \
-        if (nm_logging_enabled (_level, _domain)) { \
+        if (nm_log_enabled (_level, _domain)) { \
             const char *__ifname = (ifname); \
             \
             nm_log (_level, _domain, __ifname, NULL, \
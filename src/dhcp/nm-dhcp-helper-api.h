@@ -15,6 +15,25 @@
 #define NM_DHCP_HELPER_SERVER_INTERFACE_NAME    "org.freedesktop.nm_dhcp_server"
 #define NM_DHCP_HELPER_SERVER_METHOD_NOTIFY     "Notify"
 
+/* Besides the private D-Bus socket, NetworkManager listens on a unix datagram
+ * socket. The helper sends one datagram per event: a NMDhcpHelperDgramHeader,
+ * followed by the serialized "(a{sv})" GVariant that is also passed to Notify.
+ * That spares the helper the D-Bus connection setup and authentication, and
+ * lets NetworkManager process many events per main loop iteration.
+ *
+ * After handling the event, NetworkManager replies with a header with zero
+ * length to the address of the sender. The helper waits for that reply, so
+ * that the DHCP client doesn't run ahead of NetworkManager. The helper falls
+ * back to D-Bus only if the datagram cannot be sent. */
+#define NM_DHCP_HELPER_SERVER_DGRAM_PATH        NMRUNDIR "/private-dhcp-dgram"
+#define NM_DHCP_HELPER_SERVER_DGRAM_MAGIC       0x4e4d4448u /* "NMDH" */
+#define NM_DHCP_HELPER_SERVER_DGRAM_MAX_SIZE    (64u * 1024u)
+
+typedef struct {
+	guint32 magic;
+	guint32 len;
+} NMDhcpHelperDgramHeader;
+
 /*****************************************************************************/
 
 #endif /* __NM_DHCP_HELPER_API_H__ */
@@ -8,6 +8,8 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 #include "nm-utils/nm-vpn-plugin-macros.h"
 
@@ -105,6 +107,97 @@ next:
 	return g_variant_ref_sink (g_variant_new ("(a{sv})", &builder));
 }
 
+static gboolean
+notify_dgram (GVariant *parameters)
+{
+	const struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+		.sun_path   = NM_DHCP_HELPER_SERVER_DGRAM_PATH,
+	};
+	const struct sockaddr_un addr_auto = {
+		.sun_family = AF_UNIX,
+	};
+	const struct timeval timeout = {
+		.tv_sec = 1,
+	};
+	NMDhcpHelperDgramHeader header;
+	nm_auto_close int fd = -1;
+	struct iovec iov[2];
+	struct msghdr msg = {
+		.msg_iov     = iov,
+		.msg_iovlen  = G_N_ELEMENTS (iov),
+	};
+	gsize len;
+	gssize n;
+
+	len = g_variant_get_size (parameters);
+	if (len > NM_DHCP_HELPER_SERVER_DGRAM_MAX_SIZE - sizeof (header)) {
+		_LOGi ("event too large for datagram socket (%zu bytes)", len);
+		return FALSE;
+	}
+
+	fd = socket (AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		return FALSE;
+
+	/* bind to an autogenerated abstract address, so that NetworkManager can
+	 * acknowledge the event. */
+	if (bind (fd, (const struct sockaddr *) &addr_auto, offsetof (struct sockaddr_un, sun_path)) < 0)
+		return FALSE;
+
+	if (connect (fd, (const struct sockaddr *) &addr, sizeof (addr)) < 0) {
+		int errsv = errno;
+
+		/* ENOENT/ECONNREFUSED are expected with an older NetworkManager. */
+		_LOGi ("failure to connect to datagram socket: %s (try D-Bus)",
+		       g_strerror (errsv));
+		return FALSE;
+	}
+
+	/* if NetworkManager is too busy to empty its receive queue, don't block forever
+	 * but fall back to D-Bus. Also, don't wait forever for the acknowledgement. */
+	(void) setsockopt (fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof (timeout));
+	(void) setsockopt (fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof (timeout));
+
+	header = (NMDhcpHelperDgramHeader) {
+		.magic = NM_DHCP_HELPER_SERVER_DGRAM_MAGIC,
+		.len   = len,
+	};
+	iov[0] = (struct iovec) {
+		.iov_base = &header,
+		.iov_len  = sizeof (header),
+	};
+	iov[1] = (struct iovec) {
+		.iov_base = (gpointer) g_variant_get_data (parameters),
+		.iov_len  = len,
+	};
+
+	n = sendmsg (fd, &msg, MSG_NOSIGNAL);
+	if (n < 0) {
+		int errsv = errno;
+
+		_LOGi ("failure to send event via datagram socket: %s (try D-Bus)",
+		       g_strerror (errsv));
+		return FALSE;
+	}
+
+	/* Wait until NetworkManager handled the event, like the Notify call does.
+	 * Once sent, the event is queued. Falling back to D-Bus now would deliver it
+	 * twice, so after the timeout we give up waiting, like Notify falls back to
+	 * the asynchronous Event signal. */
+	n = recv (fd, &header, sizeof (header), 0);
+	if (n < 0) {
+		int errsv = errno;
+
+		_LOGi ("no acknowledgement for event via datagram socket: %s",
+		       g_strerror (errsv));
+	} else if (   n != sizeof (header)
+	           || header.magic != NM_DHCP_HELPER_SERVER_DGRAM_MAGIC)
+		_LOGi ("invalid acknowledgement for event via datagram socket");
+
+	return TRUE;
+}
+
 static void
 kill_pid (void)
 {
@@ -132,6 +225,15 @@ main (int argc, char *argv[])
 	gint64 time_start;
 	gint64 time_end;
 
+	parameters = build_signal_parameters ();
+
+	/* Prefer the lightweight datagram socket, and only connect to the private
+	 * D-Bus socket if that fails. */
+	if (notify_dgram (parameters)) {
+		success = TRUE;
+		goto out;
+	}
+
 	/* Connecting to the unix socket can fail with EAGAIN if there are too
 	 * many pending connections and the server can't accept them in time
 	 * before reaching backlog capacity. Ideally the server should increase
@@ -170,7 +272,6 @@ do_connect:
 		goto out;
 	}
 
-	parameters = build_signal_parameters ();
 	time_end = g_get_monotonic_time () + (200 * 1000L); /* retry for at most 200 milliseconds */
 	try_count = 0;
 
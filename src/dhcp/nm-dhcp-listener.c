@@ -8,6 +8,8 @@
 #include "nm-dhcp-listener.h"
 
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <sys/wait.h>
 #include <signal.h>
 #include <stdlib.h>
@@ -23,6 +25,10 @@
 #define PRIV_SOCK_PATH            NMRUNDIR "/private-dhcp"
 #define PRIV_SOCK_TAG             "dhcp"
 
+/* the maximum number of datagrams handled per main loop iteration, so that
+ * a burst of events does not starve other sources. */
+#define DGRAM_BATCH_MAX           64
+
 /*****************************************************************************/
 
 const NMDhcpClientFactory *const _nm_dhcp_manager_factories[6] = {
@@ -45,11 +51,19 @@ const NMDhcpClientFactory *const _nm_dhcp_manager_factories[6] = {
 
 /*****************************************************************************/
 
+NM_GOBJECT_PROPERTIES_DEFINE_BASE (
+	PROP_DGRAM_PATH,
+);
+
 typedef struct {
 	NMDBusManager *dbus_mgr;
 	gulong         new_conn_id;
 	gulong         dis_conn_id;
 	GHashTable    *connections;
+	GSource       *dgram_source;
+	guint8        *dgram_buf;
+	char          *dgram_path;
+	int            dgram_fd;
 } NMDhcpListenerPrivate;
 
 struct _NMDhcpListener {
@@ -92,6 +106,10 @@ NM_DEFINE_SINGLETON_GETTER (NMDhcpListener, nm_dhcp_listener_get, NM_TYPE_DHCP_L
 
 /*****************************************************************************/
 
+static void _dgram_drain (NMDhcpListener *self);
+
+/*****************************************************************************/
+
 static char *
 get_option (GVariant *options, const char *key)
 {
@@ -188,6 +206,11 @@ _method_call (GDBusConnection *connection,
 		return;
 	}
 
+	/* the helper only falls back to D-Bus if it could not send the datagram.
+	 * Earlier events of the same client might still be queued on the datagram
+	 * socket, handle them first so that this one does not overtake them. */
+	_dgram_drain (self);
+
 	_method_call_handle (self, parameters);
 	g_dbus_method_invocation_return_value (invocation, NULL);
 }
@@ -262,6 +285,227 @@ dis_connection_cb (NMDBusManager *mgr,
 
 /*****************************************************************************/
 
+static gboolean
+_dgram_handle_one (NMDhcpListener *self,
+                   gboolean *out_again)
+{
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE (self);
+	struct iovec iov = {
+		.iov_base = priv->dgram_buf,
+		.iov_len  = NM_DHCP_HELPER_SERVER_DGRAM_MAX_SIZE,
+	};
+	union {
+		struct cmsghdr cmsghdr;
+		guint8 buf[CMSG_SPACE (sizeof (struct ucred))];
+	} control;
+	struct msghdr msg = {
+		.msg_iov        = &iov,
+		.msg_iovlen     = 1,
+		.msg_control    = &control,
+		.msg_controllen = sizeof (control),
+	};
+	struct sockaddr_un sender;
+	const struct ucred *ucred = NULL;
+	struct cmsghdr *cmsg;
+	NMDhcpHelperDgramHeader header;
+	gs_unref_bytes GBytes *bytes = NULL;
+	gs_unref_variant GVariant *parameters = NULL;
+	gssize n;
+
+	msg.msg_name = &sender;
+	msg.msg_namelen = sizeof (sender);
+
+	*out_again = FALSE;
+
+	n = recvmsg (priv->dgram_fd, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+	if (n < 0) {
+		int errsv = errno;
+
+		if (errsv == EINTR)
+			*out_again = TRUE;
+		else if (errsv != EAGAIN)
+			_LOGW ("dgram: failure to receive event: %s", nm_strerror_native (errsv));
+		return FALSE;
+	}
+
+	*out_again = TRUE;
+
+	for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+		if (   cmsg->cmsg_level == SOL_SOCKET
+		    && cmsg->cmsg_type == SCM_CREDENTIALS
+		    && cmsg->cmsg_len >= CMSG_LEN (sizeof (struct ucred))) {
+			ucred = (const struct ucred *) CMSG_DATA (cmsg);
+			break;
+		}
+	}
+
+	/* the socket is only writable by root, but double check. The DHCP clients
+	 * run as root, and so do the helper and NetworkManager. */
+	if (   !ucred
+	    || (   ucred->uid != 0
+	        && ucred->uid != geteuid ())) {
+		_LOGW ("dgram: ignore event from unprivileged sender");
+		return FALSE;
+	}
+
+	if (   NM_FLAGS_HAS (msg.msg_flags, MSG_TRUNC)
+	    || n < (gssize) sizeof (header)) {
+		_LOGW ("dgram: ignore event with invalid size");
+		goto out_ack;
+	}
+
+	memcpy (&header, priv->dgram_buf, sizeof (header));
+	if (   header.magic != NM_DHCP_HELPER_SERVER_DGRAM_MAGIC
+	    || header.len != (gsize) n - sizeof (header)) {
+		_LOGW ("dgram: ignore malformed event");
+		goto out_ack;
+	}
+
+	bytes = g_bytes_new (&priv->dgram_buf[sizeof (header)], header.len);
+	parameters = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE ("(a{sv})"),
+	                                                           bytes,
+	                                                           FALSE));
+	_method_call_handle (self, parameters);
+
+out_ack:
+	/* the helper waits for this reply, so that the DHCP client doesn't
+	 * continue before we processed the event. Like for Notify, the reply
+	 * doesn't tell whether the event was valid. */
+	if (msg.msg_namelen > offsetof (struct sockaddr_un, sun_path)) {
+		header = (NMDhcpHelperDgramHeader) {
+			.magic = NM_DHCP_HELPER_SERVER_DGRAM_MAGIC,
+			.len   = 0,
+		};
+		if (sendto (priv->dgram_fd,
+		            &header,
+		            sizeof (header),
+		            MSG_DONTWAIT | MSG_NOSIGNAL,
+		            (struct sockaddr *) &sender,
+		            msg.msg_namelen) < 0) {
+			int errsv = errno;
+
+			_LOGD ("dgram: failure to acknowledge event: %s", nm_strerror_native (errsv));
+		}
+	}
+	return TRUE;
+}
+
+static void
+_dgram_drain (NMDhcpListener *self)
+{
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE (self);
+	gboolean again;
+
+	if (priv->dgram_fd < 0)
+		return;
+
+	do {
+		_dgram_handle_one (self, &again);
+	} while (again);
+}
+
+static gboolean
+_dgram_event_cb (int fd,
+                 GIOCondition condition,
+                 gpointer user_data)
+{
+	NMDhcpListener *self = user_data;
+	gboolean again;
+	guint i;
+
+	/* Handle the events that queued up since the last main loop iteration as
+	 * a batch. If more are pending, we get called again on the next iteration. */
+	for (i = 0; i < DGRAM_BATCH_MAX; i++) {
+		_dgram_handle_one (self, &again);
+		if (!again)
+			break;
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
+static void
+_dgram_setup (NMDhcpListener *self)
+{
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE (self);
+	const char *path = priv->dgram_path ?: NM_DHCP_HELPER_SERVER_DGRAM_PATH;
+	struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+	};
+	nm_auto_close int fd = -1;
+	const int on = 1;
+	int errsv;
+
+	fd = socket (AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+	if (fd < 0) {
+		errsv = errno;
+		_LOGW ("dgram: failure to create socket: %s", nm_strerror_native (errsv));
+		return;
+	}
+
+	if (setsockopt (fd, SOL_SOCKET, SO_PASSCRED, &on, sizeof (on)) < 0) {
+		errsv = errno;
+		_LOGW ("dgram: failure to enable credentials: %s", nm_strerror_native (errsv));
+		return;
+	}
+
+	if (g_strlcpy (addr.sun_path, path, sizeof (addr.sun_path)) >= sizeof (addr.sun_path)) {
+		_LOGW ("dgram: socket path %s too long", path);
+		return;
+	}
+
+	/* a stale socket from a previous run would make bind() fail. */
+	unlink (path);
+
+	if (bind (fd, (struct sockaddr *) &addr, sizeof (addr)) < 0) {
+		errsv = errno;
+		_LOGW ("dgram: failure to bind %s: %s",
+		       path,
+		       nm_strerror_native (errsv));
+		return;
+	}
+
+	if (chmod (path, 0600) < 0) {
+		errsv = errno;
+		_LOGW ("dgram: failure to restrict permissions of %s: %s",
+		       path,
+		       nm_strerror_native (errsv));
+		unlink (path);
+		return;
+	}
+
+	priv->dgram_buf = g_malloc (NM_DHCP_HELPER_SERVER_DGRAM_MAX_SIZE);
+	priv->dgram_fd = nm_steal_fd (&fd);
+	priv->dgram_source = nm_g_unix_fd_source_new (priv->dgram_fd,
+	                                              G_IO_IN,
+	                                              G_PRIORITY_DEFAULT,
+	                                              _dgram_event_cb,
+	                                              self,
+	                                              NULL);
+	g_source_attach (priv->dgram_source, NULL);
+}
+
+/*****************************************************************************/
+
+static void
+set_property (GObject *object, guint prop_id,
+              const GValue *value, GParamSpec *pspec)
+{
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE (object);
+
+	switch (prop_id) {
+	case PROP_DGRAM_PATH:
+		/* construct-only */
+		priv->dgram_path = g_value_dup_string (value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+		break;
+	}
+}
+
+/*****************************************************************************/
+
 static void
 nm_dhcp_listener_init (NMDhcpListener *self)
 {
@@ -270,6 +514,23 @@ nm_dhcp_listener_init (NMDhcpListener *self)
 	/* Maps GDBusConnection :: signal-id */
 	priv->connections = g_hash_table_new (nm_direct_hash, NULL);
 
+	priv->dgram_fd = -1;
+}
+
+static void
+constructed (GObject *object)
+{
+	NMDhcpListener *self = NM_DHCP_LISTENER (object);
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE (self);
+
+	G_OBJECT_CLASS (nm_dhcp_listener_parent_class)->constructed (object);
+
+	if (priv->dgram_path) {
+		/* for tests, only listen on the given datagram socket. */
+		_dgram_setup (self);
+		return;
+	}
+
 	priv->dbus_mgr = g_object_ref (nm_dbus_manager_get ());
 
 	/* Register the socket our DHCP clients will return lease info on */
@@ -282,6 +543,20 @@ nm_dhcp_listener_init (NMDhcpListener *self)
 	                                      NM_DBUS_MANAGER_PRIVATE_CONNECTION_DISCONNECTED "::" PRIV_SOCK_TAG,
 	                                      G_CALLBACK (dis_connection_cb),
 	                                      self);
+
+	_dgram_setup (self);
+}
+
+/*****************************************************************************/
+
+NMDhcpListener *
+nmtst_dhcp_listener_new (const char *dgram_path)
+{
+	g_return_val_if_fail (dgram_path, NULL);
+
+	return g_object_new (NM_TYPE_DHCP_LISTENER,
+	                     NM_DHCP_LISTENER_DGRAM_PATH, dgram_path,
+	                     NULL);
 }
 
 static void
@@ -294,6 +569,15 @@ dispose (GObject *object)
 
 	nm_clear_pointer (&priv->connections, g_hash_table_destroy);
 
+	nm_clear_g_source_inst (&priv->dgram_source);
+	if (priv->dgram_fd >= 0) {
+		unlink (priv->dgram_path ?: NM_DHCP_HELPER_SERVER_DGRAM_PATH);
+		nm_close (priv->dgram_fd);
+		priv->dgram_fd = -1;
+	}
+	nm_clear_g_free (&priv->dgram_buf);
+	nm_clear_g_free (&priv->dgram_path);
+
 	g_clear_object (&priv->dbus_mgr);
 
 	G_OBJECT_CLASS (nm_dhcp_listener_parent_class)->dispose (object);
@@ -304,8 +588,18 @@ nm_dhcp_listener_class_init (NMDhcpListenerClass *listener_class)
 {
 	GObjectClass *object_class = G_OBJECT_CLASS (listener_class);
 
+	object_class->set_property = set_property;
+	object_class->constructed = constructed;
 	object_class->dispose = dispose;
 
+	obj_properties[PROP_DGRAM_PATH] =
+	    g_param_spec_string (NM_DHCP_LISTENER_DGRAM_PATH, "", "",
+	                         NULL,
+	                         G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY |
+	                         G_PARAM_STATIC_STRINGS);
+
+	g_object_class_install_properties (object_class, _PROPERTY_ENUMS_LAST, obj_properties);
+
 	signals[EVENT] =
 	    g_signal_new (NM_DHCP_LISTENER_EVENT,
 	                  G_OBJECT_CLASS_TYPE (object_class),
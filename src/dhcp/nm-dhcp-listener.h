@@ -11,6 +11,8 @@
 #define NM_IS_DHCP_LISTENER(obj)        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), NM_TYPE_DHCP_LISTENER))
 #define NM_DHCP_LISTENER_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), NM_TYPE_DHCP_LISTENER, NMDhcpListenerClass))
 
+#define NM_DHCP_LISTENER_DGRAM_PATH "dgram-path"
+
 #define NM_DHCP_LISTENER_EVENT "event"
 
 typedef struct _NMDhcpListener NMDhcpListener;
@@ -20,4 +22,6 @@ GType nm_dhcp_listener_get_type (void);
 
 NMDhcpListener *nm_dhcp_listener_get (void);
 
+NMDhcpListener *nmtst_dhcp_listener_new (const char *dgram_path);
+
 #endif /* __NETWORKMANAGER_DHCP_LISTENER_H__ */
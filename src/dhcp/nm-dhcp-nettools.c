@@ -17,6 +17,7 @@
 #include "hostname-util.h"
 
 #include "nm-glib-aux/nm-dedup-multi.h"
+#include "nm-glib-aux/nm-io-utils.h"
 #include "nm-std-aux/unaligned.h"
 
 #include "nm-utils.h"
@@ -24,6 +25,7 @@
 #include "nm-dhcp-utils.h"
 #include "nm-dhcp-options.h"
 #include "nm-core-utils.h"
+#include "nm-worker-pool.h"
 #include "NetworkManagerUtils.h"
 #include "platform/nm-platform.h"
 #include "nm-dhcp-client-logging.h"
@@ -961,13 +963,62 @@ lease_to_ip4_config (NMDedupMultiIndex *multi_idx,
 
 /*****************************************************************************/
 
+/* The lease file is written on the worker pool. Until the write completes,
+ * remember the saved address, so that a client that starts meanwhile for
+ * the same lease file neither reads a stale file nor waits for the write. */
+typedef struct {
+	char *lease_file;
+	struct in_addr address;
+	guint64 expires;
+	guint n_pending;
+} LeasePending;
+
+static GHashTable *lease_pending_hash;
+
+static void
+_lease_pending_free (gpointer data)
+{
+	LeasePending *pending = data;
+
+	g_free (pending->lease_file);
+	nm_g_slice_free (pending);
+}
+
+static LeasePending *
+_lease_pending_lookup (const char *lease_file)
+{
+	if (!lease_pending_hash)
+		return NULL;
+	return g_hash_table_lookup (lease_pending_hash, &lease_file);
+}
+
+static void
+lease_save_cb (const char *lease_file,
+               GError *error,
+               gpointer user_data)
+{
+	gs_free char *iface = user_data;
+	LeasePending *pending;
+
+	pending = _lease_pending_lookup (lease_file);
+	nm_assert (pending && pending->n_pending > 0);
+	if (--pending->n_pending == 0)
+		g_hash_table_remove (lease_pending_hash, pending);
+
+	if (error)
+		_LOG2W (LOGD_DHCP4, iface, "error saving lease to %s: %s", lease_file, error->message);
+}
+
 static void
 lease_save (NMDhcpNettools *self, NDhcp4ClientLease *lease, const char *lease_file)
 {
 	struct in_addr a_address;
 	nm_auto_free_gstring GString *new_contents = NULL;
 	char sbuf[NM_UTILS_INET_ADDRSTRLEN];
-	gs_free_error GError *error = NULL;
+	guint64 nettools_lifetime;
+	guint64 expires = 0;
+	gsize new_contents_len;
+	LeasePending *pending;
 
 	nm_assert (lease);
 	nm_assert (lease_file);
@@ -981,11 +1032,110 @@ lease_save (NMDhcpNettools *self, NDhcp4ClientLease *lease, const char *lease_fi
 	g_string_append_printf (new_contents,
 	                        "ADDRESS=%s\n", _nm_utils_inet4_ntop (a_address.s_addr, sbuf));
 
-	if (!g_file_set_contents (lease_file,
-	                          new_contents->str,
-	                          -1,
-	                          &error))
-		_LOGW ("error saving lease to %s: %s", lease_file, error->message);
+	/* The lifetime of the lease is based on CLOCK_BOOTTIME, which does not survive
+	 * a reboot. Persist the expiry as wall-clock time instead. */
+	n_dhcp4_client_lease_get_lifetime (lease, &nettools_lifetime);
+	if (nettools_lifetime != G_MAXUINT64) {
+		guint64 now_ns = nm_utils_clock_gettime_nsec (CLOCK_BOOTTIME);
+		guint64 remaining;
+
+		remaining =   nettools_lifetime > now_ns
+		            ? (nettools_lifetime - now_ns) / NM_UTILS_NSEC_PER_SEC
+		            : 0u;
+		expires = ((guint64) time (NULL)) + remaining;
+		g_string_append_printf (new_contents,
+		                        "EXPIRES=%"G_GUINT64_FORMAT"\n",
+		                        expires);
+	}
+
+	pending = _lease_pending_lookup (lease_file);
+	if (!pending) {
+		if (!lease_pending_hash)
+			lease_pending_hash = g_hash_table_new_full (nm_pstr_hash, nm_pstr_equal, _lease_pending_free, NULL);
+		pending = g_slice_new (LeasePending);
+		*pending = (LeasePending) {
+			.lease_file = g_strdup (lease_file),
+		};
+		g_hash_table_add (lease_pending_hash, pending);
+	}
+	pending->address = a_address;
+	pending->expires = expires;
+	pending->n_pending++;
+
+	/* writing the file syncs it to disk. Don't block the main loop for that. */
+	new_contents_len = new_contents->len;
+	nm_worker_pool_file_set_contents (lease_file,
+	                                  g_string_free (g_steal_pointer (&new_contents), FALSE),
+	                                  new_contents_len,
+	                                  lease_save_cb,
+	                                  g_strdup (nm_dhcp_client_get_iface (NM_DHCP_CLIENT (self))));
+}
+
+static gboolean
+get_rapid_commit (NMDhcpNettools *self)
+{
+	const NMPlatformLink *pllink;
+	gs_free char *value = NULL;
+
+	pllink = nm_platform_link_get (NM_PLATFORM_GET,
+	                               nm_dhcp_client_get_ifindex (NM_DHCP_CLIENT (self)));
+	value = nm_config_data_get_device_config_by_pllink (NM_CONFIG_GET_DATA,
+	                                                    NM_CONFIG_KEYFILE_KEY_DEVICE_DHCP4_RAPID_COMMIT,
+	                                                    pllink,
+	                                                    NULL,
+	                                                    NULL);
+	return nm_config_parse_boolean (value, FALSE);
+}
+
+static gboolean
+lease_load_address (const char *lease_file,
+                    struct in_addr *out_address,
+                    gboolean *out_expired)
+{
+	gs_free char *contents = NULL;
+	gs_free const char **lines = NULL;
+	struct in_addr address = { 0 };
+	guint64 expires = 0;
+	const LeasePending *pending;
+	gsize i;
+
+	pending = _lease_pending_lookup (lease_file);
+	if (pending) {
+		/* the file is still being written. Take what we are writing. */
+		address = pending->address;
+		expires = pending->expires;
+	} else {
+		if (!nm_utils_file_get_contents (-1,
+		                                 lease_file,
+		                                 256*1024,
+		                                 NM_UTILS_FILE_GET_CONTENTS_FLAG_NONE,
+		                                 &contents,
+		                                 NULL,
+		                                 NULL,
+		                                 NULL))
+			return FALSE;
+
+		lines = nm_utils_strsplit_set (contents, "\n");
+		for (i = 0; lines && lines[i]; i++) {
+			const char *line = lines[i];
+
+			if (NM_STR_HAS_PREFIX (line, "ADDRESS="))
+				inet_pton (AF_INET, &line[NM_STRLEN ("ADDRESS=")], &address);
+			else if (NM_STR_HAS_PREFIX (line, "EXPIRES=")) {
+				expires = _nm_utils_ascii_str_to_uint64 (&line[NM_STRLEN ("EXPIRES=")],
+				                                         10, 0, G_MAXUINT64, 0);
+			}
+		}
+	}
+
+	if (address.s_addr == INADDR_ANY)
+		return FALSE;
+
+	/* Lease files without expiry are either for an infinite lease, or written
+	 * by older versions that only stored the address. Consider them valid. */
+	*out_address = address;
+	*out_expired = (expires != 0 && expires <= (guint64) time (NULL));
+	return TRUE;
 }
 
 static void
@@ -1287,6 +1437,7 @@ ip4_start (NMDhcpClient *client,
 	NMDhcpNettoolsPrivate *priv = NM_DHCP_NETTOOLS_GET_PRIVATE (self);
 	gs_free char *lease_file = NULL;
 	struct in_addr last_addr = { 0 };
+	gboolean last_expired = FALSE;
 	const char *hostname;
 	const char *mud_url;
 	int r, i;
@@ -1316,24 +1467,25 @@ ip4_start (NMDhcpClient *client,
 
 	if (last_ip4_address)
 		inet_pton (AF_INET, last_ip4_address, &last_addr);
-	else {
-		/*
-		 * TODO: we stick to the systemd-networkd lease file format. Quite easy for now to
-		 * just use the functions in systemd code. Anyway, as in the end we just use the
-		 * ip address from all the options found in the lease, write a function that parses
-		 * the lease file just for the assigned address and returns it in &last_address.
-		 * Then drop reference to systemd-networkd structures and functions.
-		 */
-		nm_auto (sd_dhcp_lease_unrefp) sd_dhcp_lease *lease = NULL;
-
-		dhcp_lease_load (&lease, lease_file);
-		if (lease)
-			sd_dhcp_lease_get_address (lease, &last_addr);
-	}
+	else
+		lease_load_address (lease_file, &last_addr, &last_expired);
 
 	if (last_addr.s_addr) {
 		n_dhcp4_client_probe_config_set_requested_ip (config, last_addr);
-		n_dhcp4_client_probe_config_set_init_reboot (config, TRUE);
+
+		/* Only try INIT-REBOOT while the previous lease is still valid. Otherwise,
+		 * the server will likely NAK the request and we only lose time before
+		 * falling back to DISCOVER. The address is still requested in that case. */
+		if (!last_expired)
+			n_dhcp4_client_probe_config_set_init_reboot (config, TRUE);
+	}
+
+	/* Allow the server to reply to DISCOVER with an ACK right away (RFC 4039).
+	 * With several servers on the link, each of them might commit an address
+	 * for us. So this is only done when configured. */
+	if (get_rapid_commit (self)) {
+		_LOGT ("request rapid commit");
+		n_dhcp4_client_probe_config_set_rapid_commit (config, TRUE);
 	}
 
 	/* Add requested options */
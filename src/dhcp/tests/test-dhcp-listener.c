@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "dhcp/nm-dhcp-helper-api.h"
+#include "dhcp/nm-dhcp-listener.h"
+
+#include "nm-test-utils-core.h"
+
+/*****************************************************************************/
+
+static gboolean
+_event_cb (NMDhcpListener *listener,
+           const char *iface,
+           int pid,
+           GVariant *options,
+           const char *reason,
+           gpointer user_data)
+{
+	GPtrArray *events = user_data;
+
+	g_ptr_array_add (events, g_strdup_printf ("%s/%d/%s", iface, pid, reason));
+	return TRUE;
+}
+
+static GVariant *
+_build_parameters (const char *iface, int pid, const char *reason)
+{
+	GVariantBuilder builder;
+	char pid_str[32];
+
+	nm_sprintf_buf (pid_str, "%d", pid);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+	g_variant_builder_add (&builder, "{sv}", "interface",
+	                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, iface, strlen (iface), 1));
+	g_variant_builder_add (&builder, "{sv}", "pid",
+	                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, pid_str, strlen (pid_str), 1));
+	g_variant_builder_add (&builder, "{sv}", "reason",
+	                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, reason, strlen (reason), 1));
+	return g_variant_ref_sink (g_variant_new ("(a{sv})", &builder));
+}
+
+/* send a datagram like nm-dhcp-helper does, and return the socket to
+ * receive the acknowledgement on. */
+static int
+_send_raw (const char *path, guint32 magic, GVariant *parameters)
+{
+	struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+	};
+	const struct sockaddr_un addr_auto = {
+		.sun_family = AF_UNIX,
+	};
+	NMDhcpHelperDgramHeader header = {
+		.magic = magic,
+		.len   = g_variant_get_size (parameters),
+	};
+	struct iovec iov[2] = {
+		{
+			.iov_base = &header,
+			.iov_len  = sizeof (header),
+		},
+		{
+			.iov_base = (gpointer) g_variant_get_data (parameters),
+			.iov_len  = header.len,
+		},
+	};
+	struct msghdr msg = {
+		.msg_iov    = iov,
+		.msg_iovlen = G_N_ELEMENTS (iov),
+	};
+	int fd;
+
+	g_strlcpy (addr.sun_path, path, sizeof (addr.sun_path));
+
+	fd = socket (AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	g_assert_cmpint (fd, >=, 0);
+	g_assert_cmpint (bind (fd, (const struct sockaddr *) &addr_auto, offsetof (struct sockaddr_un, sun_path)), ==, 0);
+	g_assert_cmpint (connect (fd, (const struct sockaddr *) &addr, sizeof (addr)), ==, 0);
+	g_assert_cmpint (sendmsg (fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL), ==, sizeof (header) + header.len);
+	return fd;
+}
+
+static int
+_send_event (const char *path, const char *iface, int pid, const char *reason)
+{
+	gs_unref_variant GVariant *parameters = _build_parameters (iface, pid, reason);
+
+	return _send_raw (path, NM_DHCP_HELPER_SERVER_DGRAM_MAGIC, parameters);
+}
+
+static gboolean
+_has_ack (int fd)
+{
+	NMDhcpHelperDgramHeader header;
+	gssize n;
+
+	n = recv (fd, &header, sizeof (header), MSG_DONTWAIT);
+	if (n < 0) {
+		g_assert_cmpint (errno, ==, EAGAIN);
+		return FALSE;
+	}
+
+	g_assert_cmpint (n, ==, sizeof (header));
+	g_assert_cmpint (header.magic, ==, NM_DHCP_HELPER_SERVER_DGRAM_MAGIC);
+	g_assert_cmpint (header.len, ==, 0);
+	return TRUE;
+}
+
+/*****************************************************************************/
+
+static void
+test_dgram (void)
+{
+	gs_free_error GError *error = NULL;
+	gs_free char *dir = NULL;
+	gs_free char *path = NULL;
+	gs_unref_object NMDhcpListener *listener = NULL;
+	gs_unref_ptrarray GPtrArray *events = g_ptr_array_new_with_free_func (g_free);
+	int fds[5];
+	guint i;
+
+	dir = g_dir_make_tmp ("test-dhcp-listener-XXXXXX", &error);
+	nmtst_assert_success (dir, error);
+	path = g_build_filename (dir, "dgram", NULL);
+
+	listener = nmtst_dhcp_listener_new (path);
+	g_signal_connect (listener, NM_DHCP_LISTENER_EVENT, G_CALLBACK (_event_cb), events);
+	g_assert (g_file_test (path, G_FILE_TEST_EXISTS));
+
+	for (i = 0; i < G_N_ELEMENTS (fds); i++)
+		fds[i] = _send_event (path, i % 2 ? "eth1" : "eth0", 100 + i, "BOUND");
+
+	/* nothing is handled, nor acknowledged, before the main loop runs. */
+	g_assert_cmpint (events->len, ==, 0);
+	for (i = 0; i < G_N_ELEMENTS (fds); i++)
+		g_assert (!_has_ack (fds[i]));
+
+	nmtst_main_context_iterate_until_assert (NULL, 1000, events->len == G_N_ELEMENTS (fds));
+
+	/* the events are handled in the order they were sent, and each sender
+	 * gets its acknowledgement after its event was handled. */
+	for (i = 0; i < G_N_ELEMENTS (fds); i++) {
+		gs_free char *expected = g_strdup_printf ("%s/%u/BOUND", i % 2 ? "eth1" : "eth0", 100 + i);
+
+		g_assert_cmpstr (events->pdata[i], ==, expected);
+		g_assert (_has_ack (fds[i]));
+		g_assert (!_has_ack (fds[i]));
+		nm_close (fds[i]);
+	}
+
+	/* a malformed event is dropped, but still acknowledged so that the
+	 * sender doesn't wait in vain. */
+	{
+		gs_unref_variant GVariant *parameters = _build_parameters ("eth0", 200, "BOUND");
+		nm_auto_close int fd = -1;
+
+		NMTST_EXPECT_NM_WARN ("*dgram: ignore malformed event*");
+		fd = _send_raw (path, ~NM_DHCP_HELPER_SERVER_DGRAM_MAGIC, parameters);
+		nmtst_main_context_iterate_until_assert (NULL, 1000, _has_ack (fd));
+		g_test_assert_expected_messages ();
+		g_assert_cmpint (events->len, ==, G_N_ELEMENTS (fds));
+	}
+
+	g_clear_object (&listener);
+	g_assert (!g_file_test (path, G_FILE_TEST_EXISTS));
+	g_assert_cmpint (rmdir (dir), ==, 0);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	nmtst_init_assert_logging (&argc, &argv, "WARN", "DEFAULT");
+
+	g_test_add_func ("/dhcp/listener/dgram", test_dgram);
+
+	return g_test_run ();
+}
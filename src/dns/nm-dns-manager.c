@@ -137,7 +137,7 @@ NM_DEFINE_SINGLETON_GETTER (NMDnsManager, nm_dns_manager_get, NM_TYPE_DNS_MANAGE
     G_STMT_START { \
         const NMLogLevel __level = (level); \
         \
-        if (nm_logging_enabled (__level, _NMLOG_DOMAIN)) { \
+        if (nm_log_enabled (__level, _NMLOG_DOMAIN)) { \
             char __prefix[20]; \
             const NMDnsManager *const __self = (self); \
             \
@@ -346,6 +346,77 @@ nm_dns_manager_has_systemd_resolved (NMDnsManager *self)
 	       && nm_dns_systemd_resolved_is_running (plugin);
 }
 
+static gboolean
+_nameserver_is_global (int addr_family, const NMIPAddr *addr)
+{
+	if (addr_family == AF_INET) {
+		in_addr_t addr4 = ntohl (addr->addr4);
+
+		return    !nm_utils_ip_is_site_local (AF_INET, &addr->addr4)
+		       && !nm_utils_ip4_address_is_link_local (addr->addr4)
+		       && (addr4 & 0xff000000) != 0x00000000  /* 0.0.0.0/8 */
+		       && (addr4 & 0xff000000) != 0x7f000000  /* 127.0.0.0/8 */
+		       && (addr4 & 0xffc00000) != 0x64400000; /* 100.64.0.0/10 */
+	}
+
+	return    !IN6_IS_ADDR_UNSPECIFIED (&addr->addr6)
+	       && !IN6_IS_ADDR_LOOPBACK (&addr->addr6)
+	       && !IN6_IS_ADDR_LINKLOCAL (&addr->addr6)
+	       && !IN6_IS_ADDR_SITELOCAL (&addr->addr6)
+	       && !IN6_IS_ADDR_V4MAPPED (&addr->addr6)
+	       && (addr->addr6.s6_addr[0] & 0xfe) != 0xfc; /* fc00::/7 */
+}
+
+/**
+ * nm_dns_manager_get_link_nameservers:
+ * @self: the #NMDnsManager
+ * @ifindex: the interface index
+ *
+ * Returns: (transfer full): a comma separated list of the name servers
+ *   configured on the link, or %NULL if there are none. Servers that are
+ *   not globally routable get the @ifindex as scope, because the same
+ *   private address can be a different server on another link. Two links
+ *   with the same string use the same set of servers.
+ */
+char *
+nm_dns_manager_get_link_nameservers (NMDnsManager *self, int ifindex)
+{
+	NMDnsManagerPrivate *priv;
+	NMDnsConfigData *data;
+	NMDnsIPConfigData *ip_data;
+	GString *str;
+
+	g_return_val_if_fail (NM_IS_DNS_MANAGER (self), NULL);
+	g_return_val_if_fail (ifindex > 0, NULL);
+
+	priv = NM_DNS_MANAGER_GET_PRIVATE (self);
+
+	data = g_hash_table_lookup (priv->configs, GINT_TO_POINTER (ifindex));
+	if (!data)
+		return NULL;
+
+	str = g_string_new (NULL);
+	c_list_for_each_entry (ip_data, &data->data_lst_head, data_lst) {
+		const NMIPConfig *ip_config = ip_data->ip_config;
+		const int addr_family = nm_ip_config_get_addr_family (ip_config);
+		char buf[NM_UTILS_INET_ADDRSTRLEN];
+		guint i, num;
+
+		num = nm_ip_config_get_num_nameservers (ip_config);
+		for (i = 0; i < num; i++) {
+			const NMIPAddr *addr = nm_ip_config_get_nameserver (ip_config, i);
+
+			if (str->len > 0)
+				g_string_append_c (str, ',');
+			g_string_append (str, nm_utils_inet_ntop (addr_family, addr, buf));
+			if (!_nameserver_is_global (addr_family, addr))
+				g_string_append_printf (str, "%%%d", ifindex);
+		}
+	}
+
+	return g_string_free (str, str->len == 0);
+}
+
 /*****************************************************************************/
 
 static void
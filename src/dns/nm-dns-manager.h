@@ -115,6 +115,8 @@ void nm_dns_manager_stop (NMDnsManager *self);
 
 gboolean nm_dns_manager_has_systemd_resolved (NMDnsManager *self);
 
+char *nm_dns_manager_get_link_nameservers (NMDnsManager *self, int ifindex);
+
 /*****************************************************************************/
 
 char *nmtst_dns_create_resolv_conf (const char *const*searches,
@@ -36,7 +36,7 @@ G_DEFINE_ABSTRACT_TYPE (NMDnsPlugin, nm_dns_plugin, G_TYPE_OBJECT)
     G_STMT_START { \
         const NMLogLevel __level = (level); \
         \
-        if (nm_logging_enabled (__level, _NMLOG_DOMAIN)) { \
+        if (nm_log_enabled (__level, _NMLOG_DOMAIN)) { \
             char __prefix[20]; \
             const NMDnsPlugin *const __self = (self); \
             \
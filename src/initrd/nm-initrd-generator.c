@@ -86,6 +86,8 @@ main (int argc, char *argv[])
 	GOptionContext *option_context;
 	gs_free_error GError *error = NULL;
 	gs_free char *hostname = NULL;
+	gs_free const char **keys = NULL;
+	guint i, len;
 	int errsv;
 
 	option_context = g_option_context_new ("-- [ip=...] [rd.route=...] [bridge=...] [bond=...] [team=...] [vlan=...] "
@@ -127,7 +129,9 @@ main (int argc, char *argv[])
 	                                        (const char *const*) remaining,
 	                                        &hostname);
 
-	g_hash_table_foreach (connections, output_conn, connections_dir);
+	keys = nm_utils_strdict_get_keys (connections, TRUE, &len);
+	for (i = 0; i < len; i++)
+		output_conn ((gpointer) keys[i], g_hash_table_lookup (connections, keys[i]), connections_dir);
 	g_hash_table_destroy (connections);
 
 	if (dump_to_stdout) {
@@ -25,6 +25,9 @@ typedef struct {
 	NMConnection *default_connection;   /* connection not bound to any ifname */
 	char *hostname;
 
+	/* the iBFT records, read from sysfs on first use. */
+	GHashTable *ibft;
+
 	/* Parameters to be set for all connections */
 	gboolean ignore_auto_dns;
 	int dhcp_timeout;
@@ -52,6 +55,7 @@ reader_destroy (Reader *reader, gboolean free_hash)
 	g_ptr_array_unref (reader->array);
 	hash = g_steal_pointer (&reader->hash);
 	nm_clear_g_free (&reader->hostname);
+	nm_clear_pointer (&reader->ibft, g_hash_table_unref);
 	nm_g_slice_free (reader);
 	if (!free_hash)
 		return g_steal_pointer (&hash);
@@ -272,10 +276,21 @@ connection_set (NMConnection *connection, const char *setting_name, const char *
 		_LOGW (LOGD_CORE, "Don't know how to set '%s' of %s", property, setting_name);
 }
 
+static GHashTable *
+reader_get_ibft (Reader *reader, const char *sysfs_dir)
+{
+	/* Walking the iBFT tables in sysfs (and loading the module) is
+	 * expensive. Do it only once, no matter how many arguments refer
+	 * to iBFT. */
+	if (!reader->ibft)
+		reader->ibft = nmi_ibft_read (sysfs_dir);
+	return reader->ibft;
+}
+
 static void
 reader_read_all_connections_from_fw (Reader *reader, const char *sysfs_dir)
 {
-	gs_unref_hashtable GHashTable *ibft = NULL;
+	GHashTable *ibft;
 	NMConnection *dt_connection;
 	const char *mac;
 	GHashTable *nic;
@@ -284,7 +299,7 @@ reader_read_all_connections_from_fw (Reader *reader, const char *sysfs_dir)
 	guint i, length;
 	gs_free const char **keys = NULL;
 
-	ibft = nmi_ibft_read (sysfs_dir);
+	ibft = reader_get_ibft (reader, sysfs_dir);
 	keys = nm_utils_strdict_get_keys (ibft, TRUE, &length);
 
 	for (i = 0; i < length; i++) {
@@ -320,7 +335,6 @@ reader_parse_ip (Reader *reader, const char *sysfs_dir, char *argument)
 {
 	NMConnection *connection;
 	NMSettingIPConfig *s_ip4 = NULL, *s_ip6 = NULL;
-	gs_unref_hashtable GHashTable *ibft = NULL;
 	const char *tmp;
 	const char *kind = NULL;
 	const char *client_ip = NULL;
@@ -507,8 +521,7 @@ reader_parse_ip (Reader *reader, const char *sysfs_dir, char *argument)
 		if (mac) {
 			g_strchomp (mac);
 			mac_up = g_ascii_strup (mac, -1);
-			ibft = nmi_ibft_read (sysfs_dir);
-			nic = g_hash_table_lookup (ibft, mac_up);
+			nic = g_hash_table_lookup (reader_get_ibft (reader, sysfs_dir), mac_up);
 			if (!nic)
 				_LOGW (LOGD_CORE, "No iBFT NIC for %s (%s)", ifname, mac_up);
 		}
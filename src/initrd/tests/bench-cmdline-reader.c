@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: LGPL-2.1+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nm-core-internal.h"
+#include "NetworkManagerUtils.h"
+
+#include "../nm-initrd-generator.h"
+
+#include "nm-test-utils-core.h"
+
+/* Benchmarks for parsing large kernel command lines, like on diskless boot
+ * servers with many ip=, vlan= and bond= arguments.
+ *
+ * See nmtst_bench_report() for how to run them. */
+
+/*****************************************************************************/
+
+static GPtrArray *
+_argv_new (guint n, gboolean with_ibft)
+{
+	GPtrArray *argv;
+	guint i;
+
+	argv = g_ptr_array_new_with_free_func (g_free);
+
+	/* static addresses on n interfaces, with a VLAN on each and
+	 * pairs of them enslaved to bonds. */
+	for (i = 0; i < n; i++) {
+		g_ptr_array_add (argv,
+		                 g_strdup_printf ("ip=10.%u.%u.%u::10.%u.0.1:255.255.0.0:host%u:eth%u:none",
+		                                  10 + i / 65536, (i / 256) % 256, i % 256,
+		                                  10 + i / 65536, i, 10 + i));
+		g_ptr_array_add (argv, g_strdup_printf ("vlan=eth%u.100:eth%u", 10 + i, 10 + i));
+		if (i % 2 == 1) {
+			g_ptr_array_add (argv,
+			                 g_strdup_printf ("bond=bond%u:eth%u.100,eth%u.100:mode=active-backup",
+			                                  i / 2, 10 + i - 1, 10 + i));
+		}
+		g_ptr_array_add (argv, g_strdup_printf ("nameserver=10.%u.0.53", 10 + i / 65536));
+	}
+
+	if (with_ibft) {
+		/* every argument that refers to iBFT used to walk the
+		 * firmware tables again. */
+		for (i = 0; i < n; i++)
+			g_ptr_array_add (argv, g_strdup ("rd.iscsi.ibft"));
+		g_ptr_array_add (argv, g_strdup ("ip=eth0:ibft"));
+	}
+
+	g_ptr_array_add (argv, NULL);
+	return argv;
+}
+
+static void
+_bench_parse (const char *name, gboolean with_ibft)
+{
+	const guint n = nmtst_bench_n (1000, 50);
+	gs_unref_ptrarray GPtrArray *argv = NULL;
+	gs_unref_hashtable GHashTable *connections = NULL;
+	gs_free char *hostname = NULL;
+	gint64 start;
+
+	argv = _argv_new (n, with_ibft);
+
+	start = nmtst_bench_now ();
+	connections = nmi_cmdline_reader_parse (TEST_INITRD_DIR "/sysfs",
+	                                        (const char *const*) argv->pdata,
+	                                        &hostname);
+	nmtst_bench_report (name, NULL, argv->len - 1, start);
+
+	g_assert (connections);
+	g_assert_cmpint (g_hash_table_size (connections), >=, 2 * n);
+}
+
+static void
+bench_cmdline (void)
+{
+	_bench_parse ("initrd-cmdline-parse", FALSE);
+}
+
+static void
+bench_cmdline_ibft (void)
+{
+	_bench_parse ("initrd-cmdline-parse-ibft", TRUE);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int main (int argc, char **argv)
+{
+	/* logging would dominate the measurements. */
+	nmtst_init_with_logging (&argc, &argv, "ERR", "ALL");
+
+	g_test_add_func ("/bench/initrd/cmdline", bench_cmdline);
+	g_test_add_func ("/bench/initrd/cmdline/ibft", bench_cmdline_ibft);
+
+	return g_test_run ();
+}
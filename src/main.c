@@ -35,6 +35,7 @@
 #include "dns/nm-dns-manager.h"
 #include "systemd/nm-sd.h"
 #include "nm-netns.h"
+#include "nm-worker-pool.h"
 
 #if !defined(NM_DIST_VERSION)
 # define NM_DIST_VERSION VERSION
@@ -376,6 +377,28 @@ main (int argc, char *argv[])
 		nm_logging_init (v, nm_config_get_is_debug (config));
 	}
 
+	{
+		gint64 queue_size;
+
+		queue_size = nm_config_data_get_value_int64 (NM_CONFIG_GET_DATA_ORIG,
+		                                             NM_CONFIG_KEYFILE_GROUP_LOGGING,
+		                                             NM_CONFIG_KEYFILE_KEY_LOGGING_ASYNC_QUEUE_SIZE,
+		                                             10, 0, 1 << 20, 0);
+		if (queue_size > 0)
+			nm_logging_async_start (queue_size);
+	}
+
+	{
+		gint64 n_records;
+
+		n_records = nm_config_data_get_value_int64 (NM_CONFIG_GET_DATA_ORIG,
+		                                            NM_CONFIG_KEYFILE_GROUP_LOGGING,
+		                                            NM_CONFIG_KEYFILE_KEY_LOGGING_FLIGHT_RECORDER_SIZE,
+		                                            10, 0, NM_LOGGING_FLIGHT_RECORDER_SIZE_MAX, 0);
+		if (n_records > 0)
+			nm_logging_flight_recorder_start (n_records);
+	}
+
 	nm_log_info (LOGD_CORE, "NetworkManager (version " NM_DIST_VERSION ") is starting... (%s)",
 	             nm_config_get_first_start (config) ? "for the first time" : "after a restart");
 
@@ -472,6 +495,9 @@ done:
 
 	nm_settings_kf_db_write (NM_SETTINGS_GET);
 
+	/* finish pending writes of lease files and the like. */
+	nm_worker_pool_wait ();
+
 done_no_manager:
 	if (global_opt.pidfile && wrote_pidfile)
 		unlink (global_opt.pidfile);
@@ -26,6 +26,8 @@ typedef struct {
 	GArray *dns_domains;
 	int hop_limit;
 	guint32 mtu;
+	struct in6_addr router;
+	bool has_router:1;
 } FakeRa;
 
 typedef struct {
@@ -123,6 +125,21 @@ nm_fake_ndisc_add_ra (NMFakeNDisc *self,
 	return ra->id;
 }
 
+/* Set the address of the router that sends the RA. Like with a real RA,
+ * NMNDisc then recognizes an identical RA that the router repeats. */
+void
+nm_fake_ndisc_set_router (NMFakeNDisc *self,
+                          guint ra_id,
+                          const char *addr)
+{
+	NMFakeNDiscPrivate *priv = NM_FAKE_NDISC_GET_PRIVATE (self);
+	FakeRa *ra = find_ra (priv->ras, ra_id);
+
+	g_assert (ra);
+	g_assert (inet_pton (AF_INET6, addr, &ra->router) == 1);
+	ra->has_router = TRUE;
+}
+
 void
 nm_fake_ndisc_add_gateway (NMFakeNDisc *self,
                            guint ra_id,
@@ -225,6 +242,44 @@ send_rs (NMNDisc *ndisc, GError **error)
 	return TRUE;
 }
 
+static guint64
+fake_ra_fingerprint (const FakeRa *ra)
+{
+	NMHashState h;
+	guint i;
+
+	/* like a hash of the payload of a real RA. That contains the lifetimes,
+	 * but not the timestamps. */
+	nm_hash_init (&h, 1887446917u);
+	nm_hash_update_vals (&h, ra->dhcp_level, ra->hop_limit, ra->mtu);
+	for (i = 0; i < ra->gateways->len; i++) {
+		const NMNDiscGateway *item = &g_array_index (ra->gateways, NMNDiscGateway, i);
+
+		nm_hash_update (&h, &item->address, sizeof (item->address));
+		nm_hash_update_vals (&h, item->lifetime, item->preference);
+	}
+	for (i = 0; i < ra->prefixes->len; i++) {
+		const FakePrefix *item = &g_array_index (ra->prefixes, FakePrefix, i);
+
+		nm_hash_update (&h, &item->network, sizeof (item->network));
+		nm_hash_update (&h, &item->gateway, sizeof (item->gateway));
+		nm_hash_update_vals (&h, item->plen, item->lifetime, item->preferred, item->preference);
+	}
+	for (i = 0; i < ra->dns_servers->len; i++) {
+		const NMNDiscDNSServer *item = &g_array_index (ra->dns_servers, NMNDiscDNSServer, i);
+
+		nm_hash_update (&h, &item->address, sizeof (item->address));
+		nm_hash_update_val (&h, item->lifetime);
+	}
+	for (i = 0; i < ra->dns_domains->len; i++) {
+		const NMNDiscDNSDomain *item = &g_array_index (ra->dns_domains, NMNDiscDNSDomain, i);
+
+		nm_hash_update_str (&h, item->domain);
+		nm_hash_update_val (&h, item->lifetime);
+	}
+	return nm_hash_complete_u64 (&h);
+}
+
 static gboolean
 receive_ra (gpointer user_data)
 {
@@ -237,6 +292,9 @@ receive_ra (gpointer user_data)
 	gint32 now = nm_utils_get_monotonic_timestamp_sec ();
 	guint i;
 	NMNDiscDHCPLevel dhcp_level;
+	struct in6_addr router;
+	gboolean has_router;
+	guint64 fingerprint;
 
 	priv->receive_ra_id = 0;
 
@@ -309,10 +367,18 @@ receive_ra (gpointer user_data)
 		changed |= NM_NDISC_CONFIG_HOP_LIMIT;
 	}
 
+	router = ra->router;
+	has_router = ra->has_router;
+	fingerprint = fake_ra_fingerprint (ra);
+
 	priv->ras = g_slist_remove (priv->ras, priv->ras->data);
 	fake_ra_free (ra);
 
-	nm_ndisc_ra_received (NM_NDISC (self), now, changed);
+	nm_ndisc_ra_received (NM_NDISC (self),
+	                      now,
+	                      changed,
+	                      has_router ? &router : NULL,
+	                      fingerprint);
 
 	/* Schedule next RA */
 	if (priv->ras) {
@@ -30,6 +30,10 @@ guint nm_fake_ndisc_add_ra (NMFakeNDisc *self,
                             int hop_limit,
                             guint32 mtu);
 
+void nm_fake_ndisc_set_router     (NMFakeNDisc *self,
+                                   guint ra_id,
+                                   const char *addr);
+
 void nm_fake_ndisc_add_gateway    (NMFakeNDisc *self,
                                    guint ra_id,
                                    const char *addr,
@@ -101,6 +101,7 @@ receive_ra (struct ndp *ndp, struct ndp_msg *msg, gpointer user_data)
 	int offset;
 	int hop_limit;
 	guint32 val;
+	guint64 fingerprint;
 
 	/* Router discovery is subject to the following RFC documents:
 	 *
@@ -308,7 +309,13 @@ receive_ra (struct ndp *ndp, struct ndp_msg *msg, gpointer user_data)
 		}
 	}
 
-	nm_ndisc_ra_received (ndisc, now, changed);
+	/* The fingerprint lets NMNDisc recognize a router that repeats an
+	 * identical advertisement, which then only refreshes lifetimes. */
+	fingerprint = nm_hash_siphash42 (1887446917u,
+	                                 ndp_msg_payload (msg),
+	                                 ndp_msg_payload_len (msg));
+
+	nm_ndisc_ra_received (ndisc, now, changed, &gateway_addr, fingerprint);
 	return 0;
 }
 
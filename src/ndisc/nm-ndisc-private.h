@@ -21,7 +21,11 @@ struct _NMNDiscDataInternal {
 
 typedef struct _NMNDiscDataInternal NMNDiscDataInternal;
 
-void nm_ndisc_ra_received (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap changed);
+void nm_ndisc_ra_received (NMNDisc *ndisc,
+                           gint32 now,
+                           NMNDiscConfigMap changed,
+                           const struct in6_addr *router,
+                           guint64 fingerprint);
 void nm_ndisc_rs_received (NMNDisc *ndisc);
 
 gboolean nm_ndisc_add_gateway              (NMNDisc *ndisc, const NMNDiscGateway *new);
@@ -40,7 +44,7 @@ gboolean nm_ndisc_add_dns_domain           (NMNDisc *ndisc, const NMNDiscDNSDoma
         const NMLogLevel __level = (level); \
         const NMLogDomain __domain = (domain); \
         \
-        if (nm_logging_enabled (__level, __domain)) { \
+        if (nm_log_enabled (__level, __domain)) { \
             NMNDisc *const __self = (self); \
             char __prefix[64]; \
             const char *__ifname = __self ? nm_ndisc_get_ifname (__self) : NULL; \
@@ -21,10 +21,38 @@
 
 /*****************************************************************************/
 
+/* Maps the key of a gateway or route to its position in the array.
+ * The index gets invalid whenever the array is modified, and it is
+ * rebuilt after processing an RA. */
+typedef struct {
+	GHashTable *table;
+	struct _NMNDiscIdxEntry *entries;
+	bool valid:1;
+} NMNDiscIdx;
+
+typedef struct {
+	struct in6_addr router;
+	guint64 fingerprint;
+} NMNDiscRAFingerprint;
+
 struct _NMNDiscPrivate {
 	/* this *must* be the first field. */
 	NMNDiscDataInternal rdata;
 
+	NMNDiscIdx gateways_idx;
+	NMNDiscIdx routes_idx;
+
+	/* the fingerprint of the last RA, per router. */
+	GArray *ra_fingerprints;
+
+	/* the parts of the configuration that changed in more than their
+	 * lifetimes, since the last RA. */
+	NMNDiscConfigMap changed_content;
+
+	/* when the addresses must be emitted again, so that their
+	 * lifetimes on the interface get refreshed. */
+	gint32 addresses_refresh_at;
+
 	union {
 		gint32 solicitations_left;
 		gint32 announcements_left;
@@ -237,6 +265,134 @@ nm_ndisc_get_node_type (NMNDisc *self)
 
 /*****************************************************************************/
 
+/* Only index arrays of at least this size. For smaller ones, the
+ * linear search is just as fast. */
+#define IDX_MIN_LEN 8
+
+/* Remember at most that many routers for the RA fingerprints. */
+#define RA_FINGERPRINTS_MAX 16
+
+typedef struct _NMNDiscIdxEntry {
+	struct in6_addr network;
+	guint8 plen;
+	guint idx;
+} NMNDiscIdxEntry;
+
+static guint
+_idx_entry_hash (gconstpointer ptr)
+{
+	const NMNDiscIdxEntry *entry = ptr;
+	NMHashState h;
+
+	nm_hash_init (&h, 1441802549u);
+	nm_hash_update (&h, &entry->network, sizeof (entry->network));
+	nm_hash_update_val (&h, entry->plen);
+	return nm_hash_complete (&h);
+}
+
+static gboolean
+_idx_entry_equal (gconstpointer a, gconstpointer b)
+{
+	const NMNDiscIdxEntry *entry_a = a;
+	const NMNDiscIdxEntry *entry_b = b;
+
+	return    entry_a->plen == entry_b->plen
+	       && IN6_ARE_ADDR_EQUAL (&entry_a->network, &entry_b->network);
+}
+
+static void
+_idx_clear (NMNDiscIdx *idx)
+{
+	nm_clear_pointer (&idx->table, g_hash_table_unref);
+	nm_clear_g_free (&idx->entries);
+	idx->valid = FALSE;
+}
+
+static gboolean
+_idx_reset (NMNDiscIdx *idx, guint len)
+{
+	_idx_clear (idx);
+	if (len < IDX_MIN_LEN)
+		return FALSE;
+
+	idx->entries = g_new (NMNDiscIdxEntry, len);
+	idx->table = g_hash_table_new (_idx_entry_hash, _idx_entry_equal);
+	idx->valid = TRUE;
+	return TRUE;
+}
+
+static void
+_idx_add (NMNDiscIdx *idx, guint i, const struct in6_addr *network, guint8 plen)
+{
+	NMNDiscIdxEntry *entry = &idx->entries[i];
+
+	entry->network = *network;
+	entry->plen = plen;
+	entry->idx = i;
+	g_hash_table_add (idx->table, entry);
+}
+
+/* Returns %TRUE if the index is valid and contains the entry. If it returns
+ * %FALSE, the caller must fall back to a linear search. */
+static gboolean
+_idx_lookup (const NMNDiscIdx *idx, const struct in6_addr *network, guint8 plen, guint *out_i)
+{
+	NMNDiscIdxEntry needle;
+	const NMNDiscIdxEntry *entry;
+
+	if (!idx->valid)
+		return FALSE;
+
+	needle.network = *network;
+	needle.plen = plen;
+	entry = g_hash_table_lookup (idx->table, &needle);
+	if (!entry)
+		return FALSE;
+
+	*out_i = entry->idx;
+	return TRUE;
+}
+
+static void
+_idx_rebuild (NMNDisc *ndisc)
+{
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NMNDiscDataInternal *rdata = &priv->rdata;
+	guint i;
+
+	if (   !priv->gateways_idx.valid
+	    && _idx_reset (&priv->gateways_idx, rdata->gateways->len)) {
+		for (i = 0; i < rdata->gateways->len; i++) {
+			const NMNDiscGateway *item = &g_array_index (rdata->gateways, NMNDiscGateway, i);
+
+			_idx_add (&priv->gateways_idx, i, &item->address, 128);
+		}
+	}
+
+	if (   !priv->routes_idx.valid
+	    && _idx_reset (&priv->routes_idx, rdata->routes->len)) {
+		for (i = 0; i < rdata->routes->len; i++) {
+			const NMNDiscRoute *item = &g_array_index (rdata->routes, NMNDiscRoute, i);
+
+			_idx_add (&priv->routes_idx, i, &item->network, item->plen);
+		}
+	}
+}
+
+/* Records that entries were added to or removed from the configuration,
+ * or changed in more than their lifetimes. */
+static void
+_content_changed (NMNDiscPrivate *priv, NMNDiscConfigMap map)
+{
+	priv->changed_content |= map;
+	if (map & NM_NDISC_CONFIG_GATEWAYS)
+		priv->gateways_idx.valid = FALSE;
+	if (map & NM_NDISC_CONFIG_ROUTES)
+		priv->routes_idx.valid = FALSE;
+}
+
+/*****************************************************************************/
+
 static void
 _ASSERT_data_gateways (const NMNDiscDataInternal *data)
 {
@@ -290,12 +446,37 @@ _data_complete (NMNDiscDataInternal *data)
 	return &data->public;
 }
 
+static gint32
+_addresses_refresh_at (const NMNDiscDataInternal *rdata)
+{
+	gint64 refresh = G_MAXINT32;
+	guint i;
+
+	/* The addresses are configured with their lifetimes, which the kernel
+	 * then counts down. They must be emitted again before half of their
+	 * (preferred) lifetime elapsed, even if an RA only refreshes them. */
+	for (i = 0; i < rdata->addresses->len; i++) {
+		const NMNDiscAddress *item = &g_array_index (rdata->addresses, NMNDiscAddress, i);
+
+		refresh = MIN (refresh, get_expiry_half (item));
+		if (   item->preferred > 0
+		    && item->preferred != NM_NDISC_INFINITY)
+			refresh = MIN (refresh, get_expiry_time (item->timestamp, item->preferred / 2));
+	}
+	return refresh;
+}
+
 void
 nm_ndisc_emit_config_change (NMNDisc *self, NMNDiscConfigMap changed)
 {
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (self);
+
+	if (changed & NM_NDISC_CONFIG_ADDRESSES)
+		priv->addresses_refresh_at = _addresses_refresh_at (&priv->rdata);
+
 	_config_changed_log (self, changed);
 	g_signal_emit (self, signals[CONFIG_RECEIVED], 0,
-	               _data_complete (&NM_NDISC_GET_PRIVATE (self)->rdata),
+	               _data_complete (&priv->rdata),
 	               (guint) changed);
 }
 
@@ -304,22 +485,42 @@ nm_ndisc_emit_config_change (NMNDisc *self, NMNDiscConfigMap changed)
 gboolean
 nm_ndisc_add_gateway (NMNDisc *ndisc, const NMNDiscGateway *new)
 {
-	NMNDiscDataInternal *rdata = &NM_NDISC_GET_PRIVATE(ndisc)->rdata;
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NMNDiscDataInternal *rdata = &priv->rdata;
 	guint i;
 	guint insert_idx = G_MAXUINT;
 
+	if (_idx_lookup (&priv->gateways_idx, &new->address, 128, &i)) {
+		NMNDiscGateway *item = &g_array_index (rdata->gateways, NMNDiscGateway, i);
+
+		nm_assert (IN6_ARE_ADDR_EQUAL (&item->address, &new->address));
+
+		/* the common case of a router refreshing its lifetime. Otherwise,
+		 * the linear search below removes or moves the entry. */
+		if (   new->lifetime != 0
+		    && item->preference == new->preference) {
+			if (get_expiry (item) == get_expiry (new))
+				return FALSE;
+
+			*item = *new;
+			return TRUE;
+		}
+	}
+
 	for (i = 0; i < rdata->gateways->len; ) {
 		NMNDiscGateway *item = &g_array_index (rdata->gateways, NMNDiscGateway, i);
 
 		if (IN6_ARE_ADDR_EQUAL (&item->address, &new->address)) {
 			if (new->lifetime == 0) {
 				g_array_remove_index (rdata->gateways, i);
+				_content_changed (priv, NM_NDISC_CONFIG_GATEWAYS);
 				_ASSERT_data_gateways (rdata);
 				return TRUE;
 			}
 
 			if (item->preference != new->preference) {
 				g_array_remove_index (rdata->gateways, i);
+				_content_changed (priv, NM_NDISC_CONFIG_GATEWAYS);
 				continue;
 			}
 
@@ -345,6 +546,7 @@ nm_ndisc_add_gateway (NMNDisc *ndisc, const NMNDiscGateway *new)
 		                      ? rdata->gateways->len
 		                      : insert_idx,
 		                    *new);
+		_content_changed (priv, NM_NDISC_CONFIG_GATEWAYS);
 	}
 	_ASSERT_data_gateways (rdata);
 	return !!new->lifetime;
@@ -489,6 +691,7 @@ nm_ndisc_add_address (NMNDisc *ndisc,
 
 		if (new->lifetime == 0) {
 			g_array_remove_index (rdata->addresses, i);
+			_content_changed (priv, NM_NDISC_CONFIG_ADDRESSES);
 			return TRUE;
 		}
 
@@ -522,6 +725,7 @@ nm_ndisc_add_address (NMNDisc *ndisc,
 	}
 
 	g_array_append_val (rdata->addresses, *new);
+	_content_changed (priv, NM_NDISC_CONFIG_ADDRESSES);
 	return TRUE;
 }
 
@@ -555,6 +759,24 @@ nm_ndisc_add_route (NMNDisc *ndisc, const NMNDiscRoute *new)
 	priv = NM_NDISC_GET_PRIVATE (ndisc);
 	rdata = &priv->rdata;
 
+	if (_idx_lookup (&priv->routes_idx, &new->network, new->plen, &i)) {
+		NMNDiscRoute *item = &g_array_index (rdata->routes, NMNDiscRoute, i);
+
+		nm_assert (   IN6_ARE_ADDR_EQUAL (&item->network, &new->network)
+		           && item->plen == new->plen);
+
+		if (   new->lifetime != 0
+		    && item->preference == new->preference) {
+			if (!IN6_ARE_ADDR_EQUAL (&item->gateway, &new->gateway))
+				_content_changed (priv, NM_NDISC_CONFIG_ROUTES);
+			else if (get_expiry (item) == get_expiry (new))
+				return FALSE;
+
+			*item = *new;
+			return TRUE;
+		}
+	}
+
 	for (i = 0; i < rdata->routes->len; ) {
 		NMNDiscRoute *item = &g_array_index (rdata->routes, NMNDiscRoute, i);
 
@@ -562,16 +784,19 @@ nm_ndisc_add_route (NMNDisc *ndisc, const NMNDiscRoute *new)
 		    && item->plen == new->plen) {
 			if (new->lifetime == 0) {
 				g_array_remove_index (rdata->routes, i);
+				_content_changed (priv, NM_NDISC_CONFIG_ROUTES);
 				return TRUE;
 			}
 
 			if (item->preference != new->preference) {
 				g_array_remove_index (rdata->routes, i);
+				_content_changed (priv, NM_NDISC_CONFIG_ROUTES);
 				continue;
 			}
 
-			if (   get_expiry (item) == get_expiry (new)
-			    && IN6_ARE_ADDR_EQUAL (&item->gateway, &new->gateway))
+			if (!IN6_ARE_ADDR_EQUAL (&item->gateway, &new->gateway))
+				_content_changed (priv, NM_NDISC_CONFIG_ROUTES);
+			else if (get_expiry (item) == get_expiry (new))
 				return FALSE;
 
 			*item = *new;
@@ -592,6 +817,7 @@ nm_ndisc_add_route (NMNDisc *ndisc, const NMNDiscRoute *new)
 		                      ? 0u
 		                      : insert_idx,
 		                    *new);
+		_content_changed (priv, NM_NDISC_CONFIG_ROUTES);
 	}
 	return !!new->lifetime;
 }
@@ -612,6 +838,7 @@ nm_ndisc_add_dns_server (NMNDisc *ndisc, const NMNDiscDNSServer *new)
 		if (IN6_ARE_ADDR_EQUAL (&item->address, &new->address)) {
 			if (new->lifetime == 0) {
 				g_array_remove_index (rdata->dns_servers, i);
+				_content_changed (priv, NM_NDISC_CONFIG_DNS_SERVERS);
 				return TRUE;
 			}
 
@@ -623,8 +850,10 @@ nm_ndisc_add_dns_server (NMNDisc *ndisc, const NMNDiscDNSServer *new)
 		}
 	}
 
-	if (new->lifetime)
+	if (new->lifetime) {
 		g_array_append_val (rdata->dns_servers, *new);
+		_content_changed (priv, NM_NDISC_CONFIG_DNS_SERVERS);
+	}
 	return !!new->lifetime;
 }
 
@@ -646,6 +875,7 @@ nm_ndisc_add_dns_domain (NMNDisc *ndisc, const NMNDiscDNSDomain *new)
 		if (!g_strcmp0 (item->domain, new->domain)) {
 			if (new->lifetime == 0) {
 				g_array_remove_index (rdata->dns_domains, i);
+				_content_changed (priv, NM_NDISC_CONFIG_DNS_DOMAINS);
 				return TRUE;
 			}
 
@@ -664,6 +894,7 @@ nm_ndisc_add_dns_domain (NMNDisc *ndisc, const NMNDiscDNSDomain *new)
 		                       NMNDiscDNSDomain,
 		                       rdata->dns_domains->len - 1);
 		item->domain = g_strdup (new->domain);
+		_content_changed (priv, NM_NDISC_CONFIG_DNS_DOMAINS);
 	}
 	return !!new->lifetime;
 }
@@ -885,6 +1116,7 @@ nm_ndisc_set_iid (NMNDisc *ndisc, const NMUtilsIPv6IfaceId iid)
 		if (rdata->addresses->len) {
 			_LOGD ("IPv6 interface identifier changed, flushing addresses");
 			g_array_remove_range (rdata->addresses, 0, rdata->addresses->len);
+			_content_changed (priv, NM_NDISC_CONFIG_ADDRESSES);
 			nm_ndisc_emit_config_change (ndisc, NM_NDISC_CONFIG_ADDRESSES);
 			solicit_routers (ndisc);
 		}
@@ -953,11 +1185,13 @@ nm_ndisc_start (NMNDisc *ndisc)
 NMNDiscConfigMap
 nm_ndisc_dad_failed (NMNDisc *ndisc, const struct in6_addr *address, gboolean emit_changed_signal)
 {
+	NMNDiscPrivate *priv;
 	NMNDiscDataInternal *rdata;
 	guint i;
 	gboolean changed = FALSE;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
+	priv = NM_NDISC_GET_PRIVATE (ndisc);
+	rdata = &priv->rdata;
 
 	for (i = 0; i < rdata->addresses->len; ) {
 		NMNDiscAddress *item = &g_array_index (rdata->addresses, NMNDiscAddress, i);
@@ -975,6 +1209,9 @@ nm_ndisc_dad_failed (NMNDisc *ndisc, const struct in6_addr *address, gboolean em
 		i++;
 	}
 
+	if (changed)
+		_content_changed (priv, NM_NDISC_CONFIG_ADDRESSES);
+
 	if (emit_changed_signal && changed)
 		nm_ndisc_emit_config_change (ndisc, NM_NDISC_CONFIG_ADDRESSES);
 
@@ -1090,16 +1327,19 @@ _config_changed_log (NMNDisc *ndisc, NMNDiscConfigMap changed)
 static void
 clean_gateways (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
 {
+	NMNDiscPrivate *priv;
 	NMNDiscDataInternal *rdata;
 	guint i;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
+	priv = NM_NDISC_GET_PRIVATE (ndisc);
+	rdata = &priv->rdata;
 
 	for (i = 0; i < rdata->gateways->len; ) {
 		NMNDiscGateway *item = &g_array_index (rdata->gateways, NMNDiscGateway, i);
 
 		if (!expiry_next (now, get_expiry (item), nextevent)) {
 			g_array_remove_index (rdata->gateways, i);
+			_content_changed (priv, NM_NDISC_CONFIG_GATEWAYS);
 			*changed |= NM_NDISC_CONFIG_GATEWAYS;
 			continue;
 		}
@@ -1113,16 +1353,19 @@ clean_gateways (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *n
 static void
 clean_addresses (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
 {
+	NMNDiscPrivate *priv;
 	NMNDiscDataInternal *rdata;
 	guint i;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
+	priv = NM_NDISC_GET_PRIVATE (ndisc);
+	rdata = &priv->rdata;
 
 	for (i = 0; i < rdata->addresses->len; ) {
 		const NMNDiscAddress *item = &g_array_index (rdata->addresses, NMNDiscAddress, i);
 
 		if (!expiry_next (now, get_expiry (item), nextevent)) {
 			g_array_remove_index (rdata->addresses, i);
+			_content_changed (priv, NM_NDISC_CONFIG_ADDRESSES);
 			*changed |= NM_NDISC_CONFIG_ADDRESSES;
 			continue;
 		}
@@ -1134,16 +1377,19 @@ clean_addresses (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *
 static void
 clean_routes (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
 {
+	NMNDiscPrivate *priv;
 	NMNDiscDataInternal *rdata;
 	guint i;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
+	priv = NM_NDISC_GET_PRIVATE (ndisc);
+	rdata = &priv->rdata;
 
 	for (i = 0; i < rdata->routes->len; ) {
 		NMNDiscRoute *item = &g_array_index (rdata->routes, NMNDiscRoute, i);
 
 		if (!expiry_next (now, get_expiry (item), nextevent)) {
 			g_array_remove_index (rdata->routes, i);
+			_content_changed (priv, NM_NDISC_CONFIG_ROUTES);
 			*changed |= NM_NDISC_CONFIG_ROUTES;
 			continue;
 		}
@@ -1155,10 +1401,12 @@ clean_routes (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nex
 static void
 clean_dns_servers (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
 {
+	NMNDiscPrivate *priv;
 	NMNDiscDataInternal *rdata;
 	guint i;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
+	priv = NM_NDISC_GET_PRIVATE (ndisc);
+	rdata = &priv->rdata;
 
 	for (i = 0; i < rdata->dns_servers->len; ) {
 		NMNDiscDNSServer *item = &g_array_index (rdata->dns_servers, NMNDiscDNSServer, i);
@@ -1168,6 +1416,7 @@ clean_dns_servers (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32
 		if (refresh != _EXPIRY_INFINITY) {
 			if (!expiry_next (now, get_expiry (item), NULL)) {
 				g_array_remove_index (rdata->dns_servers, i);
+				_content_changed (priv, NM_NDISC_CONFIG_DNS_SERVERS);
 				*changed |= NM_NDISC_CONFIG_DNS_SERVERS;
 				continue;
 			}
@@ -1184,10 +1433,12 @@ clean_dns_servers (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32
 static void
 clean_dns_domains (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
 {
+	NMNDiscPrivate *priv;
 	NMNDiscDataInternal *rdata;
 	guint i;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
+	priv = NM_NDISC_GET_PRIVATE (ndisc);
+	rdata = &priv->rdata;
 
 	for (i = 0; i < rdata->dns_domains->len; ) {
 		NMNDiscDNSDomain *item = &g_array_index (rdata->dns_domains, NMNDiscDNSDomain, i);
@@ -1197,6 +1448,7 @@ clean_dns_domains (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32
 		if (refresh != _EXPIRY_INFINITY) {
 			if (!expiry_next (now, get_expiry (item), NULL)) {
 				g_array_remove_index (rdata->dns_domains, i);
+				_content_changed (priv, NM_NDISC_CONFIG_DNS_DOMAINS);
 				*changed |= NM_NDISC_CONFIG_DNS_DOMAINS;
 				continue;
 			}
@@ -1249,15 +1501,88 @@ timeout_cb (gpointer user_data)
 	return G_SOURCE_REMOVE;
 }
 
+/* Returns whether @router sent an RA with this @fingerprint before, and
+ * remembers the @fingerprint for the next one. */
+static gboolean
+_ra_fingerprint_update (NMNDisc *ndisc, const struct in6_addr *router, guint64 fingerprint)
+{
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NMNDiscRAFingerprint *item;
+	guint i;
+
+	if (!priv->ra_fingerprints)
+		priv->ra_fingerprints = g_array_new (FALSE, FALSE, sizeof (NMNDiscRAFingerprint));
+
+	for (i = 0; i < priv->ra_fingerprints->len; i++) {
+		item = &g_array_index (priv->ra_fingerprints, NMNDiscRAFingerprint, i);
+		if (IN6_ARE_ADDR_EQUAL (&item->router, router)) {
+			if (item->fingerprint == fingerprint)
+				return TRUE;
+			item->fingerprint = fingerprint;
+			return FALSE;
+		}
+	}
+
+	if (priv->ra_fingerprints->len >= RA_FINGERPRINTS_MAX)
+		g_array_remove_index (priv->ra_fingerprints, 0);
+
+	g_array_set_size (priv->ra_fingerprints, priv->ra_fingerprints->len + 1);
+	item = &g_array_index (priv->ra_fingerprints, NMNDiscRAFingerprint, priv->ra_fingerprints->len - 1);
+	item->router = *router;
+	item->fingerprint = fingerprint;
+	return FALSE;
+}
+
+/**
+ * nm_ndisc_ra_received:
+ * @ndisc: the #NMNDisc
+ * @now: the current timestamp in seconds
+ * @changed: the parts of the configuration that were updated by the RA
+ * @router: (allow-none): the address of the router that sent the RA
+ * @fingerprint: a hash of the RA's content
+ *
+ * Routers repeat their advertisements periodically, and usually without
+ * modification. If @router sent the same RA before and it only refreshed
+ * the lifetimes of the configuration, that is not signaled as a change.
+ * Only the addresses are still emitted periodically, because the kernel
+ * counts down their lifetimes.
+ */
 void
-nm_ndisc_ra_received (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap changed)
+nm_ndisc_ra_received (NMNDisc *ndisc,
+                      gint32 now,
+                      NMNDiscConfigMap changed,
+                      const struct in6_addr *router,
+                      guint64 fingerprint)
 {
 	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NMNDiscConfigMap refreshed;
 
 	nm_clear_g_source (&priv->ra_timeout_id);
 	nm_clear_g_source (&priv->send_rs_id);
 	nm_clear_g_free (&priv->last_error);
+
+	if (   router
+	    && _ra_fingerprint_update (ndisc, router, fingerprint)) {
+		refreshed =   changed
+		            & ~priv->changed_content
+		            & (  NM_NDISC_CONFIG_GATEWAYS
+		               | NM_NDISC_CONFIG_ADDRESSES
+		               | NM_NDISC_CONFIG_ROUTES
+		               | NM_NDISC_CONFIG_DNS_SERVERS
+		               | NM_NDISC_CONFIG_DNS_DOMAINS);
+		if (now >= priv->addresses_refresh_at)
+			refreshed &= ~NM_NDISC_CONFIG_ADDRESSES;
+		if (refreshed) {
+			_LOGT ("identical RA only refreshed lifetimes, don't signal changes 0x%x",
+			       (guint) refreshed);
+			changed &= ~refreshed;
+		}
+	}
+
 	check_timestamps (ndisc, now, changed);
+
+	priv->changed_content = NM_NDISC_CONFIG_NONE;
+	_idx_rebuild (ndisc);
 }
 
 void
@@ -1407,6 +1732,10 @@ finalize (GObject *object)
 	g_array_unref (rdata->dns_servers);
 	g_array_unref (rdata->dns_domains);
 
+	_idx_clear (&priv->gateways_idx);
+	_idx_clear (&priv->routes_idx);
+	nm_clear_pointer (&priv->ra_fingerprints, g_array_unref);
+
 	g_clear_object (&priv->netns);
 	g_clear_object (&priv->platform);
 
@@ -426,6 +426,81 @@ test_preference_changed (void)
 	g_main_loop_unref (data.loop);
 }
 
+static void
+test_repeated_ra_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_int, TestData *data)
+{
+	NMNDiscConfigMap changed = changed_int;
+
+	if (data->counter == 0) {
+		g_assert_cmpint (changed, ==, NM_NDISC_CONFIG_DHCP_LEVEL |
+		                              NM_NDISC_CONFIG_GATEWAYS |
+		                              NM_NDISC_CONFIG_ADDRESSES |
+		                              NM_NDISC_CONFIG_ROUTES |
+		                              NM_NDISC_CONFIG_DNS_SERVERS |
+		                              NM_NDISC_CONFIG_DNS_DOMAINS |
+		                              NM_NDISC_CONFIG_HOP_LIMIT |
+		                              NM_NDISC_CONFIG_MTU);
+		match_gateway (rdata, 0, "fe80::1", data->timestamp1, 10, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+		match_address (rdata, 0, "2001:db8:a:a::1", data->timestamp1, 10, 10);
+	} else if (data->counter == 1) {
+		/* the second RA is identical and only refreshed the lifetimes. It was
+		 * not signaled. The third one is identical too, but by now, half of
+		 * the address lifetime elapsed, so the addresses are emitted again. */
+		g_assert_cmpint (changed, ==, NM_NDISC_CONFIG_ADDRESSES);
+
+		/* the other parts are still refreshed, just not signaled. */
+		g_assert_cmpint (rdata->gateways_n, ==, 1);
+		match_gateway (rdata, 0, "fe80::1", data->timestamp1 + 6, 10, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+		g_assert_cmpint (rdata->addresses_n, ==, 1);
+		match_address (rdata, 0, "2001:db8:a:a::1", data->timestamp1 + 6, 10, 10);
+		g_assert_cmpint (rdata->routes_n, ==, 1);
+		match_route (rdata, 0, "2001:db8:a:a::", 64, "fe80::1", data->timestamp1 + 6, 10, 10);
+		g_assert_cmpint (rdata->dns_servers_n, ==, 1);
+		match_dns_server (rdata, 0, "2001:db8:c:c::1", data->timestamp1 + 6, 10);
+
+		g_assert (nm_fake_ndisc_done (NM_FAKE_NDISC (ndisc)));
+		g_main_loop_quit (data->loop);
+	} else
+		g_assert_not_reached ();
+
+	data->counter++;
+}
+
+static void
+test_repeated_ra (void)
+{
+	NMFakeNDisc *ndisc = ndisc_new ();
+	guint32 now = nm_utils_get_monotonic_timestamp_sec ();
+	TestData data = { g_main_loop_new (NULL, FALSE), 0, 0, now };
+	const guint32 timestamps[] = { now, now + 1, now + 6 };
+	const guint seconds[] = { 1, 1, 5 };
+	guint id;
+	guint i;
+
+	/* a router repeats the same RA. */
+	for (i = 0; i < G_N_ELEMENTS (timestamps); i++) {
+		id = nm_fake_ndisc_add_ra (ndisc, seconds[i], NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+		g_assert (id);
+		nm_fake_ndisc_set_router (ndisc, id, "fe80::1");
+		nm_fake_ndisc_add_gateway (ndisc, id, "fe80::1", timestamps[i], 10, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+		nm_fake_ndisc_add_prefix (ndisc, id, "2001:db8:a:a::", 64, "fe80::1", timestamps[i], 10, 10, 10);
+		nm_fake_ndisc_add_dns_server (ndisc, id, "2001:db8:c:c::1", timestamps[i], 10);
+		nm_fake_ndisc_add_dns_domain (ndisc, id, "foobar.com", timestamps[i], 10);
+	}
+
+	g_signal_connect (ndisc,
+	                  NM_NDISC_CONFIG_RECEIVED,
+	                  G_CALLBACK (test_repeated_ra_changed),
+	                  &data);
+
+	nm_ndisc_start (NM_NDISC (ndisc));
+	g_main_loop_run (data.loop);
+	g_assert_cmpint (data.counter, ==, 2);
+
+	g_object_unref (ndisc);
+	g_main_loop_unref (data.loop);
+}
+
 static void
 test_dns_solicit_loop_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_int, TestData *data)
 {
@@ -526,6 +601,7 @@ main (int argc, char **argv)
 	g_test_add_func ("/ndisc/everything-changed", test_everything);
 	g_test_add_func ("/ndisc/preference-order", test_preference_order);
 	g_test_add_func ("/ndisc/preference-changed", test_preference_changed);
+	g_test_add_func ("/ndisc/repeated-ra", test_repeated_ra);
 	g_test_add_func ("/ndisc/dns-solicit-loop", test_dns_solicit_loop);
 
 	return g_test_run ();
@@ -21,6 +21,12 @@
 #define CANCELLATION_ID_PREFIX "cancellation-id-"
 #define CANCELLATION_TIMEOUT_MS 5000
 
+/* how long a cached authorization result from polkit is used. */
+#define AUTH_CACHE_TTL_MSEC 10000
+
+/* the maximum number of cached authorization results. */
+#define AUTH_CACHE_MAX_SIZE 1000
+
 /*****************************************************************************/
 
 NM_GOBJECT_PROPERTIES_DEFINE_BASE (
@@ -39,7 +45,9 @@ typedef struct {
 	GDBusConnection *dbus_connection;
 	GCancellable *main_cancellable;
 	char *name_owner;
+	GHashTable *auth_cache;
 	guint64 call_numid_counter;
+	guint64 auth_cache_generation;
 	guint changed_id;
 	guint name_owner_changed_id;
 	bool disposing:1;
@@ -69,7 +77,7 @@ NM_DEFINE_SINGLETON_REGISTER (NMAuthManager);
 #define _NMLOG_DOMAIN         LOGD_CORE
 #define _NMLOG(level, ...) \
     G_STMT_START { \
-        if (nm_logging_enabled ((level), (_NMLOG_DOMAIN))) { \
+        if (nm_log_enabled ((level), (_NMLOG_DOMAIN))) { \
             char __prefix[30] = _NMLOG_PREFIX_NAME; \
             \
             if ((self) != singleton_instance) \
@@ -82,7 +90,7 @@ NM_DEFINE_SINGLETON_REGISTER (NMAuthManager);
 
 #define _NMLOG2(level, call_id, ...) \
     G_STMT_START { \
-        if (nm_logging_enabled ((level), (_NMLOG_DOMAIN))) { \
+        if (nm_log_enabled ((level), (_NMLOG_DOMAIN))) { \
             NMAuthManagerCallId *_call_id = (call_id); \
             char __prefix[30] = _NMLOG_PREFIX_NAME; \
             \
@@ -119,17 +127,173 @@ typedef enum {
 	POLKIT_CHECK_AUTHORIZATION_FLAGS_ALLOW_USER_INTERACTION = (1<<0),
 } PolkitCheckAuthorizationFlags;
 
+typedef struct {
+	gulong uid;
+	gulong pid;
+	guint64 start_time;
+	gint64 expiry_msec;
+	bool is_authorized:1;
+	char action_id[];
+} AuthCacheEntry;
+
 struct _NMAuthManagerCallId {
 	CList calls_lst;
 	NMAuthManager *self;
 	GCancellable *dbus_cancellable;
 	NMAuthManagerCheckAuthorizationCallback callback;
 	gpointer user_data;
+	AuthCacheEntry *cache_entry;
+	guint64 cache_generation;
 	guint64 call_numid;
 	guint idle_id;
 	bool idle_is_authorized:1;
 };
 
+/*****************************************************************************/
+
+static guint
+_auth_cache_entry_hash (gconstpointer ptr)
+{
+	const AuthCacheEntry *entry = ptr;
+	NMHashState h;
+
+	nm_hash_init (&h, 1569432787u);
+	nm_hash_update_vals (&h,
+	                     entry->uid,
+	                     entry->pid,
+	                     entry->start_time);
+	nm_hash_update_str (&h, entry->action_id);
+	return nm_hash_complete (&h);
+}
+
+static gboolean
+_auth_cache_entry_equal (gconstpointer ptr_a, gconstpointer ptr_b)
+{
+	const AuthCacheEntry *a = ptr_a;
+	const AuthCacheEntry *b = ptr_b;
+
+	return    a->uid == b->uid
+	       && a->pid == b->pid
+	       && a->start_time == b->start_time
+	       && nm_streq (a->action_id, b->action_id);
+}
+
+static AuthCacheEntry *
+_auth_cache_entry_new (NMAuthSubject *subject,
+                       const char *action_id,
+                       gboolean allow_user_interaction)
+{
+	AuthCacheEntry *entry;
+	guint64 start_time;
+	gsize action_id_len;
+
+	/* With user interaction, polkit might have granted a one-time authorization
+	 * after asking for a password. That must not be reused, so only
+	 * non-interactive requests are cached. */
+	if (allow_user_interaction)
+		return NULL;
+
+	/* without start-time, a process cannot be told apart from a later one
+	 * that reuses the PID. */
+	start_time = nm_auth_subject_get_unix_process_start_time (subject);
+	if (start_time == 0)
+		return NULL;
+
+	action_id_len = strlen (action_id) + 1;
+
+	entry = g_malloc (sizeof (AuthCacheEntry) + action_id_len);
+	*entry = (AuthCacheEntry) {
+		.uid        = nm_auth_subject_get_unix_process_uid (subject),
+		.pid        = nm_auth_subject_get_unix_process_pid (subject),
+		.start_time = start_time,
+	};
+	memcpy (entry->action_id, action_id, action_id_len);
+	return entry;
+}
+
+static gboolean
+_auth_cache_lookup (NMAuthManager *self,
+                    NMAuthSubject *subject,
+                    const char *action_id,
+                    gboolean allow_user_interaction,
+                    gboolean *out_is_authorized)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+	gs_free AuthCacheEntry *needle = NULL;
+	const AuthCacheEntry *entry;
+
+	if (   !priv->auth_cache
+	    || g_hash_table_size (priv->auth_cache) == 0)
+		return FALSE;
+
+	needle = _auth_cache_entry_new (subject, action_id, allow_user_interaction);
+	if (!needle)
+		return FALSE;
+
+	entry = g_hash_table_lookup (priv->auth_cache, needle);
+	if (!entry)
+		return FALSE;
+
+	if (entry->expiry_msec <= nm_utils_get_monotonic_timestamp_msec ()) {
+		g_hash_table_remove (priv->auth_cache, entry);
+		return FALSE;
+	}
+
+	*out_is_authorized = entry->is_authorized;
+	return TRUE;
+}
+
+static gboolean
+_auth_cache_remove_expired_cb (gpointer key, gpointer value, gpointer user_data)
+{
+	const AuthCacheEntry *entry = key;
+
+	return entry->expiry_msec <= *((const gint64 *) user_data);
+}
+
+static void
+_auth_cache_add (NMAuthManagerCallId *call_id,
+                 gboolean is_authorized)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (call_id->self);
+	AuthCacheEntry *entry;
+	gint64 now_msec;
+
+	if (!priv->auth_cache)
+		return;
+
+	if (call_id->cache_generation != priv->auth_cache_generation) {
+		/* polkit signaled a change while the request was pending. The
+		 * result might already be outdated. */
+		return;
+	}
+
+	now_msec = nm_utils_get_monotonic_timestamp_msec ();
+
+	if (g_hash_table_size (priv->auth_cache) >= AUTH_CACHE_MAX_SIZE) {
+		g_hash_table_foreach_remove (priv->auth_cache, _auth_cache_remove_expired_cb, &now_msec);
+		if (g_hash_table_size (priv->auth_cache) >= AUTH_CACHE_MAX_SIZE)
+			g_hash_table_remove_all (priv->auth_cache);
+	}
+
+	entry = g_steal_pointer (&call_id->cache_entry);
+	entry->expiry_msec = now_msec + AUTH_CACHE_TTL_MSEC;
+	entry->is_authorized = is_authorized;
+	g_hash_table_add (priv->auth_cache, entry);
+}
+
+static void
+_auth_cache_clear (NMAuthManager *self)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+
+	priv->auth_cache_generation++;
+	if (priv->auth_cache)
+		g_hash_table_remove_all (priv->auth_cache);
+}
+
+/*****************************************************************************/
+
 #define cancellation_id_to_str_a(call_numid) \
 	nm_sprintf_bufa (NM_STRLEN (CANCELLATION_ID_PREFIX) + 60, \
 	                 CANCELLATION_ID_PREFIX"%"G_GUINT64_FORMAT, \
@@ -148,6 +312,7 @@ _call_id_free (NMAuthManagerCallId *call_id)
 		return;
 	}
 
+	g_free (call_id->cache_entry);
 	g_object_unref (call_id->self);
 	g_slice_free (NMAuthManagerCallId, call_id);
 }
@@ -257,6 +422,12 @@ _call_check_authorize_cb (GObject *proxy,
 		               NULL);
 		_LOG2T (call_id, "completed: authorized=%d, challenge=%d",
 		        is_authorized, is_challenge);
+
+		/* a challenge means that the user could authenticate. Only cache
+		 * definite results. */
+		if (   call_id->cache_entry
+		    && !is_challenge)
+			_auth_cache_add (call_id, is_authorized);
 	} else
 		_LOG2T (call_id, "completed: failed: %s", error->message);
 
@@ -305,6 +476,7 @@ nm_auth_manager_check_authorization (NMAuthManager *self,
 	PolkitCheckAuthorizationFlags flags;
 	char subject_buf[64];
 	NMAuthManagerCallId *call_id;
+	gboolean is_authorized;
 
 	g_return_val_if_fail (NM_IS_AUTH_MANAGER (self), NULL);
 	g_return_val_if_fail (NM_IN_SET (nm_auth_subject_get_subject_type (subject),
@@ -343,6 +515,10 @@ nm_auth_manager_check_authorization (NMAuthManager *self,
 		        priv->auth_polkit_mode == NM_AUTH_POLKIT_MODE_ALLOW_ALL ? "grant" : "deny");
 		call_id->idle_is_authorized = (priv->auth_polkit_mode == NM_AUTH_POLKIT_MODE_ALLOW_ALL);
 		call_id->idle_id = g_idle_add (_call_on_idle, call_id);
+	} else if (_auth_cache_lookup (self, subject, action_id, allow_user_interaction, &is_authorized)) {
+		_LOG2T (call_id, "CheckAuthorization(%s), subject=%s (cached result)", action_id, nm_auth_subject_to_string (subject, subject_buf, sizeof (subject_buf)));
+		call_id->idle_is_authorized = is_authorized;
+		call_id->idle_id = g_idle_add (_call_on_idle, call_id);
 	} else {
 		GVariant *parameters;
 		GVariantBuilder builder;
@@ -366,6 +542,8 @@ nm_auth_manager_check_authorization (NMAuthManager *self,
 		_LOG2T (call_id, "CheckAuthorization(%s), subject=%s", action_id, nm_auth_subject_to_string (subject, subject_buf, sizeof (subject_buf)));
 
 		call_id->dbus_cancellable = g_cancellable_new ();
+		call_id->cache_entry = _auth_cache_entry_new (subject, action_id, allow_user_interaction);
+		call_id->cache_generation = priv->auth_cache_generation;
 
 		nm_assert (priv->main_cancellable);
 
@@ -430,8 +608,10 @@ changed_signal_cb (GDBusConnection *connection,
 
 	_LOGD ("dbus-signal: \"Changed\" notification%s", valid_sender ? "" : " (ignore)");
 
-	if (valid_sender)
+	if (valid_sender) {
+		_auth_cache_clear (self);
 		_emit_changed_signal (self);
+	}
 }
 
 static void
@@ -475,6 +655,8 @@ _name_owner_changed (NMAuthManager *self,
 			_LOGT ("name-owner: polkit started (now %s)", priv->name_owner);
 	}
 
+	_auth_cache_clear (self);
+
 	if (priv->name_owner)
 		_emit_changed_signal (self);
 }
@@ -624,6 +806,11 @@ constructed (GObject *object)
 
 	priv->main_cancellable = g_cancellable_new ();
 
+	priv->auth_cache = g_hash_table_new_full (_auth_cache_entry_hash,
+	                                          _auth_cache_entry_equal,
+	                                          g_free,
+	                                          NULL);
+
 	priv->name_owner_changed_id = nm_dbus_connection_signal_subscribe_name_owner_changed (priv->dbus_connection,
 	                                                                                      POLKIT_SERVICE,
 	                                                                                      _name_owner_changed_cb,
@@ -703,6 +890,7 @@ dispose (GObject *object)
 	g_clear_object (&priv->dbus_connection);
 
 	nm_clear_g_free (&priv->name_owner);
+	nm_clear_pointer (&priv->auth_cache, g_hash_table_unref);
 }
 
 static void
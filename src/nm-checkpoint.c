@@ -76,7 +76,7 @@ G_DEFINE_TYPE (NMCheckpoint, nm_checkpoint, NM_TYPE_DBUS_OBJECT)
 
 #define _NMLOG(level, ...) \
 	G_STMT_START { \
-		if (nm_logging_enabled (level, _NMLOG_DOMAIN)) { \
+		if (nm_log_enabled (level, _NMLOG_DOMAIN)) { \
 			char __prefix[32]; \
 			\
 			if (self) \
@@ -770,9 +770,11 @@ static const ConfigGroup config_groups[] = {
 	{
 		.group = NM_CONFIG_KEYFILE_GROUP_LOGGING,
 		.keys = NM_MAKE_STRV (
+			NM_CONFIG_KEYFILE_KEY_LOGGING_ASYNC_QUEUE_SIZE,
 			NM_CONFIG_KEYFILE_KEY_LOGGING_AUDIT,
 			NM_CONFIG_KEYFILE_KEY_LOGGING_BACKEND,
 			NM_CONFIG_KEYFILE_KEY_LOGGING_DOMAINS,
+			NM_CONFIG_KEYFILE_KEY_LOGGING_FLIGHT_RECORDER_SIZE,
 			NM_CONFIG_KEYFILE_KEY_LOGGING_LEVEL,
 		),
 	},
@@ -789,6 +791,7 @@ static const ConfigGroup config_groups[] = {
 		.group = NM_CONFIG_KEYFILE_GROUP_KEYFILE,
 		.keys = NM_MAKE_STRV (
 			NM_CONFIG_KEYFILE_KEY_KEYFILE_HOSTNAME,
+			NM_CONFIG_KEYFILE_KEY_KEYFILE_INCREMENTAL_RELOAD,
 			NM_CONFIG_KEYFILE_KEY_KEYFILE_PATH,
 			NM_CONFIG_KEYFILE_KEY_KEYFILE_UNMANAGED_DEVICES,
 		),
@@ -804,10 +807,13 @@ static const ConfigGroup config_groups[] = {
 		.is_prefix = TRUE,
 		.keys = NM_MAKE_STRV (
 			NM_CONFIG_KEYFILE_KEY_DEVICE_CARRIER_WAIT_TIMEOUT,
+			NM_CONFIG_KEYFILE_KEY_DEVICE_DHCP4_RAPID_COMMIT,
 			NM_CONFIG_KEYFILE_KEY_DEVICE_IGNORE_CARRIER,
+			NM_CONFIG_KEYFILE_KEY_DEVICE_LLDP_MIN_UPDATE_INTERVAL,
 			NM_CONFIG_KEYFILE_KEY_DEVICE_MANAGED,
 			NM_CONFIG_KEYFILE_KEY_DEVICE_SRIOV_NUM_VFS,
 			NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_BACKEND,
+			NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_MAX_APS_PER_SSID,
 			NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_SCAN_RAND_MAC_ADDRESS,
 			NM_CONFIG_KEYFILE_KEY_MATCH_DEVICE,
 			NM_CONFIG_KEYFILE_KEY_STOP_MATCH,
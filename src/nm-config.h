@@ -58,9 +58,11 @@
 #define NM_CONFIG_KEYFILE_KEY_MAIN_SLAVES_ORDER             "slaves-order"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_SYSTEMD_RESOLVED         "systemd-resolved"
 
+#define NM_CONFIG_KEYFILE_KEY_LOGGING_ASYNC_QUEUE_SIZE      "async-queue-size"
 #define NM_CONFIG_KEYFILE_KEY_LOGGING_AUDIT                 "audit"
 #define NM_CONFIG_KEYFILE_KEY_LOGGING_BACKEND               "backend"
 #define NM_CONFIG_KEYFILE_KEY_LOGGING_DOMAINS               "domains"
+#define NM_CONFIG_KEYFILE_KEY_LOGGING_FLIGHT_RECORDER_SIZE  "flight-recorder-size"
 #define NM_CONFIG_KEYFILE_KEY_LOGGING_LEVEL                 "level"
 
 #define NM_CONFIG_KEYFILE_KEY_CONNECTIVITY_ENABLED          "enabled"
@@ -71,6 +73,7 @@
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_PATH                  "path"
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_UNMANAGED_DEVICES     "unmanaged-devices"
 #define NM_CONFIG_KEYFILE_KEY_KEYFILE_HOSTNAME              "hostname"
+#define NM_CONFIG_KEYFILE_KEY_KEYFILE_INCREMENTAL_RELOAD    "incremental-reload"
 
 #define NM_CONFIG_KEYFILE_KEY_IFUPDOWN_MANAGED              "managed"
 
@@ -85,7 +88,10 @@
 #define NM_CONFIG_KEYFILE_KEY_DEVICE_SRIOV_NUM_VFS          "sriov-num-vfs"
 #define NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_BACKEND           "wifi.backend"
 #define NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_SCAN_RAND_MAC_ADDRESS "wifi.scan-rand-mac-address"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_MAX_APS_PER_SSID "wifi.max-aps-per-ssid"
 #define NM_CONFIG_KEYFILE_KEY_DEVICE_CARRIER_WAIT_TIMEOUT   "carrier-wait-timeout"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_DHCP4_RAPID_COMMIT     "dhcp4.rapid-commit"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_LLDP_MIN_UPDATE_INTERVAL "lldp.min-update-interval"
 
 #define NM_CONFIG_KEYFILE_KEY_MATCH_DEVICE           "match-device"
 #define NM_CONFIG_KEYFILE_KEY_STOP_MATCH             "stop-match"
@@ -24,6 +24,10 @@
 
 #define HEADER_STATUS_ONLINE "X-NetworkManager-Status: online\r\n"
 
+/* how long we remember the addresses of the check host that
+ * systemd-resolved returned. */
+#define CONCHECK_DNS_CACHE_TTL_MSEC (60 * 1000)
+
 /*****************************************************************************/
 
 static
@@ -57,8 +61,27 @@ typedef struct {
 	char *response;
 } ConConfig;
 
+typedef struct {
+	/* the key must be the first field. */
+	char *key;
+
+	NMConnectivity *self;
+
+	/* the result of the last lookup, of type "a(iiay)". */
+	GVariant *addresses;
+	gint64 expiry_msec;
+
+	/* while a lookup is pending, the checks that wait for it. */
+	GCancellable *cancellable;
+	CList waiters_lst_head;
+
+	/* the DNS configuration changed while the lookup was pending. */
+	bool stale:1;
+} DnsCacheEntry;
+
 struct _NMConnectivityCheckHandle {
 	CList handles_lst;
+	CList queued_lst;
 	NMConnectivity *self;
 	NMConnectivityCheckCallback callback;
 	gpointer user_data;
@@ -72,7 +95,8 @@ struct _NMConnectivityCheckHandle {
 	struct {
 		ConConfig *con_config;
 
-		GCancellable *resolve_cancellable;
+		CList dns_waiters_lst;
+		char *dns_key;
 		CURLM *curl_mhandle;
 		CURL *curl_ehandle;
 		struct curl_slist *request_headers;
@@ -87,12 +111,17 @@ struct _NMConnectivityCheckHandle {
 
 	guint64 request_counter;
 
+	gint64 start_msec;
+	gint64 latency_msec;
+
 	int addr_family;
 
 	guint timeout_id;
 
 	NMConnectivityState completed_state;
 	const char *completed_reason;
+
+	bool is_running:1;
 };
 
 enum {
@@ -106,10 +135,24 @@ static guint signals[LAST_SIGNAL] = { 0 };
 typedef struct {
 	CList handles_lst_head;
 	CList completed_handles_lst_head;
+	CList queued_lst_head;
 	NMConfig *config;
 	ConConfig *con_config;
 	guint interval;
 
+	guint n_running;
+	guint queue_idle_id;
+	guint32 offset_counter;
+
+	/* the addresses of the check host, per set of name servers. */
+	GHashTable *dns_cache;
+	NMDnsManager *dns_manager;
+
+	/* set by tests, to resolve via this connection (or not at all)
+	 * instead of asking the NMDnsManager and NMDBusManager singletons. */
+	GDBusConnection *nmtst_resolve_dbus_connection;
+	bool nmtst_resolve_set:1;
+
 	bool enabled:1;
 	bool uri_valid:1;
 } NMConnectivityPrivate;
@@ -139,7 +182,7 @@ NM_DEFINE_SINGLETON_GETTER (NMConnectivity, nm_connectivity_get, NM_TYPE_CONNECT
     G_STMT_START { \
         const NMLogLevel __level = (level); \
         \
-        if (nm_logging_enabled (__level, _NMLOG2_DOMAIN)) { \
+        if (nm_log_enabled (__level, _NMLOG2_DOMAIN)) { \
             _nm_log (__level, _NMLOG2_DOMAIN, 0, \
                      (cb_data->ifspec ? &cb_data->ifspec[3] : NULL), \
                      NULL, \
@@ -194,12 +237,71 @@ _con_config_get_response (const ConConfig *con_config)
 
 /*****************************************************************************/
 
+#if WITH_CONCHECK
+static void
+_dns_cache_entry_free (gpointer data)
+{
+	DnsCacheEntry *entry = data;
+
+	nm_assert (c_list_is_empty (&entry->waiters_lst_head));
+
+	nm_clear_g_cancellable (&entry->cancellable);
+	nm_clear_pointer (&entry->addresses, g_variant_unref);
+	g_free (entry->key);
+	nm_g_slice_free (entry);
+}
+
+static void
+_dns_cache_invalidate (NMConnectivity *self, const char *key)
+{
+	NMConnectivityPrivate *priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+	DnsCacheEntry *entry;
+
+	if (!priv->dns_cache)
+		return;
+
+	entry = g_hash_table_lookup (priv->dns_cache, &key);
+	if (   entry
+	    && !entry->cancellable) {
+		_LOGT ("drop cached addresses for '%s'", key);
+		g_hash_table_remove (priv->dns_cache, entry);
+	}
+}
+
+static void
+_dns_config_changed (NMDnsManager *dns_manager, gpointer user_data)
+{
+	NMConnectivity *self = user_data;
+	NMConnectivityPrivate *priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+	GHashTableIter iter;
+	DnsCacheEntry *entry;
+
+	if (!priv->dns_cache)
+		return;
+
+	/* the name servers might have changed. Pending lookups still serve the checks
+	 * that wait for them, but their result is not remembered. */
+	g_hash_table_iter_init (&iter, priv->dns_cache);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &entry, NULL)) {
+		if (entry->cancellable)
+			entry->stale = TRUE;
+		else
+			g_hash_table_iter_remove (&iter);
+	}
+}
+
+static void _queue_schedule (NMConnectivity *self);
+#endif
+
+/*****************************************************************************/
+
 static void
 cb_data_complete (NMConnectivityCheckHandle *cb_data,
                   NMConnectivityState state,
                   const char *log_message)
 {
 	NMConnectivity *self;
+	char latency_buf[50];
 
 	nm_assert (cb_data);
 	nm_assert (NM_IS_CONNECTIVITY (cb_data->self));
@@ -214,8 +316,30 @@ cb_data_complete (NMConnectivityCheckHandle *cb_data,
 	cb_data->self = NULL;
 
 	c_list_unlink_stale (&cb_data->handles_lst);
+	c_list_unlink (&cb_data->queued_lst);
 
 #if WITH_CONCHECK
+	if (cb_data->is_running) {
+		NMConnectivityPrivate *priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+
+		cb_data->is_running = FALSE;
+		cb_data->latency_msec = nm_utils_get_monotonic_timestamp_msec () - cb_data->start_msec;
+
+		/* let the next queued check start. */
+		nm_assert (priv->n_running > 0);
+		priv->n_running--;
+		_queue_schedule (self);
+	}
+
+	c_list_unlink (&cb_data->concheck.dns_waiters_lst);
+	if (   cb_data->concheck.dns_key
+	    && NM_IN_SET (state, NM_CONNECTIVITY_LIMITED,
+	                         NM_CONNECTIVITY_PORTAL)) {
+		/* the check used a cached address and failed. Maybe the address is
+		 * no longer right, resolve it anew next time. */
+		_dns_cache_invalidate (self, cb_data->concheck.dns_key);
+	}
+
 	if (cb_data->concheck.curl_ehandle) {
 		/* Contrary to what cURL manual claim it is *not* safe to remove
 		 * the easy handle "at any moment"; specifically it's not safe to
@@ -240,14 +364,19 @@ cb_data_complete (NMConnectivityCheckHandle *cb_data,
 		curl_slist_free_all (cb_data->concheck.hosts);
 	}
 	nm_clear_g_source (&cb_data->concheck.curl_timer);
-	nm_clear_g_cancellable (&cb_data->concheck.resolve_cancellable);
 #endif
 
 	nm_clear_g_source (&cb_data->timeout_id);
 
-	_LOG2D ("check completed: %s; %s",
+	if (cb_data->latency_msec >= 0)
+		nm_sprintf_buf (latency_buf, " (after %"G_GINT64_FORMAT" msec)", cb_data->latency_msec);
+	else
+		latency_buf[0] = '\0';
+
+	_LOG2D ("check completed: %s; %s%s",
 	        nm_connectivity_state_to_string (state),
-	        log_message);
+	        log_message,
+	        latency_buf);
 
 	cb_data->callback (self,
 	                   cb_data,
@@ -260,6 +389,7 @@ cb_data_complete (NMConnectivityCheckHandle *cb_data,
 
 #if WITH_CONCHECK
 	_con_config_unref (cb_data->concheck.con_config);
+	g_free (cb_data->concheck.dns_key);
 #endif
 	g_free (cb_data->ifspec);
 	if (cb_data->completed_log_message_free)
@@ -722,34 +852,14 @@ do_curl_request (NMConnectivityCheckHandle *cb_data)
 }
 
 static void
-resolve_cb (GObject *object, GAsyncResult *res, gpointer user_data)
+_resolve_apply (NMConnectivityCheckHandle *cb_data, GVariant *addresses)
 {
-	NMConnectivityCheckHandle *cb_data;
-	gs_unref_variant GVariant *result = NULL;
-	gs_unref_variant GVariant *addresses = NULL;
 	gsize no_addresses;
 	int ifindex;
 	int addr_family;
 	gsize len = 0;
 	gsize i;
-	gs_free_error GError *error = NULL;
-
-	result = g_dbus_connection_call_finish (G_DBUS_CONNECTION (object), res, &error);
-	if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
-		return;
-
-	cb_data = user_data;
-
-	g_clear_object (&cb_data->concheck.resolve_cancellable);
-
-	if (!result) {
-		/* Never mind. Just let do curl do its own resolving. */
-		_LOG2D ("can't resolve a name via systemd-resolved: %s", error->message);
-		do_curl_request (cb_data);
-		return;
-	}
 
-	addresses = g_variant_get_child_value (result, 0);
 	no_addresses = g_variant_n_children (addresses);
 
 	for (i = 0; i < no_addresses; i++) {
@@ -776,8 +886,66 @@ resolve_cb (GObject *object, GAsyncResult *res, gpointer user_data)
 		cb_data->concheck.hosts = curl_slist_append (cb_data->concheck.hosts, host_entry);
 		_LOG2T ("adding '%s' to curl resolve list", host_entry);
 	}
+}
+
+static void
+resolve_cb (GObject *object, GAsyncResult *res, gpointer user_data)
+{
+	NMConnectivity *self;
+	NMConnectivityPrivate *priv;
+	NMConnectivityCheckHandle *cb_data;
+	DnsCacheEntry *entry;
+	CList waiters_lst_head;
+	gs_unref_variant GVariant *result = NULL;
+	gs_unref_variant GVariant *addresses = NULL;
+	gs_free char *key = NULL;
+	gs_free_error GError *error = NULL;
+
+	result = g_dbus_connection_call_finish (G_DBUS_CONNECTION (object), res, &error);
+	if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		return;
+
+	entry = user_data;
+	self = entry->self;
+	priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+
+	g_clear_object (&entry->cancellable);
+
+	/* take the waiting checks. Starting their requests invokes callbacks,
+	 * which might drop @entry from the cache. */
+	c_list_init (&waiters_lst_head);
+	c_list_splice (&waiters_lst_head, &entry->waiters_lst_head);
+
+	if (!result) {
+		g_hash_table_remove (priv->dns_cache, entry);
+
+		while ((cb_data = c_list_first_entry (&waiters_lst_head, NMConnectivityCheckHandle, concheck.dns_waiters_lst))) {
+			c_list_unlink (&cb_data->concheck.dns_waiters_lst);
+
+			/* Never mind. Just let do curl do its own resolving. */
+			_LOG2D ("can't resolve a name via systemd-resolved: %s", error->message);
+			do_curl_request (cb_data);
+		}
+		return;
+	}
+
+	addresses = g_variant_get_child_value (result, 0);
+	key = g_strdup (entry->key);
+
+	if (entry->stale)
+		g_hash_table_remove (priv->dns_cache, entry);
+	else {
+		entry->addresses = g_variant_ref (addresses);
+		entry->expiry_msec = nm_utils_get_monotonic_timestamp_msec () + CONCHECK_DNS_CACHE_TTL_MSEC;
+	}
+
+	while ((cb_data = c_list_first_entry (&waiters_lst_head, NMConnectivityCheckHandle, concheck.dns_waiters_lst))) {
+		c_list_unlink (&cb_data->concheck.dns_waiters_lst);
 
-	do_curl_request (cb_data);
+		cb_data->concheck.dns_key = g_strdup (key);
+		_resolve_apply (cb_data, addresses);
+		do_curl_request (cb_data);
+	}
 }
 #endif
 
@@ -851,6 +1019,193 @@ check_platform_config (NMConnectivity *self,
 	return NM_CONNECTIVITY_UNKNOWN;
 }
 
+#if WITH_CONCHECK
+static void
+_request_start (NMConnectivityCheckHandle *cb_data)
+{
+	NMConnectivity *self = cb_data->self;
+	NMConnectivityPrivate *priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+	NMDnsManager *dns_manager;
+	GDBusConnection *dbus_connection;
+	DnsCacheEntry *entry;
+	gs_free char *nameservers = NULL;
+	gs_free char *key = NULL;
+	gboolean has_resolved;
+	gint64 now_msec;
+
+	nm_assert (!cb_data->is_running);
+	nm_assert (priv->n_running < NM_CONNECTIVITY_MAX_RUNNING);
+
+	now_msec = nm_utils_get_monotonic_timestamp_msec ();
+
+	cb_data->is_running = TRUE;
+	cb_data->start_msec = now_msec;
+	priv->n_running++;
+
+	/* note that we pick up support for systemd-resolved right away when we need it.
+	 * We don't need to remember the setting, because we can (cheaply) check anew
+	 * on each request.
+	 *
+	 * Yes, this makes NMConnectivity singleton dependent on NMDnsManager singleton.
+	 * Well, not really: it makes connectivity-check-start dependent on NMDnsManager
+	 * which merely means, not to start a connectivity check, late during shutdown.
+	 *
+	 * NMDnsSystemdResolved tries to D-Bus activate systemd-resolved only once,
+	 * to not spam syslog with failures messages from dbus-daemon.
+	 * Note that unless NMDnsSystemdResolved tried and failed to start systemd-resolved,
+	 * it guesses that systemd-resolved is activatable and returns %TRUE here. That
+	 * means, while NMDnsSystemdResolved would not try to D-Bus activate systemd-resolved
+	 * more than once, NMConnectivity might -- until NMDnsSystemdResolved tried itself
+	 * and noticed that systemd-resolved is not available.
+	 * This is relatively cumbersome to avoid, because we would have to go through
+	 * NMDnsSystemdResolved trying to asynchronously start the service, to ensure there
+	 * is only one attempt to start the service. */
+	if (priv->nmtst_resolve_set) {
+		dns_manager = NULL;
+		dbus_connection = priv->nmtst_resolve_dbus_connection;
+		has_resolved = !!dbus_connection;
+	} else {
+		dns_manager = nm_dns_manager_get ();
+		dbus_connection = NULL;
+		has_resolved = nm_dns_manager_has_systemd_resolved (dns_manager);
+	}
+
+	if (!has_resolved) {
+		_LOG2D ("start request to '%s' (systemd-resolved not available)",
+		        cb_data->concheck.con_config->uri);
+		do_curl_request (cb_data);
+		return;
+	}
+
+	if (dns_manager) {
+		dbus_connection = NM_MAIN_DBUS_CONNECTION_GET;
+		if (!dbus_connection) {
+			/* we have no D-Bus connection? That might happen in configure and quit mode.
+			 *
+			 * Anyway, something is very odd, just fail connectivity check. */
+			_LOG2D ("start fake request (fail due to no D-Bus connection)");
+			cb_data->completed_state = NM_CONNECTIVITY_ERROR;
+			cb_data->completed_reason = "no D-Bus connection";
+			cb_data->timeout_id = g_idle_add (_idle_cb, cb_data);
+			return;
+		}
+
+		if (!priv->dns_manager) {
+			priv->dns_manager = g_object_ref (dns_manager);
+			g_signal_connect (priv->dns_manager,
+			                  NM_DNS_MANAGER_CONFIG_CHANGED,
+			                  G_CALLBACK (_dns_config_changed),
+			                  self);
+		}
+	}
+	if (!priv->dns_cache)
+		priv->dns_cache = g_hash_table_new_full (nm_pstr_hash, nm_pstr_equal, _dns_cache_entry_free, NULL);
+
+	/* systemd-resolved asks the name servers of the link. Links that have the same
+	 * public name servers get the same answer, so they share the lookup and its
+	 * result. Private name servers are only shared by checks on the same link. */
+	if (dns_manager)
+		nameservers = nm_dns_manager_get_link_nameservers (dns_manager, cb_data->concheck.ch_ifindex);
+	if (nameservers) {
+		key = g_strdup_printf ("%c/%s/%s",
+		                       nm_utils_addr_family_to_char (cb_data->addr_family),
+		                       cb_data->concheck.con_config->host,
+		                       nameservers);
+	} else {
+		key = g_strdup_printf ("%c/%s/if%d",
+		                       nm_utils_addr_family_to_char (cb_data->addr_family),
+		                       cb_data->concheck.con_config->host,
+		                       cb_data->concheck.ch_ifindex);
+	}
+
+	entry = g_hash_table_lookup (priv->dns_cache, &key);
+	if (   entry
+	    && !entry->cancellable
+	    && entry->expiry_msec <= now_msec) {
+		g_hash_table_remove (priv->dns_cache, entry);
+		entry = NULL;
+	}
+
+	if (entry) {
+		if (entry->cancellable) {
+			_LOG2D ("start request to '%s' (wait for resolving '%s' using systemd-resolved)",
+			        cb_data->concheck.con_config->uri,
+			        cb_data->concheck.con_config->host);
+			c_list_link_tail (&entry->waiters_lst_head, &cb_data->concheck.dns_waiters_lst);
+			return;
+		}
+
+		_LOG2D ("start request to '%s' (use cached addresses of '%s')",
+		        cb_data->concheck.con_config->uri,
+		        cb_data->concheck.con_config->host);
+		cb_data->concheck.dns_key = g_steal_pointer (&key);
+		_resolve_apply (cb_data, entry->addresses);
+		do_curl_request (cb_data);
+		return;
+	}
+
+	entry = g_slice_new (DnsCacheEntry);
+	*entry = (DnsCacheEntry) {
+		.key         = g_steal_pointer (&key),
+		.self        = self,
+		.cancellable = g_cancellable_new (),
+	};
+	c_list_init (&entry->waiters_lst_head);
+	g_hash_table_add (priv->dns_cache, entry);
+
+	c_list_link_tail (&entry->waiters_lst_head, &cb_data->concheck.dns_waiters_lst);
+
+	g_dbus_connection_call (dbus_connection,
+	                        "org.freedesktop.resolve1",
+	                        "/org/freedesktop/resolve1",
+	                        "org.freedesktop.resolve1.Manager",
+	                        "ResolveHostname",
+	                        g_variant_new ("(isit)",
+	                                       (gint32) cb_data->concheck.ch_ifindex,
+	                                       cb_data->concheck.con_config->host,
+	                                       (gint32) cb_data->addr_family,
+	                                       SD_RESOLVED_DNS),
+	                        G_VARIANT_TYPE ("(a(iiay)st)"),
+	                        G_DBUS_CALL_FLAGS_NONE,
+	                        -1,
+	                        entry->cancellable,
+	                        resolve_cb,
+	                        entry);
+	_LOG2D ("start request to '%s' (try resolving '%s' using systemd-resolved)",
+	        cb_data->concheck.con_config->uri,
+	        cb_data->concheck.con_config->host);
+}
+
+static gboolean
+_queue_dispatch_cb (gpointer user_data)
+{
+	NMConnectivity *self = user_data;
+	NMConnectivityPrivate *priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+	NMConnectivityCheckHandle *cb_data;
+
+	priv->queue_idle_id = 0;
+
+	while (   priv->n_running < NM_CONNECTIVITY_MAX_RUNNING
+	       && (cb_data = c_list_first_entry (&priv->queued_lst_head, NMConnectivityCheckHandle, queued_lst))) {
+		c_list_unlink (&cb_data->queued_lst);
+		_request_start (cb_data);
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_queue_schedule (NMConnectivity *self)
+{
+	NMConnectivityPrivate *priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+
+	if (   priv->n_running < NM_CONNECTIVITY_MAX_RUNNING
+	    && !c_list_is_empty (&priv->queued_lst_head)
+	    && !priv->queue_idle_id)
+		priv->queue_idle_id = g_idle_add (_queue_dispatch_cb, self);
+}
+#endif
+
 NMConnectivityCheckHandle *
 nm_connectivity_check_start (NMConnectivity *self,
                              int addr_family,
@@ -874,22 +1229,24 @@ nm_connectivity_check_start (NMConnectivity *self,
 	cb_data->self = self;
 	cb_data->request_counter = ++request_counter;
 	c_list_link_tail (&priv->handles_lst_head, &cb_data->handles_lst);
+	c_list_init (&cb_data->queued_lst);
 	cb_data->callback = callback;
 	cb_data->user_data = user_data;
 	cb_data->completed_state = NM_CONNECTIVITY_UNKNOWN;
 	cb_data->addr_family = addr_family;
+	cb_data->latency_msec = -1;
 	if (iface)
 		cb_data->ifspec = g_strdup_printf ("if!%s", iface);
 
 #if WITH_CONCHECK
 
 	cb_data->concheck.con_config = _con_config_ref (priv->con_config);
+	c_list_init (&cb_data->concheck.dns_waiters_lst);
 
 	if (   iface
 	    && ifindex > 0
 	    && priv->enabled
 	    && priv->uri_valid) {
-		gboolean has_systemd_resolved;
 		NMConnectivityState state;
 		const char *reason;
 
@@ -911,68 +1268,19 @@ nm_connectivity_check_start (NMConnectivity *self,
 			}
 		}
 
-		/* note that we pick up support for systemd-resolved right away when we need it.
-		 * We don't need to remember the setting, because we can (cheaply) check anew
-		 * on each request.
-		 *
-		 * Yes, this makes NMConnectivity singleton dependent on NMDnsManager singleton.
-		 * Well, not really: it makes connectivity-check-start dependent on NMDnsManager
-		 * which merely means, not to start a connectivity check, late during shutdown.
-		 *
-		 * NMDnsSystemdResolved tries to D-Bus activate systemd-resolved only once,
-		 * to not spam syslog with failures messages from dbus-daemon.
-		 * Note that unless NMDnsSystemdResolved tried and failed to start systemd-resolved,
-		 * it guesses that systemd-resolved is activatable and returns %TRUE here. That
-		 * means, while NMDnsSystemdResolved would not try to D-Bus activate systemd-resolved
-		 * more than once, NMConnectivity might -- until NMDnsSystemdResolved tried itself
-		 * and noticed that systemd-resolved is not available.
-		 * This is relatively cumbersome to avoid, because we would have to go through
-		 * NMDnsSystemdResolved trying to asynchronously start the service, to ensure there
-		 * is only one attempt to start the service. */
-		has_systemd_resolved = nm_dns_manager_has_systemd_resolved (nm_dns_manager_get ());
-
-		if (has_systemd_resolved) {
-			GDBusConnection *dbus_connection;
-
-			dbus_connection = NM_MAIN_DBUS_CONNECTION_GET;
-			if (!dbus_connection) {
-				/* we have no D-Bus connection? That might happen in configure and quit mode.
-				 *
-				 * Anyway, something is very odd, just fail connectivity check. */
-				_LOG2D ("start fake request (fail due to no D-Bus connection)");
-				cb_data->completed_state = NM_CONNECTIVITY_ERROR;
-				cb_data->completed_reason = "no D-Bus connection";
-				cb_data->timeout_id = g_idle_add (_idle_cb, cb_data);
-				return cb_data;
-			}
-
-			cb_data->concheck.resolve_cancellable = g_cancellable_new ();
-
-			g_dbus_connection_call (dbus_connection,
-			                        "org.freedesktop.resolve1",
-			                        "/org/freedesktop/resolve1",
-			                        "org.freedesktop.resolve1.Manager",
-			                        "ResolveHostname",
-			                        g_variant_new ("(isit)",
-			                                       (gint32) cb_data->concheck.ch_ifindex,
-			                                       cb_data->concheck.con_config->host,
-			                                       (gint32) cb_data->addr_family,
-			                                       SD_RESOLVED_DNS),
-			                        G_VARIANT_TYPE ("(a(iiay)st)"),
-			                        G_DBUS_CALL_FLAGS_NONE,
-			                        -1,
-			                        cb_data->concheck.resolve_cancellable,
-			                        resolve_cb,
-			                        cb_data);
-			_LOG2D ("start request to '%s' (try resolving '%s' using systemd-resolved)",
+		if (   priv->n_running >= NM_CONNECTIVITY_MAX_RUNNING
+		    || !c_list_is_empty (&priv->queued_lst_head)) {
+			/* too many checks are running. Wait for our turn, so that many devices
+			 * don't all hit DNS and the check server at the same moment. */
+			_LOG2D ("queue request to '%s' (%u checks running)",
 			        cb_data->concheck.con_config->uri,
-			        cb_data->concheck.con_config->host);
-		} else {
-			_LOG2D ("start request to '%s' (systemd-resolved not available)",
-			        cb_data->concheck.con_config->uri);
-			do_curl_request (cb_data);
+			        priv->n_running);
+			c_list_link_tail (&priv->queued_lst_head, &cb_data->queued_lst);
+			_queue_schedule (self);
+			return cb_data;
 		}
 
+		_request_start (cb_data);
 		return cb_data;
 	}
 #endif
@@ -1002,6 +1310,24 @@ nm_connectivity_check_cancel (NMConnectivityCheckHandle *cb_data)
 	cb_data_complete (cb_data, NM_CONNECTIVITY_CANCELLED, "cancelled");
 }
 
+/**
+ * nm_connectivity_check_get_latency_msec:
+ * @handle: the handle of the check
+ *
+ * Only call this from the #NMConnectivityCheckCallback of @handle.
+ *
+ * Returns: how long the request for the check took in milliseconds.
+ *   The time waiting in the queue is not counted. If the check did not
+ *   send a request, -1.
+ */
+gint64
+nm_connectivity_check_get_latency_msec (NMConnectivityCheckHandle *handle)
+{
+	g_return_val_if_fail (handle, -1);
+
+	return handle->latency_msec;
+}
+
 /*****************************************************************************/
 
 gboolean
@@ -1022,6 +1348,86 @@ nm_connectivity_get_interval (NMConnectivity *self)
 	       : 0;
 }
 
+/**
+ * nm_connectivity_get_periodic_offset_msec:
+ * @self: the #NMConnectivity
+ * @interval: the interval of the periodic checks in seconds
+ *
+ * Devices delay their periodic checks by this offset, so that
+ * devices which got activated together don't all check at the same time.
+ * Consecutive calls return offsets that are evenly spread over the first
+ * half of the interval, no matter how many devices there are.
+ *
+ * Returns: the offset in milliseconds.
+ */
+guint
+nm_connectivity_get_periodic_offset_msec (NMConnectivity *self, guint interval)
+{
+	NMConnectivityPrivate *priv;
+	guint32 frac;
+
+	g_return_val_if_fail (NM_IS_CONNECTIVITY (self), 0);
+
+	priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+
+	/* the fractional parts of multiples of the golden ratio (in 32 bit
+	 * fixed point) are well distributed over [0, 1). */
+	frac = ++priv->offset_counter * 2654435769u;
+
+	return (guint) ((((guint64) frac) * (((guint64) interval) * 500)) >> 32);
+}
+
+void
+nmtst_connectivity_get_queue_state (NMConnectivity *self,
+                                    guint *out_n_running,
+                                    guint *out_n_queued)
+{
+	NMConnectivityPrivate *priv;
+
+	g_return_if_fail (NM_IS_CONNECTIVITY (self));
+
+	priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+
+	NM_SET_OUT (out_n_running, priv->n_running);
+	NM_SET_OUT (out_n_queued, c_list_length (&priv->queued_lst_head));
+}
+
+/**
+ * nmtst_connectivity_set_resolve_dbus_connection:
+ * @self: the #NMConnectivity
+ * @dbus_connection: (allow-none): the connection to reach systemd-resolved on,
+ *   or %NULL to let curl resolve the names.
+ *
+ * Checks started afterwards don't use the NMDnsManager and NMDBusManager
+ * singletons, and their cached addresses are only shared per link.
+ */
+void
+nmtst_connectivity_set_resolve_dbus_connection (NMConnectivity *self,
+                                                GDBusConnection *dbus_connection)
+{
+	NMConnectivityPrivate *priv;
+
+	g_return_if_fail (NM_IS_CONNECTIVITY (self));
+	g_return_if_fail (!dbus_connection || G_IS_DBUS_CONNECTION (dbus_connection));
+
+	priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+
+	priv->nmtst_resolve_set = TRUE;
+	nm_g_object_ref_set (&priv->nmtst_resolve_dbus_connection, dbus_connection);
+}
+
+guint
+nmtst_connectivity_get_dns_cache_size (NMConnectivity *self)
+{
+	NMConnectivityPrivate *priv;
+
+	g_return_val_if_fail (NM_IS_CONNECTIVITY (self), 0);
+
+	priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+
+	return priv->dns_cache ? g_hash_table_size (priv->dns_cache) : 0u;
+}
+
 static gboolean
 host_and_port_from_uri (const char *uri, char **host, char **port)
 {
@@ -1187,6 +1593,7 @@ nm_connectivity_init (NMConnectivity *self)
 
 	c_list_init (&priv->handles_lst_head);
 	c_list_init (&priv->completed_handles_lst_head);
+	c_list_init (&priv->queued_lst_head);
 
 	priv->config = g_object_ref (nm_config_get ());
 	g_signal_connect (G_OBJECT (priv->config),
@@ -1219,6 +1626,18 @@ dispose (GObject *object)
 	                                      handles_lst)))
 		cb_data_complete (cb_data, NM_CONNECTIVITY_DISPOSING, "shutting down");
 
+	nm_assert (c_list_is_empty (&priv->queued_lst_head));
+	nm_clear_g_source (&priv->queue_idle_id);
+
+	nm_clear_pointer (&priv->dns_cache, g_hash_table_destroy);
+	if (priv->dns_manager) {
+#if WITH_CONCHECK
+		g_signal_handlers_disconnect_by_func (priv->dns_manager, _dns_config_changed, self);
+#endif
+		g_clear_object (&priv->dns_manager);
+	}
+	g_clear_object (&priv->nmtst_resolve_dbus_connection);
+
 	nm_clear_pointer (&priv->con_config, _con_config_unref);
 
 #if WITH_CONCHECK
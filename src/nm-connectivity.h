@@ -38,6 +38,10 @@ nm_connectivity_state_cmp (NMConnectivityState a, NMConnectivityState b)
 
 #define NM_CONNECTIVITY_CONFIG_CHANGED  "config-changed"
 
+/* the maximum number of checks that run at the same time. Further
+ * checks wait in a queue. */
+#define NM_CONNECTIVITY_MAX_RUNNING 32
+
 typedef struct _NMConnectivityClass NMConnectivityClass;
 
 GType nm_connectivity_get_type (void);
@@ -50,6 +54,8 @@ gboolean nm_connectivity_check_enabled (NMConnectivity *self);
 
 guint nm_connectivity_get_interval (NMConnectivity *self);
 
+guint nm_connectivity_get_periodic_offset_msec (NMConnectivity *self, guint interval);
+
 typedef struct _NMConnectivityCheckHandle NMConnectivityCheckHandle;
 
 typedef void (*NMConnectivityCheckCallback) (NMConnectivity *self,
@@ -67,4 +73,17 @@ NMConnectivityCheckHandle *nm_connectivity_check_start (NMConnectivity *self,
 
 void nm_connectivity_check_cancel (NMConnectivityCheckHandle *handle);
 
+gint64 nm_connectivity_check_get_latency_msec (NMConnectivityCheckHandle *handle);
+
+/*****************************************************************************/
+
+void nmtst_connectivity_get_queue_state (NMConnectivity *self,
+                                         guint *out_n_running,
+                                         guint *out_n_queued);
+
+void nmtst_connectivity_set_resolve_dbus_connection (NMConnectivity *self,
+                                                     GDBusConnection *dbus_connection);
+
+guint nmtst_connectivity_get_dns_cache_size (NMConnectivity *self);
+
 #endif /* __NETWORKMANAGER_CONNECTIVITY_H__ */
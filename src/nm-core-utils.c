@@ -25,6 +25,7 @@
 #include "nm-std-aux/unaligned.h"
 #include "nm-glib-aux/nm-random-utils.h"
 #include "nm-glib-aux/nm-io-utils.h"
+#include "nm-glib-aux/nm-ref-string.h"
 #include "nm-glib-aux/nm-secret-utils.h"
 #include "nm-glib-aux/nm-time-utils.h"
 #include "nm-utils.h"
@@ -3781,15 +3782,15 @@ nm_utils_setpgid (gpointer unused G_GNUC_UNUSED)
 }
 
 /**
- * nm_utils_g_value_set_strv:
+ * nm_utils_g_value_set_ref_strv:
  * @value: a #GValue, initialized to store a #G_TYPE_STRV
- * @strings: a #GPtrArray of strings. %NULL values are not
+ * @strings: a #GPtrArray of #NMRefString. %NULL values are not
  *   allowed.
  *
  * Converts @strings to a #GStrv and stores it in @value.
  */
 void
-nm_utils_g_value_set_strv (GValue *value, GPtrArray *strings)
+nm_utils_g_value_set_ref_strv (GValue *value, GPtrArray *strings)
 {
 	char **strv;
 	guint i;
@@ -3797,7 +3798,7 @@ nm_utils_g_value_set_strv (GValue *value, GPtrArray *strings)
 	strv = g_new (char *, strings->len + 1);
 	for (i = 0; i < strings->len; i++) {
 		nm_assert (strings->pdata[i]);
-		strv[i] = g_strdup (strings->pdata[i]);
+		strv[i] = g_strdup (nm_ref_string_get_str (strings->pdata[i]));
 	}
 	strv[i] = NULL;
 
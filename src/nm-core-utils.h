@@ -432,7 +432,7 @@ gboolean nm_utils_get_testing_initialized (void);
 NMUtilsTestFlags nm_utils_get_testing (void);
 void _nm_utils_set_testing (NMUtilsTestFlags flags);
 
-void nm_utils_g_value_set_strv (GValue *value, GPtrArray *strings);
+void nm_utils_g_value_set_ref_strv (GValue *value, GPtrArray *strings);
 
 void nm_utils_ifname_cpy (char *dst, const char *name);
 
@@ -8,6 +8,8 @@
 
 #include "nm-dispatcher.h"
 
+#include <sys/stat.h>
+
 #include "nm-libnm-core-aux/nm-dispatcher-api.h"
 #include "NetworkManagerUtils.h"
 #include "nm-utils.h"
@@ -57,9 +59,30 @@ struct NMDispatcherCallId {
 	NMDispatcherAction action;
 	guint idle_id;
 	guint32 request_id;
+
+	/* the "Action" parameters, while the call is queued for a batch. */
+	GVariant *parameters;
+
 	char extra_strings[];
 };
 
+typedef struct {
+	dev_t st_dev;
+	ino_t st_ino;
+	struct timespec st_mtim;
+	bool exists:1;
+} ScriptDirState;
+
+/* the directories that the dispatcher service searches for scripts. */
+static const char *const script_dirs[] = {
+	NMLIBDIR  "/dispatcher.d",
+	NMLIBDIR  "/dispatcher.d/pre-up.d",
+	NMLIBDIR  "/dispatcher.d/pre-down.d",
+	NMCONFDIR "/dispatcher.d",
+	NMCONFDIR "/dispatcher.d/pre-up.d",
+	NMCONFDIR "/dispatcher.d/pre-down.d",
+};
+
 /*****************************************************************************/
 
 /* FIXME(shutdown): on shutdown, we should not run dispatcher scripts synchronously.
@@ -74,6 +97,23 @@ static struct {
 	GDBusConnection *dbus_connection;
 	GHashTable *requests;
 	guint request_id_counter;
+
+	/* the asynchronous calls that get sent together with one "ActionBatch"
+	 * call, when the main loop is idle. */
+	GPtrArray *batch;
+	guint batch_idle_id;
+	bool batch_unsupported:1;
+
+	/* the actions for which the dispatcher service reported scripts, and
+	 * the state of the script directories at that time. */
+	struct {
+		ScriptDirState dirs[G_N_ELEMENTS (script_dirs)];
+		ScriptDirState query_dirs[G_N_ELEMENTS (script_dirs)];
+		guint32 actions;
+		bool valid:1;
+		bool pending:1;
+		bool unsupported:1;
+	} scripts;
 } gl;
 
 /*****************************************************************************/
@@ -101,6 +141,7 @@ dispatcher_call_id_new (guint32 request_id,
 	call_id->callback     = callback;
 	call_id->user_data    = user_data;
 	call_id->idle_id      = 0;
+	call_id->parameters   = NULL;
 
 	extra_strings = &call_id->extra_strings[0];
 
@@ -124,6 +165,7 @@ static void
 dispatcher_call_id_free (NMDispatcherCallId *call_id)
 {
 	nm_clear_g_source (&call_id->idle_id);
+	nm_clear_pointer (&call_id->parameters, g_variant_unref);
 	g_free (call_id);
 }
 
@@ -434,18 +476,13 @@ dispatcher_results_process (guint32 request_id,
 }
 
 static void
-dispatcher_done_cb (GObject *source, GAsyncResult *result, gpointer user_data)
+dispatcher_call_id_complete (NMDispatcherCallId *call_id,
+                             GVariant *ret,
+                             GError *error)
 {
-	gs_unref_variant GVariant *ret = NULL;
-	gs_free_error GError *error = NULL;
-	NMDispatcherCallId *call_id = user_data;
-
-	nm_assert ((gpointer) source == gl.dbus_connection);
-
-	ret = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source),
-	                                     result,
-	                                     &error);
-	if (!ret) {
+	if (!ret && !error) {
+		/* the call was skipped, because there are no scripts. */
+	} else if (!ret) {
 		if (_nm_dbus_error_has_name (error, "org.freedesktop.systemd1.LoadFailed")) {
 			g_dbus_error_strip_remote_error (error);
 			_LOG3W (call_id, "failed to call dispatcher scripts: %s",
@@ -469,6 +506,286 @@ dispatcher_done_cb (GObject *source, GAsyncResult *result, gpointer user_data)
 	dispatcher_call_id_free (call_id);
 }
 
+static void
+dispatcher_done_cb (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+	gs_unref_variant GVariant *ret = NULL;
+	gs_free_error GError *error = NULL;
+
+	nm_assert ((gpointer) source == gl.dbus_connection);
+
+	ret = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source),
+	                                     result,
+	                                     &error);
+	dispatcher_call_id_complete (user_data, ret, error);
+}
+
+static gboolean
+dispatcher_skipped_cb (gpointer user_data)
+{
+	NMDispatcherCallId *call_id = user_data;
+
+	call_id->idle_id = 0;
+	dispatcher_call_id_complete (call_id, NULL, NULL);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+dispatcher_call_send (NMDispatcherCallId *call_id)
+{
+	g_dbus_connection_call (gl.dbus_connection,
+	                        NM_DISPATCHER_DBUS_SERVICE,
+	                        NM_DISPATCHER_DBUS_PATH,
+	                        NM_DISPATCHER_DBUS_INTERFACE,
+	                        "Action",
+	                        call_id->parameters,
+	                        G_VARIANT_TYPE ("(a(sus))"),
+	                        G_DBUS_CALL_FLAGS_NONE,
+	                        CALL_TIMEOUT,
+	                        NULL,
+	                        dispatcher_done_cb,
+	                        call_id);
+	nm_clear_pointer (&call_id->parameters, g_variant_unref);
+}
+
+/*****************************************************************************/
+
+static void
+batch_done_cb (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+	gs_unref_ptrarray GPtrArray *call_ids = user_data;
+	gs_unref_variant GVariant *ret = NULL;
+	gs_unref_variant GVariant *v_results = NULL;
+	gs_free_error GError *error = NULL;
+	guint i;
+
+	ret = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source),
+	                                     result,
+	                                     &error);
+
+	if (   !ret
+	    && g_error_matches (error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD)) {
+		/* an older dispatcher service is still running. Send the calls
+		 * one by one. */
+		_LOGD ("the dispatcher service does not support batches");
+		gl.batch_unsupported = TRUE;
+		for (i = 0; i < call_ids->len; i++)
+			dispatcher_call_send (call_ids->pdata[i]);
+		return;
+	}
+
+	if (ret) {
+		v_results = g_variant_get_child_value (ret, 0);
+		if (g_variant_n_children (v_results) != call_ids->len) {
+			g_clear_pointer (&ret, g_variant_unref);
+			nm_utils_error_set (&error, NM_UTILS_ERROR_UNKNOWN,
+			                    "invalid number of results");
+		}
+	}
+
+	for (i = 0; i < call_ids->len; i++) {
+		gs_unref_variant GVariant *v_call_results = NULL;
+
+		if (ret) {
+			gs_unref_variant GVariant *v_child = NULL;
+
+			v_child = g_variant_get_child_value (v_results, i);
+			v_call_results = g_variant_ref_sink (g_variant_new_tuple (&v_child, 1));
+		}
+		dispatcher_call_id_complete (call_ids->pdata[i], v_call_results, error);
+	}
+}
+
+static gboolean
+batch_flush (gpointer user_data)
+{
+	gs_unref_ptrarray GPtrArray *call_ids = NULL;
+	GVariantBuilder builder;
+	guint i;
+
+	gl.batch_idle_id = 0;
+
+	if (!gl.batch || gl.batch->len == 0)
+		return G_SOURCE_REMOVE;
+
+	call_ids = g_steal_pointer (&gl.batch);
+
+	if (   call_ids->len == 1
+	    || gl.batch_unsupported) {
+		for (i = 0; i < call_ids->len; i++)
+			dispatcher_call_send (call_ids->pdata[i]);
+		return G_SOURCE_REMOVE;
+	}
+
+	_LOGT ("send %u actions in one batch", call_ids->len);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(" NMD_ACTION_ARGS_SIGNATURE ")"));
+	for (i = 0; i < call_ids->len; i++) {
+		NMDispatcherCallId *call_id = call_ids->pdata[i];
+
+		/* keep the parameters, in case we need to send them again without
+		 * batch. */
+		g_variant_builder_add_value (&builder, call_id->parameters);
+	}
+
+	g_dbus_connection_call (gl.dbus_connection,
+	                        NM_DISPATCHER_DBUS_SERVICE,
+	                        NM_DISPATCHER_DBUS_PATH,
+	                        NM_DISPATCHER_DBUS_INTERFACE,
+	                        "ActionBatch",
+	                        g_variant_new ("(a(" NMD_ACTION_ARGS_SIGNATURE "))", &builder),
+	                        G_VARIANT_TYPE ("(aa(sus))"),
+	                        G_DBUS_CALL_FLAGS_NONE,
+	                        CALL_TIMEOUT,
+	                        NULL,
+	                        batch_done_cb,
+	                        g_steal_pointer (&call_ids));
+	return G_SOURCE_REMOVE;
+}
+
+static void
+batch_add (NMDispatcherCallId *call_id)
+{
+	if (!gl.batch)
+		gl.batch = g_ptr_array_new ();
+	g_ptr_array_add (gl.batch, call_id);
+
+	if (!gl.batch_idle_id)
+		gl.batch_idle_id = g_idle_add (batch_flush, NULL);
+}
+
+/*****************************************************************************/
+
+static gboolean
+_script_dir_states_get (ScriptDirState *states)
+{
+	gint64 now_sec;
+	gboolean stable = TRUE;
+	guint i;
+
+	now_sec = g_get_real_time () / G_USEC_PER_SEC;
+
+	for (i = 0; i < G_N_ELEMENTS (script_dirs); i++) {
+		struct stat st;
+
+		if (stat (script_dirs[i], &st) != 0) {
+			states[i] = (ScriptDirState) { .exists = FALSE };
+			continue;
+		}
+
+		states[i] = (ScriptDirState) {
+			.st_dev  = st.st_dev,
+			.st_ino  = st.st_ino,
+			.st_mtim = st.st_mtim,
+			.exists  = TRUE,
+		};
+
+		/* filesystems with a coarse timestamp granularity might not change
+		 * the mtime again for a modification that follows shortly. */
+		if (st.st_mtim.tv_sec >= now_sec - 1)
+			stable = FALSE;
+	}
+
+	return stable;
+}
+
+static gboolean
+_script_dir_states_equal (const ScriptDirState *a, const ScriptDirState *b)
+{
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (script_dirs); i++) {
+		if (a[i].exists != b[i].exists)
+			return FALSE;
+		if (!a[i].exists)
+			continue;
+		if (   a[i].st_dev != b[i].st_dev
+		    || a[i].st_ino != b[i].st_ino
+		    || a[i].st_mtim.tv_sec != b[i].st_mtim.tv_sec
+		    || a[i].st_mtim.tv_nsec != b[i].st_mtim.tv_nsec)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static NMDispatcherAction action_from_string (const char *str);
+
+static void
+_scripts_query_cb (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+	gs_unref_variant GVariant *ret = NULL;
+	gs_free_error GError *error = NULL;
+	gs_free const char **actions = NULL;
+	guint32 mask = 0;
+	gsize i;
+
+	gl.scripts.pending = FALSE;
+
+	ret = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source),
+	                                     result,
+	                                     &error);
+	if (!ret) {
+		if (g_error_matches (error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD))
+			gl.scripts.unsupported = TRUE;
+		_LOGD ("failed to get the actions with scripts: %s", error->message);
+		return;
+	}
+
+	g_variant_get (ret, "(^a&s)", &actions);
+	for (i = 0; actions[i]; i++) {
+		NMDispatcherAction action;
+
+		action = action_from_string (actions[i]);
+		if ((int) action >= 0)
+			mask |= (1u << action);
+	}
+
+	memcpy (gl.scripts.dirs, gl.scripts.query_dirs, sizeof (gl.scripts.dirs));
+	gl.scripts.actions = mask;
+	gl.scripts.valid = TRUE;
+}
+
+/* Returns %FALSE if the dispatcher service is known to have no scripts
+ * for @action. In that case, the daemon can skip the call. */
+static gboolean
+_scripts_has_action (NMDispatcherAction action)
+{
+	ScriptDirState states[G_N_ELEMENTS (script_dirs)];
+	gboolean stable;
+
+	if (gl.scripts.unsupported)
+		return TRUE;
+
+	stable = _script_dir_states_get (states);
+
+	if (   stable
+	    && gl.scripts.valid
+	    && _script_dir_states_equal (states, gl.scripts.dirs))
+		return NM_FLAGS_ANY (gl.scripts.actions, (1u << action));
+
+	/* the script directories changed. Ask the dispatcher service again, and
+	 * meanwhile send all calls. */
+	gl.scripts.valid = FALSE;
+	if (   stable
+	    && !gl.scripts.pending) {
+		gl.scripts.pending = TRUE;
+		memcpy (gl.scripts.query_dirs, states, sizeof (gl.scripts.query_dirs));
+		g_dbus_connection_call (gl.dbus_connection,
+		                        NM_DISPATCHER_DBUS_SERVICE,
+		                        NM_DISPATCHER_DBUS_PATH,
+		                        NM_DISPATCHER_DBUS_INTERFACE,
+		                        "GetActions",
+		                        NULL,
+		                        G_VARIANT_TYPE ("(as)"),
+		                        G_DBUS_CALL_FLAGS_NONE,
+		                        -1,
+		                        NULL,
+		                        _scripts_query_cb,
+		                        NULL);
+	}
+	return TRUE;
+}
+
 static const char *action_table[] = {
 	[NM_DISPATCHER_ACTION_HOSTNAME]     = NMD_ACTION_HOSTNAME,
 	[NM_DISPATCHER_ACTION_PRE_UP]       = NMD_ACTION_PRE_UP,
@@ -492,6 +809,18 @@ action_to_string (NMDispatcherAction action)
 	return action_table[(gsize) action];
 }
 
+static NMDispatcherAction
+action_from_string (const char *str)
+{
+	gsize i;
+
+	for (i = 0; i < G_N_ELEMENTS (action_table); i++) {
+		if (nm_streq0 (action_table[i], str))
+			return (NMDispatcherAction) i;
+	}
+	return (NMDispatcherAction) -1;
+}
+
 static gboolean
 _dispatcher_call (NMDispatcherAction action,
                   gboolean blocking,
@@ -567,6 +896,23 @@ _dispatcher_call (NMDispatcherAction action,
 		        : (callback ? " (with callback)" : ""));
 	}
 
+	if (!_scripts_has_action (action)) {
+		_LOG2D (request_id, log_ifname, log_con_uuid, "no scripts for action; skip");
+		if (blocking)
+			return TRUE;
+
+		call_id = dispatcher_call_id_new (request_id,
+		                                  action,
+		                                  callback,
+		                                  user_data,
+		                                  log_ifname,
+		                                  log_con_uuid);
+		call_id->idle_id = g_idle_add (dispatcher_skipped_cb, call_id);
+		g_hash_table_add (gl.requests, call_id);
+		NM_SET_OUT (out_call_id, call_id);
+		return TRUE;
+	}
+
 	if (applied_connection)
 		connection_dict = nm_connection_to_dbus (applied_connection, NM_CONNECTION_SERIALIZE_NO_SECRETS);
 	else
@@ -648,6 +994,10 @@ _dispatcher_call (NMDispatcherAction action,
 		gs_unref_variant GVariant *ret = NULL;
 		gs_free_error GError *error = NULL;
 
+		/* don't overtake the queued calls. */
+		nm_clear_g_source (&gl.batch_idle_id);
+		batch_flush (NULL);
+
 		ret = g_dbus_connection_call_sync (gl.dbus_connection,
 		                                   NM_DISPATCHER_DBUS_SERVICE,
 		                                   NM_DISPATCHER_DBUS_PATH,
@@ -674,19 +1024,20 @@ _dispatcher_call (NMDispatcherAction action,
 	                                  user_data,
 	                                  log_ifname,
 	                                  log_con_uuid);
-
-	g_dbus_connection_call (gl.dbus_connection,
-	                        NM_DISPATCHER_DBUS_SERVICE,
-	                        NM_DISPATCHER_DBUS_PATH,
-	                        NM_DISPATCHER_DBUS_INTERFACE,
-	                        "Action",
-	                        g_steal_pointer (&parameters_floating),
-	                        G_VARIANT_TYPE ("(a(sus))"),
-	                        G_DBUS_CALL_FLAGS_NONE,
-	                        CALL_TIMEOUT,
-	                        NULL,
-	                        dispatcher_done_cb,
-	                        call_id);
+	call_id->parameters = g_variant_ref_sink (g_steal_pointer (&parameters_floating));
+
+	if (callback) {
+		/* the service replies to a batch only after all its actions completed.
+		 * A caller that waits for the result must not wait for unrelated
+		 * actions, so send the call on its own. Still, don't overtake the
+		 * queued calls. */
+		nm_clear_g_source (&gl.batch_idle_id);
+		batch_flush (NULL);
+		dispatcher_call_send (call_id);
+	} else {
+		/* calls issued during the same main loop iteration are sent together. */
+		batch_add (call_id);
+	}
 	g_hash_table_add (gl.requests, call_id);
 	NM_SET_OUT (out_call_id, call_id);
 	return TRUE;
@@ -908,3 +1259,21 @@ nm_dispatcher_call_cancel (NMDispatcherCallId *call_id)
 	_LOG3D (call_id, "cancelling dispatcher callback action");
 	call_id->callback = NULL;
 }
+
+/*****************************************************************************/
+
+void
+nmtst_dispatcher_init (GDBusConnection *dbus_connection)
+{
+	g_return_if_fail (G_IS_DBUS_CONNECTION (dbus_connection));
+	g_return_if_fail (!gl.requests);
+
+	gl.requests = g_hash_table_new (nm_direct_hash, NULL);
+	gl.dbus_connection = g_object_ref (dbus_connection);
+}
+
+guint
+nmtst_dispatcher_get_n_requests (void)
+{
+	return gl.requests ? g_hash_table_size (gl.requests) : 0u;
+}
@@ -71,4 +71,12 @@ gboolean nm_dispatcher_call_connectivity (NMConnectivityState state,
 
 void nm_dispatcher_call_cancel (NMDispatcherCallId *call_id);
 
+/*****************************************************************************/
+
+/* talk to the dispatcher service on @dbus_connection, instead of the
+ * main D-Bus connection. Must be called before any other function. */
+void nmtst_dispatcher_init (GDBusConnection *dbus_connection);
+
+guint nmtst_dispatcher_get_n_requests (void);
+
 #endif /* __NM_DISPATCHER_H__ */
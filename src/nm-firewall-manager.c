@@ -17,6 +17,10 @@
 #define FIREWALL_DBUS_PATH            "/org/fedoraproject/FirewallD1"
 #define FIREWALL_DBUS_INTERFACE_ZONE  "org.fedoraproject.FirewallD1.zone"
 
+/* the maximum number of D-Bus calls to firewalld that are pending at
+ * the same time. Further requests are queued until a call completes. */
+#define MAX_CALLS_IN_FLIGHT 16
+
 /*****************************************************************************/
 
 enum {
@@ -35,6 +39,9 @@ typedef struct {
 
 	guint name_owner_changed_id;
 
+	guint dispatch_id;
+	guint n_calls_in_flight;
+
 	bool dbus_inited:1;
 	bool running:1;
 } NMFirewallManagerPrivate;
@@ -107,7 +114,7 @@ _ops_type_to_string (OpsType ops_type)
 #define _NMLOG_PREFIX_NAME "firewall"
 #define _NMLOG(level, call_id, ...) \
     G_STMT_START { \
-        if (nm_logging_enabled ((level), (_NMLOG_DOMAIN))) { \
+        if (nm_log_enabled ((level), (_NMLOG_DOMAIN))) { \
             NMFirewallManagerCallId *_call_id = (call_id); \
             char _prefix_name[30]; \
             char _prefix_info[100]; \
@@ -195,12 +202,24 @@ _cb_info_create (NMFirewallManager *self,
 	return call_id;
 }
 
+static void _dispatch_schedule (NMFirewallManager *self);
+
 static void
 _cb_info_complete (NMFirewallManagerCallId *call_id,
                    GError *error)
 {
+	NMFirewallManagerPrivate *priv = NM_FIREWALL_MANAGER_GET_PRIVATE (call_id->self);
+
 	c_list_unlink (&call_id->lst);
 
+	if (   !call_id->is_idle
+	    && call_id->dbus.cancellable) {
+		/* the D-Bus call is still in flight, and gets cancelled below. */
+		nm_assert (priv->n_calls_in_flight > 0);
+		priv->n_calls_in_flight--;
+		_dispatch_schedule (call_id->self);
+	}
+
 	if (call_id->callback)
 		call_id->callback (call_id->self, call_id, error, call_id->user_data);
 
@@ -305,6 +324,10 @@ _handle_dbus_cb (GObject *source,
 	} else
 		_LOGD (call_id, "complete: success");
 
+	nm_assert (NM_FIREWALL_MANAGER_GET_PRIVATE (self)->n_calls_in_flight > 0);
+	NM_FIREWALL_MANAGER_GET_PRIVATE (self)->n_calls_in_flight--;
+	_dispatch_schedule (self);
+
 	g_clear_object (&call_id->dbus.cancellable);
 
 	_cb_info_complete (call_id, error);
@@ -343,6 +366,7 @@ _handle_dbus_start (NMFirewallManager *self,
 	nm_assert (!call_id->dbus.cancellable);
 
 	call_id->dbus.cancellable = g_cancellable_new ();
+	priv->n_calls_in_flight++;
 
 	g_dbus_connection_call (priv->dbus_connection,
 	                        FIREWALL_DBUS_SERVICE,
@@ -358,6 +382,60 @@ _handle_dbus_start (NMFirewallManager *self,
 	                        call_id);
 }
 
+static gboolean
+_dispatch_cb (gpointer user_data)
+{
+	NMFirewallManager *self = user_data;
+	NMFirewallManagerPrivate *priv = NM_FIREWALL_MANAGER_GET_PRIVATE (self);
+	NMFirewallManagerCallId *call_id_safe;
+	NMFirewallManagerCallId *call_id;
+
+	priv->dispatch_id = 0;
+
+	if (!priv->dbus_inited) {
+		/* name_owner_changed() starts the queued requests. */
+		return G_SOURCE_REMOVE;
+	}
+
+	c_list_for_each_entry_safe (call_id, call_id_safe, &priv->pending_calls, lst) {
+		if (   call_id->is_idle
+		    || !call_id->dbus.arg) {
+			/* not queued for a D-Bus call. */
+			continue;
+		}
+
+		if (!priv->running) {
+			/* firewalld stopped in the meantime. */
+			nm_clear_pointer (&call_id->dbus.arg, g_variant_unref);
+			call_id->is_idle = TRUE;
+			_LOGD (call_id, "firewall stopped: fake success on idle");
+			_handle_idle_start (self, call_id);
+			continue;
+		}
+
+		if (priv->n_calls_in_flight >= MAX_CALLS_IN_FLIGHT)
+			break;
+
+		_handle_dbus_start (self, call_id);
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_dispatch_schedule (NMFirewallManager *self)
+{
+	NMFirewallManagerPrivate *priv = NM_FIREWALL_MANAGER_GET_PRIVATE (self);
+
+	/* The D-Bus calls are not started right away. Instead, the requests of
+	 * one main loop iteration are collected and started together on idle.
+	 * At most MAX_CALLS_IN_FLIGHT calls are pending at a time, so that many
+	 * devices don't flood firewalld with requests that then run into the
+	 * D-Bus timeout. */
+	if (priv->dispatch_id == 0)
+		priv->dispatch_id = g_idle_add (_dispatch_cb, self);
+}
+
 static NMFirewallManagerCallId *
 _start_request (NMFirewallManager *self,
                 OpsType ops_type,
@@ -388,7 +466,7 @@ _start_request (NMFirewallManager *self,
 
 	if (!call_id->is_idle) {
 		if (priv->running)
-			_handle_dbus_start (self, call_id);
+			_dispatch_schedule (self);
 		if (!call_id->callback) {
 			/* if the user did not provide a callback, the call_id is useless.
 			 * Especially, the user cannot use the call-id to cancel the request,
@@ -491,7 +569,11 @@ name_owner_changed (NMFirewallManager *self,
 
 	now_running = _get_running (priv);
 
-	if (just_initied) {
+	if (   just_initied
+	    && priv->running) {
+		_LOGD (NULL, "initializing: start queued D-Bus calls");
+		_dispatch_schedule (self);
+	} else if (just_initied) {
 		NMFirewallManagerCallId *call_id_safe;
 		NMFirewallManagerCallId *call_id;
 
@@ -508,20 +590,19 @@ name_owner_changed (NMFirewallManager *self,
 			nm_assert (!call_id->is_idle);
 			nm_assert (call_id->dbus.arg);
 
-			if (priv->running) {
-				_LOGD (call_id, "initalizing: make D-Bus call");
-				_handle_dbus_start (self, call_id);
-			} else {
-				/* we don't want to invoke callbacks to the user right away. That is because
-				 * the user might schedule/cancel more calls, which messes up the order.
-				 *
-				 * Instead, convert the pending calls to idle requests... */
-				nm_clear_pointer (&call_id->dbus.arg, g_variant_unref);
-				call_id->is_idle = TRUE;
-				_LOGD (call_id, "initializing: fake success on idle");
-				_handle_idle_start (self, call_id);
-			}
+			/* we don't want to invoke callbacks to the user right away. That is because
+			 * the user might schedule/cancel more calls, which messes up the order.
+			 *
+			 * Instead, convert the pending calls to idle requests... */
+			nm_clear_pointer (&call_id->dbus.arg, g_variant_unref);
+			call_id->is_idle = TRUE;
+			_LOGD (call_id, "initializing: fake success on idle");
+			_handle_idle_start (self, call_id);
 		}
+	} else if (   priv->running
+	           && !c_list_is_empty (&priv->pending_calls)) {
+		/* firewalld (re)started. Start the requests that are still queued. */
+		_dispatch_schedule (self);
 	}
 
 	if (was_running != now_running)
@@ -618,6 +699,8 @@ dispose (GObject *object)
 
 	nm_clear_g_cancellable (&priv->get_name_owner_cancellable);
 
+	nm_clear_g_source (&priv->dispatch_id);
+
 	G_OBJECT_CLASS (nm_firewall_manager_parent_class)->dispose (object);
 
 	g_clear_object (&priv->dbus_connection);
@@ -13,6 +13,7 @@
 #include <linux/rtnetlink.h>
 
 #include "nm-glib-aux/nm-dedup-multi.h"
+#include "nm-glib-aux/nm-ref-string.h"
 
 #include "nm-utils.h"
 #include "platform/nmp-object.h"
@@ -1344,45 +1345,39 @@ _nameservers_get_index (const NMIP4Config *self, guint32 ns)
 }
 
 static int
-_domains_get_index (const NMIP4Config *self, const char *domain)
+_domains_get_index (const NMIP4Config *self, NMRefString *domain)
 {
 	const NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 	guint i;
 
 	for (i = 0; i < priv->domains->len; i++) {
-		const char *d = g_ptr_array_index (priv->domains, i);
-
-		if (g_strcmp0 (domain, d) == 0)
+		if (priv->domains->pdata[i] == domain)
 			return (int) i;
 	}
 	return -1;
 }
 
 static int
-_searches_get_index (const NMIP4Config *self, const char *search)
+_searches_get_index (const NMIP4Config *self, NMRefString *search)
 {
 	const NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 	guint i;
 
 	for (i = 0; i < priv->searches->len; i++) {
-		const char *s = g_ptr_array_index (priv->searches, i);
-
-		if (g_strcmp0 (search, s) == 0)
+		if (priv->searches->pdata[i] == search)
 			return (int) i;
 	}
 	return -1;
 }
 
 static int
-_dns_options_get_index (const NMIP4Config *self, const char *option)
+_dns_options_get_index (const NMIP4Config *self, NMRefString *option)
 {
 	const NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 	guint i;
 
 	for (i = 0; i < priv->dns_options->len; i++) {
-		const char *s = g_ptr_array_index (priv->dns_options, i);
-
-		if (g_strcmp0 (option, s) == 0)
+		if (priv->dns_options->pdata[i] == option)
 			return (int) i;
 	}
 	return -1;
@@ -1437,6 +1432,7 @@ nm_ip4_config_subtract (NMIP4Config *dst,
                         guint32 default_route_metric_penalty)
 {
 	NMIP4ConfigPrivate *dst_priv;
+	const NMIP4ConfigPrivate *src_priv;
 	guint i;
 	int idx;
 	const NMPlatformIP4Address *a;
@@ -1449,6 +1445,7 @@ nm_ip4_config_subtract (NMIP4Config *dst,
 	g_return_if_fail (dst != NULL);
 
 	dst_priv = NM_IP4_CONFIG_GET_PRIVATE (dst);
+	src_priv = NM_IP4_CONFIG_GET_PRIVATE (src);
 
 	g_object_freeze_notify (G_OBJECT (dst));
 
@@ -1514,21 +1511,21 @@ nm_ip4_config_subtract (NMIP4Config *dst,
 
 	/* domains */
 	for (i = 0; i < nm_ip4_config_get_num_domains (src); i++) {
-		idx = _domains_get_index (dst, nm_ip4_config_get_domain (src, i));
+		idx = _domains_get_index (dst, src_priv->domains->pdata[i]);
 		if (idx >= 0)
 			nm_ip4_config_del_domain (dst, idx);
 	}
 
 	/* dns searches */
 	for (i = 0; i < nm_ip4_config_get_num_searches (src); i++) {
-		idx = _searches_get_index (dst, nm_ip4_config_get_search (src, i));
+		idx = _searches_get_index (dst, src_priv->searches->pdata[i]);
 		if (idx >= 0)
 			nm_ip4_config_del_search (dst, idx);
 	}
 
 	/* dns options */
 	for (i = 0; i < nm_ip4_config_get_num_dns_options (src); i++) {
-		idx = _dns_options_get_index (dst, nm_ip4_config_get_dns_option (src, i));
+		idx = _dns_options_get_index (dst, src_priv->dns_options->pdata[i]);
 		if (idx >= 0)
 			nm_ip4_config_del_dns_option (dst, idx);
 	}
@@ -1920,59 +1917,20 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 	}
 
 	/* domains */
-	num = nm_ip4_config_get_num_domains (src);
-	are_equal = num == nm_ip4_config_get_num_domains (dst);
-	if (are_equal) {
-		for (i = 0; i < num; i++ ) {
-			if (g_strcmp0 (nm_ip4_config_get_domain (src, i),
-			               nm_ip4_config_get_domain (dst, i))) {
-				are_equal = FALSE;
-				break;
-			}
-		}
-	}
-	if (!are_equal) {
-		nm_ip4_config_reset_domains (dst);
-		for (i = 0; i < num; i++)
-			nm_ip4_config_add_domain (dst, nm_ip4_config_get_domain (src, i));
+	if (_nm_ip_config_ref_strv_replace (dst_priv->domains, src_priv->domains)) {
+		_notify (dst, PROP_DOMAINS);
 		has_relevant_changes = TRUE;
 	}
 
 	/* dns searches */
-	num = nm_ip4_config_get_num_searches (src);
-	are_equal = num == nm_ip4_config_get_num_searches (dst);
-	if (are_equal) {
-		for (i = 0; i < num; i++ ) {
-			if (g_strcmp0 (nm_ip4_config_get_search (src, i),
-			               nm_ip4_config_get_search (dst, i))) {
-				are_equal = FALSE;
-				break;
-			}
-		}
-	}
-	if (!are_equal) {
-		nm_ip4_config_reset_searches (dst);
-		for (i = 0; i < num; i++)
-			nm_ip4_config_add_search (dst, nm_ip4_config_get_search (src, i));
+	if (_nm_ip_config_ref_strv_replace (dst_priv->searches, src_priv->searches)) {
+		_notify (dst, PROP_SEARCHES);
 		has_relevant_changes = TRUE;
 	}
 
 	/* dns options */
-	num = nm_ip4_config_get_num_dns_options (src);
-	are_equal = num == nm_ip4_config_get_num_dns_options (dst);
-	if (are_equal) {
-		for (i = 0; i < num; i++ ) {
-			if (g_strcmp0 (nm_ip4_config_get_dns_option (src, i),
-			               nm_ip4_config_get_dns_option (dst, i))) {
-				are_equal = FALSE;
-				break;
-			}
-		}
-	}
-	if (!are_equal) {
-		nm_ip4_config_reset_dns_options (dst);
-		for (i = 0; i < num; i++)
-			nm_ip4_config_add_dns_option (dst, nm_ip4_config_get_dns_option (src, i));
+	if (_nm_ip_config_ref_strv_replace (dst_priv->dns_options, src_priv->dns_options)) {
+		_notify (dst, PROP_DNS_OPTIONS);
 		has_relevant_changes = TRUE;
 	}
 
@@ -2504,8 +2462,9 @@ _nm_ip4_config_get_nameserver (const NMIP4Config *self, guint i)
 gboolean
 _nm_ip_config_check_and_add_domain (GPtrArray *array, const char *domain)
 {
-	char *copy = NULL;
+	nm_auto_ref_string NMRefString *rstr = NULL;
 	size_t len;
+	guint i;
 
 	g_return_val_if_fail (domain, FALSE);
 	g_return_val_if_fail (domain[0] != '\0', FALSE);
@@ -2515,14 +2474,47 @@ _nm_ip_config_check_and_add_domain (GPtrArray *array, const char *domain)
 
 	len = strlen (domain);
 	if (domain[len - 1] == '.')
-		domain = copy = g_strndup (domain, len - 1);
+		len--;
 
-	if (nm_utils_strv_find_first ((char **) array->pdata, array->len, domain) >= 0) {
-		g_free (copy);
-		return FALSE;
+	/* the same domains are set on many configs. The strings are interned,
+	 * so that they are shared and can be compared by pointer. */
+	rstr = nm_ref_string_new_len (domain, len);
+
+	for (i = 0; i < array->len; i++) {
+		if (array->pdata[i] == rstr)
+			return FALSE;
 	}
 
-	g_ptr_array_add (array, copy ?: g_strdup (domain));
+	g_ptr_array_add (array, g_steal_pointer (&rstr));
+	return TRUE;
+}
+
+/**
+ * _nm_ip_config_ref_strv_replace:
+ * @dst: a #GPtrArray of #NMRefString
+ * @src: a #GPtrArray of #NMRefString
+ *
+ * Makes @dst the same list as @src.
+ *
+ * Returns: %TRUE if @dst changed.
+ */
+gboolean
+_nm_ip_config_ref_strv_replace (GPtrArray *dst, const GPtrArray *src)
+{
+	guint i;
+
+	if (dst->len == src->len) {
+		for (i = 0; i < src->len; i++) {
+			if (dst->pdata[i] != src->pdata[i])
+				break;
+		}
+		if (i == src->len)
+			return FALSE;
+	}
+
+	g_ptr_array_set_size (dst, 0);
+	for (i = 0; i < src->len; i++)
+		g_ptr_array_add (dst, nm_ref_string_ref (src->pdata[i]));
 	return TRUE;
 }
 
@@ -2570,7 +2562,7 @@ nm_ip4_config_get_domain (const NMIP4Config *self, guint i)
 {
 	const NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
-	return g_ptr_array_index (priv->domains, i);
+	return nm_ref_string_get_str (priv->domains->pdata[i]);
 }
 
 /*****************************************************************************/
@@ -2619,7 +2611,7 @@ nm_ip4_config_get_search (const NMIP4Config *self, guint i)
 {
 	const NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
-	return g_ptr_array_index (priv->searches, i);
+	return nm_ref_string_get_str (priv->searches->pdata[i]);
 }
 
 /*****************************************************************************/
@@ -2639,16 +2631,19 @@ void
 nm_ip4_config_add_dns_option (NMIP4Config *self, const char *new)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+	nm_auto_ref_string NMRefString *option = NULL;
 	int i;
 
 	g_return_if_fail (new != NULL);
 	g_return_if_fail (new[0] != '\0');
 
+	option = nm_ref_string_new (new);
+
 	for (i = 0; i < priv->dns_options->len; i++)
-		if (!g_strcmp0 (g_ptr_array_index (priv->dns_options, i), new))
+		if (priv->dns_options->pdata[i] == option)
 			return;
 
-	g_ptr_array_add (priv->dns_options, g_strdup (new));
+	g_ptr_array_add (priv->dns_options, g_steal_pointer (&option));
 	_notify (self, PROP_DNS_OPTIONS);
 }
 
@@ -2676,7 +2671,7 @@ nm_ip4_config_get_dns_option (const NMIP4Config *self, guint i)
 {
 	const NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
-	return g_ptr_array_index (priv->dns_options, i);
+	return nm_ref_string_get_str (priv->dns_options->pdata[i]);
 }
 
 /*****************************************************************************/
@@ -3314,13 +3309,13 @@ out_routes_cached:
 		                                                 sizeof (guint32)));
 		break;
 	case PROP_DOMAINS:
-		nm_utils_g_value_set_strv (value, priv->domains);
+		nm_utils_g_value_set_ref_strv (value, priv->domains);
 		break;
 	case PROP_SEARCHES:
-		nm_utils_g_value_set_strv (value, priv->searches);
+		nm_utils_g_value_set_ref_strv (value, priv->searches);
 		break;
 	case PROP_DNS_OPTIONS:
-		nm_utils_g_value_set_strv (value, priv->dns_options);
+		nm_utils_g_value_set_ref_strv (value, priv->dns_options);
 		break;
 	case PROP_DNS_PRIORITY:
 		g_value_set_int (value, priv->dns_priority);
@@ -3391,9 +3386,9 @@ nm_ip4_config_init (NMIP4Config *self)
 	priv->mdns = NM_SETTING_CONNECTION_MDNS_DEFAULT;
 	priv->llmnr = NM_SETTING_CONNECTION_LLMNR_DEFAULT;
 	priv->nameservers = g_array_new (FALSE, FALSE, sizeof (guint32));
-	priv->domains = g_ptr_array_new_with_free_func (g_free);
-	priv->searches = g_ptr_array_new_with_free_func (g_free);
-	priv->dns_options = g_ptr_array_new_with_free_func (g_free);
+	priv->domains = g_ptr_array_new_with_free_func ((GDestroyNotify) _nm_ref_string_unref_non_null);
+	priv->searches = g_ptr_array_new_with_free_func ((GDestroyNotify) _nm_ref_string_unref_non_null);
+	priv->dns_options = g_ptr_array_new_with_free_func ((GDestroyNotify) _nm_ref_string_unref_non_null);
 	priv->nis = g_array_new (FALSE, TRUE, sizeof (guint32));
 	priv->wins = g_array_new (FALSE, TRUE, sizeof (guint32));
 }
@@ -297,6 +297,7 @@ void nm_ip4_config_hash (const NMIP4Config *self, GChecksum *sum, gboolean dns_o
 gboolean nm_ip4_config_equal (const NMIP4Config *a, const NMIP4Config *b);
 
 gboolean _nm_ip_config_check_and_add_domain (GPtrArray *array, const char *domain);
+gboolean _nm_ip_config_ref_strv_replace (GPtrArray *dst, const GPtrArray *src);
 
 void nm_ip_config_dump (const NMIPConfig *self,
                         const char *detail,
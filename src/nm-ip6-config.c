@@ -14,6 +14,7 @@
 #include <linux/if.h>
 
 #include "nm-glib-aux/nm-dedup-multi.h"
+#include "nm-glib-aux/nm-ref-string.h"
 
 #include "nm-utils.h"
 #include "platform/nmp-object.h"
@@ -989,45 +990,39 @@ _nameservers_get_index (const NMIP6Config *self, const struct in6_addr *ns)
 }
 
 static int
-_domains_get_index (const NMIP6Config *self, const char *domain)
+_domains_get_index (const NMIP6Config *self, NMRefString *domain)
 {
 	const NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 	guint i;
 
 	for (i = 0; i < priv->domains->len; i++) {
-		const char *d = g_ptr_array_index (priv->domains, i);
-
-		if (g_strcmp0 (domain, d) == 0)
+		if (priv->domains->pdata[i] == domain)
 			return (int) i;
 	}
 	return -1;
 }
 
 static int
-_searches_get_index (const NMIP6Config *self, const char *search)
+_searches_get_index (const NMIP6Config *self, NMRefString *search)
 {
 	const NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 	guint i;
 
 	for (i = 0; i < priv->searches->len; i++) {
-		const char *s = g_ptr_array_index (priv->searches, i);
-
-		if (g_strcmp0 (search, s) == 0)
+		if (priv->searches->pdata[i] == search)
 			return (int) i;
 	}
 	return -1;
 }
 
 static int
-_dns_options_get_index (const NMIP6Config *self, const char *option)
+_dns_options_get_index (const NMIP6Config *self, NMRefString *option)
 {
 	const NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 	guint i;
 
 	for (i = 0; i < priv->dns_options->len; i++) {
-		const char *s = g_ptr_array_index (priv->dns_options, i);
-
-		if (g_strcmp0 (option, s) == 0)
+		if (priv->dns_options->pdata[i] == option)
 			return (int) i;
 	}
 	return -1;
@@ -1052,6 +1047,7 @@ nm_ip6_config_subtract (NMIP6Config *dst,
                         guint32 default_route_metric_penalty)
 {
 	NMIP6ConfigPrivate *dst_priv;
+	const NMIP6ConfigPrivate *src_priv;
 	guint i;
 	int idx;
 	const NMPlatformIP6Address *a;
@@ -1064,6 +1060,7 @@ nm_ip6_config_subtract (NMIP6Config *dst,
 	g_return_if_fail (dst != NULL);
 
 	dst_priv = NM_IP6_CONFIG_GET_PRIVATE (dst);
+	src_priv = NM_IP6_CONFIG_GET_PRIVATE (src);
 
 	g_object_freeze_notify (G_OBJECT (dst));
 
@@ -1129,21 +1126,21 @@ nm_ip6_config_subtract (NMIP6Config *dst,
 
 	/* domains */
 	for (i = 0; i < nm_ip6_config_get_num_domains (src); i++) {
-		idx = _domains_get_index (dst, nm_ip6_config_get_domain (src, i));
+		idx = _domains_get_index (dst, src_priv->domains->pdata[i]);
 		if (idx >= 0)
 			nm_ip6_config_del_domain (dst, idx);
 	}
 
 	/* dns searches */
 	for (i = 0; i < nm_ip6_config_get_num_searches (src); i++) {
-		idx = _searches_get_index (dst, nm_ip6_config_get_search (src, i));
+		idx = _searches_get_index (dst, src_priv->searches->pdata[i]);
 		if (idx >= 0)
 			nm_ip6_config_del_search (dst, idx);
 	}
 
 	/* dns options */
 	for (i = 0; i < nm_ip6_config_get_num_dns_options (src); i++) {
-		idx = _dns_options_get_index (dst, nm_ip6_config_get_dns_option (src, i));
+		idx = _dns_options_get_index (dst, src_priv->dns_options->pdata[i]);
 		if (idx >= 0)
 			nm_ip6_config_del_dns_option (dst, idx);
 	}
@@ -1506,59 +1503,20 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 	}
 
 	/* domains */
-	num = nm_ip6_config_get_num_domains (src);
-	are_equal = num == nm_ip6_config_get_num_domains (dst);
-	if (are_equal) {
-		for (i = 0; i < num; i++ ) {
-			if (g_strcmp0 (nm_ip6_config_get_domain (src, i),
-			                nm_ip6_config_get_domain (dst, i))) {
-				are_equal = FALSE;
-				break;
-			}
-		}
-	}
-	if (!are_equal) {
-		nm_ip6_config_reset_domains (dst);
-		for (i = 0; i < num; i++)
-			nm_ip6_config_add_domain (dst, nm_ip6_config_get_domain (src, i));
+	if (_nm_ip_config_ref_strv_replace (dst_priv->domains, src_priv->domains)) {
+		_notify (dst, PROP_DOMAINS);
 		has_relevant_changes = TRUE;
 	}
 
 	/* dns searches */
-	num = nm_ip6_config_get_num_searches (src);
-	are_equal = num == nm_ip6_config_get_num_searches (dst);
-	if (are_equal) {
-		for (i = 0; i < num; i++ ) {
-			if (g_strcmp0 (nm_ip6_config_get_search (src, i),
-			                nm_ip6_config_get_search (dst, i))) {
-				are_equal = FALSE;
-				break;
-			}
-		}
-	}
-	if (!are_equal) {
-		nm_ip6_config_reset_searches (dst);
-		for (i = 0; i < num; i++)
-			nm_ip6_config_add_search (dst, nm_ip6_config_get_search (src, i));
+	if (_nm_ip_config_ref_strv_replace (dst_priv->searches, src_priv->searches)) {
+		_notify (dst, PROP_SEARCHES);
 		has_relevant_changes = TRUE;
 	}
 
 	/* dns options */
-	num = nm_ip6_config_get_num_dns_options (src);
-	are_equal = num == nm_ip6_config_get_num_dns_options (dst);
-	if (are_equal) {
-		for (i = 0; i < num; i++ ) {
-			if (g_strcmp0 (nm_ip6_config_get_dns_option (src, i),
-			               nm_ip6_config_get_dns_option (dst, i))) {
-				are_equal = FALSE;
-				break;
-			}
-		}
-	}
-	if (!are_equal) {
-		nm_ip6_config_reset_dns_options (dst);
-		for (i = 0; i < num; i++)
-			nm_ip6_config_add_dns_option (dst, nm_ip6_config_get_dns_option (src, i));
+	if (_nm_ip_config_ref_strv_replace (dst_priv->dns_options, src_priv->dns_options)) {
+		_notify (dst, PROP_DNS_OPTIONS);
 		has_relevant_changes = TRUE;
 	}
 
@@ -2239,7 +2197,7 @@ nm_ip6_config_get_domain (const NMIP6Config *self, guint i)
 {
 	const NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
-	return g_ptr_array_index (priv->domains, i);
+	return nm_ref_string_get_str (priv->domains->pdata[i]);
 }
 
 /*****************************************************************************/
@@ -2288,7 +2246,7 @@ nm_ip6_config_get_search (const NMIP6Config *self, guint i)
 {
 	const NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
-	return g_ptr_array_index (priv->searches, i);
+	return nm_ref_string_get_str (priv->searches->pdata[i]);
 }
 
 /*****************************************************************************/
@@ -2308,16 +2266,19 @@ void
 nm_ip6_config_add_dns_option (NMIP6Config *self, const char *new)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+	nm_auto_ref_string NMRefString *option = NULL;
 	int i;
 
 	g_return_if_fail (new != NULL);
 	g_return_if_fail (new[0] != '\0');
 
+	option = nm_ref_string_new (new);
+
 	for (i = 0; i < priv->dns_options->len; i++)
-		if (!g_strcmp0 (g_ptr_array_index (priv->dns_options, i), new))
+		if (priv->dns_options->pdata[i] == option)
 			return;
 
-	g_ptr_array_add (priv->dns_options, g_strdup (new));
+	g_ptr_array_add (priv->dns_options, g_steal_pointer (&option));
 	_notify (self, PROP_DNS_OPTIONS);
 }
 
@@ -2345,7 +2306,7 @@ nm_ip6_config_get_dns_option (const NMIP6Config *self, guint i)
 {
 	const NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
-	return g_ptr_array_index (priv->dns_options, i);
+	return nm_ref_string_get_str (priv->dns_options->pdata[i]);
 }
 
 /*****************************************************************************/
@@ -2742,13 +2703,13 @@ out_routes_cached:
 		nameservers_to_gvalue (priv->nameservers, value);
 		break;
 	case PROP_DOMAINS:
-		nm_utils_g_value_set_strv (value, priv->domains);
+		nm_utils_g_value_set_ref_strv (value, priv->domains);
 		break;
 	case PROP_SEARCHES:
-		nm_utils_g_value_set_strv (value, priv->searches);
+		nm_utils_g_value_set_ref_strv (value, priv->searches);
 		break;
 	case PROP_DNS_OPTIONS:
-		nm_utils_g_value_set_strv (value, priv->dns_options);
+		nm_utils_g_value_set_ref_strv (value, priv->dns_options);
 		break;
 	case PROP_DNS_PRIORITY:
 		g_value_set_int (value, priv->dns_priority);
@@ -2799,9 +2760,9 @@ nm_ip6_config_init (NMIP6Config *self)
 	                                        NMP_OBJECT_TYPE_IP6_ROUTE);
 
 	priv->nameservers = g_array_new (FALSE, TRUE, sizeof (struct in6_addr));
-	priv->domains = g_ptr_array_new_with_free_func (g_free);
-	priv->searches = g_ptr_array_new_with_free_func (g_free);
-	priv->dns_options = g_ptr_array_new_with_free_func (g_free);
+	priv->domains = g_ptr_array_new_with_free_func ((GDestroyNotify) _nm_ref_string_unref_non_null);
+	priv->searches = g_ptr_array_new_with_free_func ((GDestroyNotify) _nm_ref_string_unref_non_null);
+	priv->dns_options = g_ptr_array_new_with_free_func ((GDestroyNotify) _nm_ref_string_unref_non_null);
 }
 
 NMIP6Config *
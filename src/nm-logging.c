@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/eventfd.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
 #include <strings.h>
@@ -141,6 +142,40 @@ NMLogDomain _nm_logging_enabled_state[_LOGL_N_REAL] = {
 	[LOGL_ERR]  = LOGD_DEFAULT,
 };
 
+/* the domains that the flight recorder captures, in addition to
+ * _nm_logging_enabled_state. Empty, unless the flight recorder is enabled. */
+NMLogDomain _nm_logging_recorder_state[_LOGL_N_REAL];
+
+/*****************************************************************************/
+
+/* The flight recorder keeps the most recent messages of all levels in
+ * memory, independent of the configured logging level. It can be dumped
+ * via D-Bus, to get verbose logs from just before an incident, without
+ * sending TRACE level logging to the logging backend all the time.
+ *
+ * The records are fixed-size slots in a ring. The message gets formatted
+ * right away (the arguments might not be valid later), but the timestamp,
+ * level and domains are kept in binary form and only formatted when dumping. */
+
+#define FLIGHT_RECORDER_MSG_SIZE 480
+
+typedef struct {
+	gint64 timestamp_usec;
+	NMLogDomain domain;
+	guint16 msg_len;
+	guint8 level;
+	bool truncated:1;
+	char msg[FLIGHT_RECORDER_MSG_SIZE];
+} FlightRecord;
+
+static struct {
+	GMutex lock;
+	FlightRecord *records;
+	guint n_records;
+	guint head;
+	guint len;
+} gl_recorder;
+
 /*****************************************************************************/
 
 static const LogDesc domain_desc[] = {
@@ -563,9 +598,10 @@ nm_logging_get_level (NMLogDomain domain)
 {
 	NMLogLevel sl = _LOGL_OFF;
 
+	/* this is about the configured level. The flight recorder is not considered. */
 	G_STATIC_ASSERT (LOGL_TRACE == 0);
 	while (   sl > LOGL_TRACE
-	       && _nm_logging_enabled_lockfree (sl - 1, domain))
+	       && (_nm_logging_enabled_state[sl - 1] & domain))
 		sl--;
 	return sl;
 }
@@ -582,12 +618,24 @@ _nm_logging_enabled_locking (NMLogLevel level,
 	return v;
 }
 
+gboolean
+_nm_log_enabled_locking (NMLogLevel level,
+                         NMLogDomain domain)
+{
+	gboolean v;
+
+	G_LOCK (log);
+	v = _nm_log_enabled_lockfree (level, domain);
+	G_UNLOCK (log);
+	return v;
+}
+
 gboolean
 _nm_log_enabled_impl (gboolean mt_require_locking,
                       NMLogLevel level,
                       NMLogDomain domain)
 {
-	return nm_logging_enabled_mt (mt_require_locking, level, domain);
+	return nm_log_enabled_mt (mt_require_locking, level, domain);
 }
 
 #if SYSTEMD_JOURNAL
@@ -648,83 +696,42 @@ _iovec_set_format (struct iovec *iov, char **iov_free, const char *format, ...)
 
 #endif
 
-void
-_nm_log_impl (const char *file,
-              guint line,
-              const char *func,
-              gboolean mt_require_locking,
-              NMLogLevel level,
-              NMLogDomain domain,
-              int error,
-              const char *ifname,
-              const char *conn_uuid,
-              const char *fmt,
-              ...)
-{
-	va_list args;
+typedef struct {
+	const char *file;
+	const char *func;
+	const char *ifname;
+	const char *conn_uuid;
 	char *msg;
 	GTimeVal tv;
-	int errsv;
-	const NMLogDomain *cur_log_state;
-	NMLogDomain cur_log_state_copy[_LOGL_N_REAL];
-	Global g_copy;
-	const Global *g;
-
-	if (G_UNLIKELY (mt_require_locking)) {
-		G_LOCK (log);
-		/* we evaluate logging-enabled under lock. There is still a race that
-		 * we might log the message below *after* logging was disabled. That means,
-		 * when disabling logging, we might still log messages. */
-		if (!_nm_logging_enabled_lockfree (level, domain)) {
-			G_UNLOCK (log);
-			return;
-		}
-		g_copy = gl.imm;
-		memcpy (cur_log_state_copy, _nm_logging_enabled_state, sizeof (cur_log_state_copy));
-		G_UNLOCK (log);
-		g = &g_copy;
-		cur_log_state = cur_log_state_copy;
-	} else {
-		NM_ASSERT_ON_MAIN_THREAD ();
-		if (!_nm_logging_enabled_lockfree (level, domain))
-			return;
-		g = &gl.imm;
-		cur_log_state = _nm_logging_enabled_state;
-	}
 
-	(void) cur_log_state;
+	/* the monotonic timestamp in nanoseconds. Only set for the journal backend. */
+	gint64 now;
 
-	errsv = errno;
-
-	/* Make sure that %m maps to the specified error */
-	if (error != 0) {
-		if (error < 0)
-			error = -error;
-		errno = error;
-	}
-
-	va_start (args, fmt);
-	msg = g_strdup_vprintf (fmt, args);
-	va_end (args);
+	NMLogDomain domain;
+	guint line;
+	int error;
+	NMLogLevel level;
+} LogRecord;
 
 #define MESSAGE_FMT "%s%-7s [%ld.%04ld] %s"
-#define MESSAGE_ARG(prefix, tv, msg) \
+#define MESSAGE_ARG(prefix, rec) \
     prefix, \
-    level_desc[level].level_str, \
-    (tv).tv_sec, \
-    ((tv).tv_usec / 100), \
-    (msg)
-
-	g_get_current_time (&tv);
+    level_desc[(rec)->level].level_str, \
+    (rec)->tv.tv_sec, \
+    ((rec)->tv.tv_usec / 100), \
+    (rec)->msg
 
+static void
+_log_record_emit (const Global *g, const LogRecord *rec)
+{
 	if (g->debug_stderr)
-		g_printerr (MESSAGE_FMT"\n", MESSAGE_ARG (g->prefix, tv, msg));
+		g_printerr (MESSAGE_FMT"\n", MESSAGE_ARG (g->prefix, rec));
 
 	switch (g->log_backend) {
 #if SYSTEMD_JOURNAL
 	case LOG_BACKEND_JOURNAL:
 		{
-			gint64 now, boottime;
+			gint64 boottime;
 			struct iovec iov_data[15];
 			struct iovec *iov = iov_data;
 			char *iov_free_data[5];
@@ -735,15 +742,14 @@ _nm_log_impl (const char *file,
 			char *s_log_domains;
 			gsize l_log_domains;
 
-			now = nm_utils_get_monotonic_timestamp_nsec ();
-			boottime = nm_utils_monotonic_timestamp_as_boottime (now, 1);
+			boottime = nm_utils_monotonic_timestamp_as_boottime (rec->now, 1);
 
-			_iovec_set_format_a (iov++, 30, "PRIORITY=%d", level_desc[level].syslog_level);
-			_iovec_set_format (iov++, iov_free++, "MESSAGE="MESSAGE_FMT, MESSAGE_ARG (g->prefix, tv, msg));
+			_iovec_set_format_a (iov++, 30, "PRIORITY=%d", level_desc[rec->level].syslog_level);
+			_iovec_set_format (iov++, iov_free++, "MESSAGE="MESSAGE_FMT, MESSAGE_ARG (g->prefix, rec));
 			_iovec_set_string (iov++, syslog_identifier_full (g->syslog_identifier));
 			_iovec_set_format_a (iov++, 30, "SYSLOG_PID=%ld", (long) getpid ());
 
-			dom_all = domain;
+			dom_all = rec->domain;
 			s_log_domains = s_log_domains_buf;
 			l_log_domains = sizeof (s_log_domains_buf);
 
@@ -751,7 +757,7 @@ _nm_log_impl (const char *file,
 			for (diter = &domain_desc[0]; dom_all != 0 && diter->name; diter++) {
 				if (!NM_FLAGS_ANY (dom_all, diter->num))
 					continue;
-				if (dom_all != domain)
+				if (dom_all != rec->domain)
 					nm_utils_strbuf_append_c (&s_log_domains, &l_log_domains, ',');
 				nm_utils_strbuf_append_str (&s_log_domains, &l_log_domains, diter->name);
 				dom_all &= ~diter->num;
@@ -761,19 +767,19 @@ _nm_log_impl (const char *file,
 
 			G_STATIC_ASSERT_EXPR (LOG_FAC (LOG_DAEMON) == 3);
 			_iovec_set_string_literal (iov++, "SYSLOG_FACILITY=3");
-			_iovec_set_format_str_a (iov++, 15, "NM_LOG_LEVEL=%s", level_desc[level].name);
-			if (func)
-				_iovec_set_format (iov++, iov_free++, "CODE_FUNC=%s", func);
-			_iovec_set_format (iov++, iov_free++, "CODE_FILE=%s", file ?: "");
-			_iovec_set_format_a (iov++, 20, "CODE_LINE=%u", line);
-			_iovec_set_format_a (iov++, 60, "TIMESTAMP_MONOTONIC=%lld.%06lld", (long long) (now / NM_UTILS_NSEC_PER_SEC), (long long) ((now % NM_UTILS_NSEC_PER_SEC) / 1000));
+			_iovec_set_format_str_a (iov++, 15, "NM_LOG_LEVEL=%s", level_desc[rec->level].name);
+			if (rec->func)
+				_iovec_set_format (iov++, iov_free++, "CODE_FUNC=%s", rec->func);
+			_iovec_set_format (iov++, iov_free++, "CODE_FILE=%s", rec->file ?: "");
+			_iovec_set_format_a (iov++, 20, "CODE_LINE=%u", rec->line);
+			_iovec_set_format_a (iov++, 60, "TIMESTAMP_MONOTONIC=%lld.%06lld", (long long) (rec->now / NM_UTILS_NSEC_PER_SEC), (long long) ((rec->now % NM_UTILS_NSEC_PER_SEC) / 1000));
 			_iovec_set_format_a (iov++, 60, "TIMESTAMP_BOOTTIME=%lld.%06lld", (long long) (boottime / NM_UTILS_NSEC_PER_SEC), (long long) ((boottime % NM_UTILS_NSEC_PER_SEC) / 1000));
-			if (error != 0)
-				_iovec_set_format_a (iov++, 30, "ERRNO=%d", error);
-			if (ifname)
-				_iovec_set_format (iov++, iov_free++, "NM_DEVICE=%s", ifname);
-			if (conn_uuid)
-				_iovec_set_format (iov++, iov_free++, "NM_CONNECTION=%s", conn_uuid);
+			if (rec->error != 0)
+				_iovec_set_format_a (iov++, 30, "ERRNO=%d", rec->error);
+			if (rec->ifname)
+				_iovec_set_format (iov++, iov_free++, "NM_DEVICE=%s", rec->ifname);
+			if (rec->conn_uuid)
+				_iovec_set_format (iov++, iov_free++, "NM_CONNECTION=%s", rec->conn_uuid);
 
 			nm_assert (iov <= &iov_data[G_N_ELEMENTS (iov_data)]);
 			nm_assert (iov_free <= &iov_free_data[G_N_ELEMENTS (iov_free_data)]);
@@ -786,16 +792,600 @@ _nm_log_impl (const char *file,
 		break;
 #endif
 	case LOG_BACKEND_SYSLOG:
-		syslog (level_desc[level].syslog_level,
-		        MESSAGE_FMT, MESSAGE_ARG (g->prefix, tv, msg));
+		syslog (level_desc[rec->level].syslog_level,
+		        MESSAGE_FMT, MESSAGE_ARG (g->prefix, rec));
 		break;
 	default:
-		g_log (syslog_identifier_domain (g->syslog_identifier), level_desc[level].g_log_level,
-		       MESSAGE_FMT, MESSAGE_ARG (g->prefix, tv, msg));
+		g_log (syslog_identifier_domain (g->syslog_identifier), level_desc[rec->level].g_log_level,
+		       MESSAGE_FMT, MESSAGE_ARG (g->prefix, rec));
 		break;
 	}
+}
+
+/*****************************************************************************/
+
+static FlightRecord *
+_flight_recorder_next_locked (void)
+{
+	FlightRecord *record;
+
+	record = &gl_recorder.records[gl_recorder.head];
+	gl_recorder.head = (gl_recorder.head + 1) % gl_recorder.n_records;
+	if (gl_recorder.len < gl_recorder.n_records)
+		gl_recorder.len++;
+	return record;
+}
+
+static void
+_flight_recorder_add (NMLogLevel level,
+                      NMLogDomain domain,
+                      gint64 timestamp_usec,
+                      const char *msg)
+{
+	FlightRecord *record;
+	gsize l;
+
+	l = strlen (msg);
+
+	g_mutex_lock (&gl_recorder.lock);
+	if (gl_recorder.records) {
+		record = _flight_recorder_next_locked ();
+		record->timestamp_usec = timestamp_usec;
+		record->level = level;
+		record->domain = domain;
+		record->truncated = (l >= sizeof (record->msg));
+		record->msg_len = NM_MIN (l, sizeof (record->msg) - 1);
+		memcpy (record->msg, msg, record->msg_len);
+		record->msg[record->msg_len] = '\0';
+	}
+	g_mutex_unlock (&gl_recorder.lock);
+}
+
+_nm_printf (3, 0)
+static void
+_flight_recorder_add_v (NMLogLevel level,
+                        NMLogDomain domain,
+                        const char *fmt,
+                        va_list args)
+{
+	FlightRecord *record;
+	int l;
+
+	g_mutex_lock (&gl_recorder.lock);
+	if (gl_recorder.records) {
+		/* format directly into the slot, without heap allocation. */
+		record = _flight_recorder_next_locked ();
+		record->timestamp_usec = g_get_real_time ();
+		record->level = level;
+		record->domain = domain;
+		l = g_vsnprintf (record->msg, sizeof (record->msg), fmt, args);
+		if (l < 0)
+			l = 0;
+		record->truncated = (l >= (int) sizeof (record->msg));
+		record->msg_len = strlen (record->msg);
+	}
+	g_mutex_unlock (&gl_recorder.lock);
+}
+
+/**
+ * nm_logging_flight_recorder_start:
+ * @n_records: the number of messages to keep.
+ *
+ * Start recording the most recent messages of all levels and
+ * domains in memory. Use nm_logging_flight_recorder_dump() to
+ * get them.
+ *
+ * Like the logging configuration with nm_logging_setup(), the
+ * flight recorder does not capture %LOGD_VPN_PLUGIN at the
+ * verbose levels, because it may expose sensitive data.
+ *
+ * Must only be called once, on the main thread.
+ */
+void
+nm_logging_flight_recorder_start (guint n_records)
+{
+	int i;
+
+	NM_ASSERT_ON_MAIN_THREAD ();
+
+	g_return_if_fail (n_records > 0);
+	g_return_if_fail (n_records <= NM_LOGGING_FLIGHT_RECORDER_SIZE_MAX);
+	g_return_if_fail (!gl_recorder.records);
+
+	g_mutex_lock (&gl_recorder.lock);
+	gl_recorder.records = g_new (FlightRecord, n_records);
+	gl_recorder.n_records = n_records;
+	g_mutex_unlock (&gl_recorder.lock);
+
+	G_LOCK (log);
+	for (i = 0; i < _LOGL_N_REAL; i++) {
+		_nm_logging_recorder_state[i] = LOGD_ALL;
+		if (i < LOGL_INFO)
+			_nm_logging_recorder_state[i] &= ~LOGD_VPN_PLUGIN;
+	}
+	G_UNLOCK (log);
+}
+
+/**
+ * nm_logging_flight_recorder_dump:
+ *
+ * Returns: (transfer full): the recorded messages as text lines, the
+ *   oldest first. %NULL if the flight recorder is not enabled.
+ */
+char **
+nm_logging_flight_recorder_dump (void)
+{
+	GPtrArray *lines;
+	guint i;
+
+	g_mutex_lock (&gl_recorder.lock);
+
+	if (!gl_recorder.records) {
+		g_mutex_unlock (&gl_recorder.lock);
+		return NULL;
+	}
+
+	lines = g_ptr_array_sized_new (gl_recorder.len + 1);
+	for (i = 0; i < gl_recorder.len; i++) {
+		const FlightRecord *record;
+		const LogDesc *diter;
+		GString *str;
+
+		record = &gl_recorder.records[  (gl_recorder.head + gl_recorder.n_records - gl_recorder.len + i)
+		                              % gl_recorder.n_records];
+
+		str = g_string_sized_new (record->msg_len + 60);
+		g_string_append_printf (str, "%-7s [%lld.%04lld] [",
+		                        level_desc[record->level].level_str,
+		                        (long long) (record->timestamp_usec / G_USEC_PER_SEC),
+		                        (long long) ((record->timestamp_usec % G_USEC_PER_SEC) / 100));
+		for (diter = &domain_desc[0]; diter->name; diter++) {
+			if (!NM_FLAGS_ANY (record->domain, diter->num))
+				continue;
+			if (str->str[str->len - 1] != '[')
+				g_string_append_c (str, ',');
+			g_string_append (str, diter->name);
+		}
+		g_string_append (str, "] ");
+		g_string_append_len (str, record->msg, record->msg_len);
+		if (record->truncated)
+			g_string_append (str, "...");
+		g_ptr_array_add (lines, g_string_free (str, FALSE));
+	}
+
+	g_mutex_unlock (&gl_recorder.lock);
+
+	g_ptr_array_add (lines, NULL);
+	return (char **) g_ptr_array_free (lines, FALSE);
+}
+
+/*****************************************************************************/
+
+/* Asynchronous logging.
+ *
+ * With verbose logging, writing each message synchronously to journald/syslog
+ * from the calling thread is expensive and delays the main loop. When enabled
+ * via nm_logging_async_start(), _nm_log_impl() only formats the message and
+ * appends the record to a bounded queue. A dedicated writer thread takes the
+ * records from the queue and passes them on to the backend.
+ *
+ * The queue is a lock-free, bounded multi-producer/multi-consumer ring buffer
+ * (after Dmitry Vyukov). Each cell has a sequence number that tells whether the
+ * cell is ready to be written by a producer (seq == pos) or to be read by a consumer
+ * (seq == pos + 1). Consumers are the writer thread, and the main thread after
+ * the writer thread was stopped. If the queue is full, the
+ * message is dropped and counted. The writer thread reports dropped messages.
+ *
+ * Logging via g_log() (nm_log_handler()) stays synchronous. */
+
+typedef struct {
+	int seq;
+	LogRecord *rec;
+} AsyncCell;
+
+static struct {
+	AsyncCell *cells;
+	GThread *thread;
+	pid_t pid;
+	guint mask;
+	int enqueue_pos;
+	int dequeue_pos;
+	int enabled;
+	int stop;
+	int writer_sleeping;
+	int dropped;
+	int event_fd;
+} gl_async = {
+	.event_fd = -1,
+};
+
+static LogRecord *
+_async_record_new (const LogRecord *src)
+{
+	LogRecord *rec;
+	gsize l_ifname;
+	gsize l_conn_uuid;
+	char *p;
+
+	/* @file and @func are string literals. @msg is already allocated and
+	 * the record takes ownership. Only @ifname and @conn_uuid need to be cloned. */
+	l_ifname = src->ifname ? strlen (src->ifname) + 1 : 0;
+	l_conn_uuid = src->conn_uuid ? strlen (src->conn_uuid) + 1 : 0;
+
+	rec = g_malloc (sizeof (LogRecord) + l_ifname + l_conn_uuid);
+	*rec = *src;
+
+	p = (char *) &rec[1];
+	if (src->ifname) {
+		rec->ifname = memcpy (p, src->ifname, l_ifname);
+		p += l_ifname;
+	}
+	if (src->conn_uuid)
+		rec->conn_uuid = memcpy (p, src->conn_uuid, l_conn_uuid);
+	return rec;
+}
+
+static void
+_async_record_free (LogRecord *rec)
+{
+	g_free (rec->msg);
+	g_free (rec);
+}
+
+static void
+_async_wakeup (void)
+{
+	static const guint64 v = 1;
+
+	if (write (gl_async.event_fd, &v, sizeof (v)) < 0) {
+		/* the counter of the eventfd cannot overflow in practice, and
+		 * there is nothing sensible to do about a failure. */
+	}
+}
 
-	g_free (msg);
+static gboolean
+_async_enqueue (LogRecord *rec)
+{
+	AsyncCell *cell;
+	guint pos;
+
+	pos = (guint) g_atomic_int_get (&gl_async.enqueue_pos);
+	for (;;) {
+		int diff;
+
+		cell = &gl_async.cells[pos & gl_async.mask];
+		diff = (int) ((guint) g_atomic_int_get (&cell->seq) - pos);
+		if (diff == 0) {
+			if (g_atomic_int_compare_and_exchange (&gl_async.enqueue_pos, (int) pos, (int) (pos + 1u)))
+				break;
+		} else if (diff < 0) {
+			/* the queue is full. */
+			g_atomic_int_inc (&gl_async.dropped);
+			return FALSE;
+		}
+		pos = (guint) g_atomic_int_get (&gl_async.enqueue_pos);
+	}
+
+	cell->rec = rec;
+	g_atomic_int_set (&cell->seq, (int) (pos + 1u));
+
+	/* only wake up the writer thread if it announced that it's going to sleep. While it
+	 * is busy writing messages, enqueueing does not require a syscall. */
+	if (   g_atomic_int_get (&gl_async.writer_sleeping)
+	    && g_atomic_int_compare_and_exchange (&gl_async.writer_sleeping, 1, 0))
+		_async_wakeup ();
+
+	return TRUE;
+}
+
+static LogRecord *
+_async_dequeue (void)
+{
+	AsyncCell *cell;
+	LogRecord *rec;
+	guint pos;
+
+	pos = (guint) g_atomic_int_get (&gl_async.dequeue_pos);
+	for (;;) {
+		int diff;
+
+		cell = &gl_async.cells[pos & gl_async.mask];
+		diff = (int) ((guint) g_atomic_int_get (&cell->seq) - (pos + 1u));
+		if (diff == 0) {
+			if (g_atomic_int_compare_and_exchange (&gl_async.dequeue_pos, (int) pos, (int) (pos + 1u)))
+				break;
+		} else if (diff < 0) {
+			/* the queue is empty. */
+			return NULL;
+		}
+		pos = (guint) g_atomic_int_get (&gl_async.dequeue_pos);
+	}
+
+	rec = cell->rec;
+	cell->rec = NULL;
+	g_atomic_int_set (&cell->seq, (int) (pos + gl_async.mask + 1u));
+	return rec;
+}
+
+static gboolean
+_async_is_empty (void)
+{
+	guint pos;
+
+	pos = (guint) g_atomic_int_get (&gl_async.dequeue_pos);
+	return (guint) g_atomic_int_get (&gl_async.cells[pos & gl_async.mask].seq) != pos + 1u;
+}
+
+static void
+_async_global_copy (Global *g_copy)
+{
+	/* the writer thread doesn't own the global state. Read it under lock,
+	 * like _nm_log_impl() does for other threads. */
+	G_LOCK (log);
+	*g_copy = gl.imm;
+	G_UNLOCK (log);
+}
+
+static void
+_async_drain (void)
+{
+	LogRecord *rec;
+	Global g_copy;
+
+	if (_async_is_empty ())
+		return;
+
+	_async_global_copy (&g_copy);
+	while ((rec = _async_dequeue ())) {
+		_log_record_emit (&g_copy, rec);
+		_async_record_free (rec);
+	}
+}
+
+static void
+_async_report_dropped (guint *reported)
+{
+	LogRecord rec;
+	Global g_copy;
+	guint dropped;
+
+	dropped = (guint) g_atomic_int_get (&gl_async.dropped);
+	if (dropped == *reported)
+		return;
+
+	_async_global_copy (&g_copy);
+
+	rec = (LogRecord) {
+		.file   = __FILE__,
+		.line   = __LINE__,
+		.level  = LOGL_WARN,
+		.domain = LOGD_CORE,
+		.msg    = g_strdup_printf ("logging: dropped %u messages because the queue was full (%u in total)",
+		                           dropped - *reported,
+		                           dropped),
+	};
+	g_get_current_time (&rec.tv);
+	if (g_copy.log_backend == LOG_BACKEND_JOURNAL)
+		rec.now = nm_utils_get_monotonic_timestamp_nsec ();
+	_log_record_emit (&g_copy, &rec);
+	g_free (rec.msg);
+
+	*reported = dropped;
+}
+
+static gpointer
+_async_writer_thread (gpointer user_data)
+{
+	guint reported = 0;
+
+	for (;;) {
+		guint64 v;
+
+		_async_drain ();
+		_async_report_dropped (&reported);
+
+		if (g_atomic_int_get (&gl_async.stop))
+			break;
+
+		/* announce that we are going to sleep, and check again for new messages.
+		 * A producer that enqueues after this check, sees the flag and wakes us up. */
+		g_atomic_int_set (&gl_async.writer_sleeping, 1);
+		if (   !_async_is_empty ()
+		    || g_atomic_int_get (&gl_async.stop)) {
+			g_atomic_int_set (&gl_async.writer_sleeping, 0);
+			continue;
+		}
+
+		if (read (gl_async.event_fd, &v, sizeof (v)) < 0) {
+			/* EINTR. Just try again. */
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * nm_logging_async_start:
+ * @queue_size: the maximum number of queued messages. This is rounded
+ *   up to a power of two.
+ *
+ * Start the writer thread for asynchronous logging. From now on, logging
+ * messages are queued and written by the writer thread. The queue is drained
+ * when the process exits. Messages that are still queued on a crash are lost.
+ *
+ * Must only be called once, on the main thread and after nm_logging_init().
+ */
+void
+nm_logging_async_start (guint queue_size)
+{
+	guint n;
+	guint i;
+
+	NM_ASSERT_ON_MAIN_THREAD ();
+
+	g_return_if_fail (gl.imm.init_done);
+	g_return_if_fail (!gl_async.thread);
+	g_return_if_fail (queue_size > 0 && queue_size <= (1u << 20));
+
+	gl_async.event_fd = eventfd (0, EFD_CLOEXEC);
+	if (gl_async.event_fd < 0) {
+		int errsv = errno;
+
+		nm_log_warn (LOGD_CORE, "logging: failure to create eventfd for asynchronous logging: %s",
+		             nm_strerror_native (errsv));
+		return;
+	}
+
+	for (n = 1; n < queue_size; n <<= 1)
+		;
+	gl_async.mask = n - 1;
+	gl_async.cells = g_new (AsyncCell, n);
+	for (i = 0; i < n; i++) {
+		gl_async.cells[i] = (AsyncCell) {
+			.seq = (int) i,
+		};
+	}
+
+	gl_async.pid = getpid ();
+	gl_async.thread = g_thread_new ("nm-log-writer", _async_writer_thread, NULL);
+
+	/* the "exiting" message is the last message we log. Instead of requiring
+	 * every exit() path to stop the writer thread, do it at exit. */
+	atexit (nm_logging_async_stop);
+
+	g_atomic_int_set (&gl_async.enabled, 1);
+
+	nm_log_dbg (LOGD_CORE, "logging: asynchronous logging with a queue of %u messages", n);
+}
+
+/**
+ * nm_logging_async_stop:
+ *
+ * Stop the writer thread and write all queued messages. Afterwards,
+ * messages are again logged synchronously.
+ */
+void
+nm_logging_async_stop (void)
+{
+	if (!gl_async.thread)
+		return;
+
+	/* a forked child does not have the writer thread. */
+	if (gl_async.pid != getpid ())
+		return;
+
+	g_atomic_int_set (&gl_async.enabled, 0);
+
+	g_atomic_int_set (&gl_async.stop, 1);
+	_async_wakeup ();
+	g_thread_join (g_steal_pointer (&gl_async.thread));
+
+	/* a message from another thread might have raced with disabling the queue. */
+	_async_drain ();
+}
+
+/*****************************************************************************/
+
+void
+_nm_log_impl (const char *file,
+              guint line,
+              const char *func,
+              gboolean mt_require_locking,
+              NMLogLevel level,
+              NMLogDomain domain,
+              int error,
+              const char *ifname,
+              const char *conn_uuid,
+              const char *fmt,
+              ...)
+{
+	va_list args;
+	LogRecord rec;
+	int errsv;
+	const NMLogDomain *cur_log_state;
+	NMLogDomain cur_log_state_copy[_LOGL_N_REAL];
+	NMLogDomain cur_recorder_state;
+	Global g_copy;
+	const Global *g;
+
+	if (G_UNLIKELY (mt_require_locking)) {
+		G_LOCK (log);
+		/* we evaluate logging-enabled under lock. There is still a race that
+		 * we might log the message below *after* logging was disabled. That means,
+		 * when disabling logging, we might still log messages. */
+		if (!_nm_log_enabled_lockfree (level, domain)) {
+			G_UNLOCK (log);
+			return;
+		}
+		g_copy = gl.imm;
+		memcpy (cur_log_state_copy, _nm_logging_enabled_state, sizeof (cur_log_state_copy));
+		cur_recorder_state = _nm_logging_recorder_state[level];
+		G_UNLOCK (log);
+		g = &g_copy;
+		cur_log_state = cur_log_state_copy;
+	} else {
+		NM_ASSERT_ON_MAIN_THREAD ();
+		if (!_nm_log_enabled_lockfree (level, domain))
+			return;
+		g = &gl.imm;
+		cur_log_state = _nm_logging_enabled_state;
+		cur_recorder_state = _nm_logging_recorder_state[level];
+	}
+
+	errsv = errno;
+
+	/* Make sure that %m maps to the specified error */
+	if (error != 0) {
+		if (error < 0)
+			error = -error;
+		errno = error;
+	}
+
+	rec = (LogRecord) {
+		.file      = file,
+		.line      = line,
+		.func      = func,
+		.level     = level,
+		.domain    = domain,
+		.error     = error,
+		.ifname    = ifname,
+		.conn_uuid = conn_uuid,
+	};
+
+	if (!(cur_log_state[level] & domain)) {
+		/* the message is only enabled for the flight recorder. */
+		va_start (args, fmt);
+		_flight_recorder_add_v (level, domain, fmt, args);
+		va_end (args);
+		errno = errsv;
+		return;
+	}
+
+	va_start (args, fmt);
+	rec.msg = g_strdup_vprintf (fmt, args);
+	va_end (args);
+
+	g_get_current_time (&rec.tv);
+
+	if (cur_recorder_state & domain)
+		_flight_recorder_add (level, domain, rec.tv.tv_sec * G_USEC_PER_SEC + rec.tv.tv_usec, rec.msg);
+
+	/* We only log the monotonic-timestamp with structured logging (journal). */
+	if (g->log_backend == LOG_BACKEND_JOURNAL)
+		rec.now = nm_utils_get_monotonic_timestamp_nsec ();
+
+	if (g_atomic_int_get (&gl_async.enabled)) {
+		LogRecord *rec_async;
+
+		/* the queued record takes ownership of the message. If the queue is full,
+		 * the message is dropped. We don't want to block the caller. */
+		rec_async = _async_record_new (&rec);
+		if (!_async_enqueue (rec_async))
+			_async_record_free (rec_async);
+	} else {
+		_log_record_emit (g, &rec);
+		g_free (rec.msg);
+	}
 
 	errno = errsv;
 }
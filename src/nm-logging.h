@@ -60,7 +60,7 @@ LOGD_IP_from_af (int addr_family)
  * whether logging for the given level/domain is enabled.  */
 #define nm_log(level, domain, ifname, con_uuid, ...) \
     G_STMT_START { \
-        if (nm_logging_enabled ((level), (domain))) { \
+        if (nm_log_enabled ((level), (domain))) { \
             _nm_log (level, domain, 0, ifname, con_uuid, __VA_ARGS__); \
         } \
     } G_STMT_END
@@ -156,6 +156,34 @@ nm_logging_enabled_mt (gboolean mt_require_locking, NMLogLevel level, NMLogDomai
 #define nm_logging_enabled(level, domain) \
 	nm_logging_enabled_mt (!(NM_THREAD_SAFE_ON_MAIN_THREAD), level, domain)
 
+/* nm_logging_enabled() is about the configured logging level only. A message
+ * that is not enabled there might still be captured by the flight recorder.
+ * nm_log_enabled() tells whether a log statement must be evaluated at all. */
+extern NMLogDomain _nm_logging_recorder_state[_LOGL_N_REAL];
+
+static inline gboolean
+_nm_log_enabled_lockfree (NMLogLevel level, NMLogDomain domain)
+{
+	return    _nm_logging_enabled_lockfree (level, domain)
+	       || (   ((guint) level) < G_N_ELEMENTS (_nm_logging_recorder_state)
+	           && !!(_nm_logging_recorder_state[level] & domain));
+}
+
+gboolean _nm_log_enabled_locking (NMLogLevel level, NMLogDomain domain);
+
+static inline gboolean
+nm_log_enabled_mt (gboolean mt_require_locking, NMLogLevel level, NMLogDomain domain)
+{
+	if (mt_require_locking)
+		return _nm_log_enabled_locking (level, domain);
+
+	NM_ASSERT_ON_MAIN_THREAD ();
+	return _nm_log_enabled_lockfree (level, domain);
+}
+
+#define nm_log_enabled(level, domain) \
+	nm_log_enabled_mt (!(NM_THREAD_SAFE_ON_MAIN_THREAD), level, domain)
+
 /*****************************************************************************/
 
 NMLogLevel nm_logging_get_level (NMLogDomain domain);
@@ -173,6 +201,17 @@ void nm_logging_init_pre (const char *syslog_identifier,
 
 void     nm_logging_init (const char *logging_backend, gboolean debug);
 
+void nm_logging_async_start (guint queue_size);
+void nm_logging_async_stop (void);
+
+/* DumpLogging returns all records in one D-Bus message. With up to ~550 bytes
+ * per formatted record, this keeps the reply well below the message size
+ * limit of the D-Bus daemon. */
+#define NM_LOGGING_FLIGHT_RECORDER_SIZE_MAX 16384
+
+void nm_logging_flight_recorder_start (guint n_records);
+char **nm_logging_flight_recorder_dump (void);
+
 gboolean nm_logging_syslog_enabled (void);
 
 /*****************************************************************************/
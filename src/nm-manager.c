@@ -232,7 +232,7 @@ NM_DEFINE_SINGLETON_INSTANCE (NMManager);
         const NMLogLevel _level = (level); \
         const NMLogDomain _domain = (domain); \
         \
-        if (nm_logging_enabled (_level, _domain)) { \
+        if (nm_log_enabled (_level, _domain)) { \
             const NMManager *const _self = (self); \
             char _sbuf[32]; \
             \
@@ -251,7 +251,7 @@ NM_DEFINE_SINGLETON_INSTANCE (NMManager);
         const NMLogLevel _level = (level); \
         const NMLogDomain _domain = (domain); \
         \
-        if (nm_logging_enabled (_level, _domain)) { \
+        if (nm_log_enabled (_level, _domain)) { \
             const NMManager *const _self = (self); \
             const char *const _ifname = _nm_device_get_iface (device); \
             char _sbuf[32]; \
@@ -273,7 +273,7 @@ NM_DEFINE_SINGLETON_INSTANCE (NMManager);
         const NMLogLevel _level = (level); \
         const NMLogDomain _domain = (domain); \
         \
-        if (nm_logging_enabled (_level, _domain)) { \
+        if (nm_log_enabled (_level, _domain)) { \
             const NMManager *const _self = (self); \
             NMConnection *const _connection = (connection); \
             const char *const _con_id = _nm_connection_get_id (_connection); \
@@ -6400,6 +6400,40 @@ impl_manager_set_logging (NMDBusObject *obj,
 		g_dbus_method_invocation_return_value (invocation, NULL);
 }
 
+static void
+impl_manager_dump_logging (NMDBusObject *obj,
+                           const NMDBusInterfaceInfoExtended *interface_info,
+                           const NMDBusMethodInfoExtended *method_info,
+                           GDBusConnection *connection,
+                           const char *sender,
+                           GDBusMethodInvocation *invocation,
+                           GVariant *parameters)
+{
+	NMManager *self = NM_MANAGER (obj);
+	gs_strfreev char **lines = NULL;
+
+	/* The messages may contain private data. Like for SetLogging, the
+	 * permission is enforced by the D-Bus daemon. */
+	if (!nm_dbus_manager_ensure_uid (nm_dbus_object_get_manager (NM_DBUS_OBJECT (self)),
+	                                 invocation,
+	                                 G_MAXULONG,
+	                                 NM_MANAGER_ERROR,
+	                                 NM_MANAGER_ERROR_PERMISSION_DENIED))
+		return;
+
+	lines = nm_logging_flight_recorder_dump ();
+	if (!lines) {
+		g_dbus_method_invocation_return_error_literal (invocation,
+		                                               NM_MANAGER_ERROR,
+		                                               NM_MANAGER_ERROR_FAILED,
+		                                               "The flight recorder is not enabled");
+		return;
+	}
+
+	g_dbus_method_invocation_return_value (invocation,
+	                                       g_variant_new ("(^as)", lines));
+}
+
 static void
 impl_manager_get_logging (NMDBusObject *obj,
                           const NMDBusInterfaceInfoExtended *interface_info,
@@ -8065,6 +8099,15 @@ static const NMDBusInterfaceInfoExtended interface_info_manager = {
 				),
 				.handle = impl_manager_get_logging,
 			),
+			NM_DEFINE_DBUS_METHOD_INFO_EXTENDED (
+				NM_DEFINE_GDBUS_METHOD_INFO_INIT (
+					"DumpLogging",
+					.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+						NM_DEFINE_GDBUS_ARG_INFO ("lines", "as"),
+					),
+				),
+				.handle = impl_manager_dump_logging,
+			),
 			NM_DEFINE_DBUS_METHOD_INFO_EXTENDED (
 				NM_DEFINE_GDBUS_METHOD_INFO_INIT (
 					"CheckConnectivity",
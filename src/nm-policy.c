@@ -69,6 +69,16 @@ typedef struct {
 		GInetAddress *addr;
 		GResolver *resolver;
 		GCancellable *cancellable;
+
+		/* the address of the lookup in progress. */
+		char *pending_addr_str;
+
+		/* whether the result of the pending lookup is still wanted for
+		 * the hostname. Otherwise, it only gets cached. */
+		bool pending_wanted:1;
+
+		/* recent results of reverse lookups, by address. */
+		GHashTable *cache;
 	} lookup;
 
 	NMDnsManager *dns_manager;
@@ -638,6 +648,90 @@ _set_hostname (NMPolicy *self,
 	                                            g_object_ref (self));
 }
 
+/* GResolver does not tell the TTL of the PTR record. Cache the results
+ * for a fixed time instead. The cache is flushed when the DNS
+ * configuration changes. */
+#define LOOKUP_CACHE_TTL_SEC        300
+#define LOOKUP_CACHE_TTL_FAILED_SEC 30
+#define LOOKUP_CACHE_MAX            16
+
+typedef struct {
+	char *hostname;
+	char *error_msg;
+	gint32 expiry_sec;
+} LookupCacheEntry;
+
+static void
+_lookup_cache_entry_free (gpointer data)
+{
+	LookupCacheEntry *entry = data;
+
+	g_free (entry->hostname);
+	g_free (entry->error_msg);
+	nm_g_slice_free (entry);
+}
+
+static const LookupCacheEntry *
+lookup_cache_get (NMPolicy *self, const char *addr_str)
+{
+	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (self);
+	LookupCacheEntry *entry;
+
+	entry = g_hash_table_lookup (priv->lookup.cache, addr_str);
+	if (!entry)
+		return NULL;
+
+	if (entry->expiry_sec <= nm_utils_get_monotonic_timestamp_sec ()) {
+		g_hash_table_remove (priv->lookup.cache, addr_str);
+		return NULL;
+	}
+
+	return entry;
+}
+
+static void
+lookup_cache_add (NMPolicy *self,
+                  const char *addr_str,
+                  const char *hostname,
+                  const char *error_msg)
+{
+	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (self);
+	LookupCacheEntry *entry;
+	gint32 now;
+
+	now = nm_utils_get_monotonic_timestamp_sec ();
+
+	if (g_hash_table_size (priv->lookup.cache) >= LOOKUP_CACHE_MAX) {
+		GHashTableIter iter;
+
+		g_hash_table_iter_init (&iter, priv->lookup.cache);
+		while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry)) {
+			if (entry->expiry_sec <= now)
+				g_hash_table_iter_remove (&iter);
+		}
+		if (g_hash_table_size (priv->lookup.cache) >= LOOKUP_CACHE_MAX)
+			g_hash_table_remove_all (priv->lookup.cache);
+	}
+
+	entry = g_slice_new (LookupCacheEntry);
+	*entry = (LookupCacheEntry) {
+		.hostname   = g_strdup (hostname),
+		.error_msg  = g_strdup (error_msg),
+		.expiry_sec = now + (hostname ? LOOKUP_CACHE_TTL_SEC : LOOKUP_CACHE_TTL_FAILED_SEC),
+	};
+	g_hash_table_insert (priv->lookup.cache, g_strdup (addr_str), entry);
+}
+
+static void
+lookup_cancel (NMPolicy *self)
+{
+	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (self);
+
+	nm_clear_g_cancellable (&priv->lookup.cancellable);
+	nm_clear_g_free (&priv->lookup.pending_addr_str);
+	priv->lookup.pending_wanted = FALSE;
+}
+
 static void
 lookup_callback (GObject *source,
                  GAsyncResult *result,
@@ -646,6 +740,7 @@ lookup_callback (GObject *source,
 	NMPolicy *self;
 	NMPolicyPrivate *priv;
 	gs_free char *hostname = NULL;
+	gs_free char *addr_str = NULL;
 	gs_free_error GError *error = NULL;
 
 	hostname = g_resolver_lookup_by_address_finish (G_RESOLVER (source), result, &error);
@@ -656,6 +751,15 @@ lookup_callback (GObject *source,
 	priv = NM_POLICY_GET_PRIVATE (self);
 
 	g_clear_object (&priv->lookup.cancellable);
+	addr_str = g_steal_pointer (&priv->lookup.pending_addr_str);
+
+	lookup_cache_add (self, addr_str, hostname, error ? error->message : NULL);
+
+	if (!priv->lookup.pending_wanted) {
+		_LOGT (LOGD_DNS, "reverse-lookup: result for %s is no longer needed", addr_str);
+		return;
+	}
+	priv->lookup.pending_wanted = FALSE;
 
 	if (hostname)
 		_set_hostname (self, hostname, "from address lookup");
@@ -667,9 +771,35 @@ static void
 lookup_by_address (NMPolicy *self)
 {
 	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (self);
+	const LookupCacheEntry *entry;
+	gs_free char *addr_str = NULL;
+
+	addr_str = g_inet_address_to_string (priv->lookup.addr);
+
+	entry = lookup_cache_get (self, addr_str);
+	if (entry) {
+		_LOGT (LOGD_DNS, "reverse-lookup: use cached result for %s", addr_str);
+		lookup_cancel (self);
+		if (entry->hostname)
+			_set_hostname (self, entry->hostname, "from address lookup (cached)");
+		else
+			_set_hostname (self, NULL, entry->error_msg);
+		return;
+	}
+
+	if (   priv->lookup.cancellable
+	    && nm_streq0 (priv->lookup.pending_addr_str, addr_str)) {
+		/* the same address is already being resolved. Wait for it. */
+		priv->lookup.pending_wanted = TRUE;
+		return;
+	}
+
+	/* a lookup of another address is superseded. */
+	lookup_cancel (self);
 
-	nm_clear_g_cancellable (&priv->lookup.cancellable);
 	priv->lookup.cancellable = g_cancellable_new ();
+	priv->lookup.pending_addr_str = g_steal_pointer (&addr_str);
+	priv->lookup.pending_wanted = TRUE;
 	g_resolver_lookup_by_address_async (priv->lookup.resolver,
 	                                    priv->lookup.addr,
 	                                    priv->lookup.cancellable,
@@ -700,7 +830,9 @@ update_system_hostname (NMPolicy *self, const char *msg)
 
 	_LOGT (LOGD_DNS, "set-hostname: updating hostname (%s)", msg);
 
-	nm_clear_g_cancellable (&priv->lookup.cancellable);
+	/* keep a pending reverse lookup running, it might be needed again
+	 * below. But only use its result if we ask again. */
+	priv->lookup.pending_wanted = FALSE;
 
 	/* Check if the hostname was set externally to NM, so that in that case
 	 * we can avoid to fallback to the one we got when we started.
@@ -2368,7 +2500,8 @@ dns_config_changed (NMDnsManager *dns_manager, gpointer user_data)
 	 * (race in updating DNS and doing the reverse lookup).
 	 */
 
-	nm_clear_g_cancellable (&priv->lookup.cancellable);
+	lookup_cancel (self);
+	g_hash_table_remove_all (priv->lookup.cache);
 
 	/* Re-start the hostname lookup thread if we don't have hostname yet. */
 	if (priv->lookup.addr) {
@@ -2632,6 +2765,7 @@ constructed (GObject *object)
 	                                            G_CALLBACK (dns_config_changed), self);
 
 	priv->lookup.resolver = g_resolver_get_default ();
+	priv->lookup.cache = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, _lookup_cache_entry_free);
 
 	g_signal_connect (priv->hostname_manager, "notify::" NM_HOSTNAME_MANAGER_HOSTNAME, (GCallback) hostname_changed, priv);
 
@@ -2675,9 +2809,10 @@ dispose (GObject *object)
 	NMDevice *device;
 	ActivateData *data, *data_safe;
 
-	nm_clear_g_cancellable (&priv->lookup.cancellable);
+	lookup_cancel (self);
 	g_clear_object (&priv->lookup.addr);
 	g_clear_object (&priv->lookup.resolver);
+	nm_clear_pointer (&priv->lookup.cache, g_hash_table_destroy);
 
 	nm_clear_g_object (&priv->default_ac4);
 	nm_clear_g_object (&priv->default_ac6);
@@ -45,6 +45,64 @@ nmtst_init_assert_logging (int *argc, char ***argv, const char *log_level, const
 
 /*****************************************************************************/
 
+/* Helpers for benchmarks. With meson, run them with
+ * `meson test --benchmark --suite bench`. Benchmarks that are built with
+ * NMTST_TEST_QUICK are also run as part of the regular test suite.
+ *
+ * Each benchmark produces a result as one line of JSON. If the environment
+ * variable NMTST_BENCH_JSON is set to a file name, the lines are appended to that
+ * file. Otherwise they are printed to stdout.
+ *
+ * Unless running in slow mode (NMTST_DEBUG=slow), benchmarks should only use a
+ * small input, so that they still execute quickly. */
+
+static inline guint
+nmtst_bench_n (guint n_slow, guint n_quick)
+{
+	return nmtst_test_quick () ? n_quick : n_slow;
+}
+
+static inline gint64
+nmtst_bench_now (void)
+{
+	return nm_utils_clock_gettime_nsec (CLOCK_MONOTONIC);
+}
+
+/* @platform is optional. If given, it is reported as "platform" field. */
+static inline void
+nmtst_bench_report (const char *name, const char *platform, guint n, gint64 start_nsec)
+{
+	gs_free char *line = NULL;
+	gs_free char *platform_field = NULL;
+	const char *filename;
+	gint64 duration_nsec;
+
+	duration_nsec = nmtst_bench_now () - start_nsec;
+
+	if (platform)
+		platform_field = g_strdup_printf (", \"platform\": \"%s\"", platform);
+
+	line = g_strdup_printf ("{\"benchmark\": \"%s\"%s, \"n\": %u, \"duration_nsec\": %"G_GINT64_FORMAT", \"nsec_per_op\": %.1f}\n",
+	                        name,
+	                        platform_field ?: "",
+	                        n,
+	                        duration_nsec,
+	                        n > 0 ? ((double) duration_nsec) / n : 0.0);
+
+	filename = g_getenv ("NMTST_BENCH_JSON");
+	if (filename && filename[0]) {
+		FILE *f;
+
+		f = fopen (filename, "ae");
+		g_assert (f);
+		fputs (line, f);
+		fclose (f);
+	} else
+		g_print ("%s", line);
+}
+
+/*****************************************************************************/
+
 #ifdef __NETWORKMANAGER_PLATFORM_H__
 
 static inline NMPlatformIP4Address *
@@ -0,0 +1,306 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nm-worker-pool.h"
+
+#include "c-list/src/c-list.h"
+
+/*****************************************************************************/
+
+/* the maximum number of threads. Most work is I/O bound and
+ * a few threads suffice to keep it off the main loop. */
+#define MAX_THREADS 4
+
+typedef struct {
+	CList work_lst;
+	char *serial_key;
+	NMWorkerPoolFunc func;
+	NMWorkerPoolDoneFunc done_func;
+	gpointer user_data;
+	GMainContext *context;
+} WorkItem;
+
+typedef struct {
+	/* the key must be the first field. */
+	char *serial_key;
+
+	/* the items that wait for the one currently running. */
+	CList work_lst_head;
+} SerialQueue;
+
+static struct {
+	GMutex lock;
+	GCond cond;
+	GThreadPool *pool;
+
+	/* for each serial-key that currently has a running item, the
+	 * queue of items that are waiting for it. */
+	GHashTable *serial_queues;
+
+	guint n_pending;
+} gl;
+
+/*****************************************************************************/
+
+static void
+_work_item_free (WorkItem *item)
+{
+	g_main_context_unref (item->context);
+	g_free (item->serial_key);
+	nm_g_slice_free (item);
+}
+
+static gboolean
+_work_item_done_cb (gpointer user_data)
+{
+	WorkItem *item = user_data;
+
+	item->done_func (item->user_data);
+	_work_item_free (item);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_serial_queue_free (gpointer data)
+{
+	SerialQueue *queue = data;
+
+	nm_assert (c_list_is_empty (&queue->work_lst_head));
+
+	g_free (queue->serial_key);
+	nm_g_slice_free (queue);
+}
+
+static void
+_pool_push (WorkItem *item)
+{
+	gs_free_error GError *error = NULL;
+
+	if (!g_thread_pool_push (gl.pool, item, &error)) {
+		/* the item is still queued and will be processed by another
+		 * thread of the pool. */
+		nm_log_warn (LOGD_CORE, "worker-pool: failure to start thread: %s", error->message);
+	}
+}
+
+static void
+_pool_thread_fn (gpointer data, gpointer user_data)
+{
+	WorkItem *item = data;
+	WorkItem *item_next = NULL;
+
+	item->func (item->user_data);
+
+	if (item->serial_key) {
+		SerialQueue *queue;
+
+		g_mutex_lock (&gl.lock);
+		queue = g_hash_table_lookup (gl.serial_queues, &item->serial_key);
+		nm_assert (queue);
+		item_next = c_list_first_entry (&queue->work_lst_head, WorkItem, work_lst);
+		if (item_next)
+			c_list_unlink (&item_next->work_lst);
+		else {
+			g_hash_table_remove (gl.serial_queues, &item->serial_key);
+			g_cond_broadcast (&gl.cond);
+		}
+		g_mutex_unlock (&gl.lock);
+	}
+
+	if (item->done_func) {
+		GSource *source;
+
+		/* not g_main_context_invoke_full(). That would call @done_func right
+		 * away on this thread, if it can acquire the context. */
+		source = nm_g_idle_source_new (G_PRIORITY_DEFAULT,
+		                               _work_item_done_cb,
+		                               item,
+		                               NULL);
+		g_source_attach (source, item->context);
+		g_source_unref (source);
+	} else
+		_work_item_free (item);
+
+	if (item_next)
+		_pool_push (item_next);
+
+	g_mutex_lock (&gl.lock);
+	nm_assert (gl.n_pending > 0);
+	if (--gl.n_pending == 0)
+		g_cond_broadcast (&gl.cond);
+	g_mutex_unlock (&gl.lock);
+}
+
+/**
+ * nm_worker_pool_submit:
+ * @serial_key: (allow-none): if set, work items with the same key
+ *   are run one after the other, in the order of submission.
+ * @func: the function that runs on the worker thread.
+ * @done_func: (allow-none): the function that gets invoked
+ *   on the caller's main context, after @func completed.
+ * @user_data: the user data for @func and @done_func.
+ */
+void
+nm_worker_pool_submit (const char *serial_key,
+                       NMWorkerPoolFunc func,
+                       NMWorkerPoolDoneFunc done_func,
+                       gpointer user_data)
+{
+	WorkItem *item;
+
+	g_return_if_fail (func);
+
+	item = g_slice_new (WorkItem);
+	*item = (WorkItem) {
+		.serial_key = g_strdup (serial_key),
+		.func       = func,
+		.done_func  = done_func,
+		.user_data  = user_data,
+		.context    = g_main_context_ref_thread_default (),
+	};
+
+	g_mutex_lock (&gl.lock);
+
+	if (G_UNLIKELY (!gl.pool)) {
+		gl.pool = g_thread_pool_new (_pool_thread_fn, NULL, MAX_THREADS, FALSE, NULL);
+		gl.serial_queues = g_hash_table_new_full (nm_pstr_hash, nm_pstr_equal, _serial_queue_free, NULL);
+	}
+
+	gl.n_pending++;
+
+	if (item->serial_key) {
+		SerialQueue *queue;
+
+		queue = g_hash_table_lookup (gl.serial_queues, &item->serial_key);
+		if (queue) {
+			/* another item with the same key is running. Enqueue, the thread
+			 * will push this item when it's done. */
+			c_list_link_tail (&queue->work_lst_head, &item->work_lst);
+			g_mutex_unlock (&gl.lock);
+			return;
+		}
+
+		queue = g_slice_new (SerialQueue);
+		queue->serial_key = g_strdup (item->serial_key);
+		c_list_init (&queue->work_lst_head);
+		g_hash_table_add (gl.serial_queues, queue);
+	}
+
+	g_mutex_unlock (&gl.lock);
+
+	_pool_push (item);
+}
+
+/**
+ * nm_worker_pool_wait:
+ *
+ * Blocks until all submitted work completed. This does not invoke the
+ * done functions, which are still pending on their main contexts.
+ * Call this before exiting, so that no work gets lost.
+ */
+void
+nm_worker_pool_wait (void)
+{
+	g_mutex_lock (&gl.lock);
+	while (gl.n_pending > 0)
+		g_cond_wait (&gl.cond, &gl.lock);
+	g_mutex_unlock (&gl.lock);
+}
+
+/**
+ * nm_worker_pool_wait_key:
+ * @serial_key: the key of the work items to wait for.
+ *
+ * Blocks until all work items that were submitted with @serial_key
+ * completed. For example, call this before reading a file that
+ * might still be written by the pool.
+ */
+void
+nm_worker_pool_wait_key (const char *serial_key)
+{
+	g_return_if_fail (serial_key);
+
+	g_mutex_lock (&gl.lock);
+	while (   gl.serial_queues
+	       && g_hash_table_contains (gl.serial_queues, &serial_key))
+		g_cond_wait (&gl.cond, &gl.lock);
+	g_mutex_unlock (&gl.lock);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+	char *filename;
+	char *contents;
+	gsize length;
+	GError *error;
+	NMWorkerPoolFileCallback callback;
+	gpointer user_data;
+} FileSetContentsData;
+
+static void
+_file_set_contents_fn (gpointer user_data)
+{
+	FileSetContentsData *data = user_data;
+
+	g_file_set_contents (data->filename,
+	                     data->contents,
+	                     data->length,
+	                     &data->error);
+}
+
+static void
+_file_set_contents_done (gpointer user_data)
+{
+	FileSetContentsData *data = user_data;
+
+	if (data->callback)
+		data->callback (data->filename, data->error, data->user_data);
+
+	g_clear_error (&data->error);
+	g_free (data->filename);
+	g_free (data->contents);
+	nm_g_slice_free (data);
+}
+
+/**
+ * nm_worker_pool_file_set_contents:
+ * @filename: the file to write.
+ * @contents_take: the content. The function takes ownership of the buffer.
+ * @length: the length of @contents_take.
+ * @callback: (allow-none): invoked on the caller's main context
+ *   with the result of writing the file.
+ * @user_data: the user data for @callback.
+ *
+ * Like g_file_set_contents(), but writes the file on a worker thread.
+ * Writes to the same file are performed in order.
+ */
+void
+nm_worker_pool_file_set_contents (const char *filename,
+                                  char *contents_take,
+                                  gsize length,
+                                  NMWorkerPoolFileCallback callback,
+                                  gpointer user_data)
+{
+	FileSetContentsData *data;
+
+	g_return_if_fail (filename);
+
+	data = g_slice_new (FileSetContentsData);
+	*data = (FileSetContentsData) {
+		.filename  = g_strdup (filename),
+		.contents  = contents_take,
+		.length    = length,
+		.callback  = callback,
+		.user_data = user_data,
+	};
+
+	nm_worker_pool_submit (data->filename,
+	                       _file_set_contents_fn,
+	                       _file_set_contents_done,
+	                       data);
+}
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#ifndef __NM_WORKER_POOL_H__
+#define __NM_WORKER_POOL_H__
+
+/*****************************************************************************/
+
+/* The worker pool runs blocking work (like writing files with fsync) off the
+ * main loop, on a small, bounded set of threads.
+ *
+ * The @func runs on a worker thread. It must only access the data passed
+ * via @user_data, and in particular must not touch any GObject of the daemon.
+ * Afterwards, @done_func is invoked on the GMainContext that was the
+ * thread-default context when submitting the work.
+ *
+ * Work items with the same @serial_key never run in parallel and run
+ * in the order they were submitted. For example, use the filename as key
+ * when writing a file. Items without key may run in any order. */
+
+typedef void (*NMWorkerPoolFunc)     (gpointer user_data);
+typedef void (*NMWorkerPoolDoneFunc) (gpointer user_data);
+
+void nm_worker_pool_submit (const char *serial_key,
+                            NMWorkerPoolFunc func,
+                            NMWorkerPoolDoneFunc done_func,
+                            gpointer user_data);
+
+void nm_worker_pool_wait (void);
+
+void nm_worker_pool_wait_key (const char *serial_key);
+
+/*****************************************************************************/
+
+typedef void (*NMWorkerPoolFileCallback) (const char *filename,
+                                          GError *error,
+                                          gpointer user_data);
+
+void nm_worker_pool_file_set_contents (const char *filename,
+                                       char *contents_take,
+                                       gsize length,
+                                       NMWorkerPoolFileCallback callback,
+                                       gpointer user_data);
+
+#endif /* __NM_WORKER_POOL_H__ */
@@ -59,7 +59,7 @@ G_DEFINE_TYPE (NMFakePlatform, nm_fake_platform, NM_TYPE_PLATFORM)
         const NMLogLevel __level = (level); \
         const NMLogDomain __domain = (domain); \
         \
-        if (nm_logging_enabled (__level, __domain)) { \
+        if (nm_log_enabled (__level, __domain)) { \
             char __prefix[32]; \
             const char *__p_prefix = _NMLOG_PREFIX_NAME; \
             NMPlatform *const __self = (self); \
@@ -1167,8 +1167,9 @@ ip_route_add (NMPlatform *platform,
 
 	flags = NM_FLAGS_UNSET (flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE);
 
-	/* currently, only replace is implemented. */
-	g_assert (flags == NMP_NLM_FLAG_REPLACE);
+	/* currently, only replace and append are implemented. */
+	g_assert (NM_IN_SET (flags, NMP_NLM_FLAG_REPLACE,
+	                            NMP_NLM_FLAG_APPEND));
 
 	obj = nmp_object_new (addr_family == AF_INET
 	                        ? NMP_OBJECT_TYPE_IP4_ROUTE
@@ -1256,6 +1257,9 @@ ip_route_add (NMPlatform *platform,
 		case NMP_NLM_FLAG_REPLACE:
 			nlmsgflags = NLM_F_REPLACE;
 			break;
+		case NMP_NLM_FLAG_APPEND:
+			nlmsgflags = NLM_F_APPEND;
+			break;
 		default:
 			g_assert_not_reached ();
 			break;
@@ -198,6 +198,7 @@ G_STATIC_ASSERT (RTA_MAX == (__RTA_MAX - 1));
 
 #define WGPEER_F_REMOVE_ME                     ((guint32) (1U << 0))
 #define WGPEER_F_REPLACE_ALLOWEDIPS            ((guint32) (1U << 1))
+#define WGPEER_F_UPDATE_ONLY                   ((guint32) (1U << 2))
 
 
 #define WGDEVICE_A_UNSPEC                      0
@@ -498,7 +499,7 @@ G_DEFINE_TYPE (NMLinuxPlatform, nm_linux_platform, NM_TYPE_PLATFORM)
         const NMLogLevel __level = (level); \
         const NMLogDomain __domain = (domain); \
         \
-        if (nm_logging_enabled (__level, __domain)) { \
+        if (nm_log_enabled (__level, __domain)) { \
             _LOG_print (__level, __domain, 0, self, __VA_ARGS__); \
         } \
     } G_STMT_END
@@ -508,7 +509,7 @@ G_DEFINE_TYPE (NMLinuxPlatform, nm_linux_platform, NM_TYPE_PLATFORM)
         const NMLogLevel __level = (level); \
         const NMLogDomain __domain = (domain); \
         \
-        if (nm_logging_enabled (__level, __domain)) { \
+        if (nm_log_enabled (__level, __domain)) { \
             int __errsv = (errsv); \
             \
             /* The %m format specifier (GNU extension) would already allow you to specify the error
@@ -2465,16 +2466,15 @@ _wireguard_refresh_link (NMPlatform *platform,
 	return obj_new;
 }
 
-static int
-_wireguard_create_change_nlmsgs (NMPlatform *platform,
-                                 int ifindex,
-                                 int wireguard_family_id,
-                                 const NMPlatformLnkWireGuard *lnk_wireguard,
-                                 const NMPWireGuardPeer *peers,
-                                 const NMPlatformWireGuardChangePeerFlags *peer_flags,
-                                 guint peers_len,
-                                 NMPlatformWireGuardChangeFlags change_flags,
-                                 GPtrArray **out_msgs)
+int
+_nm_linux_platform_wireguard_create_change_nlmsgs (int ifindex,
+                                                   int wireguard_family_id,
+                                                   const NMPlatformLnkWireGuard *lnk_wireguard,
+                                                   const NMPWireGuardPeer *peers,
+                                                   const NMPlatformWireGuardChangePeerFlags *peer_flags,
+                                                   guint peers_len,
+                                                   NMPlatformWireGuardChangeFlags change_flags,
+                                                   GPtrArray **out_msgs)
 {
 	gs_unref_ptrarray GPtrArray *msgs = NULL;
 	nm_auto_nlmsg struct nl_msg *msg = NULL;
@@ -2500,9 +2500,9 @@ _wireguard_create_change_nlmsgs (NMPlatform *platform,
 	idx_peer_curr = IDX_NIL;
 	idx_allowed_ips_curr = IDX_NIL;
 
-	/* TODO: for the moment, we always reset all peers and allowed-ips (WGDEVICE_F_REPLACE_PEERS, WGPEER_F_REPLACE_ALLOWEDIPS).
-	 * The platform API should be extended to also support partial updates. In particular, configuring the same configuration
-	 * multiple times, should not clear and re-add all settings, but rather sync the existing settings with the desired configuration. */
+	/* Peers without any change flags are skipped entirely. That allows the caller
+	 * to pass only the peers that changed (together with peers flagged as REMOVE_ME)
+	 * and omit WGDEVICE_F_REPLACE_PEERS, for an incremental update of the device. */
 
 again:
 
@@ -2560,8 +2560,8 @@ again:
 			                            | NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_ALLOWEDIPS
 			                            | NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REPLACE_ALLOWEDIPS)) {
 				/* no flags set. We take that as indication to skip configuring the peer
-				 * entirely. */
-				nm_assert (p_flags == NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_NONE);
+				 * entirely. UPDATE_ONLY alone has nothing to update either. */
+				nm_assert (NM_FLAGS_UNSET (p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_UPDATE_ONLY) == NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_NONE);
 				continue;
 			}
 		}
@@ -2580,6 +2580,13 @@ again:
 		} else {
 
 			if (idx_allowed_ips_curr == IDX_NIL) {
+				guint32 wgpeer_flags = 0;
+
+				if (NM_FLAGS_HAS (p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REPLACE_ALLOWEDIPS))
+					wgpeer_flags |= WGPEER_F_REPLACE_ALLOWEDIPS;
+				if (NM_FLAGS_HAS (p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_UPDATE_ONLY))
+					wgpeer_flags |= WGPEER_F_UPDATE_ONLY;
+
 				if (   NM_FLAGS_HAS (p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_PRESHARED_KEY)
 				    && nla_put (msg, WGPEER_A_PRESHARED_KEY, sizeof (p->preshared_key), p->preshared_key) < 0)
 					goto toobig_peers;
@@ -2588,8 +2595,8 @@ again:
 				    && nla_put_uint16 (msg, WGPEER_A_PERSISTENT_KEEPALIVE_INTERVAL, p->persistent_keepalive_interval) < 0)
 					goto toobig_peers;
 
-				if (   NM_FLAGS_HAS (p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REPLACE_ALLOWEDIPS)
-				    && nla_put_uint32 (msg, WGPEER_A_FLAGS, WGPEER_F_REPLACE_ALLOWEDIPS) < 0)
+				if (   wgpeer_flags != 0
+				    && nla_put_uint32 (msg, WGPEER_A_FLAGS, wgpeer_flags) < 0)
 					goto toobig_peers;
 
 				if (NM_FLAGS_HAS (p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_ENDPOINT)) {
@@ -2698,48 +2705,82 @@ link_wireguard_change (NMPlatform *platform,
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
 	gs_unref_ptrarray GPtrArray *msgs = NULL;
 	int wireguard_family_id;
-	guint i;
+	guint i_sent;
+	guint i_acked;
+	int r_first = 0;
 	int r;
 
 	wireguard_family_id = _wireguard_get_family_id (platform, ifindex);
 	if (wireguard_family_id < 0)
 		return -NME_PL_NO_FIRMWARE;
 
-	r = _wireguard_create_change_nlmsgs (platform,
-	                                     ifindex,
-	                                     wireguard_family_id,
-	                                     lnk_wireguard,
-	                                     peers,
-	                                     peer_flags,
-	                                     peers_len,
-	                                     change_flags,
-	                                     &msgs);
+	r = _nm_linux_platform_wireguard_create_change_nlmsgs (ifindex,
+	                                                       wireguard_family_id,
+	                                                       lnk_wireguard,
+	                                                       peers,
+	                                                       peer_flags,
+	                                                       peers_len,
+	                                                       change_flags,
+	                                                       &msgs);
 	if (r < 0) {
 		_LOGW ("wireguard: set-device, cannot construct netlink message: %s", nm_strerror (r));
 		return r;
 	}
 
-	for (i = 0; i < msgs->len; i++) {
-		r = nl_send_auto (priv->genl, msgs->pdata[i]);
-		if (r < 0) {
-			_LOGW ("wireguard: set-device, send netlink message #%u failed: %s", i, nm_strerror (r));
-			return r;
+	/* A large configuration is split over many messages. Instead of waiting for
+	 * the acknowledgement of each message before sending the next, we keep up to
+	 * WIREGUARD_CHANGE_PIPELINE_MAX messages in flight. The kernel handles the
+	 * requests in order, so the ACKs arrive in order too.
+	 *
+	 * The limit ensures that the pending ACKs (which, on failure, contain the
+	 * original request) fit into the receive buffer of the socket.
+	 *
+	 * If a message fails, the kernel already applied the messages before it
+	 * (and we might have sent some after it). We don't roll them back, the
+	 * device is left partially configured. The caller gets the first error
+	 * and must do a full configuration with REPLACE_PEERS to get to a known
+	 * state. */
+#define WIREGUARD_CHANGE_PIPELINE_MAX 16u
+
+	i_sent = 0;
+	i_acked = 0;
+	while (i_acked < msgs->len) {
+
+		while (   r_first >= 0
+		       && i_sent < msgs->len
+		       && i_sent - i_acked < WIREGUARD_CHANGE_PIPELINE_MAX) {
+			r = nl_send_auto (priv->genl, msgs->pdata[i_sent]);
+			if (r < 0) {
+				_LOGW ("wireguard: set-device, send netlink message #%u failed: %s", i_sent, nm_strerror (r));
+				r_first = r;
+				break;
+			}
+			i_sent++;
 		}
 
+		if (i_acked == i_sent)
+			break;
+
 		do {
 			r = nl_recvmsgs (priv->genl, NULL);
 		} while (r == -EAGAIN);
 		if (r < 0) {
-			_LOGW ("wireguard: set-device, message #%u was rejected: %s", i, nm_strerror (r));
-			return r;
-		}
-
-		_LOGT ("wireguard: set-device, message #%u sent and confirmed", i);
+			_LOGW ("wireguard: set-device, message #%u was rejected: %s", i_acked, nm_strerror (r));
+			if (r_first >= 0)
+				r_first = r;
+			if (r == -NME_NL_SEQ_MISMATCH) {
+				/* we lost track of the sequence numbers. Don't wait for
+				 * the remaining ACKs. */
+				break;
+			}
+		} else
+			_LOGT ("wireguard: set-device, message #%u sent and confirmed", i_acked);
+		i_acked++;
 	}
 
 	_wireguard_refresh_link (platform, wireguard_family_id, ifindex);
 
-	return 0;
+	return r_first < 0 ? r_first : 0;
 }
 
 /*****************************************************************************/
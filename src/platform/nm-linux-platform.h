@@ -24,4 +24,14 @@ NMPlatform *nm_linux_platform_new (gboolean log_with_ptr, gboolean netns_support
 
 void nm_linux_platform_setup (void);
 
+/* exposed for unit tests only. */
+int _nm_linux_platform_wireguard_create_change_nlmsgs (int ifindex,
+                                                       int wireguard_family_id,
+                                                       const NMPlatformLnkWireGuard *lnk_wireguard,
+                                                       const struct _NMPWireGuardPeer *peers,
+                                                       const NMPlatformWireGuardChangePeerFlags *peer_flags,
+                                                       guint peers_len,
+                                                       NMPlatformWireGuardChangeFlags change_flags,
+                                                       GPtrArray **out_msgs);
+
 #endif /* __NETWORKMANAGER_LINUX_PLATFORM_H__ */
@@ -133,7 +133,7 @@ nmp_link_address_get_as_bytes (const NMPLinkAddress *addr)
     G_STMT_START { \
         const NMLogLevel __level = (level); \
         \
-        if (nm_logging_enabled (__level, _NMLOG_DOMAIN)) { \
+        if (nm_log_enabled (__level, _NMLOG_DOMAIN)) { \
             NMLOG_COMMON(level, NULL, __VA_ARGS__);  \
         } \
     } G_STMT_END
@@ -142,7 +142,7 @@ nmp_link_address_get_as_bytes (const NMPLinkAddress *addr)
     G_STMT_START { \
         const NMLogLevel __level = (level); \
         \
-        if (nm_logging_enabled (__level, _NMLOG_DOMAIN)) { \
+        if (nm_log_enabled (__level, _NMLOG_DOMAIN)) { \
             NMLOG_COMMON(level, name, __VA_ARGS__);  \
         } \
     } G_STMT_END
@@ -151,7 +151,7 @@ nmp_link_address_get_as_bytes (const NMPLinkAddress *addr)
     G_STMT_START { \
         const NMLogLevel __level = (level); \
         \
-        if (nm_logging_enabled (__level, _NMLOG_DOMAIN)) { \
+        if (nm_log_enabled (__level, _NMLOG_DOMAIN)) { \
             NMLOG_COMMON(level, ifindex > 0 ? nm_platform_link_get_name (self, ifindex) : NULL, __VA_ARGS__);  \
         } \
     } G_STMT_END
@@ -2319,6 +2319,7 @@ NM_UTILS_FLAGS2STR_DEFINE (_wireguard_change_peer_flags_to_string, NMPlatformWir
 	NM_UTILS_FLAGS2STR (NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_ENDPOINT,           "ep"),
 	NM_UTILS_FLAGS2STR (NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_ALLOWEDIPS,         "aips"),
 	NM_UTILS_FLAGS2STR (NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REPLACE_ALLOWEDIPS,     "remove-aips"),
+	NM_UTILS_FLAGS2STR (NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_UPDATE_ONLY,            "update-only"),
 );
 
 int
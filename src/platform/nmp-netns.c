@@ -68,7 +68,7 @@ __ns_types_to_str (int ns_types, int ns_types_already_set, char *buf, gsize len)
     G_STMT_START { \
         NMLogLevel _level = (level); \
         \
-        if (nm_logging_enabled (_level, _NMLOG_DOMAIN)) { \
+        if (nm_log_enabled (_level, _NMLOG_DOMAIN)) { \
             NMPNetns *_netns = (netns); \
             char _sbuf[20]; \
             \
@@ -28,7 +28,7 @@
     G_STMT_START { \
         const NMLogLevel __level = (level); \
         \
-        if (nm_logging_enabled (__level, _NMLOG_DOMAIN)) { \
+        if (nm_log_enabled (__level, _NMLOG_DOMAIN)) { \
             const NMPObject *const __obj = (obj); \
             \
             _nm_log (__level, _NMLOG_DOMAIN, 0, NULL, NULL, \
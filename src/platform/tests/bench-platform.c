@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nm-ip4-config.h"
+
+#include "test-common.h"
+
+/* Benchmarks for NMPCache, route sync and NMIP4Config operations.
+ *
+ * This is built with NMTST_TEST_QUICK, so that the regular test suite
+ * runs it with a small input. See nmtst_bench_report() for how to run
+ * the full benchmark. */
+
+#define DEVICE_IFINDEX NMTSTP_ENV1_IFINDEX
+
+#define BENCH_PLATFORM (nmtstp_is_root_test () ? "linux" : "fake")
+
+/*****************************************************************************/
+
+static void
+_ip4_route_init (NMPlatformIP4Route *r, int ifindex, guint i, guint32 metric)
+{
+	*r = (NMPlatformIP4Route) {
+		.ifindex   = ifindex,
+		.rt_source = NM_IP_CONFIG_SOURCE_USER,
+		.network   = htonl (0x0a000000u + i),
+		.plen      = 32,
+		.metric    = metric,
+	};
+}
+
+static GPtrArray *
+_ip4_routes_new (int ifindex, guint n, guint offset, guint32 metric)
+{
+	GPtrArray *routes;
+	guint i;
+
+	routes = g_ptr_array_new_full (n, (GDestroyNotify) nmp_object_unref);
+	for (i = 0; i < n; i++) {
+		NMPlatformIP4Route r;
+
+		_ip4_route_init (&r, ifindex, offset + i, metric);
+		g_ptr_array_add (routes, nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r));
+	}
+	return routes;
+}
+
+/*****************************************************************************/
+
+static void
+bench_cache_routes (void)
+{
+	nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = NULL;
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+	const guint n = nmtst_bench_n (1000000, 10000);
+	NMPCache *cache;
+	gint64 start;
+	guint i;
+
+	multi_idx = nm_dedup_multi_index_new ();
+	cache = nmp_cache_new (multi_idx, FALSE);
+
+	routes = _ip4_routes_new (1, n, 0, 100);
+
+	start = nmtst_bench_now ();
+	for (i = 0; i < n; i++) {
+		nm_auto_nmpobj const NMPObject *obj_old = NULL;
+		nm_auto_nmpobj const NMPObject *obj_new = NULL;
+		NMPCacheOpsType ops_type;
+
+		ops_type = nmp_cache_update_netlink_route (cache,
+		                                           routes->pdata[i],
+		                                           FALSE,
+		                                           0,
+		                                           &obj_old,
+		                                           &obj_new,
+		                                           NULL,
+		                                           NULL);
+		g_assert_cmpint (ops_type, ==, NMP_CACHE_OPS_ADDED);
+	}
+	nmtst_bench_report ("cache-route-insert", BENCH_PLATFORM, n, start);
+
+	start = nmtst_bench_now ();
+	for (i = 0; i < n; i++)
+		g_assert (nmp_cache_lookup_obj (cache, routes->pdata[i]));
+	nmtst_bench_report ("cache-route-lookup", BENCH_PLATFORM, n, start);
+
+	start = nmtst_bench_now ();
+	nmp_cache_free (cache);
+	nmtst_bench_report ("cache-route-free", BENCH_PLATFORM, n, start);
+}
+
+/*****************************************************************************/
+
+static void
+bench_route_sync (void)
+{
+	const guint n = nmtst_bench_n (10000, 1000);
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+	gs_unref_ptrarray GPtrArray *routes2 = NULL;
+	gs_unref_ptrarray GPtrArray *routes_prune = NULL;
+	gint64 start;
+
+#define _route_sync(routes) \
+	G_STMT_START { \
+		gs_unref_ptrarray GPtrArray *_routes_prune = NULL; \
+		\
+		_routes_prune = nm_platform_ip_route_get_prune_list (NM_PLATFORM_GET, \
+		                                                     AF_INET, \
+		                                                     DEVICE_IFINDEX, \
+		                                                     NM_IP_ROUTE_TABLE_SYNC_MODE_MAIN); \
+		g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET, \
+		                                     AF_INET, \
+		                                     DEVICE_IFINDEX, \
+		                                     (routes), \
+		                                     _routes_prune, \
+		                                     NULL)); \
+	} G_STMT_END
+
+	routes = _ip4_routes_new (DEVICE_IFINDEX, n, 0, 100);
+
+	start = nmtst_bench_now ();
+	_route_sync (routes);
+	nmtst_bench_report ("route-sync-add", BENCH_PLATFORM, n, start);
+
+	start = nmtst_bench_now ();
+	_route_sync (routes);
+	nmtst_bench_report ("route-sync-unchanged", BENCH_PLATFORM, n, start);
+
+	/* replace half of the routes. */
+	routes2 = _ip4_routes_new (DEVICE_IFINDEX, n, n / 2, 100);
+	start = nmtst_bench_now ();
+	_route_sync (routes2);
+	nmtst_bench_report ("route-sync-replace-half", BENCH_PLATFORM, n, start);
+
+	start = nmtst_bench_now ();
+	_route_sync (NULL);
+	nmtst_bench_report ("route-sync-remove", BENCH_PLATFORM, n, start);
+
+#undef _route_sync
+
+	routes_prune = nm_platform_ip_route_get_prune_list (NM_PLATFORM_GET,
+	                                                    AF_INET,
+	                                                    DEVICE_IFINDEX,
+	                                                    NM_IP_ROUTE_TABLE_SYNC_MODE_MAIN);
+	g_assert (!routes_prune || routes_prune->len == 0);
+}
+
+/*****************************************************************************/
+
+static NMIP4Config *
+_ip4_config_new (guint n, guint offset)
+{
+	NMIP4Config *config;
+	guint i;
+
+	config = nm_ip4_config_new (nm_platform_get_multi_idx (NM_PLATFORM_GET), DEVICE_IFINDEX);
+	for (i = 0; i < n; i++) {
+		const NMPlatformIP4Address a = {
+			.ifindex      = DEVICE_IFINDEX,
+			.address      = htonl (0x0b000000u + offset + i),
+			.peer_address = htonl (0x0b000000u + offset + i),
+			.plen         = 16,
+			.addr_source  = NM_IP_CONFIG_SOURCE_USER,
+		};
+		NMPlatformIP4Route r;
+
+		nm_ip4_config_add_address (config, &a);
+
+		_ip4_route_init (&r, DEVICE_IFINDEX, offset + i, 100);
+		nm_ip4_config_add_route (config, &r, NULL);
+	}
+	return config;
+}
+
+static void
+bench_ip4_config (void)
+{
+	const guint n = nmtst_bench_n (10000, 1000);
+	gs_unref_object NMIP4Config *config_a = NULL;
+	gs_unref_object NMIP4Config *config_b = NULL;
+	gs_unref_object NMIP4Config *config_dst = NULL;
+	gint64 start;
+
+	/* @config_b overlaps with half of @config_a. */
+	config_a = _ip4_config_new (n, 0);
+	config_b = _ip4_config_new (n, n / 2);
+
+	config_dst = nm_ip4_config_new (nm_platform_get_multi_idx (NM_PLATFORM_GET), DEVICE_IFINDEX);
+	start = nmtst_bench_now ();
+	nm_ip4_config_merge (config_dst, config_a, NM_IP_CONFIG_MERGE_DEFAULT, 0);
+	nm_ip4_config_merge (config_dst, config_b, NM_IP_CONFIG_MERGE_DEFAULT, 0);
+	nmtst_bench_report ("ip4-config-merge", BENCH_PLATFORM, 2 * n, start);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (config_dst), ==, n + n / 2);
+
+	start = nmtst_bench_now ();
+	nm_ip4_config_intersect (config_dst, config_a, TRUE, TRUE, 0);
+	nmtst_bench_report ("ip4-config-intersect", BENCH_PLATFORM, n, start);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (config_dst), ==, n);
+
+	start = nmtst_bench_now ();
+	nm_ip4_config_subtract (config_dst, config_b, 0);
+	nmtst_bench_report ("ip4-config-subtract", BENCH_PLATFORM, n, start);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (config_dst), ==, n / 2);
+}
+
+/*****************************************************************************/
+
+static void
+bench_links (void)
+{
+	const guint n = nmtst_bench_n (1000, 100);
+	gs_free int *ifindexes = NULL;
+	gint64 start;
+	guint i;
+
+	/* This approximates the platform work of activating many devices: for
+	 * each dummy link, bring it up, configure an address and sync a route. */
+
+	ifindexes = g_new (int, n);
+
+	start = nmtst_bench_now ();
+	for (i = 0; i < n; i++) {
+		char name[IFNAMSIZ];
+		const NMPlatformLink *plink = NULL;
+		gs_unref_ptrarray GPtrArray *routes = NULL;
+		gs_unref_ptrarray GPtrArray *routes_prune = NULL;
+
+		nm_sprintf_buf (name, "nm-bench-%u", i);
+		g_assert (NMTST_NM_ERR_SUCCESS (nm_platform_link_dummy_add (NM_PLATFORM_GET, name, &plink)));
+		g_assert (plink);
+		ifindexes[i] = plink->ifindex;
+
+		g_assert (nm_platform_link_set_up (NM_PLATFORM_GET, ifindexes[i], NULL));
+		g_assert (nm_platform_ip4_address_add (NM_PLATFORM_GET,
+		                                       ifindexes[i],
+		                                       htonl (0x0c000000u + (i << 8) + 1),
+		                                       24,
+		                                       htonl (0x0c000000u + (i << 8) + 1),
+		                                       0,
+		                                       NM_PLATFORM_LIFETIME_PERMANENT,
+		                                       NM_PLATFORM_LIFETIME_PERMANENT,
+		                                       0,
+		                                       NULL));
+
+		routes = _ip4_routes_new (ifindexes[i], 1, 0x00100000u + i, 100);
+		routes_prune = nm_platform_ip_route_get_prune_list (NM_PLATFORM_GET,
+		                                                    AF_INET,
+		                                                    ifindexes[i],
+		                                                    NM_IP_ROUTE_TABLE_SYNC_MODE_MAIN);
+		g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET,
+		                                     AF_INET,
+		                                     ifindexes[i],
+		                                     routes,
+		                                     routes_prune,
+		                                     NULL));
+	}
+	nmtst_bench_report ("link-add-configure", BENCH_PLATFORM, n, start);
+
+	start = nmtst_bench_now ();
+	for (i = 0; i < n; i++)
+		g_assert (nm_platform_link_delete (NM_PLATFORM_GET, ifindexes[i]));
+	nmtst_bench_report ("link-delete", BENCH_PLATFORM, n, start);
+}
+
+/*****************************************************************************/
+
+NMTstpSetupFunc const _nmtstp_setup_platform_func = SETUP;
+
+void
+_nmtstp_init_tests (int *argc, char ***argv)
+{
+	/* logging would dominate the measurements. */
+	nmtst_init_with_logging (argc, argv, "WARN", "ALL");
+}
+
+void
+_nmtstp_setup_tests (void)
+{
+	if (!nmtstp_is_root_test ()) {
+		/* the cache benchmark does not depend on the platform implementation. */
+		g_test_add_func ("/bench/cache/routes", bench_cache_routes);
+	}
+	nmtstp_env1_add_test_func ("/bench/route-sync", bench_route_sync, TRUE);
+	nmtstp_env1_add_test_func ("/bench/ip4-config", bench_ip4_config, TRUE);
+	g_test_add_func ("/bench/links", bench_links);
+}
@@ -9,6 +9,7 @@
 
 #include "platform/nm-platform-utils.h"
 #include "platform/nm-linux-platform.h"
+#include "platform/nmp-object.h"
 
 #include "nm-test-utils-core.h"
 
@@ -62,6 +63,130 @@ test_nm_platform_link_flags2str (void)
 
 /*****************************************************************************/
 
+static guint
+_wireguard_count_nlmsgs (const NMPWireGuardPeer *peers,
+                         const NMPlatformWireGuardChangePeerFlags *peer_flags,
+                         guint peers_len,
+                         NMPlatformWireGuardChangeFlags change_flags)
+{
+	gs_unref_ptrarray GPtrArray *msgs = NULL;
+	NMPlatformLnkWireGuard lnk_wireguard = {
+		.listen_port = 50754,
+		.fwmark = 0x1102,
+	};
+	int r;
+
+	r = _nm_linux_platform_wireguard_create_change_nlmsgs (7,
+	                                                       0x20,
+	                                                       &lnk_wireguard,
+	                                                       peers,
+	                                                       peer_flags,
+	                                                       peers_len,
+	                                                       change_flags,
+	                                                       &msgs);
+	g_assert_cmpint (r, ==, 0);
+	g_assert (msgs);
+	g_assert_cmpint (msgs->len, >, 0);
+	return msgs->len;
+}
+
+static void
+test_wireguard_change_nlmsgs (void)
+{
+	const guint N_PEERS = 500;
+	const guint N_ALLOWED_IPS = 8;
+	gs_free NMPWireGuardPeer *peers = NULL;
+	gs_free NMPWireGuardAllowedIP *allowed_ips = NULL;
+	gs_free NMPlatformWireGuardChangePeerFlags *peer_flags = NULL;
+	guint n_full;
+	guint n;
+	guint i, j;
+
+	peers = g_new0 (NMPWireGuardPeer, N_PEERS);
+	allowed_ips = g_new0 (NMPWireGuardAllowedIP, N_PEERS * N_ALLOWED_IPS);
+	peer_flags = g_new0 (NMPlatformWireGuardChangePeerFlags, N_PEERS);
+
+	for (i = 0; i < N_PEERS; i++) {
+		NMPWireGuardPeer *peer = &peers[i];
+
+		memset (peer->public_key, 0, sizeof (peer->public_key));
+		peer->public_key[0] = i & 0xFF;
+		peer->public_key[1] = i >> 8;
+		peer->persistent_keepalive_interval = 25;
+		peer->endpoint.in = (struct sockaddr_in) {
+			.sin_family      = AF_INET,
+			.sin_addr.s_addr = htonl (0xc0a80000u + i),
+			.sin_port        = htons (51820),
+		};
+		for (j = 0; j < N_ALLOWED_IPS; j++) {
+			NMPWireGuardAllowedIP *aip = &allowed_ips[i * N_ALLOWED_IPS + j];
+
+			aip->family = AF_INET;
+			aip->addr.addr4 = htonl (0x0a000000u + (i << 8) + j);
+			aip->mask = 32;
+		}
+		peer->allowed_ips = &allowed_ips[i * N_ALLOWED_IPS];
+		peer->allowed_ips_len = N_ALLOWED_IPS;
+	}
+
+	/* replace all peers. That doesn't fit into one message. */
+	n_full = _wireguard_count_nlmsgs (peers,
+	                                  NULL,
+	                                  N_PEERS,
+	                                    NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_PRIVATE_KEY
+	                                  | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_LISTEN_PORT
+	                                  | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK
+	                                  | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_REPLACE_PEERS);
+	g_assert_cmpint (n_full, >, 10);
+
+	/* nothing changed. Only the device attributes are sent. */
+	for (i = 0; i < N_PEERS; i++)
+		peer_flags[i] = NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_NONE;
+	n = _wireguard_count_nlmsgs (peers,
+	                             peer_flags,
+	                             N_PEERS,
+	                               NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_LISTEN_PORT
+	                             | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK);
+	g_assert_cmpint (n, ==, 1);
+
+	/* one peer changed and one was removed. */
+	peer_flags[17] =   NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_DEFAULT
+	                 | NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REPLACE_ALLOWEDIPS;
+	peer_flags[N_PEERS - 1] = NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REMOVE_ME;
+	n = _wireguard_count_nlmsgs (peers,
+	                             peer_flags,
+	                             N_PEERS,
+	                               NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_LISTEN_PORT
+	                             | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK);
+	g_assert_cmpint (n, ==, 1);
+
+	/* update the endpoints of all peers. That needs fewer messages than
+	 * a full replace, because the allowed-ips are not sent. */
+	for (i = 0; i < N_PEERS; i++) {
+		peer_flags[i] =   NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_ENDPOINT
+		                | NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_UPDATE_ONLY;
+	}
+	n = _wireguard_count_nlmsgs (peers,
+	                             peer_flags,
+	                             N_PEERS,
+	                             NM_PLATFORM_WIREGUARD_CHANGE_FLAG_NONE);
+	g_assert_cmpint (n, >, 1);
+	g_assert_cmpint (n, <, n_full);
+
+	/* peers whose endpoint is not resolved yet only have UPDATE_ONLY set.
+	 * They are skipped like peers without flags. */
+	for (i = 0; i < N_PEERS; i++)
+		peer_flags[i] = NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_UPDATE_ONLY;
+	peer_flags[3] |= NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_ENDPOINT;
+	n = _wireguard_count_nlmsgs (peers,
+	                             peer_flags,
+	                             N_PEERS,
+	                             NM_PLATFORM_WIREGUARD_CHANGE_FLAG_NONE);
+	g_assert_cmpint (n, ==, 1);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -72,6 +197,7 @@ main (int argc, char **argv)
 	g_test_add_func ("/general/init_linux_platform", test_init_linux_platform);
 	g_test_add_func ("/general/link_get_all", test_link_get_all);
 	g_test_add_func ("/general/nm_platform_link_flags2str", test_nm_platform_link_flags2str);
+	g_test_add_func ("/general/wireguard_change_nlmsgs", test_wireguard_change_nlmsgs);
 
 	return g_test_run ();
 }
@@ -65,7 +65,7 @@ NM_DEFINE_SINGLETON_GETTER (NMAgentManager, nm_agent_manager_get, NM_TYPE_AGENT_
 #define _NMLOG_DOMAIN         LOGD_AGENTS
 #define _NMLOG(level, agent, ...) \
     G_STMT_START { \
-        if (nm_logging_enabled ((level), (_NMLOG_DOMAIN))) { \
+        if (nm_log_enabled ((level), (_NMLOG_DOMAIN))) { \
             char __prefix1[32]; \
             char __prefix2[128]; \
             NMSecretAgent *__agent = (agent); \
@@ -63,7 +63,7 @@ G_DEFINE_TYPE (NMSecretAgent, nm_secret_agent, G_TYPE_OBJECT)
 #define _NMLOG_DOMAIN         LOGD_AGENTS
 #define _NMLOG(level, ...) \
     G_STMT_START { \
-        if (nm_logging_enabled ((level), (_NMLOG_DOMAIN))) { \
+        if (nm_log_enabled ((level), (_NMLOG_DOMAIN))) { \
             char _prefix[64]; \
             \
             if ((self)) { \
@@ -211,6 +211,7 @@ static NMConnection *
 _read_from_file (const char *full_filename,
                  const char *plugin_dir,
                  struct stat *out_stat,
+                 guint64 *out_content_hash,
                  NMTernary *out_is_nm_generated,
                  NMTernary *out_is_volatile,
                  NMTernary *out_is_external,
@@ -225,6 +226,7 @@ _read_from_file (const char *full_filename,
 	connection = nms_keyfile_reader_from_file (full_filename,
 	                                           plugin_dir,
 	                                           out_stat,
+	                                           out_content_hash,
 	                                           out_is_nm_generated,
 	                                           out_is_volatile,
 	                                           out_is_external,
@@ -288,6 +290,84 @@ _nm_assert_storage (gpointer plugin  /* NMSKeyfilePlugin  */,
 
 /*****************************************************************************/
 
+static void
+_fingerprint_init (NMSKeyfileStorageFingerprint *fingerprint,
+                   const struct stat *st,
+                   guint64 content_hash)
+{
+	*fingerprint = (NMSKeyfileStorageFingerprint) {
+		.st_mtim      = st->st_mtim,
+		.st_ctim      = st->st_ctim,
+		.st_dev       = st->st_dev,
+		.st_ino       = st->st_ino,
+		.st_size      = st->st_size,
+		.content_hash = content_hash,
+		.valid        = TRUE,
+	};
+}
+
+static NMSKeyfileStorage *
+_fingerprint_lookup_unchanged (NMSKeyfilePlugin *self,
+                               const char *dirname,
+                               const char *filename)
+{
+	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
+	const NMSKeyfileStorageFingerprint *fingerprint;
+	gs_free char *full_filename = NULL;
+	gs_free char *contents = NULL;
+	NMSKeyfileStorage *storage;
+	gsize contents_len;
+	guint64 content_hash;
+	struct stat st;
+
+	full_filename = g_build_filename (dirname, filename, NULL);
+
+	storage = nm_sett_util_storages_lookup_by_filename (&priv->storages, full_filename);
+	if (   !storage
+	    || storage->is_meta_data
+	    || !storage->u.conn_data.fingerprint.valid)
+		return NULL;
+
+	fingerprint = &storage->u.conn_data.fingerprint;
+
+	/* the reader also uses stat(), not lstat(). */
+	if (stat (full_filename, &st) != 0)
+		return NULL;
+
+	if (   st.st_dev != fingerprint->st_dev
+	    || st.st_ino != fingerprint->st_ino
+	    || st.st_size != fingerprint->st_size
+	    || st.st_mtim.tv_sec != fingerprint->st_mtim.tv_sec
+	    || st.st_mtim.tv_nsec != fingerprint->st_mtim.tv_nsec
+	    || st.st_ctim.tv_sec != fingerprint->st_ctim.tv_sec
+	    || st.st_ctim.tv_nsec != fingerprint->st_ctim.tv_nsec)
+		return NULL;
+
+	/* The timestamps might have a coarse granularity, so a modification
+	 * right after we read the file might not be visible in stat. Also compare
+	 * the content. Reading and hashing the file is still much cheaper than
+	 * parsing it. */
+	if (!nm_utils_file_get_contents (-1,
+	                                 full_filename,
+	                                 G_MAXSIZE,
+	                                 NM_UTILS_FILE_GET_CONTENTS_FLAG_SECRET,
+	                                 &contents,
+	                                 &contents_len,
+	                                 NULL,
+	                                 NULL))
+		return NULL;
+
+	content_hash = nm_hash_siphash42 (NMS_KEYFILE_CONTENT_HASH_SEED, contents, contents_len);
+	nm_explicit_bzero (contents, contents_len);
+
+	if (content_hash != fingerprint->content_hash)
+		return NULL;
+
+	return storage;
+}
+
+/*****************************************************************************/
+
 static NMSKeyfileStorage *
 _load_file (NMSKeyfilePlugin *self,
             const char *dirname,
@@ -304,6 +384,8 @@ _load_file (NMSKeyfilePlugin *self,
 	gs_free char *shadowed_storage = NULL;
 	gs_free_error GError *local = NULL;
 	gs_free char *full_filename = NULL;
+	NMSKeyfileStorage *storage;
+	guint64 content_hash;
 	struct stat st;
 
 	if (_ignore_filename (storage_type, filename)) {
@@ -362,6 +444,7 @@ _load_file (NMSKeyfilePlugin *self,
 	connection = _read_from_file (full_filename,
 	                              _get_plugin_dir (priv),
 	                              &st,
+	                              &content_hash,
 	                              &is_nm_generated_opt,
 	                              &is_volatile_opt,
 	                              &is_external_opt,
@@ -376,16 +459,18 @@ _load_file (NMSKeyfilePlugin *self,
 		return NULL;
 	}
 
-	return nms_keyfile_storage_new_connection (self,
-	                                           g_steal_pointer (&connection),
-	                                           full_filename,
-	                                           storage_type,
-	                                           is_nm_generated_opt,
-	                                           is_volatile_opt,
-	                                           is_external_opt,
-	                                           shadowed_storage,
-	                                           shadowed_owned_opt,
-	                                           &st.st_mtim);
+	storage = nms_keyfile_storage_new_connection (self,
+	                                              g_steal_pointer (&connection),
+	                                              full_filename,
+	                                              storage_type,
+	                                              is_nm_generated_opt,
+	                                              is_volatile_opt,
+	                                              is_external_opt,
+	                                              shadowed_storage,
+	                                              shadowed_owned_opt,
+	                                              &st.st_mtim);
+	_fingerprint_init (&storage->u.conn_data.fingerprint, &st, content_hash);
+	return storage;
 }
 
 static NMSKeyfileStorage *
@@ -414,7 +499,8 @@ static void
 _load_dir (NMSKeyfilePlugin *self,
            NMSKeyfileStorageType storage_type,
            const char *dirname,
-           NMSettUtilStorages *storages)
+           NMSettUtilStorages *storages,
+           GHashTable *storages_unchanged)
 {
 	const char *filename;
 	GDir *dir;
@@ -433,6 +519,16 @@ _load_dir (NMSKeyfilePlugin *self,
 		if (!g_hash_table_add (dupl_filenames, (char *) filename))
 			continue;
 
+		if (storages_unchanged) {
+			NMSKeyfileStorage *storage_old;
+
+			storage_old = _fingerprint_lookup_unchanged (self, dirname, filename);
+			if (storage_old) {
+				g_hash_table_add (storages_unchanged, storage_old);
+				continue;
+			}
+		}
+
 		storage = _load_file (self,
 		                      dirname,
 		                      filename,
@@ -463,6 +559,7 @@ _storages_consolidate (NMSKeyfilePlugin *self,
                        NMSettUtilStorages *storages_new,
                        gboolean replace_all,
                        GHashTable *storages_replaced,
+                       GHashTable *storages_unchanged,
                        NMSettingsPluginConnectionLoadCallback callback,
                        gpointer user_data)
 {
@@ -479,8 +576,12 @@ _storages_consolidate (NMSKeyfilePlugin *self,
 	storages_modified = g_ptr_array_new_with_free_func (g_object_unref);
 	c_list_init (&storages_deleted);
 
-	c_list_for_each_entry (storage_old, &priv->storages._storage_lst_head, parent._storage_lst)
-		storage_old->is_dirty = TRUE;
+	c_list_for_each_entry (storage_old, &priv->storages._storage_lst_head, parent._storage_lst) {
+		/* storages that were not re-read because their file is unchanged are
+		 * kept as they are, and we don't notify about them. */
+		storage_old->is_dirty =    !storages_unchanged
+		                        || !g_hash_table_contains (storages_unchanged, storage_old);
+	}
 
 	c_list_for_each_entry_safe (storage_new, storage_safe, &storages_new->_storage_lst_head, parent._storage_lst) {
 		storage_old = nm_sett_util_storages_lookup_by_filename (&priv->storages, nms_keyfile_storage_get_filename (storage_new));
@@ -570,18 +671,32 @@ reload_connections (NMSettingsPlugin *plugin,
 	NMSKeyfilePlugin *self = NMS_KEYFILE_PLUGIN (plugin);
 	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
 	nm_auto_clear_sett_util_storages NMSettUtilStorages storages_new = NM_SETT_UTIL_STORAGES_INIT (storages_new, nms_keyfile_storage_destroy);
+	gs_unref_hashtable GHashTable *storages_unchanged = NULL;
 	int i;
 
-	_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_RUN, priv->dirname_run, &storages_new);
+	if (nm_config_data_get_value_boolean (nm_config_get_data (priv->config),
+	                                      NM_CONFIG_KEYFILE_GROUP_KEYFILE,
+	                                      NM_CONFIG_KEYFILE_KEY_KEYFILE_INCREMENTAL_RELOAD,
+	                                      FALSE))
+		storages_unchanged = g_hash_table_new (nm_direct_hash, NULL);
+
+	_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_RUN, priv->dirname_run, &storages_new, storages_unchanged);
 	if (priv->dirname_etc)
-		_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_ETC, priv->dirname_etc, &storages_new);
+		_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_ETC, priv->dirname_etc, &storages_new, storages_unchanged);
 	for (i = 0; priv->dirname_libs[i]; i++)
-		_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_LIB (i), priv->dirname_libs[i], &storages_new);
+		_load_dir (self, NMS_KEYFILE_STORAGE_TYPE_LIB (i), priv->dirname_libs[i], &storages_new, storages_unchanged);
+
+	if (storages_unchanged) {
+		_LOGD ("reload: %u profiles unchanged, %u profiles re-read",
+		       g_hash_table_size (storages_unchanged),
+		       (guint) c_list_length (&storages_new._storage_lst_head));
+	}
 
 	_storages_consolidate (self,
 	                       &storages_new,
 	                       TRUE,
 	                       NULL,
+	                       storages_unchanged,
 	                       callback,
 	                       user_data);
 }
@@ -738,6 +853,7 @@ load_connections (NMSettingsPlugin *plugin,
 	                       &storages_new,
 	                       FALSE,
 	                       storages_replaced,
+	                       NULL,
 	                       callback,
 	                       user_data);
 }
@@ -965,6 +1081,7 @@ nms_keyfile_plugin_update_connection (NMSKeyfilePlugin *self,
 	storage->u.conn_data.is_external     = is_external;
 	storage->u.conn_data.stat_mtime      = *nm_sett_util_stat_mtime (full_filename, FALSE, &mtime);
 	storage->u.conn_data.shadowed_owned  = shadowed_owned;
+	storage->u.conn_data.fingerprint     = (NMSKeyfileStorageFingerprint) { };
 
 	*out_storage = g_object_ref (NM_SETTINGS_STORAGE (storage));
 	*out_connection = g_steal_pointer (&reread);
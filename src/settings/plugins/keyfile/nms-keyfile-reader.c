@@ -9,6 +9,7 @@
 
 #include <sys/stat.h>
 
+#include "nm-glib-aux/nm-io-utils.h"
 #include "nm-keyfile/nm-keyfile-internal.h"
 
 #include "NetworkManagerUtils.h"
@@ -150,10 +151,43 @@ nms_keyfile_reader_from_keyfile (GKeyFile *key_file,
 	return connection;
 }
 
+static gboolean
+_key_file_load (GKeyFile *key_file,
+                const char *full_filename,
+                guint64 *out_content_hash,
+                GError **error)
+{
+	gs_free char *contents = NULL;
+	gsize contents_len;
+	gboolean success;
+
+	if (!out_content_hash)
+		return g_key_file_load_from_file (key_file, full_filename, G_KEY_FILE_NONE, error);
+
+	/* Read the file ourself, so that the hash is of exactly the content
+	 * that we parse. */
+	if (!nm_utils_file_get_contents (-1,
+	                                 full_filename,
+	                                 G_MAXSIZE,
+	                                 NM_UTILS_FILE_GET_CONTENTS_FLAG_SECRET,
+	                                 &contents,
+	                                 &contents_len,
+	                                 NULL,
+	                                 error))
+		return FALSE;
+
+	*out_content_hash = nm_hash_siphash42 (NMS_KEYFILE_CONTENT_HASH_SEED, contents, contents_len);
+
+	success = g_key_file_load_from_data (key_file, contents, contents_len, G_KEY_FILE_NONE, error);
+	nm_explicit_bzero (contents, contents_len);
+	return success;
+}
+
 NMConnection *
 nms_keyfile_reader_from_file (const char *full_filename,
                               const char *profile_dir,
                               struct stat *out_stat,
+                              guint64 *out_content_hash,
                               NMTernary *out_is_nm_generated,
                               NMTernary *out_is_volatile,
                               NMTernary *out_is_external,
@@ -179,7 +213,7 @@ nms_keyfile_reader_from_file (const char *full_filename,
 		return NULL;
 
 	key_file = g_key_file_new ();
-	if (!g_key_file_load_from_file (key_file, full_filename, G_KEY_FILE_NONE, error))
+	if (!_key_file_load (key_file, full_filename, out_content_hash, error))
 		return NULL;
 
 	connection = nms_keyfile_reader_from_keyfile (key_file, full_filename, NULL, profile_dir, TRUE, error);
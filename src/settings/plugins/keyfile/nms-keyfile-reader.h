@@ -18,9 +18,14 @@ NMConnection *nms_keyfile_reader_from_keyfile (GKeyFile *key_file,
 
 struct stat;
 
+/* the seed for the hash of the file content, that the plugin keeps to
+ * detect unchanged files on reload. */
+#define NMS_KEYFILE_CONTENT_HASH_SEED 1490270651u
+
 NMConnection *nms_keyfile_reader_from_file (const char *full_filename,
                                             const char *profile_dir,
                                             struct stat *out_stat,
+                                            guint64 *out_content_hash,
                                             NMTernary *out_is_nm_generated,
                                             NMTernary *out_is_volatile,
                                             NMTernary *out_is_external,
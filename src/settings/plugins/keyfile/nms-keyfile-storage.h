@@ -25,6 +25,18 @@ typedef struct {
 	bool is_tombstone:1;
 } NMSettingsMetaData;
 
+typedef struct {
+	/* identifies the content of a keyfile on disk at the time we read it. On
+	 * reload, a file whose fingerprint is unchanged need not be parsed again. */
+	struct timespec st_mtim;
+	struct timespec st_ctim;
+	dev_t st_dev;
+	ino_t st_ino;
+	off_t st_size;
+	guint64 content_hash;
+	bool valid:1;
+} NMSKeyfileStorageFingerprint;
+
 typedef struct {
 	NMSettingsStorage parent;
 
@@ -56,6 +68,11 @@ typedef struct {
 			 * multiple files with the same UUID, then the newer file gets preferred. */
 			struct timespec stat_mtime;
 
+			/* the fingerprint of the file when we last read it. It is only valid
+			 * if the file was read from disk, and is cleared when we write the file
+			 * ourself. */
+			NMSKeyfileStorageFingerprint fingerprint;
+
 			/* these flags are only relevant for storages with %NMS_KEYFILE_STORAGE_TYPE_RUN
 			 * (and non-metadata). This is to persist and reload these settings flags to
 			 * /run.
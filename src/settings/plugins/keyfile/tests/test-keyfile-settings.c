@@ -8,6 +8,8 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <sys/socket.h>
@@ -15,6 +17,8 @@
 
 #include "nm-core-internal.h"
 
+#include "nm-config.h"
+#include "settings/plugins/keyfile/nms-keyfile-plugin.h"
 #include "settings/plugins/keyfile/nms-keyfile-reader.h"
 #include "settings/plugins/keyfile/nms-keyfile-writer.h"
 #include "settings/plugins/keyfile/nms-keyfile-utils.h"
@@ -64,6 +68,7 @@ check_ip_route (NMSettingIPConfig *config, int idx, const char *destination, int
 	                                            NULL, \
 	                                            NULL, \
 	                                            NULL, \
+	                                            NULL, \
 	                                            (nmtst_get_rand_uint32 () % 2) ? &_error : NULL); \
 	nmtst_assert_success (_connection, _error); \
 	nmtst_assert_connection_verifies_without_normalization (_connection); \
@@ -2607,6 +2612,166 @@ test_nmmeta (void)
 
 /*****************************************************************************/
 
+#define TEST_INCREMENTAL_RELOAD_DIR TEST_SCRATCH_DIR"/incremental-reload"
+
+static void
+_incremental_reload_write (const char *filename, const char *id, const char *uuid)
+{
+	gs_free char *full_filename = g_build_filename (TEST_INCREMENTAL_RELOAD_DIR, filename, NULL);
+	gs_free char *contents = NULL;
+	FILE *f;
+
+	contents = g_strdup_printf ("[connection]\n"
+	                            "id=%s\n"
+	                            "uuid=%s\n"
+	                            "type=ethernet\n",
+	                            id,
+	                            uuid);
+
+	/* write the file in place, to keep the inode. */
+	f = fopen (full_filename, "we");
+	g_assert (f);
+	fputs (contents, f);
+	g_assert_cmpint (fclose (f), ==, 0);
+	g_assert_cmpint (chmod (full_filename, 0600), ==, 0);
+}
+
+static void
+_incremental_reload_cb (NMSettingsPlugin *plugin,
+                        NMSettingsStorage *storage,
+                        NMConnection *connection,
+                        gpointer user_data)
+{
+	GPtrArray *events = user_data;
+	const char *filename;
+
+	/* the plugin also reads the profiles from /run and /usr/lib. Ignore them. */
+	filename = nm_settings_storage_get_filename (storage);
+	if (!g_str_has_prefix (filename, TEST_INCREMENTAL_RELOAD_DIR"/"))
+		return;
+
+	filename = &filename[NM_STRLEN (TEST_INCREMENTAL_RELOAD_DIR"/")];
+	if (connection)
+		g_ptr_array_add (events, g_strdup_printf ("+%s:%s", filename, nm_connection_get_id (connection)));
+	else
+		g_ptr_array_add (events, g_strdup_printf ("-%s", filename));
+}
+
+static char *
+_incremental_reload (NMSKeyfilePlugin *plugin)
+{
+	gs_unref_ptrarray GPtrArray *events = g_ptr_array_new_with_free_func (g_free);
+
+	nm_settings_plugin_reload_connections (NM_SETTINGS_PLUGIN (plugin),
+	                                       _incremental_reload_cb,
+	                                       events);
+	g_ptr_array_sort (events, nm_strcmp_p);
+	g_ptr_array_add (events, NULL);
+	return g_strjoinv (" ", (char **) events->pdata);
+}
+
+static void
+_incremental_reload_setup_config (void)
+{
+	gs_free char *config_file = g_build_filename (TEST_INCREMENTAL_RELOAD_DIR, "NetworkManager.conf", NULL);
+	gs_free char *config_dir = g_build_filename (TEST_INCREMENTAL_RELOAD_DIR, "conf.d", NULL);
+	gs_free char *no_auto_default_file = g_build_filename (TEST_INCREMENTAL_RELOAD_DIR, "no-auto-default.state", NULL);
+	gs_free char *contents = NULL;
+	gs_free_error GError *error = NULL;
+	NMConfigCmdLineOptions *cli;
+	GOptionContext *context;
+	const char *args[] = {
+		"test-keyfile-settings",
+		"--config",            config_file,
+		"--config-dir",        config_dir,
+		"--system-config-dir", config_dir,
+		"--intern-config",     "",
+		"--state-file",        "",
+		"--no-auto-default",   no_auto_default_file,
+	};
+	char **argv = (char **) args;
+	int argc = G_N_ELEMENTS (args);
+	NMConfig *config;
+
+	g_assert_cmpint (g_mkdir_with_parents (config_dir, 0755), ==, 0);
+
+	contents = g_strdup_printf ("[keyfile]\n"
+	                            "path=%s\n"
+	                            "incremental-reload=true\n",
+	                            TEST_INCREMENTAL_RELOAD_DIR);
+	nmtst_file_set_contents (config_file, contents);
+
+	cli = nm_config_cmd_line_options_new (FALSE);
+	context = g_option_context_new (NULL);
+	nm_config_cmd_line_options_add_to_entries (cli, context);
+	g_assert (g_option_context_parse (context, &argc, &argv, NULL));
+	g_option_context_free (context);
+
+	config = nm_config_setup (cli, NULL, &error);
+	nmtst_assert_success (config, error);
+	nm_config_cmd_line_options_free (cli);
+}
+
+static void
+test_incremental_reload (void)
+{
+	gs_unref_object NMSKeyfilePlugin *plugin = NULL;
+	gs_free char *full_filename_b = g_build_filename (TEST_INCREMENTAL_RELOAD_DIR, "b.nmconnection", NULL);
+	gs_free char *full_filename_c = g_build_filename (TEST_INCREMENTAL_RELOAD_DIR, "c.nmconnection", NULL);
+	struct timespec times[2];
+	struct stat st;
+	char *events;
+
+	g_assert_cmpint (g_mkdir_with_parents (TEST_INCREMENTAL_RELOAD_DIR, 0755), ==, 0);
+	_incremental_reload_write ("a.nmconnection", "test-a1", "60a36b1a-8fb1-4c45-a4b5-9a0bdc3d5e1e");
+	_incremental_reload_write ("b.nmconnection", "test-b1", "5d3c6cc1-4c16-4de5-bbba-6af7d9d1a8d5");
+	_incremental_reload_write ("c.nmconnection", "test-c1", "e3f3f9c2-3f7b-4ac8-a2a4-1c7a6ab2c4d9");
+
+	_incremental_reload_setup_config ();
+
+	plugin = nms_keyfile_plugin_new ();
+
+	/* the first reload reads all files. */
+	events = _incremental_reload (plugin);
+	g_assert_cmpstr (events, ==, "+a.nmconnection:test-a1 +b.nmconnection:test-b1 +c.nmconnection:test-c1");
+	g_free (events);
+
+	/* nothing changed. No events. */
+	events = _incremental_reload (plugin);
+	g_assert_cmpstr (events, ==, "");
+	g_free (events);
+
+	/* modify "b" in place, with the same size and the same mtime. */
+	g_assert_cmpint (stat (full_filename_b, &st), ==, 0);
+	_incremental_reload_write ("b.nmconnection", "test-b2", "5d3c6cc1-4c16-4de5-bbba-6af7d9d1a8d5");
+	times[0] = st.st_atim;
+	times[1] = st.st_mtim;
+	g_assert_cmpint (utimensat (AT_FDCWD, full_filename_b, times, 0), ==, 0);
+
+	events = _incremental_reload (plugin);
+	g_assert_cmpstr (events, ==, "+b.nmconnection:test-b2");
+	g_free (events);
+
+	/* remove "c". */
+	g_assert_cmpint (unlink (full_filename_c), ==, 0);
+
+	events = _incremental_reload (plugin);
+	g_assert_cmpstr (events, ==, "-c.nmconnection");
+	g_free (events);
+
+	events = _incremental_reload (plugin);
+	g_assert_cmpstr (events, ==, "");
+	g_free (events);
+
+	(void) unlink (TEST_INCREMENTAL_RELOAD_DIR"/a.nmconnection");
+	(void) unlink (full_filename_b);
+	(void) unlink (TEST_INCREMENTAL_RELOAD_DIR"/NetworkManager.conf");
+	(void) rmdir (TEST_INCREMENTAL_RELOAD_DIR"/conf.d");
+	(void) rmdir (TEST_INCREMENTAL_RELOAD_DIR);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int main (int argc, char **argv)
@@ -2696,5 +2861,7 @@ int main (int argc, char **argv)
 
 	g_test_add_func ("/keyfile/test_nmmeta", test_nmmeta);
 
+	g_test_add_func ("/keyfile/test_incremental_reload", test_incremental_reload);
+
 	return g_test_run ();
 }
@@ -758,38 +758,53 @@ _bss_info_properties_changed (NMSupplicantInterface *self,
 	_bss_info_changed_emit (self, bss_info, TRUE);
 }
 
+static void
+_bss_info_init_complete (NMSupplicantInterface *self,
+                         NMSupplicantBssInfo *bss_info,
+                         GVariant *properties)
+{
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+
+	nm_clear_g_cancellable (&bss_info->_init_cancellable);
+	nm_c_list_move_tail (&priv->bss_lst_head, &bss_info->_bss_lst);
+
+	_bss_info_properties_changed (self, bss_info, properties, TRUE);
+
+	_starting_check_ready (self);
+
+	_notify_maybe_scanning (self);
+}
+
 static void
 _bss_info_get_all_cb (GVariant *result,
                       GError *error,
                       gpointer user_data)
 {
 	NMSupplicantBssInfo *bss_info;
-	NMSupplicantInterface *self;
-	NMSupplicantInterfacePrivate *priv;
 	gs_unref_variant GVariant *properties = NULL;
 
 	if (nm_utils_error_is_cancelled (error))
 		return;
 
 	bss_info = user_data;
-	self = bss_info->_self;
-	priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 
 	g_clear_object (&bss_info->_init_cancellable);
-	nm_c_list_move_tail (&priv->bss_lst_head, &bss_info->_bss_lst);
 
 	if (result)
 		g_variant_get (result, "(@a{sv})", &properties);
 
-	_bss_info_properties_changed (self, bss_info, properties, TRUE);
-
-	_starting_check_ready (self);
-
-	_notify_maybe_scanning (self);
+	_bss_info_init_complete (bss_info->_self, bss_info, properties);
 }
 
+/* If @properties are given (as by the BSSAdded signal, which carries all
+ * properties of the BSS), the BSS is initialized right away. Otherwise, its
+ * properties are fetched with a GetAll call. In a dense environment, most
+ * BSSs get announced via the signal, which saves a D-Bus roundtrip for each
+ * of them. */
 static void
-_bss_info_add (NMSupplicantInterface *self, const char *object_path)
+_bss_info_add (NMSupplicantInterface *self,
+               const char *object_path,
+               GVariant *properties)
 {
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 	nm_auto_ref_string NMRefString *bss_path = NULL;
@@ -802,6 +817,11 @@ _bss_info_add (NMSupplicantInterface *self, const char *object_path)
 	bss_info = g_hash_table_lookup (priv->bss_idx, &bss_path);
 	if (bss_info) {
 		bss_info->_bss_dirty = FALSE;
+		if (   properties
+		    && bss_info->_init_cancellable) {
+			/* the GetAll call is still pending. No need to wait for it. */
+			_bss_info_init_complete (self, bss_info, properties);
+		}
 		return;
 	}
 
@@ -809,11 +829,16 @@ _bss_info_add (NMSupplicantInterface *self, const char *object_path)
 	*bss_info = (NMSupplicantBssInfo) {
 		._self             = self,
 		.bss_path          = g_steal_pointer (&bss_path),
-		._init_cancellable = g_cancellable_new (),
+		._init_cancellable = properties ? NULL : g_cancellable_new (),
 	};
 	c_list_link_tail (&priv->bss_initializing_lst_head, &bss_info->_bss_lst);
 	g_hash_table_add (priv->bss_idx, bss_info);
 
+	if (properties) {
+		_bss_info_init_complete (self, bss_info, properties);
+		return;
+	}
+
 	nm_dbus_connection_call_get_all (priv->dbus_connection,
 	                                 priv->name_owner->str,
 	                                 bss_info->bss_path->str,
@@ -1907,7 +1932,7 @@ _properties_changed_main (NMSupplicantInterface *self,
 			bss_info->_bss_dirty = TRUE;
 
 		for (iter = v_strv; *iter; iter++)
-			_bss_info_add (self, *iter);
+			_bss_info_add (self, *iter, NULL);
 
 		g_free (v_strv);
 
@@ -2912,11 +2937,13 @@ _signal_handle (NMSupplicantInterface *self,
 			return;
 
 		if (nm_streq (signal_name, "BSSAdded")) {
+			gs_unref_variant GVariant *properties = NULL;
+
 			if (!g_variant_is_of_type (parameters, G_VARIANT_TYPE ("(oa{sv})")))
 				return;
 
-			g_variant_get (parameters, "(&oa{sv})", &path, NULL);
-			_bss_info_add (self, path);
+			g_variant_get (parameters, "(&o@a{sv})", &path, &properties);
+			_bss_info_add (self, path, properties);
 			return;
 		}
 
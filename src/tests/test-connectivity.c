@@ -0,0 +1,433 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <unistd.h>
+
+#include "nm-config.h"
+#include "nm-connectivity.h"
+
+#include "nm-test-utils-core.h"
+
+/*****************************************************************************/
+
+static char *config_dir;
+
+static void
+_setup_config (void)
+{
+	gs_free char *config_file = NULL;
+	gs_free char *config_d_dir = NULL;
+	gs_free char *no_auto_default_file = NULL;
+	gs_free_error GError *error = NULL;
+	NMConfigCmdLineOptions *cli;
+	GOptionContext *context;
+	const char *args[] = {
+		"test-connectivity",
+		"--config",            NULL,
+		"--config-dir",        NULL,
+		"--system-config-dir", NULL,
+		"--intern-config",     "",
+		"--state-file",        "",
+		"--no-auto-default",   NULL,
+	};
+	char **argv = (char **) args;
+	int argc = G_N_ELEMENTS (args);
+	NMConfig *config;
+
+	config_dir = g_dir_make_tmp ("test-connectivity-XXXXXX", &error);
+	nmtst_assert_success (config_dir, error);
+
+	config_file = g_build_filename (config_dir, "NetworkManager.conf", NULL);
+	config_d_dir = g_build_filename (config_dir, "conf.d", NULL);
+	no_auto_default_file = g_build_filename (config_dir, "no-auto-default.state", NULL);
+	args[2] = config_file;
+	args[4] = config_d_dir;
+	args[6] = config_d_dir;
+	args[12] = no_auto_default_file;
+
+	g_assert_cmpint (g_mkdir_with_parents (config_d_dir, 0755), ==, 0);
+
+	/* nothing listens on port 1, so the checks fail quickly. */
+	nmtst_file_set_contents (config_file,
+	                         "[main]\n"
+	                         "dns=none\n"
+	                         "rc-manager=unmanaged\n"
+	                         "\n"
+	                         "[connectivity]\n"
+	                         "uri=http://127.0.0.1:1/\n"
+	                         "interval=300\n");
+
+	cli = nm_config_cmd_line_options_new (FALSE);
+	context = g_option_context_new (NULL);
+	nm_config_cmd_line_options_add_to_entries (cli, context);
+	g_assert (g_option_context_parse (context, &argc, &argv, NULL));
+	g_option_context_free (context);
+
+	config = nm_config_setup (cli, NULL, &error);
+	nmtst_assert_success (config, error);
+	nm_config_cmd_line_options_free (cli);
+}
+
+static void
+_cleanup_config (void)
+{
+	gs_free char *config_file = g_build_filename (config_dir, "NetworkManager.conf", NULL);
+	gs_free char *config_d_dir = g_build_filename (config_dir, "conf.d", NULL);
+	gs_free char *no_auto_default_file = g_build_filename (config_dir, "no-auto-default.state", NULL);
+
+	(void) unlink (config_file);
+	(void) unlink (no_auto_default_file);
+	(void) rmdir (config_d_dir);
+	(void) rmdir (config_dir);
+	nm_clear_g_free (&config_dir);
+}
+
+/*****************************************************************************/
+
+static void
+test_periodic_offset (void)
+{
+	const guint interval = 300;
+	const guint range_msec = interval * 500;
+	gs_unref_object NMConnectivity *connectivity = NULL;
+	gs_unref_array GArray *offsets = NULL;
+	guint n, i;
+
+	connectivity = g_object_new (NM_TYPE_CONNECTIVITY, NULL);
+	offsets = g_array_new (FALSE, FALSE, sizeof (guint));
+
+	g_assert_cmpint (nm_connectivity_get_periodic_offset_msec (connectivity, 0), ==, 0);
+
+	for (n = 1; n <= 256; n++) {
+		gs_unref_array GArray *sorted = NULL;
+		guint offset;
+		guint gap_min = G_MAXUINT;
+		guint gap_max = 0;
+
+		offset = nm_connectivity_get_periodic_offset_msec (connectivity, interval);
+		g_assert_cmpint (offset, <, range_msec);
+		g_array_append_val (offsets, offset);
+
+		sorted = g_array_sized_new (FALSE, FALSE, sizeof (guint), n);
+		g_array_append_vals (sorted, offsets->data, n);
+		g_array_sort_with_data (sorted, nm_cmp_uint32_p_with_data, NULL);
+
+		for (i = 0; i <= n; i++) {
+			guint a = i > 0 ? g_array_index (sorted, guint, i - 1) : 0;
+			guint b = i < n ? g_array_index (sorted, guint, i) : range_msec;
+
+			gap_max = NM_MAX (gap_max, b - a);
+			if (i > 0 && i < n)
+				gap_min = NM_MIN (gap_min, b - a);
+		}
+
+		/* the offsets of any number of devices are spread evenly over the
+		 * first half of the interval. */
+		g_assert_cmpint (((guint64) gap_max) * n, <=, 2 * (guint64) range_msec);
+		if (n > 1)
+			g_assert_cmpint (((guint64) gap_min) * n * 4, >=, (guint64) range_msec);
+	}
+}
+
+/*****************************************************************************/
+
+#if WITH_CONCHECK
+
+typedef struct {
+	NMConnectivityCheckHandle *handle;
+	NMConnectivityState state;
+	gint64 latency_msec;
+	guint *n_done;
+	bool done:1;
+} CheckData;
+
+static void
+_check_cb (NMConnectivity *self,
+           NMConnectivityCheckHandle *handle,
+           NMConnectivityState state,
+           gpointer user_data)
+{
+	CheckData *data = user_data;
+	guint n_running;
+
+	g_assert (data->handle == handle);
+	g_assert (!data->done);
+
+	nmtst_connectivity_get_queue_state (self, &n_running, NULL);
+	g_assert_cmpint (n_running, <=, NM_CONNECTIVITY_MAX_RUNNING);
+
+	data->done = TRUE;
+	data->state = state;
+	data->latency_msec = nm_connectivity_check_get_latency_msec (handle);
+	(*data->n_done)++;
+}
+
+static void
+test_queue (void)
+{
+	const guint N_QUEUED = 8;
+	const guint N = NM_CONNECTIVITY_MAX_RUNNING + N_QUEUED;
+	gs_unref_object NMConnectivity *connectivity = NULL;
+	gs_free CheckData *checks = NULL;
+	guint n_running;
+	guint n_queued;
+	guint n_done = 0;
+	guint i;
+
+	connectivity = g_object_new (NM_TYPE_CONNECTIVITY, NULL);
+	g_assert (nm_connectivity_check_enabled (connectivity));
+
+	/* let curl resolve the names, without the DNS manager. */
+	nmtst_connectivity_set_resolve_dbus_connection (connectivity, NULL);
+
+	checks = g_new0 (CheckData, N);
+	for (i = 0; i < N; i++) {
+		checks[i].n_done = &n_done;
+		checks[i].handle = nm_connectivity_check_start (connectivity,
+		                                                AF_INET,
+		                                                NULL,
+		                                                1,
+		                                                "lo",
+		                                                _check_cb,
+		                                                &checks[i]);
+		g_assert (checks[i].handle);
+	}
+
+	/* nothing happens before the main loop runs. */
+	nmtst_connectivity_get_queue_state (connectivity, &n_running, &n_queued);
+	g_assert_cmpint (n_running, ==, NM_CONNECTIVITY_MAX_RUNNING);
+	g_assert_cmpint (n_queued, ==, N_QUEUED);
+
+	/* cancelling a queued check doesn't free a slot. */
+	nm_connectivity_check_cancel (checks[N - 1].handle);
+	g_assert (checks[N - 1].done);
+	g_assert_cmpint (checks[N - 1].latency_msec, ==, -1);
+	nmtst_connectivity_get_queue_state (connectivity, &n_running, &n_queued);
+	g_assert_cmpint (n_running, ==, NM_CONNECTIVITY_MAX_RUNNING);
+	g_assert_cmpint (n_queued, ==, N_QUEUED - 1);
+
+	/* cancelling running checks frees their slots. */
+	for (i = 0; i < 3; i++) {
+		nm_connectivity_check_cancel (checks[i].handle);
+		g_assert (checks[i].done);
+		g_assert_cmpint (checks[i].latency_msec, >=, 0);
+	}
+	nmtst_connectivity_get_queue_state (connectivity, &n_running, &n_queued);
+	g_assert_cmpint (n_running, ==, NM_CONNECTIVITY_MAX_RUNNING - 3);
+	g_assert_cmpint (n_queued, ==, N_QUEUED - 1);
+
+	/* all remaining checks complete, the queued ones after they got a slot. */
+	while (n_done < N)
+		g_main_context_iteration (NULL, TRUE);
+
+	nmtst_connectivity_get_queue_state (connectivity, &n_running, &n_queued);
+	g_assert_cmpint (n_running, ==, 0);
+	g_assert_cmpint (n_queued, ==, 0);
+
+	for (i = 0; i < N - 1; i++)
+		g_assert_cmpint (checks[i].latency_msec, >=, 0);
+}
+
+/*****************************************************************************/
+
+/* a fake systemd-resolved, which resolves every name to 127.0.0.1. */
+static void
+_resolved_method_call (GDBusConnection *connection,
+                       const char *sender,
+                       const char *object_path,
+                       const char *interface_name,
+                       const char *method_name,
+                       GVariant *parameters,
+                       GDBusMethodInvocation *invocation,
+                       gpointer user_data)
+{
+	const guint8 address[4] = { 127, 0, 0, 1 };
+	guint *n_calls = user_data;
+	GVariantBuilder builder;
+	const char *name;
+	gint32 ifindex;
+	gint32 family;
+	guint64 flags;
+
+	g_assert_cmpstr (method_name, ==, "ResolveHostname");
+
+	g_variant_get (parameters, "(i&sit)", &ifindex, &name, &family, &flags);
+	g_assert_cmpint (ifindex, ==, 1);
+	g_assert_cmpstr (name, ==, "127.0.0.1");
+	g_assert_cmpint (family, ==, AF_INET);
+
+	(*n_calls)++;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(iiay)"));
+	g_variant_builder_add (&builder, "(ii@ay)",
+	                       ifindex,
+	                       family,
+	                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, address, sizeof (address), 1));
+	g_dbus_method_invocation_return_value (invocation,
+	                                       g_variant_new ("(a(iiay)st)", &builder, name, (guint64) 0));
+}
+
+static GDBusInterfaceInfo *const resolved_interface_info = NM_DEFINE_GDBUS_INTERFACE_INFO (
+	"org.freedesktop.resolve1.Manager",
+	.methods = NM_DEFINE_GDBUS_METHOD_INFOS (
+		NM_DEFINE_GDBUS_METHOD_INFO (
+			"ResolveHostname",
+			.in_args = NM_DEFINE_GDBUS_ARG_INFOS (
+				NM_DEFINE_GDBUS_ARG_INFO ("ifindex", "i"),
+				NM_DEFINE_GDBUS_ARG_INFO ("name", "s"),
+				NM_DEFINE_GDBUS_ARG_INFO ("family", "i"),
+				NM_DEFINE_GDBUS_ARG_INFO ("flags", "t"),
+			),
+			.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+				NM_DEFINE_GDBUS_ARG_INFO ("addresses", "a(iiay)"),
+				NM_DEFINE_GDBUS_ARG_INFO ("canonical", "s"),
+				NM_DEFINE_GDBUS_ARG_INFO ("flags", "t"),
+			),
+		),
+	),
+);
+
+static const GDBusInterfaceVTable resolved_interface_vtable = {
+	.method_call = _resolved_method_call,
+};
+
+static void
+_name_acquired_cb (GDBusConnection *connection,
+                   const char *name,
+                   gpointer user_data)
+{
+	*((gboolean *) user_data) = TRUE;
+}
+
+static void
+test_dns_cache (void)
+{
+	gs_unref_object NMConnectivity *connectivity = NULL;
+	gs_free_error GError *error = NULL;
+	gs_free char *dbus_daemon = NULL;
+	GTestDBus *test_bus;
+	GDBusConnection *bus;
+	CheckData checks[3] = { };
+	gboolean name_acquired = FALSE;
+	guint n_resolve_calls = 0;
+	guint n_done = 0;
+	guint registration_id;
+	guint own_name_id;
+	guint i;
+
+	dbus_daemon = g_find_program_in_path ("dbus-daemon");
+	if (!dbus_daemon) {
+		g_test_skip ("dbus-daemon is not available");
+		return;
+	}
+
+	test_bus = g_test_dbus_new (G_TEST_DBUS_NONE);
+	g_test_dbus_up (test_bus);
+
+	bus = g_dbus_connection_new_for_address_sync (g_test_dbus_get_bus_address (test_bus),
+	                                                G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT
+	                                              | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+	                                              NULL,
+	                                              NULL,
+	                                              &error);
+	nmtst_assert_success (bus, error);
+
+	registration_id = g_dbus_connection_register_object (bus,
+	                                                     "/org/freedesktop/resolve1",
+	                                                     resolved_interface_info,
+	                                                     NM_UNCONST_PTR (GDBusInterfaceVTable, &resolved_interface_vtable),
+	                                                     &n_resolve_calls,
+	                                                     NULL,
+	                                                     &error);
+	nmtst_assert_success (registration_id != 0, error);
+
+	own_name_id = g_bus_own_name_on_connection (bus,
+	                                            "org.freedesktop.resolve1",
+	                                            G_BUS_NAME_OWNER_FLAGS_NONE,
+	                                            _name_acquired_cb,
+	                                            NULL,
+	                                            &name_acquired,
+	                                            NULL);
+	nmtst_main_context_iterate_until_assert (NULL, 5000, name_acquired);
+
+	connectivity = g_object_new (NM_TYPE_CONNECTIVITY, NULL);
+	nmtst_connectivity_set_resolve_dbus_connection (connectivity, bus);
+
+	for (i = 0; i < G_N_ELEMENTS (checks); i++)
+		checks[i].n_done = &n_done;
+
+	/* two checks on the same link share one lookup. */
+	for (i = 0; i < 2; i++) {
+		checks[i].handle = nm_connectivity_check_start (connectivity,
+		                                                AF_INET,
+		                                                NULL,
+		                                                1,
+		                                                "lo",
+		                                                _check_cb,
+		                                                &checks[i]);
+		g_assert (checks[i].handle);
+	}
+	g_assert_cmpint (nmtst_connectivity_get_dns_cache_size (connectivity), ==, 1);
+
+	nmtst_main_context_iterate_until_assert (NULL, 5000, n_done == 2);
+	g_assert_cmpint (n_resolve_calls, ==, 1);
+
+	/* nothing listens on the resolved address, so the checks fail. That
+	 * drops the cached address... */
+	for (i = 0; i < 2; i++)
+		g_assert_cmpint (checks[i].state, ==, NM_CONNECTIVITY_LIMITED);
+	g_assert_cmpint (nmtst_connectivity_get_dns_cache_size (connectivity), ==, 0);
+
+	/* ... and the next check resolves the name again. */
+	checks[2].handle = nm_connectivity_check_start (connectivity,
+	                                                AF_INET,
+	                                                NULL,
+	                                                1,
+	                                                "lo",
+	                                                _check_cb,
+	                                                &checks[2]);
+	g_assert (checks[2].handle);
+
+	nmtst_main_context_iterate_until_assert (NULL, 5000, n_done == 3);
+	g_assert_cmpint (n_resolve_calls, ==, 2);
+	g_assert_cmpint (checks[2].state, ==, NM_CONNECTIVITY_LIMITED);
+
+	g_clear_object (&connectivity);
+
+	g_bus_unown_name (own_name_id);
+	g_dbus_connection_unregister_object (bus, registration_id);
+	g_object_unref (bus);
+	g_test_dbus_down (test_bus);
+	g_object_unref (test_bus);
+}
+
+#endif
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	int r;
+
+	nmtst_init_with_logging (&argc, &argv, NULL, "ALL");
+
+	_setup_config ();
+
+	g_test_add_func ("/connectivity/periodic-offset", test_periodic_offset);
+#if WITH_CONCHECK
+	g_test_add_func ("/connectivity/queue", test_queue);
+	g_test_add_func ("/connectivity/dns-cache", test_dns_cache);
+#endif
+
+	r = g_test_run ();
+
+	_cleanup_config ();
+	return r;
+}
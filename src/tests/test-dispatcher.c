@@ -0,0 +1,397 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nm-dispatcher.h"
+#include "nm-libnm-core-aux/nm-dispatcher-api.h"
+
+#include "nm-test-utils-core.h"
+
+/*****************************************************************************/
+
+/* A fake dispatcher service on a private bus. It only has scripts for
+ * "connectivity-change", and records the "Action" and "ActionBatch"
+ * calls it receives. */
+static struct {
+	GTestDBus *test_bus;
+	GDBusConnection *service_bus;
+	GDBusConnection *client_bus;
+	guint registration_id;
+	guint own_name_id;
+	bool name_acquired:1;
+
+	GPtrArray *calls;
+
+	/* reply to "ActionBatch" with UNKNOWN_METHOD, like an older service. */
+	bool batch_unsupported:1;
+
+	/* reply to "ActionBatch" with one result less than there were events. */
+	bool batch_drop_result:1;
+} fake;
+
+/* records @parameters of an "Action" call as "action/connectivity-state". */
+static void
+_fake_append_action (GString *str, GVariant *parameters)
+{
+	const char *action;
+	const char *connectivity_state;
+
+	g_variant_get_child (parameters, 0, "&s", &action);
+	g_variant_get_child (parameters, 9, "&s", &connectivity_state);
+	g_string_append_printf (str, "%s/%s", action, connectivity_state);
+}
+
+static void
+_fake_method_call (GDBusConnection *connection,
+                   const char *sender,
+                   const char *object_path,
+                   const char *interface_name,
+                   const char *method_name,
+                   GVariant *parameters,
+                   GDBusMethodInvocation *invocation,
+                   gpointer user_data)
+{
+	if (nm_streq (method_name, "GetActions")) {
+		g_dbus_method_invocation_return_value (invocation,
+		                                       g_variant_new_parsed ("([%s],)", NMD_ACTION_CONNECTIVITY_CHANGE));
+		return;
+	}
+
+	if (nm_streq (method_name, "Action")) {
+		GString *str;
+
+		str = g_string_new ("Action:");
+		_fake_append_action (str, parameters);
+		g_ptr_array_add (fake.calls, g_string_free (str, FALSE));
+		g_dbus_method_invocation_return_value (invocation,
+		                                       g_variant_new_parsed ("(@a(sus) [],)"));
+		return;
+	}
+
+	if (nm_streq (method_name, "ActionBatch")) {
+		gs_unref_variant GVariant *events = NULL;
+		GString *str;
+		GVariantBuilder builder;
+		gsize n;
+		gsize i;
+
+		events = g_variant_get_child_value (parameters, 0);
+		n = g_variant_n_children (events);
+
+		str = g_string_new ("ActionBatch:");
+		for (i = 0; i < n; i++) {
+			gs_unref_variant GVariant *event = g_variant_get_child_value (events, i);
+
+			if (i > 0)
+				g_string_append_c (str, ',');
+			_fake_append_action (str, event);
+		}
+		g_ptr_array_add (fake.calls, g_string_free (str, FALSE));
+
+		if (fake.batch_unsupported) {
+			g_dbus_method_invocation_return_error (invocation,
+			                                       G_DBUS_ERROR,
+			                                       G_DBUS_ERROR_UNKNOWN_METHOD,
+			                                       "Unknown method %s",
+			                                       method_name);
+			return;
+		}
+
+		if (fake.batch_drop_result && n > 0)
+			n--;
+
+		g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa(sus)"));
+		for (i = 0; i < n; i++)
+			g_variant_builder_add_value (&builder, g_variant_new_array (G_VARIANT_TYPE ("(sus)"), NULL, 0));
+		g_dbus_method_invocation_return_value (invocation,
+		                                       g_variant_new ("(aa(sus))", &builder));
+		return;
+	}
+
+	g_assert_not_reached ();
+}
+
+static GDBusInterfaceInfo *const fake_interface_info = NM_DEFINE_GDBUS_INTERFACE_INFO (
+	NM_DISPATCHER_DBUS_INTERFACE,
+	.methods = NM_DEFINE_GDBUS_METHOD_INFOS (
+		NM_DEFINE_GDBUS_METHOD_INFO (
+			"Action",
+			.in_args = NM_DEFINE_GDBUS_ARG_INFOS (
+				NM_DEFINE_GDBUS_ARG_INFO ("action", "s"),
+				NM_DEFINE_GDBUS_ARG_INFO ("connection", "a{sa{sv}}"),
+				NM_DEFINE_GDBUS_ARG_INFO ("connection_properties", "a{sv}"),
+				NM_DEFINE_GDBUS_ARG_INFO ("device_properties", "a{sv}"),
+				NM_DEFINE_GDBUS_ARG_INFO ("device_proxy_properties", "a{sv}"),
+				NM_DEFINE_GDBUS_ARG_INFO ("device_ip4_config", "a{sv}"),
+				NM_DEFINE_GDBUS_ARG_INFO ("device_ip6_config", "a{sv}"),
+				NM_DEFINE_GDBUS_ARG_INFO ("device_dhcp4_config", "a{sv}"),
+				NM_DEFINE_GDBUS_ARG_INFO ("device_dhcp6_config", "a{sv}"),
+				NM_DEFINE_GDBUS_ARG_INFO ("connectivity_state", "s"),
+				NM_DEFINE_GDBUS_ARG_INFO ("vpn_ip_iface", "s"),
+				NM_DEFINE_GDBUS_ARG_INFO ("vpn_proxy_properties", "a{sv}"),
+				NM_DEFINE_GDBUS_ARG_INFO ("vpn_ip4_config", "a{sv}"),
+				NM_DEFINE_GDBUS_ARG_INFO ("vpn_ip6_config", "a{sv}"),
+				NM_DEFINE_GDBUS_ARG_INFO ("debug", "b"),
+			),
+			.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+				NM_DEFINE_GDBUS_ARG_INFO ("results", "a(sus)"),
+			),
+		),
+		NM_DEFINE_GDBUS_METHOD_INFO (
+			"ActionBatch",
+			.in_args = NM_DEFINE_GDBUS_ARG_INFOS (
+				NM_DEFINE_GDBUS_ARG_INFO ("events", "a(" NMD_ACTION_ARGS_SIGNATURE ")"),
+			),
+			.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+				NM_DEFINE_GDBUS_ARG_INFO ("results", "aa(sus)"),
+			),
+		),
+		NM_DEFINE_GDBUS_METHOD_INFO (
+			"GetActions",
+			.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+				NM_DEFINE_GDBUS_ARG_INFO ("actions", "as"),
+			),
+		),
+	),
+);
+
+static const GDBusInterfaceVTable fake_interface_vtable = {
+	.method_call = _fake_method_call,
+};
+
+static void
+_fake_name_acquired_cb (GDBusConnection *connection,
+                        const char *name,
+                        gpointer user_data)
+{
+	fake.name_acquired = TRUE;
+}
+
+static void
+_fake_setup (void)
+{
+	gs_free_error GError *error = NULL;
+	gs_free char *dbus_daemon = NULL;
+
+	dbus_daemon = g_find_program_in_path ("dbus-daemon");
+	if (!dbus_daemon)
+		return;
+
+	fake.calls = g_ptr_array_new_with_free_func (g_free);
+
+	fake.test_bus = g_test_dbus_new (G_TEST_DBUS_NONE);
+	g_test_dbus_up (fake.test_bus);
+
+	fake.service_bus = g_dbus_connection_new_for_address_sync (g_test_dbus_get_bus_address (fake.test_bus),
+	                                                             G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT
+	                                                           | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+	                                                           NULL,
+	                                                           NULL,
+	                                                           &error);
+	nmtst_assert_success (fake.service_bus, error);
+
+	fake.client_bus = g_dbus_connection_new_for_address_sync (g_test_dbus_get_bus_address (fake.test_bus),
+	                                                            G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT
+	                                                          | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+	                                                          NULL,
+	                                                          NULL,
+	                                                          &error);
+	nmtst_assert_success (fake.client_bus, error);
+
+	fake.registration_id = g_dbus_connection_register_object (fake.service_bus,
+	                                                          NM_DISPATCHER_DBUS_PATH,
+	                                                          fake_interface_info,
+	                                                          NM_UNCONST_PTR (GDBusInterfaceVTable, &fake_interface_vtable),
+	                                                          NULL,
+	                                                          NULL,
+	                                                          &error);
+	nmtst_assert_success (fake.registration_id != 0, error);
+
+	fake.own_name_id = g_bus_own_name_on_connection (fake.service_bus,
+	                                                 NM_DISPATCHER_DBUS_SERVICE,
+	                                                 G_BUS_NAME_OWNER_FLAGS_NONE,
+	                                                 _fake_name_acquired_cb,
+	                                                 NULL,
+	                                                 NULL,
+	                                                 NULL);
+	nmtst_main_context_iterate_until_assert (NULL, 5000, fake.name_acquired);
+
+	nmtst_dispatcher_init (fake.client_bus);
+}
+
+static void
+_fake_cleanup (void)
+{
+	if (!fake.test_bus)
+		return;
+
+	g_bus_unown_name (nm_steal_int (&fake.own_name_id));
+	g_dbus_connection_unregister_object (fake.service_bus, nm_steal_int (&fake.registration_id));
+	g_clear_object (&fake.client_bus);
+	g_clear_object (&fake.service_bus);
+	g_test_dbus_down (fake.test_bus);
+	g_clear_object (&fake.test_bus);
+	nm_clear_pointer (&fake.calls, g_ptr_array_unref);
+}
+
+/* asserts that the service received the calls in @expected (separated by
+ * spaces) since the last check, and forgets them. */
+static void
+_fake_assert_calls (const char *expected)
+{
+	gs_free char *calls = NULL;
+
+	g_ptr_array_add (fake.calls, NULL);
+	calls = g_strjoinv (" ", (char **) fake.calls->pdata);
+	g_ptr_array_set_size (fake.calls, 0);
+
+	g_assert_cmpstr (calls, ==, expected);
+}
+
+#define CONNECTIVITY(state) NMD_ACTION_CONNECTIVITY_CHANGE "/" state
+
+/*****************************************************************************/
+
+static void
+_done_cb (NMDispatcherCallId *call_id, gpointer user_data)
+{
+	(*((guint *) user_data))++;
+}
+
+static void
+test_batch (void)
+{
+	guint n_done = 0;
+
+	if (!fake.test_bus) {
+		g_test_skip ("dbus-daemon is not available");
+		return;
+	}
+
+	/* the calls of one main loop iteration are sent together, once the
+	 * main loop runs. */
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_NONE, NULL, NULL, NULL));
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_LIMITED, NULL, NULL, NULL));
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_FULL, NULL, NULL, NULL));
+	g_assert_cmpint (nmtst_dispatcher_get_n_requests (), ==, 3);
+
+	nmtst_main_context_iterate_until_assert (NULL, 5000, nmtst_dispatcher_get_n_requests () == 0);
+	_fake_assert_calls ("ActionBatch:" CONNECTIVITY ("NONE") "," CONNECTIVITY ("LIMITED") "," CONNECTIVITY ("FULL"));
+
+	/* a call with a callback is sent on its own, but doesn't overtake
+	 * the queued calls. */
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_NONE, NULL, NULL, NULL));
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_LIMITED, NULL, NULL, NULL));
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_FULL, _done_cb, &n_done, NULL));
+
+	nmtst_main_context_iterate_until_assert (NULL, 5000, nmtst_dispatcher_get_n_requests () == 0);
+	g_assert_cmpint (n_done, ==, 1);
+	_fake_assert_calls ("ActionBatch:" CONNECTIVITY ("NONE") "," CONNECTIVITY ("LIMITED") " "
+	                    "Action:" CONNECTIVITY ("FULL"));
+}
+
+static void
+test_batch_invalid_results (void)
+{
+	if (!fake.test_bus) {
+		g_test_skip ("dbus-daemon is not available");
+		return;
+	}
+
+	/* results that don't match the events fail all calls of the batch,
+	 * without sending them again. */
+	fake.batch_drop_result = TRUE;
+
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_NONE, NULL, NULL, NULL));
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_FULL, NULL, NULL, NULL));
+
+	nmtst_main_context_iterate_until_assert (NULL, 5000, nmtst_dispatcher_get_n_requests () == 0);
+	_fake_assert_calls ("ActionBatch:" CONNECTIVITY ("NONE") "," CONNECTIVITY ("FULL"));
+
+	fake.batch_drop_result = FALSE;
+}
+
+static void
+test_skip (void)
+{
+	NMDispatcherCallId *call_id = NULL;
+	guint n_done = 0;
+
+	if (!fake.test_bus) {
+		g_test_skip ("dbus-daemon is not available");
+		return;
+	}
+
+	/* the first calls made the daemon ask for the actions with scripts,
+	 * and the reply arrived before theirs. */
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_FULL, NULL, NULL, NULL));
+	nmtst_main_context_iterate_until_assert (NULL, 5000, nmtst_dispatcher_get_n_requests () == 0);
+	_fake_assert_calls ("Action:" CONNECTIVITY ("FULL"));
+
+	/* there are no scripts for "hostname", so the call is not sent. Still,
+	 * the callback is invoked, but not before the main loop runs. */
+	g_assert (nm_dispatcher_call_hostname (_done_cb, &n_done, &call_id));
+	g_assert (call_id);
+	g_assert_cmpint (n_done, ==, 0);
+
+	nmtst_main_context_iterate_until_assert (NULL, 5000, n_done == 1);
+	g_assert_cmpint (nmtst_dispatcher_get_n_requests (), ==, 0);
+	_fake_assert_calls ("");
+}
+
+static void
+test_batch_unsupported (void)
+{
+	if (!fake.test_bus) {
+		g_test_skip ("dbus-daemon is not available");
+		return;
+	}
+
+	/* an older service doesn't know "ActionBatch". The calls are sent
+	 * again one by one, and so are all later calls. */
+	fake.batch_unsupported = TRUE;
+
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_NONE, NULL, NULL, NULL));
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_FULL, NULL, NULL, NULL));
+
+	nmtst_main_context_iterate_until_assert (NULL, 5000, nmtst_dispatcher_get_n_requests () == 0);
+	_fake_assert_calls ("ActionBatch:" CONNECTIVITY ("NONE") "," CONNECTIVITY ("FULL") " "
+	                    "Action:" CONNECTIVITY ("NONE") " "
+	                    "Action:" CONNECTIVITY ("FULL"));
+
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_LIMITED, NULL, NULL, NULL));
+	g_assert (nm_dispatcher_call_connectivity (NM_CONNECTIVITY_FULL, NULL, NULL, NULL));
+
+	nmtst_main_context_iterate_until_assert (NULL, 5000, nmtst_dispatcher_get_n_requests () == 0);
+	_fake_assert_calls ("Action:" CONNECTIVITY ("LIMITED") " "
+	                    "Action:" CONNECTIVITY ("FULL"));
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	int r;
+
+	nmtst_init_assert_logging (&argc, &argv, "WARN", "DEFAULT");
+
+	_fake_setup ();
+
+	/* the tests share the state of the dispatcher module. The fallback for
+	 * a service without "ActionBatch" is permanent, so it goes last. */
+	g_test_add_func ("/dispatcher/batch", test_batch);
+	g_test_add_func ("/dispatcher/batch-invalid-results", test_batch_invalid_results);
+	g_test_add_func ("/dispatcher/skip", test_skip);
+	g_test_add_func ("/dispatcher/batch-unsupported", test_batch_unsupported);
+
+	r = g_test_run ();
+
+	_fake_cleanup ();
+	return r;
+}
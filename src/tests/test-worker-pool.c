@@ -0,0 +1,242 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2020 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <unistd.h>
+
+#include "nm-worker-pool.h"
+
+#include "nm-test-utils-core.h"
+
+/*****************************************************************************/
+
+typedef struct {
+	GMutex lock;
+	GArray *order;
+	int n_running;
+	int max_running;
+	guint n_done;
+} TestData;
+
+typedef struct {
+	TestData *data;
+	guint idx;
+	gulong sleep_usec;
+} TestItem;
+
+static void
+_test_item_fn (gpointer user_data)
+{
+	TestItem *item = user_data;
+	TestData *data = item->data;
+
+	g_mutex_lock (&data->lock);
+	data->n_running++;
+	data->max_running = MAX (data->max_running, data->n_running);
+	g_mutex_unlock (&data->lock);
+
+	if (item->sleep_usec)
+		g_usleep (item->sleep_usec);
+
+	g_mutex_lock (&data->lock);
+	data->n_running--;
+	g_array_append_val (data->order, item->idx);
+	g_mutex_unlock (&data->lock);
+}
+
+static void
+_test_item_done (gpointer user_data)
+{
+	TestItem *item = user_data;
+
+	item->data->n_done++;
+	g_free (item);
+}
+
+static void
+_test_data_init (TestData *data)
+{
+	*data = (TestData) {
+		.order = g_array_new (FALSE, FALSE, sizeof (guint)),
+	};
+	g_mutex_init (&data->lock);
+}
+
+static void
+_test_data_clear (TestData *data)
+{
+	g_array_unref (data->order);
+	g_mutex_clear (&data->lock);
+}
+
+static void
+_test_submit (TestData *data, const char *serial_key, guint idx, gulong sleep_usec)
+{
+	TestItem *item;
+
+	item = g_new (TestItem, 1);
+	*item = (TestItem) {
+		.data       = data,
+		.idx        = idx,
+		.sleep_usec = sleep_usec,
+	};
+	nm_worker_pool_submit (serial_key, _test_item_fn, _test_item_done, item);
+}
+
+static void
+_test_iterate_until_done (TestData *data, guint n)
+{
+	while (data->n_done < n)
+		g_main_context_iteration (NULL, TRUE);
+	g_assert_cmpint (data->n_done, ==, n);
+}
+
+/*****************************************************************************/
+
+static void
+test_serial_key (void)
+{
+	const guint N = 20;
+	TestData data;
+	guint i;
+
+	_test_data_init (&data);
+
+	/* items with the same key run one after the other, in order. */
+	for (i = 0; i < N; i++)
+		_test_submit (&data, "key", i, nmtst_get_rand_uint32 () % 2000);
+
+	nm_worker_pool_wait ();
+
+	g_assert_cmpint (data.order->len, ==, N);
+	for (i = 0; i < N; i++)
+		g_assert_cmpint (g_array_index (data.order, guint, i), ==, i);
+	g_assert_cmpint (data.max_running, ==, 1);
+
+	/* the done functions are invoked on our main context. */
+	g_assert_cmpint (data.n_done, ==, 0);
+	_test_iterate_until_done (&data, N);
+
+	_test_data_clear (&data);
+}
+
+static void
+test_wait (void)
+{
+	const guint N = 20;
+	TestData data;
+	guint i;
+
+	_test_data_init (&data);
+
+	for (i = 0; i < N; i++)
+		_test_submit (&data, NULL, i, 1000);
+
+	nm_worker_pool_wait ();
+
+	g_mutex_lock (&data.lock);
+	g_assert_cmpint (data.order->len, ==, N);
+	g_assert_cmpint (data.n_running, ==, 0);
+	g_mutex_unlock (&data.lock);
+
+	_test_iterate_until_done (&data, N);
+
+	_test_data_clear (&data);
+}
+
+static void
+test_wait_key (void)
+{
+	TestData data;
+	guint i;
+
+	_test_data_init (&data);
+
+	_test_submit (&data, "key-a", 0, 50000);
+	_test_submit (&data, "key-a", 1, 10000);
+
+	nm_worker_pool_wait_key ("key-a");
+
+	/* both items with the key completed. */
+	g_mutex_lock (&data.lock);
+	g_assert_cmpint (data.order->len, ==, 2);
+	for (i = 0; i < 2; i++)
+		g_assert_cmpint (g_array_index (data.order, guint, i), ==, i);
+	g_mutex_unlock (&data.lock);
+
+	/* waiting for a key without pending items returns right away. */
+	nm_worker_pool_wait_key ("key-b");
+
+	_test_iterate_until_done (&data, 2);
+
+	_test_data_clear (&data);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+	guint n_called;
+} FileData;
+
+static void
+_file_set_contents_cb (const char *filename,
+                       GError *error,
+                       gpointer user_data)
+{
+	FileData *data = user_data;
+
+	g_assert_no_error (error);
+	data->n_called++;
+}
+
+static void
+test_file_set_contents (void)
+{
+	gs_free char *filename = NULL;
+	gs_free char *contents = NULL;
+	FileData data = { };
+	guint i;
+	int fd;
+
+	fd = g_file_open_tmp ("test-worker-pool-XXXXXX", &filename, NULL);
+	g_assert (fd >= 0);
+	nm_close (fd);
+
+	for (i = 0; i < 10; i++) {
+		nm_worker_pool_file_set_contents (filename,
+		                                  g_strdup_printf ("contents %u\n", i),
+		                                  NM_STRLEN ("contents 0\n"),
+		                                  _file_set_contents_cb,
+		                                  &data);
+	}
+
+	/* the file has the last content, once the writes for it are done. */
+	nm_worker_pool_wait_key (filename);
+	g_assert (g_file_get_contents (filename, &contents, NULL, NULL));
+	g_assert_cmpstr (contents, ==, "contents 9\n");
+
+	while (data.n_called < 10)
+		g_main_context_iteration (NULL, TRUE);
+
+	(void) unlink (filename);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	nmtst_init_with_logging (&argc, &argv, NULL, "ALL");
+
+	g_test_add_func ("/worker-pool/serial-key", test_serial_key);
+	g_test_add_func ("/worker-pool/wait", test_wait);
+	g_test_add_func ("/worker-pool/wait-key", test_wait_key);
+	g_test_add_func ("/worker-pool/file-set-contents", test_file_set_contents);
+
+	return g_test_run ();
+}
@@ -94,9 +94,16 @@ typedef struct {
 	NMVpnServiceState service_state;
 	guint start_timeout;
 	gboolean service_running;
+	/* whether this connection spawned the service and added it
+	 * to _services_starting. */
+	gboolean service_starting;
 	NMVpnPluginInfo *plugin_info;
 	char *bus_name;
 
+	/* if the plugin supports instances, the object path of the
+	 * plugin instance that handles this connection. */
+	char *instance_path;
+
 	NMFirewallManagerCallId *fw_call;
 
 	NMNetns *netns;
@@ -209,7 +216,7 @@ __LOG_create_prefix (char *buf, NMVpnConnection *self, NMSettingsConnection *con
         const NMLogLevel _level = (level); \
         NMSettingsConnection *_con = (self) ? _get_settings_connection (self, TRUE) : NULL; \
         \
-        if (nm_logging_enabled (_level, _NMLOG_DOMAIN)) { \
+        if (nm_log_enabled (_level, _NMLOG_DOMAIN)) { \
             char __prefix[__NMLOG_prefix_buf_len]; \
             \
             _nm_log (_level, _NMLOG_DOMAIN, 0, \
@@ -394,6 +401,7 @@ vpn_cleanup (NMVpnConnection *self, NMDevice *parent_dev)
 
 	g_free (priv->bus_name);
 	priv->bus_name = NULL;
+	nm_clear_g_free (&priv->instance_path);
 
 	/* Clear out connection secrets to ensure that the settings service
 	 * gets asked for them next time the connection is activated.
@@ -2114,6 +2122,78 @@ ip6_config_cb (GDBusProxy *proxy,
 		nm_vpn_connection_ip6_config_get (self, dict);
 }
 
+/* Bus names of multi-instance services that were spawned, but did not yet
+ * appear on D-Bus. Further connections wait for them, instead of spawning
+ * the service again. */
+static GHashTable *_services_starting;
+
+static void
+_services_starting_remove (NMVpnConnection *self)
+{
+	NMVpnConnectionPrivate *priv = NM_VPN_CONNECTION_GET_PRIVATE (self);
+
+	/* only the connection that spawned the service owns the entry. */
+	if (!priv->service_starting)
+		return;
+	priv->service_starting = FALSE;
+	if (_services_starting)
+		g_hash_table_remove (_services_starting, priv->bus_name);
+}
+
+static void
+_service_ready (NMVpnConnection *self)
+{
+	NMVpnConnectionPrivate *priv = NM_VPN_CONNECTION_GET_PRIVATE (self);
+
+	/* Expect success because the VPN service has already appeared */
+	_nm_dbus_signal_connect (priv->proxy, "Failure", G_VARIANT_TYPE ("(u)"),
+	                         G_CALLBACK (failure_cb), self);
+	_nm_dbus_signal_connect (priv->proxy, "StateChanged", G_VARIANT_TYPE ("(u)"),
+	                         G_CALLBACK (state_changed_cb), self);
+	_nm_dbus_signal_connect (priv->proxy, "SecretsRequired", G_VARIANT_TYPE ("(sas)"),
+	                         G_CALLBACK (secrets_required_cb), self);
+	_nm_dbus_signal_connect (priv->proxy, "Config", G_VARIANT_TYPE ("(a{sv})"),
+	                         G_CALLBACK (config_cb), self);
+	_nm_dbus_signal_connect (priv->proxy, "Ip4Config", G_VARIANT_TYPE ("(a{sv})"),
+	                         G_CALLBACK (ip4_config_cb), self);
+	_nm_dbus_signal_connect (priv->proxy, "Ip6Config", G_VARIANT_TYPE ("(a{sv})"),
+	                         G_CALLBACK (ip6_config_cb), self);
+
+	_set_vpn_state (self, STATE_NEED_AUTH, NM_ACTIVE_CONNECTION_STATE_REASON_NONE, FALSE);
+
+	/* Kick off the secrets requests; first we get existing system secrets
+	 * and ask the plugin if these are sufficient, next we get all existing
+	 * secrets from system and from user agents and ask the plugin again,
+	 * and last we ask the user for new secrets if required.
+	 */
+	get_secrets (self, SECRETS_REQ_SYSTEM, NULL);
+}
+
+static void
+_add_instance_cb (GObject *source,
+                  GAsyncResult *result,
+                  gpointer user_data)
+{
+	NMVpnConnection *self;
+	gs_unref_variant GVariant *ret = NULL;
+	gs_free_error GError *error = NULL;
+
+	ret = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source), result, &error);
+	if (nm_utils_error_is_cancelled (error))
+		return;
+
+	self = NM_VPN_CONNECTION (user_data);
+
+	if (!ret) {
+		g_dbus_error_strip_remote_error (error);
+		_LOGW ("failed to create the plugin instance: %s", error->message);
+		nm_vpn_connection_disconnect (self, NM_ACTIVE_CONNECTION_STATE_REASON_SERVICE_START_FAILED, FALSE);
+		return;
+	}
+
+	_service_ready (self);
+}
+
 static void
 _name_owner_changed (GObject *object,
                      GParamSpec *pspec,
@@ -2133,28 +2213,26 @@ _name_owner_changed (GObject *object,
 		/* No need to wait for the timeout any longer */
 		nm_clear_g_source (&priv->start_timeout);
 
-		/* Expect success because the VPN service has already appeared */
-		_nm_dbus_signal_connect (priv->proxy, "Failure", G_VARIANT_TYPE ("(u)"),
-		                         G_CALLBACK (failure_cb), self);
-		_nm_dbus_signal_connect (priv->proxy, "StateChanged", G_VARIANT_TYPE ("(u)"),
-		                         G_CALLBACK (state_changed_cb), self);
-		_nm_dbus_signal_connect (priv->proxy, "SecretsRequired", G_VARIANT_TYPE ("(sas)"),
-		                         G_CALLBACK (secrets_required_cb), self);
-		_nm_dbus_signal_connect (priv->proxy, "Config", G_VARIANT_TYPE ("(a{sv})"),
-		                         G_CALLBACK (config_cb), self);
-		_nm_dbus_signal_connect (priv->proxy, "Ip4Config", G_VARIANT_TYPE ("(a{sv})"),
-		                         G_CALLBACK (ip4_config_cb), self);
-		_nm_dbus_signal_connect (priv->proxy, "Ip6Config", G_VARIANT_TYPE ("(a{sv})"),
-		                         G_CALLBACK (ip6_config_cb), self);
-
-		_set_vpn_state (self, STATE_NEED_AUTH, NM_ACTIVE_CONNECTION_STATE_REASON_NONE, FALSE);
-
-		/* Kick off the secrets requests; first we get existing system secrets
-		 * and ask the plugin if these are sufficient, next we get all existing
-		 * secrets from system and from user agents and ask the plugin again,
-		 * and last we ask the user for new secrets if required.
-		 */
-		get_secrets (self, SECRETS_REQ_SYSTEM, NULL);
+		_services_starting_remove (self);
+
+		if (priv->instance_path) {
+
+			/* the connection is handled by a new instance of the
+			 * running plugin service. */
+			g_dbus_connection_call (g_dbus_proxy_get_connection (priv->proxy),
+			                        priv->bus_name,
+			                        NM_VPN_DBUS_PLUGIN_PATH,
+			                        NM_VPN_DBUS_PLUGIN_INTERFACE,
+			                        "AddInstance",
+			                        g_variant_new ("(o)", priv->instance_path),
+			                        G_VARIANT_TYPE ("()"),
+			                        G_DBUS_CALL_FLAGS_NONE,
+			                        -1,
+			                        priv->cancellable,
+			                        _add_instance_cb,
+			                        self);
+		} else
+			_service_ready (self);
 	} else if (!owner && priv->service_running) {
 		/* service went away */
 		priv->service_running = FALSE;
@@ -2173,6 +2251,7 @@ _daemon_exec_timeout (gpointer data)
 
 	_LOGW ("Timed out waiting for the service to start");
 	priv->start_timeout = 0;
+	_services_starting_remove (self);
 	nm_vpn_connection_disconnect (self, NM_ACTIVE_CONNECTION_STATE_REASON_SERVICE_START_TIMEOUT, FALSE);
 	return G_SOURCE_REMOVE;
 }
@@ -2231,6 +2310,15 @@ nm_vpn_service_daemon_exec (NMVpnConnection *self, GError **error)
 
 	priv = NM_VPN_CONNECTION_GET_PRIVATE (self);
 
+	if (   priv->instance_path
+	    && _services_starting
+	    && g_hash_table_contains (_services_starting, priv->bus_name)) {
+		/* another connection already started the service. Wait for it. */
+		_LOGI ("Waiting for the VPN service to start");
+		priv->start_timeout = g_timeout_add_seconds (5, _daemon_exec_timeout, self);
+		return TRUE;
+	}
+
 	i = 0;
 	vpn_argv[i++] = (char *) nm_vpn_plugin_info_get_program (priv->plugin_info);
 	g_return_val_if_fail (vpn_argv[0], FALSE);
@@ -2268,6 +2356,12 @@ nm_vpn_service_daemon_exec (NMVpnConnection *self, GError **error)
 	if (success) {
 		_LOGI ("Started the VPN service, PID %ld", (long int) pid);
 		priv->start_timeout = g_timeout_add_seconds (5, _daemon_exec_timeout, self);
+		if (priv->instance_path) {
+			if (!_services_starting)
+				_services_starting = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, NULL);
+			g_hash_table_add (_services_starting, g_strdup (priv->bus_name));
+			priv->service_starting = TRUE;
+		}
 	} else {
 		g_set_error (error,
 		             NM_MANAGER_ERROR, NM_MANAGER_ERROR_FAILED,
@@ -2342,7 +2436,19 @@ nm_vpn_connection_activate (NMVpnConnection *self,
 	service = nm_vpn_plugin_info_get_service (plugin_info);
 	nm_assert (service);
 
-	if (nm_vpn_plugin_info_supports_multiple (plugin_info)) {
+	if (nm_vpn_plugin_info_supports_instances (plugin_info)) {
+		const char *path;
+
+		/* one service process handles all connections, each by
+		 * a separate plugin instance. */
+		path = nm_dbus_object_get_path (NM_DBUS_OBJECT (self));
+		if (path)
+			path = strrchr (path, '/');
+		g_return_if_fail (path);
+
+		priv->bus_name = g_strdup (service);
+		priv->instance_path = g_strdup_printf ("%s/Connection_%s", NM_VPN_DBUS_PLUGIN_PATH, &path[1]);
+	} else if (nm_vpn_plugin_info_supports_multiple (plugin_info)) {
 		const char *path;
 
 		path = nm_dbus_object_get_path (NM_DBUS_OBJECT (self));
@@ -2362,7 +2468,7 @@ nm_vpn_connection_activate (NMVpnConnection *self,
 	                          G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES,
 	                          NULL,
 	                          priv->bus_name,
-	                          NM_VPN_DBUS_PLUGIN_PATH,
+	                          priv->instance_path ?: NM_VPN_DBUS_PLUGIN_PATH,
 	                          NM_VPN_DBUS_PLUGIN_INTERFACE,
 	                          priv->cancellable,
 	                          (GAsyncReadyCallback) on_proxy_acquired,
@@ -2788,6 +2894,7 @@ dispose (GObject *object)
 		g_signal_handlers_disconnect_by_data (priv->proxy, self);
 
 	nm_clear_g_source (&priv->start_timeout);
+	_services_starting_remove (self);
 
 	nm_clear_pointer (&priv->connect_hash, g_variant_unref);
 
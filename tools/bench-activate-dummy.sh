@@ -0,0 +1,79 @@
+#!/bin/bash
+
+# Benchmark the activation of many dummy devices end-to-end.
+#
+# This requires a running NetworkManager and root privileges. It creates
+# N in-memory dummy profiles with static addresses, activates them all
+# at once and waits until every device is activated. Afterwards the
+# profiles (and thereby the devices) are deleted again.
+#
+# The result is printed as one line of JSON, in the same format as the
+# platform benchmarks. If NMTST_BENCH_JSON is set, the line is appended
+# to that file instead.
+#
+# Usage: tools/bench-activate-dummy.sh [N]
+
+set -e
+
+N="${1:-100}"
+NMCLI="${NMCLI:-nmcli}"
+PREFIX="nm-bench-act"
+
+die() {
+    echo "$@" >&2
+    exit 1
+}
+
+now_nsec() {
+    date +%s%N
+}
+
+cleanup() {
+    local i
+    for ((i = 0; i < N; i++)); do
+        "$NMCLI" connection delete "$PREFIX-$i" &>/dev/null || :
+    done
+}
+
+[ "$N" -gt 0 ] 2>/dev/null || die "invalid number of devices \"$N\""
+[ "$N" -le 65536 ] || die "too many devices \"$N\""
+
+trap cleanup EXIT
+
+for ((i = 0; i < N; i++)); do
+    "$NMCLI" connection add \
+        save no \
+        type dummy \
+        con-name "$PREFIX-$i" \
+        ifname "$PREFIX-$i" \
+        autoconnect no \
+        ipv4.method manual \
+        ipv4.addresses "172.30.$((i / 256)).$((i % 256))/32" \
+        ipv6.method ignore \
+        >/dev/null || die "failure to add profile $PREFIX-$i"
+done
+
+START="$(now_nsec)"
+
+for ((i = 0; i < N; i++)); do
+    "$NMCLI" --wait 0 connection up "$PREFIX-$i" >/dev/null &
+done
+wait
+
+while :; do
+    ACTIVATED="$("$NMCLI" -g NAME,STATE connection show --active 2>/dev/null |
+                 grep -c "^$PREFIX-[0-9]*:activated$" || :)"
+    [ "$ACTIVATED" -ge "$N" ] && break
+    sleep 0.05
+done
+
+DURATION="$(( $(now_nsec) - START ))"
+
+LINE="$(awk -v n="$N" -v d="$DURATION" \
+            'BEGIN { printf "{\"benchmark\": \"activate-dummy\", \"platform\": \"linux\", \"n\": %d, \"duration_nsec\": %.0f, \"nsec_per_op\": %.1f}\n", n, d, d / n }')"
+
+if [ -n "$NMTST_BENCH_JSON" ]; then
+    echo "$LINE" >> "$NMTST_BENCH_JSON"
+else
+    echo "$LINE"
+fi